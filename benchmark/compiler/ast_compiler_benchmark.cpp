@@ -9,6 +9,7 @@
 #include <spdlog/spdlog.h>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 
 using namespace epoch_script;
 using namespace epoch_benchmark;
@@ -113,6 +114,92 @@ TEST_CASE("AST Compiler - Empty Script", "[compiler][edge]") {
     };
 }
 
+//=============================================================================
+// LARGE GENERATED SCRIPTS: Scaling of the post-compilation passes
+// Parameter-grid generators emit scripts with tens of thousands of nodes;
+// CSE, orphan removal, topological sort and timeframe resolution must stay
+// near-linear in the node count.
+//=============================================================================
+
+// Generates a script of about `nodes` nodes before optimization. Every
+// statement group adds an ema chained on the previous one, an identical
+// copy of it (removed by CSE) and a comparison nobody reads (removed as an
+// orphan); only the chain reaches the executor.
+static std::string make_synthetic_script(size_t nodes) {
+    std::string script = "src = market_data_source(timeframe=\"1D\")\n"
+                         "e0 = ema(period=10)(src.c)\n";
+    const size_t groups = nodes / 3;
+    for (size_t i = 1; i <= groups; ++i) {
+        const size_t period = 2 + i % 50;
+        script += fmt::format("e{0} = ema(period={1})(e{2}.result)\n"
+                              "d{0} = ema(period={1})(e{2}.result)\n"
+                              "c{0} = e{0}.result > d{0}.result\n",
+                              i, period, i - 1);
+    }
+    script += fmt::format("cross = crossover()(e{}.result, src.c)\n"
+                          "trade_signal_executor()(enter_long=cross.result)\n",
+                          groups);
+    return script;
+}
+
+static double time_compile_ms(const std::string &script, size_t &result_size) {
+    auto start = Clock::now();
+    AlgorithmAstCompiler compiler;
+    auto result = compiler.compile(script);
+    auto end = Clock::now();
+    result_size = result.size();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+TEST_CASE("AST Compiler - Large Generated Scripts", "[compiler][stress][scaling]") {
+    const std::vector<size_t> sizes = {1000, 10000, 50000};
+
+    for (const size_t nodes : sizes) {
+        const std::string script = make_synthetic_script(nodes);
+        // src, e0, one ema per group, crossover and executor survive
+        const size_t expected = nodes / 3 + 4;
+
+        BENCHMARK("Compile generated script (" + std::to_string(nodes) + " nodes)") {
+            AlgorithmAstCompiler compiler;
+            auto result = compiler.compile(script);
+            REQUIRE(result.size() == expected);
+            return result.size();
+        };
+    }
+}
+
+TEST_CASE("AST Compiler - Linear Scaling", "[compiler][stress][scaling]") {
+    const std::vector<size_t> sizes = {1000, 10000, 50000};
+
+    // Best of a few runs per size, as time per generated node
+    std::vector<double> per_node_us;
+    for (const size_t nodes : sizes) {
+        const std::string script = make_synthetic_script(nodes);
+        const int num_samples = nodes > 10000 ? 3 : 5;
+
+        double best_ms = std::numeric_limits<double>::max();
+        for (int i = 0; i < num_samples; ++i) {
+            size_t result_size = 0;
+            best_ms = std::min(best_ms, time_compile_ms(script, result_size));
+            REQUIRE(result_size == nodes / 3 + 4);
+        }
+        per_node_us.push_back(best_ms * 1000.0 / static_cast<double>(nodes));
+
+        SPDLOG_INFO("{:>6} nodes : {:>12} ({:.2f} µs/node)", nodes,
+                    format_duration(best_ms), per_node_us.back());
+    }
+
+    // A quadratic pass makes the cost per node grow with the script: 50x the
+    // nodes would cost about 50x more per node. Allow hashing, allocation
+    // and cache effects a small constant factor on top of linear.
+    constexpr double kMaxPerNodeGrowth = 4.0;
+    for (size_t i = 1; i < sizes.size(); ++i) {
+        INFO(sizes[i] << " nodes: " << per_node_us[i] << " µs/node vs "
+             << sizes[0] << " nodes: " << per_node_us[0] << " µs/node");
+        CHECK(per_node_us[i] <= per_node_us[0] * kMaxPerNodeGrowth);
+    }
+}
+
 //=============================================================================
 // SUMMARY TEST: Compare All Scenarios
 //=============================================================================
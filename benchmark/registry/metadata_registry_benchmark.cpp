@@ -0,0 +1,108 @@
+//
+// EpochScript Metadata Registry Benchmark
+// Cold-start transform registry initialization: YAML and C++ builders versus
+// the build-time snapshot
+//
+
+#include <catch2/catch_all.hpp>
+#include <benchmark_utils.h>
+#include <epoch_script/transforms/core/registration.h>
+#include <epoch_script/transforms/core/registry.h>
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+#include <filesystem>
+#include <limits>
+
+using namespace epoch_script;
+using namespace epoch_benchmark;
+
+namespace {
+const auto YAML_LOADER = [](std::string const &path) {
+    return YAML::LoadFile(std::filesystem::path{METADATA_FILES_DIR} / path);
+};
+
+// Written by the transform_metadata_snapshot target
+std::string load_snapshot() {
+    const auto path = std::filesystem::path{METADATA_FILES_DIR} / "transforms_snapshot.json";
+    REQUIRE(std::filesystem::exists(path));
+    return load_script(path.string());
+}
+
+size_t registry_size() {
+    return transforms::ITransformRegistry::GetInstance().GetMetaData().size();
+}
+
+void clear_registry() {
+    transforms::ITransformRegistry::GetInstance().Clear();
+}
+
+// Each sample registers into an empty registry, as a fresh process does
+template <class F>
+double best_of_ms(F &&register_metadata, int samples) {
+    double best_ms = std::numeric_limits<double>::max();
+    for (int i = 0; i < samples; ++i) {
+        clear_registry();
+        auto start = Clock::now();
+        register_metadata();
+        best_ms = std::min(best_ms, Duration(Clock::now() - start).count());
+    }
+    return best_ms;
+}
+} // namespace
+
+TEST_CASE("Metadata Registry - Initialization", "[registry][baseline]") {
+    const std::string snapshot = load_snapshot();
+    const size_t expected = registry_size();
+
+    SPDLOG_INFO("=== Transform Registry Initialization ===");
+    SPDLOG_INFO("Snapshot: {} bytes, {} transforms", snapshot.size(), expected);
+
+    // Every run clears the registry first so insertions are measured, not
+    // overwrites of existing entries; the clear is part of every case
+    BENCHMARK("Register from YAML and C++ metadata") {
+        clear_registry();
+        transforms::RegisterTransformMetadata(YAML_LOADER);
+        return registry_size();
+    };
+
+    BENCHMARK("Register from snapshot (in memory)") {
+        clear_registry();
+        transforms::RegisterTransformMetadataSnapshot(snapshot);
+        return registry_size();
+    };
+
+    BENCHMARK("Register from snapshot (read from disk)") {
+        clear_registry();
+        transforms::RegisterTransformMetadataSnapshot(load_snapshot());
+        return registry_size();
+    };
+
+    BENCHMARK("Register from snapshot with YAML fallback") {
+        clear_registry();
+        transforms::RegisterTransformMetadata(
+            YAML_LOADER, std::filesystem::path{METADATA_FILES_DIR} / "transforms_snapshot.json");
+        return registry_size();
+    };
+
+    REQUIRE(registry_size() == expected);
+}
+
+TEST_CASE("Metadata Registry - Performance Summary", "[registry][summary]") {
+    const std::string snapshot = load_snapshot();
+
+    const size_t expected = registry_size();
+
+    const double yaml_ms = best_of_ms([] { transforms::RegisterTransformMetadata(YAML_LOADER); }, 5);
+    REQUIRE(registry_size() == expected);
+    const double snapshot_ms = best_of_ms([&] { transforms::RegisterTransformMetadataSnapshot(load_snapshot()); }, 5);
+    REQUIRE(registry_size() == expected);
+
+    SPDLOG_INFO("{:20} : {:>12}", "YAML + C++", format_duration(yaml_ms));
+    SPDLOG_INFO("{:20} : {:>12} ({:.1f}x faster)", "Snapshot", format_duration(snapshot_ms),
+                yaml_ms / snapshot_ms);
+
+    // Target for short-lived workers and CLI tools
+    constexpr double kMaxSnapshotMs = 10.0;
+    CHECK(snapshot_ms < yaml_ms);
+    CHECK(snapshot_ms < kMaxSnapshotMs);
+}
@@ -0,0 +1,71 @@
+# Build-time hashes of source trees, for keys of persisted caches that must
+# not be reused by a build whose code may produce different results.
+#
+#   epoch_script_source_fingerprint(<macro> <directory>...)
+#
+# generates fingerprints/<macro lower case>.h defining <macro> as a hash of
+# the .cpp, .h and .yaml files under the given directories (relative to the
+# project root), regenerated whenever one of them changes.
+#
+# The same file runs in script mode (cmake -P) to write the header.
+
+if(CMAKE_SCRIPT_MODE_FILE)
+    string(REPLACE "|" ";" _directories "${DIRECTORIES}")
+    set(_sources)
+    foreach(_directory IN LISTS _directories)
+        file(GLOB_RECURSE _found
+            "${ROOT}/${_directory}/*.cpp" "${ROOT}/${_directory}/*.h" "${ROOT}/${_directory}/*.yaml")
+        list(APPEND _sources ${_found})
+    endforeach()
+    list(SORT _sources)
+
+    set(_content "")
+    foreach(_file IN LISTS _sources)
+        file(SHA256 "${_file}" _hash)
+        file(RELATIVE_PATH _name "${ROOT}" "${_file}")
+        string(APPEND _content "${_name}:${_hash}\n")
+    endforeach()
+    string(SHA256 _fingerprint "${_content}")
+    string(SUBSTRING "${_fingerprint}" 0 16 _fingerprint)
+
+    file(WRITE "${OUTPUT}"
+        "#pragma once\n"
+        "// Generated by cmake/SourceFingerprint.cmake\n"
+        "#define ${NAME} \"${_fingerprint}\"\n")
+    return()
+endif()
+
+include_guard(GLOBAL)
+
+function(epoch_script_source_fingerprint name)
+    set(globs)
+    foreach(directory IN LISTS ARGN)
+        list(APPEND globs
+            ${PROJECT_SOURCE_DIR}/${directory}/*.cpp
+            ${PROJECT_SOURCE_DIR}/${directory}/*.h
+            ${PROJECT_SOURCE_DIR}/${directory}/*.yaml)
+    endforeach()
+    file(GLOB_RECURSE sources CONFIGURE_DEPENDS ${globs})
+
+    string(TOLOWER ${name} file_name)
+    set(directory ${PROJECT_BINARY_DIR}/generated)
+    set(output ${directory}/fingerprints/${file_name}.h)
+    list(JOIN ARGN "|" directories)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND}
+            -DROOT=${PROJECT_SOURCE_DIR}
+            "-DDIRECTORIES=${directories}"
+            -DNAME=${name}
+            -DOUTPUT=${output}
+            -P ${PROJECT_SOURCE_DIR}/cmake/SourceFingerprint.cmake
+        DEPENDS ${sources} ${PROJECT_SOURCE_DIR}/cmake/SourceFingerprint.cmake
+        COMMENT "Fingerprinting ${ARGN}"
+        VERBATIM)
+
+    # epoch_script is created in another directory, so it depends on the
+    # output through a target defined here
+    add_custom_target(${file_name} DEPENDS ${output})
+    add_dependencies(epoch_script ${file_name})
+    target_include_directories(epoch_script PRIVATE ${directory})
+endfunction()
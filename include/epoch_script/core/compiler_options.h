@@ -0,0 +1,27 @@
+#pragma once
+//
+// Optional optimization passes of the EpochScript compiler
+//
+#include <compare>
+
+namespace epoch_script {
+
+struct CompilerOptions {
+  // Fuse same-timeframe elementwise operator trees into fused_expression
+  // nodes evaluated in one pass
+  bool elementwise_fusion{false};
+
+  // Rewrite equivalent expressions into one canonical form ahead of CSE
+  bool algebraic_simplification{false};
+
+  // Passes named in EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS, a comma separated
+  // list of option names ("elementwise_fusion", "algebraic_simplification")
+  // or "all"; none when unset.
+  // Entry points that compile on behalf of a deployment (PythonSource,
+  // compileBatch, CompileSession) default to these.
+  static CompilerOptions FromEnvironment();
+
+  auto operator<=>(CompilerOptions const &) const = default;
+};
+
+} // namespace epoch_script
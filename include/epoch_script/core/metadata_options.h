@@ -589,6 +589,7 @@ namespace epoch_script
     double step_size{0.000001};
     std::string desc{};
     std::string tuningGuidance{}; // How to adjust this parameter for different strategies
+    bool isLookback{false}; // Value is a number of bars consumed before the first output
 
     void decode(YAML::Node const &);
 
@@ -3,6 +3,8 @@
 //
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <fmt/format.h>
 #include <functional>
 #include <optional>
@@ -21,14 +23,26 @@ public:
   void Register(MetaDataT metaData) noexcept {
     auto name = metaData.id;
     m_registry[name] = std::move(metaData);
+    ++m_generation;
   }
 
   void Register(std::vector<MetaDataT> const &metaDataList) noexcept {
     for (auto const &metaData : metaDataList) {
       m_registry[metaData.id] = metaData;
     }
+    ++m_generation;
   }
 
+  // Removes every entry, e.g. to time registration from a cold start
+  void Clear() noexcept {
+    m_registry.clear();
+    ++m_generation;
+  }
+
+  // Bumped by every Register and Clear call, so caches derived from the
+  // metadata can tell when it was added to, replaced or removed
+  uint64_t Generation() const noexcept { return m_generation.load(); }
+
   std::optional<std::reference_wrapper<const MetaDataT>>
   GetMetaData(const std::string &name) const noexcept {
     if (auto iter = m_registry.find(name); iter != m_registry.end()) {
@@ -48,5 +62,6 @@ public:
 
 private:
   std::unordered_map<std::string, MetaDataT> m_registry;
+  std::atomic<uint64_t> m_generation{0};
 };
 } // namespace epoch_script
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+//
+// Process and build independent hashing, for keys that name files on disk
+// or outlive the process (std::hash is neither).
+//
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace epoch_script {
+
+// FNV-1a (64 bit). Strings are length-prefixed, so ("ab", "c") and
+// ("a", "bc") hash differently.
+class StableHasher {
+public:
+  StableHasher &Add(std::string_view bytes) {
+    Add(static_cast<uint64_t>(bytes.size()));
+    Mix(bytes);
+    return *this;
+  }
+
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  StableHasher &Add(T value) {
+    Mix({reinterpret_cast<const char *>(&value), sizeof(value)});
+    return *this;
+  }
+
+  StableHasher &Add(std::span<const double> values) {
+    Add(static_cast<uint64_t>(values.size()));
+    Mix({reinterpret_cast<const char *>(values.data()), values.size_bytes()});
+    return *this;
+  }
+
+  uint64_t Digest() const { return m_hash; }
+  std::string HexDigest() const { return std::format("{:016x}", m_hash); }
+
+private:
+  void Mix(std::string_view bytes) {
+    for (const unsigned char c : bytes) {
+      m_hash ^= c;
+      m_hash *= 1099511628211ULL;
+    }
+  }
+
+  uint64_t m_hash{14695981039346656037ULL};
+};
+
+} // namespace epoch_script
@@ -16,6 +16,15 @@ public:
       TimeFrameNotation const &, asset::Asset const &,
       epoch_frame::DataFrame const &, epoch_frame::DateTime const &)>;
 
+  // Non-owning view of the rows one frame holds for a timestamp. References
+  // stay valid until the pipeline is re-run.
+  struct RowsView {
+    TimeFrameNotation const &timeframe;
+    asset::Asset const &asset;
+    epoch_frame::DataFrame const &frame;
+    IndexRange range; // inclusive [first, last] row positions in `frame`
+  };
+
   using Ptr = std::shared_ptr<Database>;
   using ConstPtr = const std::shared_ptr<Database>;
 
@@ -31,11 +40,11 @@ public:
 
   void RunPipeline();
 
-  std::unordered_map<std::string, epoch_proto::TearSheet> GetGeneratedReports() const {
+  const epoch_script::runtime::AssetReportMap &GetGeneratedReports() const {
     return m_impl->GetGeneratedReports();
   }
 
-  epoch_script::runtime::AssetEventMarkerMap GetGeneratedEventMarkers() const {
+  const epoch_script::runtime::AssetEventMarkerMap &GetGeneratedEventMarkers() const {
     return m_impl->GetGeneratedEventMarkers();
   }
 
@@ -45,9 +54,37 @@ public:
 
   std::optional<epoch_frame::Series> GetBenchmark() const { return m_impl->GetBenchmark(); }
 
+  const epoch_frame::DataFrame &GetCurrentData(TimeFrameNotation const &timeframe,
+                                               asset::Asset const &asset) const {
+    return m_impl->GetCurrentData(timeframe, asset);
+  }
+
   void HandleData(const DataHandler &dataHandler,
                   const epoch_frame::DateTime &t) const;
 
+  // Allocation free variant of HandleData: calls `visitor(RowsView const &)`
+  // for every (timeframe, asset) with rows at `t`, without slicing frames.
+  template <typename Visitor>
+  void ForEachRowsAt(const epoch_frame::DateTime &t, Visitor &&visitor) const {
+    const auto &timestampIndex = m_impl->GetTimestampIndex();
+    const auto it = timestampIndex.find(t.m_nanoseconds.count());
+    if (it == timestampIndex.end()) {
+      return;
+    }
+    const auto &transformedData = GetTransformedData();
+    for (const auto &entry : it->second) {
+      visitor(RowsView{entry.timeframe, entry.asset,
+                       transformedData.at(entry.timeframe).at(entry.asset),
+                       entry.range});
+    }
+  }
+
+  // O(log n) binary search over the frame's sorted index. Returns std::nullopt
+  // when the frame has no rows at `t`.
+  std::optional<IndexRange> GetRowsAt(TimeFrameNotation const &timeframe,
+                                      asset::Asset const &asset,
+                                      const epoch_frame::DateTime &t) const;
+
   DataCategory GetDataCategory() const { return m_impl->GetDataCategory(); }
 
   asset::AssetHashSet GetAssets() const noexcept { return m_impl->GetAssets(); }
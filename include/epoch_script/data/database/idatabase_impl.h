@@ -24,8 +24,10 @@ struct IDatabaseImpl {
 
   virtual const TransformedDataType &GetTransformedData() const = 0;
 
-  virtual epoch_frame::DataFrame GetCurrentData(TimeFrameNotation const &,
-                                                asset::Asset const &) const = 0;
+  // Returns a reference into the transformed data; valid until the next
+  // RunPipeline/RefreshPipeline.
+  virtual const epoch_frame::DataFrame &
+  GetCurrentData(TimeFrameNotation const &, asset::Asset const &) const = 0;
 
   virtual DataCategory GetDataCategory() const = 0;
 
@@ -39,9 +41,9 @@ struct IDatabaseImpl {
   GetFrontContract(const asset::Asset &asset,
                    epoch_frame::DateTime const &) const = 0;
 
-  virtual std::unordered_map<std::string, epoch_proto::TearSheet> GetGeneratedReports() const = 0;
+  virtual const epoch_script::runtime::AssetReportMap &GetGeneratedReports() const = 0;
 
-  virtual epoch_script::runtime::AssetEventMarkerMap GetGeneratedEventMarkers() const = 0;
+  virtual const epoch_script::runtime::AssetEventMarkerMap &GetGeneratedEventMarkers() const = 0;
 };
 using IDatabaseImplPtr = std::unique_ptr<IDatabaseImpl>;
 } // namespace epoch_script::data
\ No newline at end of file
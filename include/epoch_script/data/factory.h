@@ -4,6 +4,9 @@
 //
 
 #include <epoch_data_sdk/dataloader/dataloader.hpp>
+#include <filesystem>
+#include <map>
+#include <set>
 #include <epoch_data_sdk/dataloader/options.hpp>
 #include <epoch_data_sdk/model/asset/asset.hpp>
 
@@ -37,6 +40,16 @@ private:
   asset::AssetClassMap<IWebSocketManagerPtr> m_webSocketManager;
 };
 
+// Warm-restart support. When set, the fully transformed database is restored
+// from `directory` if a snapshot with the same key exists, and written there
+// after a full run otherwise. The key covers `scriptHash`, the loader period,
+// categories, assets, resample timeframes and continuation settings. Ignored
+// when liveUpdates is set.
+struct DatabaseSnapshotOption {
+  std::filesystem::path directory;
+  std::string scriptHash;
+};
+
 struct DataModuleOption {
   DataloaderOption loader;
 
@@ -47,6 +60,17 @@ struct DataModuleOption {
   epoch_script::runtime::ITransformManagerPtr transformManager = nullptr;
 
   bool liveUpdates = false;
+
+  std::optional<DatabaseSnapshotOption> snapshot = std::nullopt;
+
+  // Columns the transforms read, by category. Recorded for inspection; the
+  // dataloader still loads whole categories.
+  std::map<DataCategory, std::set<std::string>> requiredColumns = {};
+
+  // Set when loader.startDate was moved earlier for transform warm-up: the
+  // first date of the requested period. Transformed data, reports and event
+  // markers are trimmed to each asset's first session of that date.
+  std::optional<epoch_frame::Date> evaluationStart = std::nullopt;
 };
 
 namespace factory {
@@ -74,6 +98,25 @@ std::vector<DataCategory>
 ExtractAuxiliaryCategoriesFromTransforms(
     epoch_script::transform::TransformConfigurationPtrList const &configs);
 
+// What a transform graph reads from the dataloader: the referenced columns
+// per category, and the bars each timeframe consumes before the first valid
+// output (the longest chain of options whose metadata marks them isLookback).
+struct DataRequirements {
+  std::map<DataCategory, std::set<std::string>> columns;
+  std::map<epoch_script::TimeFrame, size_t> warmupBars;
+};
+
+// Columns of non-auxiliary data sources, and requiredDataSources of other
+// transforms, are attributed to primaryCategory
+DataRequirements AnalyzeDataRequirements(
+    epoch_script::transform::TransformConfigurationPtrList const &configs,
+    DataCategory primaryCategory);
+
+// Records the columns and moves loader.startDate back by the warm-up of the
+// slowest timeframe, keeping the requested start in evaluationStart
+void ApplyDataRequirements(DataRequirements const &requirements,
+                           DataModuleOption &dataModuleOption);
+
 void ProcessConfigurations(
     std::vector<std::unique_ptr<
         epoch_script::transform::TransformConfiguration>> const &configs,
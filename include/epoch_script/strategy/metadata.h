@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include "epoch_script/core/compiler_options.h"
 #include "epoch_script/core/metadata_options.h"
 #include "epoch_script/core/time_frame.h"
 #include "enums.h"
@@ -31,7 +32,8 @@ namespace epoch_script::strategy
     PythonSource() = default;
 
     // Constructor that compiles source and extracts metadata
-    explicit PythonSource(std::string src, bool skip_sink_validation = false);
+    explicit PythonSource(std::string src, bool skip_sink_validation = false,
+                          CompilerOptions options = CompilerOptions::FromEnvironment());
 
     // Const getters
     const std::string &GetSource() const { return source_; }
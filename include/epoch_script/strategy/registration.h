@@ -4,15 +4,20 @@
 
 #pragma once
 #include "epoch_script/core/constants.h"
+#include <filesystem>
 
 #define REGISTER_ALGORITHM_METADATA(FactoryMetaData, FactoryMetaDataCreator)   \
   const int REGISTER_STRATEGY_METADATA##FactoryMetaData =                      \
       RegisterStrategyMetaData(#FactoryMetaData, FactoryMetaDataCreator)
 
 namespace epoch_script::strategy {
+// Transform metadata comes from `transformMetadataSnapshot` when given and
+// built from the same sources as this library, from `loader` otherwise; the
+// other metadata always comes from `loader`.
 void RegisterStrategyMetadata(
     FileLoaderInterface const &loader,
     std::vector<std::string> const &aiGeneratedAlgorithms,
-    std::vector<std::string> const &aiGeneratedStrategies);
+    std::vector<std::string> const &aiGeneratedStrategies,
+    std::filesystem::path const &transformMetadataSnapshot = {});
 
 } // namespace epoch_script::strategy
\ No newline at end of file
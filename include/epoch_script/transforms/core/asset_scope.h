@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+namespace epoch_script::transform {
+
+// Asset the current thread is running a transform for, and the graph that
+// transform belongs to. The runtime evaluates transforms per asset but
+// TransformData only receives the frame, so transforms that keep per-asset
+// state (e.g. trained model caches) read the asset from here, and scope that
+// state by the graph so two strategies running in one process never share it.
+// Scopes nest, restoring the previous asset on exit, so a worker that picks up
+// another asset's task while waiting stays consistent.
+class ScopedAssetContext {
+public:
+  explicit ScopedAssetContext(std::string assetId, std::string graphId = {})
+      : m_previous(std::exchange(
+            Current(), Context{std::move(assetId), std::move(graphId)})) {}
+  ~ScopedAssetContext() { Current() = std::move(m_previous); }
+
+  ScopedAssetContext(const ScopedAssetContext &) = delete;
+  ScopedAssetContext &operator=(const ScopedAssetContext &) = delete;
+
+  // Empty outside of a scope, e.g. when a transform is called directly.
+  static std::string const &CurrentAssetId() { return Current().assetId; }
+
+  // Fingerprint of the running transform graph; empty outside of a scope or
+  // when the runtime did not provide one.
+  static std::string const &CurrentGraphId() { return Current().graphId; }
+
+private:
+  struct Context {
+    std::string assetId;
+    std::string graphId;
+  };
+
+  static Context &Current() {
+    thread_local Context context;
+    return context;
+  }
+
+  Context m_previous;
+};
+
+} // namespace epoch_script::transform
@@ -1876,6 +1876,20 @@ inline auto static_cast_to_timestamp_cfg = [](std::string const &id, std::string
   return single_input_op("static_cast_to_timestamp", id, input, timeframe);
 };
 
+// Fused expression transform helpers (compiler-inserted by elementwise fusion)
+inline auto fused_expression_cfg = [](std::string const &type, std::string const &id,
+                                      const std::vector<std::string> &inputs,
+                                      std::string const &program,
+                                      epoch_script::TimeFrame const &timeframe) {
+  YAML::Node inputs_yaml;
+  inputs_yaml["SLOT"] = inputs;
+
+  YAML::Node options_yaml;
+  options_yaml["program"] = program;
+
+  return run_op("fused_expression_" + type, id, inputs_yaml, options_yaml, timeframe);
+};
+
 // GroupBy aggregate transform helpers
 inline auto groupby_numeric_agg = [](std::string const &id,
                                       std::string const &agg_type,
@@ -80,6 +80,13 @@ CREATE_ENUM(
 
 CREATE_ENUM(IODataType, Decimal, Integer, Number, Boolean, String, Timestamp, Any);
 
+// Growth of a transform's work with the rows of one asset (N)
+CREATE_ENUM(CostComplexity,
+            Constant,  // per-call overhead only
+            Linear,    // O(N)
+            Windowed,  // O(N·window), window read from scaleOption
+            Quadratic); // O(N²), e.g. expanding-window recomputation
+
 // Note: CardRenderType, CardSlot, Color enums are defined in constants.h
 // Note: Use TransformCategory to distinguish between transform types:
 //   - Regular transforms: Aggregate, Math, Trend, Momentum, etc.
@@ -119,6 +126,28 @@ struct FlagSchema {
   std::optional<std::string> title{std::nullopt}; // Optional popup/tooltip title
 };
 
+/**
+ * @brief Static runtime cost model used by the compiler's cost estimator
+ * Work per asset = perCallOverhead + updateCoefficient · N
+ *                  + coefficient · f(N) / stride,
+ * in units of one elementwise operation on one row. f(N) is 0, N, N·scale or
+ * N² by complexity. updateCoefficient is the work of state that slides on
+ * every row whatever the stride (rolling accumulators); coefficient is the
+ * work stride skips. Transforms without a model are costed as Linear,
+ * coefficient 1.
+ */
+struct CostModel {
+  epoch_core::CostComplexity complexity{epoch_core::CostComplexity::Linear};
+  std::string scaleOption{};     // option multiplying per-row work (window, iterations)
+  std::string strideOption{};    // option recomputing only every k-th row
+  double coefficient{1.0};       // work per row (per window element for Windowed)
+  double updateCoefficient{0.0}; // work per row not divided by stride
+  double perCallOverhead{0.0};   // fixed work per asset (setup, remote calls)
+
+  void decode(YAML::Node const &);
+  YAML::Node encode() const { return {}; }
+};
+
 struct TransformsMetaData {
   std::string id;
   epoch_core::TransformCategory category;
@@ -146,6 +175,9 @@ struct TransformsMetaData {
   std::string usageContext{};  // When/why to use this transform
   std::string limitations{};  // Important caveats or constraints
 
+  // Runtime cost for the compiler's estimator; nullopt = Linear, coefficient 1
+  std::optional<CostModel> costModel{std::nullopt};
+
   void decode(YAML::Node const &);
   YAML::Node encode() const { return {}; }
 };
@@ -304,6 +336,14 @@ template <> struct convert<epoch_script::transforms::IOMetaData> {
   }
 };
 
+template <> struct convert<epoch_script::transforms::CostModel> {
+  static bool decode(const Node &node,
+                     epoch_script::transforms::CostModel &t) {
+    t.decode(node);
+    return true;
+  }
+};
+
 template <> struct convert<epoch_script::transforms::TransformsMetaData> {
   static bool decode(const Node &node,
                      epoch_script::transforms::TransformsMetaData &t) {
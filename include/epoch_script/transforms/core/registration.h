@@ -5,6 +5,8 @@
 #pragma once
 
 #include "metadata.h"
+#include <filesystem>
+#include <string_view>
 
 #define REGISTER_ALGORITHM_METADATA(FactoryMetaData, FactoryMetaDataCreator)   \
   const int REGISTER_STRATEGY_METADATA##FactoryMetaData =                      \
@@ -20,10 +22,30 @@ void RegisterStrategyMetaData(const std::string &name,
                               const TransformsMetaDataCreator &metaData);
 
 void RegisterTransformMetadata(FileLoaderInterface const &loader);
+
+// Snapshot of the merged transform registry (YAML entries, C++ metadata and
+// the flags RegisterTransformMetadata derives), written by the
+// epoch_metadata_snapshot tool at build time. Registering from it skips
+// yaml-cpp and the Make*MetaData builders; it throws on a malformed snapshot,
+// one written with a different format version, or one whose YAML and
+// metadata sources differ from this build's
+// (EPOCH_SCRIPT_METADATA_FINGERPRINT).
+std::string SerializeTransformMetadataSnapshot();
+std::vector<TransformsMetaData>
+ReadTransformMetadataSnapshot(std::string_view snapshot);
+void RegisterTransformMetadataSnapshot(std::string_view snapshot);
+
+// Registers from the snapshot file at snapshotPath, falling back to
+// RegisterTransformMetadata(loader) when it is missing, malformed, of
+// another format version or stale. Returns whether the snapshot was used.
+bool RegisterTransformMetadata(FileLoaderInterface const &loader,
+                               std::filesystem::path const &snapshotPath);
 } // namespace epoch_script::transforms
 
 namespace epoch_script::transform {
+// See strategy::RegisterStrategyMetadata for transformMetadataSnapshot
 void InitializeTransforms(
     std::function<YAML::Node(std::string const &)> const &,
-    std::vector<std::string> const &, std::vector<std::string> const &);
+    std::vector<std::string> const &, std::vector<std::string> const &,
+    std::filesystem::path const &transformMetadataSnapshot = {});
 } // namespace epoch_script::transform
\ No newline at end of file
@@ -1,21 +1,26 @@
 #pragma once
 
+#include <arrow/array.h>
 #include <epoch_frame/dataframe.h>
 #include <epoch_frame/datetime.h>
 #include <epoch_frame/index.h>
-#include <vector>
+#include <memory>
 
 namespace epoch_script::transform::sessions_utils {
-struct SessionState {
-  std::vector<bool> active;
-  std::vector<bool> opened;
-  std::vector<bool> closed;
+// Per-bar session membership as Arrow boolean arrays, so they can be used as
+// output columns and loc filters without conversion.
+struct SessionMasks {
+  std::shared_ptr<arrow::BooleanArray> active;
+  std::shared_ptr<arrow::BooleanArray> opened;
+  std::shared_ptr<arrow::BooleanArray> closed;
 };
 
-// Build active mask for a UTC index given a local SessionRange (start/end may
-// carry tz)
-SessionState BuildActiveMaskUTC(const epoch_frame::IndexPtr &utcIndex,
-                                const epoch_frame::SessionRange &range);
+// Session masks for a timestamp index (UTC or tz-aware) given a local
+// SessionRange (start/end may carry tz). Computed once per (index, range) and
+// shared by every caller passing the same index.
+std::shared_ptr<const SessionMasks>
+GetSessionMasks(const epoch_frame::IndexPtr &index,
+                const epoch_frame::SessionRange &range);
 
 // Slice a UTC DataFrame to the active session range via timezone-aware
 // boundaries
@@ -15,6 +15,12 @@ namespace epoch_script::runtime {
         virtual TimeFrameAssetDataFrameMap
         ExecutePipeline(TimeFrameAssetDataFrameMap data) = 0;
 
+        // First timestamp (UTC nanoseconds) of the requested period per
+        // asset. Reporters and event markers only see rows from it on; earlier
+        // rows just warm up the transforms they read from. Orchestrators
+        // without reporters may ignore it.
+        virtual void SetEvaluationStart(AssetTimestampMap) {}
+
         virtual AssetReportMap GetGeneratedReports() const = 0;
 
         virtual AssetEventMarkerMap GetGeneratedEventMarkers() const = 0;
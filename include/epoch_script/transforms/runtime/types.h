@@ -10,6 +10,7 @@ namespace epoch_script::runtime {
     using AssetID = std::string;
     using AssetDataFrameMap = std::unordered_map<AssetID, epoch_frame::DataFrame>;
     using TimeFrameAssetDataFrameMap = std::unordered_map<std::string, AssetDataFrameMap>;
+    using AssetTimestampMap = std::unordered_map<AssetID, int64_t>;
 
     using AssetReportMap = std::unordered_map<AssetID, epoch_proto::TearSheet>;
     using AssetEventMarkerMap = std::unordered_map<AssetID, std::vector<epoch_script::transform::EventMarkerData>>;
@@ -441,7 +441,8 @@ void MetaDataOption::decode(const YAML::Node &element) {
         .min = 1, // Period must be at least 1
         .max = 1000,
         .desc = "Number of bars to look back for calculation",
-        .tuningGuidance = "Shorter periods (5-20) are more responsive but noisier. Longer periods (50-200) are smoother but lag more. Common values: 14 (swing trading), 20 (daily), 50/200 (long-term trends)"}}};
+        .tuningGuidance = "Shorter periods (5-20) are more responsive but noisier. Longer periods (50-200) are smoother but lag more. Common values: 14 (swing trading), 20 (daily), 50/200 (long-term trends)",
+        .isLookback = true}}};
 
   if (element.IsScalar()) {
     *this = epoch_core::lookup(PLACEHOLDER_MAP, element.as<std::string>());
@@ -480,5 +481,6 @@ void MetaDataOption::decode(const YAML::Node &element) {
   isRequired = element["required"].as<bool>(true);
   desc = element["desc"].as<std::string>("");
   tuningGuidance = element["tuningGuidance"].as<std::string>("");
+  isLookback = element["lookback"].as<bool>(false);
 }
 } // namespace epoch_script
\ No newline at end of file
@@ -1,21 +1,18 @@
 #include <epoch_script/core/sql_statement.h>
 #include <duckdb.hpp>
-#include <mutex>
 
 namespace epoch_script
 {
 
 namespace
 {
-  // Static shared DuckDB connection for SQL validation
+  // Shared in-memory DuckDB database for SQL validation
   // This avoids creating a new database for each validation
-  struct ValidationConnection
+  struct ValidationDatabase
   {
     duckdb::DuckDB db;
-    duckdb::Connection con;
-    std::mutex mutex;
 
-    ValidationConnection() : db(nullptr), con(db)
+    ValidationDatabase() : db(nullptr)
     {
       // Create a dummy "self" table with timestamp and SLOT columns
       // Use enough SLOT columns to accommodate most use cases (SLOT0-SLOT99)
@@ -27,6 +24,7 @@ namespace
       }
       createTableSQL += ")";
 
+      duckdb::Connection con(db);
       auto createResult = con.Query(createTableSQL);
       if (createResult->HasError())
       {
@@ -35,10 +33,13 @@ namespace
     }
   };
 
-  ValidationConnection& GetValidationConnection()
+  // One connection per thread: a DuckDB connection must not be used by two
+  // threads at once, but connections to one database can prepare in parallel
+  duckdb::Connection& GetValidationConnection()
   {
-    static ValidationConnection validationConn;
-    return validationConn;
+    static ValidationDatabase validationDb;
+    thread_local duckdb::Connection con(validationDb.db);
+    return con;
   }
 }
 
@@ -61,7 +62,7 @@ void SqlStatement::ValidateInternal()
 
   // 3. Use DuckDB to validate SQL syntax and semantics
   // DuckDB will validate:
-  // - Table 'self' exists (enforced by dummy table in ValidationConnection)
+  // - Table 'self' exists (enforced by dummy table in ValidationDatabase)
   // - Columns SLOT0-SLOT99 exist (enforced by dummy table schema)
   // - SQL syntax is correct
   ValidateWithDuckDB();
@@ -71,15 +72,12 @@ void SqlStatement::ValidateWithDuckDB()
 {
   try
   {
-    // Get the shared validation connection
+    // Get this thread's validation connection
     auto& validationConn = GetValidationConnection();
 
-    // Lock the connection for thread-safe validation
-    std::lock_guard<std::mutex> lock(validationConn.mutex);
-
     // Prepare the user's SQL statement
     // PREPARE validates syntax and semantics without executing the query
-    auto prepareResult = validationConn.con.Prepare(m_sql);
+    auto prepareResult = validationConn.Prepare(m_sql);
     if (prepareResult->HasError())
     {
       throw std::runtime_error("SQL validation failed: " + prepareResult->GetError());
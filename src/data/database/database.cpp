@@ -2,6 +2,7 @@
 // Created by dewe on 10/2/21.
 //
 #include "epoch_script/data/database/database.h"
+#include <algorithm>
 
 namespace epoch_script::data {
 
@@ -12,20 +13,27 @@ void Database::RunPipeline() { m_impl->RunPipeline(); }
 void Database::HandleData(const DataHandler &dataHandler,
                           const epoch_frame::DateTime &t) const {
   // ✅ O(1) timestamp index lookup (replaces O(T×A) linear scan)
-  const auto &timestamp_index = m_impl->GetTimestampIndex();
-  const auto it = timestamp_index.find(t.m_nanoseconds.count());
-
-  if (it == timestamp_index.end()) {
-    return;  // No data for this timestamp
-  }
+  ForEachRowsAt(t, [&](RowsView const &rows) {
+    auto [start, end] = rows.range;
+    auto sub_df = rows.frame.iloc({start, end + 1});
+    dataHandler(rows.timeframe, rows.asset, sub_df, t);
+  });
+}
 
-  // Process all (timeframe, asset, range) entries for this timestamp
-  for (const auto &entry : it->second) {
-    const auto &df = GetTransformedData().at(entry.timeframe).at(entry.asset);
-    auto [start, end] = entry.range;
-    auto sub_df = df.iloc({start, end+1});
-    dataHandler(entry.timeframe, entry.asset, sub_df, t);
+std::optional<IndexRange>
+Database::GetRowsAt(TimeFrameNotation const &timeframe,
+                    asset::Asset const &asset,
+                    const epoch_frame::DateTime &t) const {
+  const auto &df = GetTransformedData().at(timeframe).at(asset);
+  const auto timestamps = df.index()->array().to_timestamp_view();
+  const int64_t *begin = timestamps->raw_values();
+  const int64_t *end = begin + timestamps->length();
+  const auto [first, last] =
+      std::equal_range(begin, end, t.m_nanoseconds.count());
+  if (first == last) {
+    return std::nullopt;
   }
+  return IndexRange{first - begin, last - begin - 1};
 }
 
 Database::~Database() = default;
@@ -13,6 +13,7 @@
 #include "epoch_frame/factory/index_factory.h"
 #include "epoch_frame/factory/scalar_factory.h"
 #include "epoch_frame/market_calendar.h"
+#include "epoch_frame/scalar.h"
 #include "index/datetime_index.h"
 #include <epoch_data_sdk/model/asset/asset.hpp>
 #include <epoch_data_sdk/model/asset/asset_specification.hpp>
@@ -22,11 +23,17 @@
 #include <arrow/type_fwd.h>
 #include <epoch_frame/index.h>
 #include <epoch_script/core/symbol.h>
+#include <epoch_script/data/model/exchange_calendar.h>
+#include <algorithm>
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_reduce.h>
 #include <oneapi/tbb/global_control.h>
+#include <ranges>
+#include <spdlog/spdlog.h>
 #include <vector>
 
 namespace epoch_script::data {
@@ -141,7 +148,9 @@ namespace epoch_script::data {
         m_futuresContinuationConstructor(
             std::move(options.futuresContinuationConstructor)),
         m_resampler(std::move(options.resampler)),
-        m_websocketManager(std::move(options.websocketManager)) {
+        m_websocketManager(std::move(options.websocketManager)),
+        m_snapshot(std::move(options.snapshot)),
+        m_evaluationStart(options.evaluationStart) {
     AssertFromFormat(m_dataloader != nullptr,
                      "Database Construction failed: dataloader == nullptr");
 
@@ -173,8 +182,90 @@ namespace epoch_script::data {
   }
 
   void DatabaseImpl::RunPipeline() {
+    if (m_snapshot) {
+      // A snapshot that cannot be restored is only a cache miss
+      try {
+        if (RestoreSnapshot(*m_snapshot)) {
+          return;
+        }
+      } catch (std::exception const &e) {
+        SPDLOG_WARN("Discarding database snapshot {}: {}",
+                    m_snapshot->GetPath().string(), e.what());
+        std::error_code error;
+        std::filesystem::remove_all(m_snapshot->GetPath(), error);
+      }
+    }
+
     LoadData();
     CompletePipeline();
+
+    if (m_snapshot) {
+      try {
+        SaveSnapshot(*m_snapshot);
+      } catch (std::exception const &e) {
+        SPDLOG_WARN("Failed to write database snapshot {}: {}",
+                    m_snapshot->GetPath().string(), e.what());
+      }
+    }
+  }
+
+  void DatabaseImpl::SaveSnapshot(DatabaseSnapshotLocation const &location) const {
+    const auto start = std::chrono::high_resolution_clock::now();
+    WriteDatabaseSnapshot(location.GetPath(), location.key,
+                          {.baseTimeframe = m_baseTimeframe,
+                           .transformedData = m_transformedData,
+                           .indexer = m_indexer,
+                           .reports = m_reports,
+                           .eventMarkers = m_eventMarkers});
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    SPDLOG_INFO("Database snapshot written to {} in {} ms",
+                location.GetPath().string(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+                    .count());
+  }
+
+  bool DatabaseImpl::RestoreSnapshot(DatabaseSnapshotLocation const &location) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto snapshot = ReadDatabaseSnapshot(
+        location.GetPath(), location.key,
+        [this](std::string const &assetId) { return ResolveAsset(assetId); });
+    if (!snapshot) {
+      return false;
+    }
+    AssertFromFormat(snapshot->baseTimeframe == m_baseTimeframe,
+                     "Snapshot base timeframe {} does not match {}",
+                     snapshot->baseTimeframe, m_baseTimeframe);
+
+    // Nothing is replaced until every step that can throw has succeeded
+    auto timestampIndex = BuildTimestampIndex(snapshot->indexer);
+    m_transformedData = std::move(snapshot->transformedData);
+    m_indexer = std::move(snapshot->indexer);
+    m_timestampIndex = std::move(timestampIndex);
+    m_reports = std::move(snapshot->reports);
+    m_eventMarkers = std::move(snapshot->eventMarkers);
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    SPDLOG_INFO("Database restored from snapshot {} in {} ms",
+                location.GetPath().string(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+                    .count());
+    return true;
+  }
+
+  asset::Asset DatabaseImpl::ResolveAsset(std::string const &assetId) const {
+    for (auto const &asset : m_dataloader->GetAssets()) {
+      if (asset.GetID() == assetId) {
+        return asset;
+      }
+      if (asset.IsFuturesContract()) {
+        if (auto continuation = asset.MakeFuturesContinuation();
+            continuation.GetID() == assetId) {
+          return continuation;
+        }
+      }
+    }
+    return asset::MakeAsset(asset::AssetSpecificationQuery{assetId});
   }
 
   void DatabaseImpl::RefreshPipeline() {
@@ -183,10 +274,10 @@ namespace epoch_script::data {
   }
 
   void DatabaseImpl::AppendFuturesContinuations() {
-    for (auto const &[k, v] :
+    for (auto &[k, v] :
          m_futuresContinuationConstructor->Build(m_loadedBarData)) {
-      m_loadedBarData.insert_or_assign(k, v);
-         }
+      m_loadedBarData.insert_or_assign(k, std::move(v));
+    }
   }
 
   void DatabaseImpl::UpdateData() {
@@ -260,9 +351,10 @@ namespace epoch_script::data {
       }
     }
 
-    // Process all items in parallel with a single thread pool
-    m_indexer.reserve(flattened_data.size());
-    std::mutex mutex;
+    // Each task writes its own slot, so no lock is needed; empty frames leave
+    // a null slot that is compacted away afterwards.
+    const bool debugEnabled = spdlog::should_log(spdlog::level::debug);
+    DatabaseIndexer indexer(flattened_data.size());
     oneapi::tbb::parallel_for(
         oneapi::tbb::blocked_range<size_t>(0, flattened_data.size()),
         [&](const oneapi::tbb::blocked_range<size_t> &range) {
@@ -270,27 +362,21 @@ namespace epoch_script::data {
             const auto &[timeframe, asset, dataframe] = flattened_data[i];
             if (dataframe.empty()) {
               continue;
-              ;
             }
-            auto result = std::make_unique<DatabaseIndexerItem>(
+            indexer[i] = std::make_unique<DatabaseIndexerItem>(
                 timeframe, asset, GetTimestampIndexMapping(dataframe.index()));
-            {
-              std::lock_guard lock(mutex);
-              m_indexer.emplace_back(std::move(result));
+            if (debugEnabled) {
+              SPDLOG_DEBUG("{}|{}|{}", timeframe, asset.ToString(),
+                           DebugPrintDataFrame(dataframe));
             }
-            SPDLOG_DEBUG("{}|{}|{}", timeframe, asset.ToString(),
-                         DebugPrintDataFrame(dataframe));
           }
         });
+    std::erase(indexer, nullptr);
+    m_indexer = std::move(indexer);
 
     // Build inverted timestamp index for O(1) lookup
     SPDLOG_DEBUG("Building timestamp index for {} indexer items", m_indexer.size());
-    for (const auto &item : m_indexer) {
-      const auto &[timeframe, asset, indexer] = *item;
-      for (const auto &[timestamp, range] : indexer) {
-        m_timestampIndex[timestamp].push_back({timeframe, asset, range});
-      }
-    }
+    m_timestampIndex = BuildTimestampIndex(m_indexer);
     SPDLOG_DEBUG("Timestamp index built with {} unique timestamps", m_timestampIndex.size());
   }
 
@@ -312,8 +398,39 @@ namespace epoch_script::data {
     SPDLOG_DEBUG("DatabaseImpl: Retrieved {} assets from dataloader", m_loadedBarData.size());
   }
 
+  int64_t DatabaseImpl::GetSessionStart(asset::Asset const &asset,
+                                        epoch_frame::Date const &date) {
+    const auto midnight = epoch_frame::Scalar{date}.timestamp().value;
+    try {
+      const auto day = epoch_frame::factory::index::make_datetime_index(
+          std::vector{epoch_frame::DateTime::fromtimestamp(midnight)}, "", "UTC");
+      const auto open = calendar::GetExchangeCalendar(asset)->days_at_time(
+          day, epoch_core::MarketTimeType::MarketOpen);
+      if (open.size() == 1) {
+        return std::min(midnight, open.iloc(0).timestamp().value);
+      }
+    } catch (std::exception const &e) {
+      SPDLOG_WARN("No session open for {} on {}, using UTC midnight: {}",
+                  asset.GetID(), epoch_frame::Scalar{date}.repr(), e.what());
+    }
+    return midnight;
+  }
+
   TransformedDataType
   DatabaseImpl::TransformBarData(StringAssetDataFrameMap dataFrameMap) {
+    // Rows before the requested period only warmed up the transforms
+    epoch_script::runtime::AssetTimestampMap evaluationStart;
+    if (m_evaluationStart) {
+      for (const auto &assetMap : dataFrameMap | std::views::values) {
+        for (const auto &asset : assetMap | std::views::keys) {
+          if (!evaluationStart.contains(asset.GetID())) {
+            evaluationStart.emplace(asset.GetID(),
+                                    GetSessionStart(asset, *m_evaluationStart));
+          }
+        }
+      }
+    }
+
     TransformedDataType result;
     if (m_dataTransform) {
       SPDLOG_DEBUG("Starting Data Transformation stage.");
@@ -333,6 +450,10 @@ namespace epoch_script::data {
         SPDLOG_INFO("TBB parallelism limited to 1 via EPOCH_DISABLE_PARALLEL_REPORTS.");
       }
 
+      if (m_evaluationStart) {
+        m_dataTransform->SetEvaluationStart(evaluationStart);
+      }
+
       // Build asset ID -> Asset mapping for reverse lookup
       std::unordered_map<std::string, asset::Asset> assetIdToAsset;
       std::unordered_map<std::string, std::unordered_map<std::string, epoch_frame::DataFrame>> stringKeyedMap;
@@ -374,6 +495,17 @@ namespace epoch_script::data {
 
     for (auto &[tf, item] : dataFrameMap) {
       for (auto &[asset, df] : item) {
+        const auto start = evaluationStart.find(asset.GetID());
+        if (start != evaluationStart.end() && df.num_rows() > 0) {
+          const auto timestamps = df.index()->array().to_timestamp_view();
+          const int64_t *begin = timestamps->raw_values();
+          const int64_t *end = begin + timestamps->length();
+          const auto first = std::lower_bound(begin, end, start->second) - begin;
+          if (first > 0) {
+            result[tf].insert_or_assign(asset, df.iloc({first, end - begin}));
+            continue;
+          }
+        }
         result[tf].insert_or_assign(asset, df);
       }
     }
@@ -381,9 +513,53 @@ namespace epoch_script::data {
     return result;
   }
 
+  TimestampIndex DatabaseImpl::BuildTimestampIndex(DatabaseIndexer const &indexer) {
+    // Partial indices are merged left-to-right so entry order follows indexer
+    // order.
+    return oneapi::tbb::parallel_reduce(
+        oneapi::tbb::blocked_range<size_t>(0, indexer.size()),
+        TimestampIndex{},
+        [&](const oneapi::tbb::blocked_range<size_t> &range,
+            TimestampIndex partial) {
+          // Items mostly share timestamps, so the range's union is about
+          // the size of its largest item
+          size_t largest = 0;
+          for (size_t i = range.begin(); i < range.end(); ++i) {
+            largest = std::max(largest, indexer[i]->indexer.size());
+          }
+          partial.reserve(std::max(partial.size(), largest));
+
+          for (size_t i = range.begin(); i < range.end(); ++i) {
+            const auto &[timeframe, asset, itemIndexer] = *indexer[i];
+            for (const auto &[timestamp, indexRange] : itemIndexer) {
+              partial[timestamp].push_back({timeframe, asset, indexRange});
+            }
+          }
+          return partial;
+        },
+        [](TimestampIndex lhs, TimestampIndex rhs) {
+          if (lhs.size() < rhs.size()) {
+            // Keep the larger table as the destination, but preserve order.
+            for (auto &[timestamp, entries] : lhs) {
+              auto &dst = rhs[timestamp];
+              dst.insert(dst.begin(), std::make_move_iterator(entries.begin()),
+                         std::make_move_iterator(entries.end()));
+            }
+            return rhs;
+          }
+          for (auto &[timestamp, entries] : rhs) {
+            auto &dst = lhs[timestamp];
+            dst.insert(dst.end(), std::make_move_iterator(entries.begin()),
+                       std::make_move_iterator(entries.end()));
+          }
+          return lhs;
+        });
+  }
+
   DatabaseIndexerValue
   DatabaseImpl::GetTimestampIndexMapping(epoch_frame::IndexPtr const &index) {
     DatabaseIndexerValue result;
+    result.reserve(index->size());
 
     const auto &timeStampIndex = index->array().to_timestamp_view();
     for (auto iterator = timeStampIndex->begin();
@@ -416,13 +592,17 @@ namespace epoch_script::data {
     return ss.str();
   }
 
-std::unordered_map<std::string, epoch_proto::TearSheet> DatabaseImpl::GetGeneratedReports() const {
-  // AssetReportMap already uses string keys (asset IDs)
-  return m_reports;
-}
-
-epoch_script::runtime::AssetEventMarkerMap DatabaseImpl::GetGeneratedEventMarkers() const {
-  return m_eventMarkers;
+const epoch_frame::DataFrame &
+DatabaseImpl::GetCurrentData(const std::string &timeframe,
+                             const asset::Asset &asset) const {
+  const auto assetMap = m_transformedData.find(timeframe);
+  AssertFromFormat(assetMap != m_transformedData.end(),
+                   "No transformed data for timeframe {}", timeframe);
+  const auto df = assetMap->second.find(asset);
+  AssertFromFormat(df != assetMap->second.end(),
+                   "No transformed data for {} at timeframe {}",
+                   asset.GetID(), timeframe);
+  return df->second;
 }
 
 } // namespace epoch_script::data
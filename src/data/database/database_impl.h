@@ -11,6 +11,7 @@
 #include <epoch_script/data/database/idatabase_impl.h>
 #include <epoch_data_sdk/model/asset/asset.hpp>
 #include "resample.h"
+#include "snapshot.h"
 #include <epoch_script/transforms/runtime/iorchestrator.h>
 #include <epoch_script/transforms/runtime/types.h>
 #include "../../../include/epoch_script/data/database/updates/iwebsocket_manager.h"
@@ -33,6 +34,15 @@ struct DatabaseImplOptions {
   IFuturesContinuationConstructor::Ptr futuresContinuationConstructor = nullptr;
   IResamplerPtr resampler = nullptr;
   asset::AssetClassMap<IWebSocketManagerPtr> websocketManager;
+  // When set, RunPipeline restores from this snapshot if it matches and
+  // writes one after a full run otherwise. A snapshot that fails to restore
+  // is deleted and rebuilt. Leave unset for live databases: RefreshPipeline
+  // needs the raw loaded bars, which a snapshot does not carry.
+  std::optional<DatabaseSnapshotLocation> snapshot = std::nullopt;
+  // Transformed rows before each asset's first session of this date only
+  // warmed up the transforms and are dropped, also from reports and event
+  // markers.
+  std::optional<epoch_frame::Date> evaluationStart = std::nullopt;
 };
 
 struct NYSEMarketSession {
@@ -71,10 +81,9 @@ public:
     return m_transformedData;
   }
 
-  epoch_frame::DataFrame GetCurrentData(const std::string &timeframe,
-                                        const asset::Asset &asset) const override {
-    return lookup(lookup(m_transformedData, timeframe), asset);
-  }
+  const epoch_frame::DataFrame &
+  GetCurrentData(const std::string &timeframe,
+                 const asset::Asset &asset) const override;
 
   std::optional<epoch_frame::Series> GetBenchmark() const override {
     return m_dataloader->GetBenchmark();
@@ -87,9 +96,13 @@ public:
   GetFrontContract(const asset::Asset &asset,
                    epoch_frame::DateTime const &) const final;
 
-  std::unordered_map<std::string, epoch_proto::TearSheet> GetGeneratedReports() const override;
+  const epoch_script::runtime::AssetReportMap &GetGeneratedReports() const override {
+    return m_reports;
+  }
 
-  epoch_script::runtime::AssetEventMarkerMap GetGeneratedEventMarkers() const override;
+  const epoch_script::runtime::AssetEventMarkerMap &GetGeneratedEventMarkers() const override {
+    return m_eventMarkers;
+  }
 
   const DatabaseIndexer &GetIndexer() const final { return m_indexer; }
 
@@ -100,6 +113,19 @@ public:
   static DatabaseIndexerValue
   GetTimestampIndexMapping(epoch_frame::IndexPtr const &index);
 
+  static TimestampIndex BuildTimestampIndex(DatabaseIndexer const &indexer);
+
+  // First timestamp (UTC nanoseconds) of the asset's trading on `date`: its
+  // exchange session open when that precedes UTC midnight (CME Globex opens
+  // the evening before, Sydney and Tokyo trade ahead of UTC), else midnight.
+  static int64_t GetSessionStart(asset::Asset const &asset,
+                                 epoch_frame::Date const &date);
+
+  void SaveSnapshot(DatabaseSnapshotLocation const &location) const;
+
+  // Returns false when no matching snapshot exists.
+  bool RestoreSnapshot(DatabaseSnapshotLocation const &location);
+
 private:
   DatabaseIndexer m_indexer;
   TimestampIndex m_timestampIndex;  // O(1) inverted index
@@ -114,6 +140,10 @@ private:
   // asset::AssetClassMap<NewMessageObserverPtr> m_messageHandlers;
   asset::AssetClassMap<IWebSocketManagerPtr> m_websocketManager;
 
+  std::optional<DatabaseSnapshotLocation> m_snapshot;
+
+  std::optional<epoch_frame::Date> m_evaluationStart;
+
   std::string m_baseTimeframe;
 
   // contains bar data, indexed by base timeframe
@@ -137,5 +167,7 @@ private:
   void UpdateData();
 
   void CompletePipeline();
+
+  asset::Asset ResolveAsset(std::string const &assetId) const;
 };
 } // namespace epoch_script::data
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "snapshot.h"
+#include "fingerprints/epoch_script_pipeline_fingerprint.h"
+#include "epoch_core/macros.h"
+#include "epoch_frame/common.h"
+#include <epoch_script/core/stable_hash.h>
+#include "index/datetime_index.h"
+#include <arrow/array/concatenate.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/table.h>
+#include <atomic>
+#include <fstream>
+#include <glaze/glaze.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+namespace epoch_script::data {
+
+namespace {
+constexpr auto kIndexColumn = "__index__";
+constexpr uint32_t kIndexMagic = 0x58495045; // "EPIX"
+
+struct SnapshotFrameEntry {
+  std::string timeframe;
+  std::string asset_id;
+  std::string file;
+};
+
+struct SnapshotReportEntry {
+  std::string asset_id;
+  std::string file;
+};
+
+struct SnapshotEventMarkerEntry {
+  std::string asset_id;
+  std::string title;
+  epoch_core::Icon icon{epoch_core::Icon::Info};
+  std::vector<epoch_script::CardColumnSchema> schemas;
+  std::optional<size_t> pivot_index;
+  std::string file;
+};
+
+struct SnapshotManifest {
+  uint32_t version{};
+  std::string key;
+  std::string base_timeframe;
+  std::vector<SnapshotFrameEntry> frames;
+  std::vector<SnapshotReportEntry> reports;
+  std::vector<SnapshotEventMarkerEntry> event_markers;
+};
+
+// index.bin headers. Every record is a multiple of 8 bytes so the triples stay
+// aligned when the file is mapped.
+struct IndexFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t itemCount;
+};
+
+struct IndexItemHeader {
+  uint64_t frameSlot;
+  uint64_t count;
+};
+
+struct IndexEntry {
+  int64_t timestamp;
+  int64_t start;
+  int64_t end;
+};
+
+void WriteFrame(std::filesystem::path const &path,
+                epoch_frame::DataFrame const &df) {
+  auto table = df.table();
+  const auto index = df.index()->array().value();
+  table = epoch_frame::AssertResultIsOk(table->AddColumn(
+      0, arrow::field(kIndexColumn, index->type()),
+      std::make_shared<arrow::ChunkedArray>(index)));
+
+  auto stream =
+      epoch_frame::AssertResultIsOk(arrow::io::FileOutputStream::Open(path.string()));
+  auto writer = epoch_frame::AssertResultIsOk(
+      arrow::ipc::MakeFileWriter(stream, table->schema()));
+  epoch_frame::AssertStatusIsOk(writer->WriteTable(*table));
+  epoch_frame::AssertStatusIsOk(writer->Close());
+  epoch_frame::AssertStatusIsOk(stream->Close());
+}
+
+epoch_frame::DataFrame ReadFrame(std::filesystem::path const &path) {
+  // Buffers handed out by the reader point into the mapping, so columns are
+  // not copied.
+  auto file = epoch_frame::AssertResultIsOk(arrow::io::MemoryMappedFile::Open(
+      path.string(), arrow::io::FileMode::READ));
+  auto reader = epoch_frame::AssertResultIsOk(
+      arrow::ipc::RecordBatchFileReader::Open(file));
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  batches.reserve(reader->num_record_batches());
+  for (int i = 0; i < reader->num_record_batches(); ++i) {
+    batches.emplace_back(
+        epoch_frame::AssertResultIsOk(reader->ReadRecordBatch(i)));
+  }
+  auto table = epoch_frame::AssertResultIsOk(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+
+  AssertFromFormat(table->num_columns() > 0 &&
+                       table->field(0)->name() == kIndexColumn,
+                   "Snapshot frame {} has no index column", path.string());
+  const auto indexChunks = table->column(0);
+  auto index = indexChunks->num_chunks() == 1
+                   ? indexChunks->chunk(0)
+                   : epoch_frame::AssertResultIsOk(
+                         arrow::Concatenate(indexChunks->chunks()));
+  table = epoch_frame::AssertResultIsOk(table->RemoveColumn(0));
+
+  return epoch_frame::DataFrame{
+      std::make_shared<epoch_frame::DateTimeIndex>(index), table};
+}
+
+void WriteBytes(std::filesystem::path const &path, std::string const &bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  AssertFromFormat(out.good(), "Failed to open {} for writing", path.string());
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::string ReadBytes(std::filesystem::path const &path) {
+  std::ifstream in(path, std::ios::binary);
+  AssertFromFormat(in.good(), "Failed to open {} for reading", path.string());
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void WriteIndex(std::filesystem::path const &path,
+                DatabaseIndexer const &indexer,
+                std::unordered_map<DatabaseIndexerItem const *, size_t> const
+                    &frameSlots) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  AssertFromFormat(out.good(), "Failed to open {} for writing", path.string());
+
+  const IndexFileHeader header{kIndexMagic, kDatabaseSnapshotVersion,
+                               indexer.size()};
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  std::vector<IndexEntry> entries;
+  for (auto const &item : indexer) {
+    entries.clear();
+    entries.reserve(item->indexer.size());
+    for (auto const &[timestamp, range] : item->indexer) {
+      entries.push_back({timestamp, range.first, range.second});
+    }
+    std::ranges::sort(entries, {}, &IndexEntry::timestamp);
+
+    const IndexItemHeader itemHeader{frameSlots.at(item.get()),
+                                     entries.size()};
+    out.write(reinterpret_cast<const char *>(&itemHeader), sizeof(itemHeader));
+    out.write(reinterpret_cast<const char *>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+  }
+}
+
+// Sibling of `path` no other process or thread picks
+std::filesystem::path UniqueSibling(std::filesystem::path const &path,
+                                    std::string_view tag) {
+  static std::atomic<uint64_t> counter{0};
+  thread_local std::mt19937_64 random{std::random_device{}()};
+  return path.string() + std::format(".{}-{}-{}-{:016x}", tag, ::getpid(),
+                                     counter++, random());
+}
+
+DatabaseIndexer ReadIndex(std::filesystem::path const &path,
+                          std::vector<SnapshotFrameEntry> const &frames,
+                          AssetResolver const &resolveAsset) {
+  auto file = epoch_frame::AssertResultIsOk(arrow::io::MemoryMappedFile::Open(
+      path.string(), arrow::io::FileMode::READ));
+  const auto size = epoch_frame::AssertResultIsOk(file->GetSize());
+  const auto buffer = epoch_frame::AssertResultIsOk(file->ReadAt(0, size));
+  const uint8_t *cursor = buffer->data();
+  const uint8_t *end = cursor + buffer->size();
+
+  auto take = [&]<typename T>(size_t count) {
+    const size_t bytes = count * sizeof(T);
+    AssertFromFormat(cursor + bytes <= end, "Snapshot index {} is truncated",
+                     path.string());
+    auto *ptr = reinterpret_cast<const T *>(cursor);
+    cursor += bytes;
+    return ptr;
+  };
+
+  const auto *header = take.template operator()<IndexFileHeader>(1);
+  AssertFromFormat(header->magic == kIndexMagic &&
+                       header->version == kDatabaseSnapshotVersion,
+                   "Snapshot index {} has an unexpected header",
+                   path.string());
+
+  DatabaseIndexer indexer;
+  indexer.reserve(header->itemCount);
+  for (uint64_t i = 0; i < header->itemCount; ++i) {
+    const auto *itemHeader = take.template operator()<IndexItemHeader>(1);
+    const auto *entries =
+        take.template operator()<IndexEntry>(itemHeader->count);
+    auto const &frame = frames.at(itemHeader->frameSlot);
+
+    DatabaseIndexerValue value;
+    value.reserve(itemHeader->count);
+    for (uint64_t j = 0; j < itemHeader->count; ++j) {
+      value.emplace(entries[j].timestamp,
+                    IndexRange{entries[j].start, entries[j].end});
+    }
+    indexer.emplace_back(std::make_unique<DatabaseIndexerItem>(
+        frame.timeframe, resolveAsset(frame.asset_id), std::move(value)));
+  }
+  return indexer;
+}
+} // namespace
+
+std::string MakeDatabaseSnapshotKey(std::vector<std::string> parts) {
+  StableHasher hasher;
+  hasher.Add(std::string_view{EPOCH_SCRIPT_PIPELINE_FINGERPRINT});
+  for (auto const &part : parts) {
+    hasher.Add(part);
+  }
+  return std::format("v{}-{}", kDatabaseSnapshotVersion, hasher.HexDigest());
+}
+
+void WriteDatabaseSnapshot(std::filesystem::path const &directory,
+                           std::string const &key,
+                           DatabaseSnapshotRef const &snapshot) {
+  namespace fs = std::filesystem;
+  const auto staging = UniqueSibling(directory, "tmp");
+  fs::remove_all(staging);
+  fs::create_directories(staging / "frames");
+  fs::create_directories(staging / "markers");
+  fs::create_directories(staging / "reports");
+
+  SnapshotManifest manifest{.version = kDatabaseSnapshotVersion,
+                            .key = key,
+                            .base_timeframe = snapshot.baseTimeframe};
+
+  std::vector<epoch_frame::DataFrame const *> frames;
+  std::unordered_map<std::string, std::unordered_map<std::string, size_t>>
+      frameSlotByKey;
+  for (auto const &[timeframe, assetMap] : snapshot.transformedData) {
+    for (auto const &[asset, df] : assetMap) {
+      const auto slot = frames.size();
+      manifest.frames.push_back({.timeframe = timeframe,
+                                 .asset_id = asset.GetID(),
+                                 .file = std::format("frames/{}.arrow", slot)});
+      frameSlotByKey[timeframe][asset.GetID()] = slot;
+      frames.push_back(&df);
+    }
+  }
+  oneapi::tbb::parallel_for(size_t{0}, frames.size(), [&](size_t i) {
+    WriteFrame(staging / manifest.frames[i].file, *frames[i]);
+  });
+
+  std::unordered_map<DatabaseIndexerItem const *, size_t> indexSlots;
+  for (auto const &item : snapshot.indexer) {
+    indexSlots.emplace(item.get(),
+                       frameSlotByKey.at(item->timeframe).at(item->asset.GetID()));
+  }
+  WriteIndex(staging / "index.bin", snapshot.indexer, indexSlots);
+
+  for (auto const &[assetId, report] : snapshot.reports) {
+    const auto file = std::format("reports/{}.pb", manifest.reports.size());
+    std::string bytes;
+    AssertFromFormat(report.SerializeToString(&bytes),
+                     "Failed to serialize report for {}", assetId);
+    WriteBytes(staging / file, bytes);
+    manifest.reports.push_back({.asset_id = assetId, .file = file});
+  }
+
+  for (auto const &[assetId, markers] : snapshot.eventMarkers) {
+    for (auto const &marker : markers) {
+      const auto file =
+          std::format("markers/{}.arrow", manifest.event_markers.size());
+      WriteFrame(staging / file, marker.data);
+      manifest.event_markers.push_back({.asset_id = assetId,
+                                        .title = marker.title,
+                                        .icon = marker.icon,
+                                        .schemas = marker.schemas,
+                                        .pivot_index = marker.pivot_index,
+                                        .file = file});
+    }
+  }
+
+  std::string json;
+  const auto error = glz::write_json(manifest, json);
+  AssertFromFormat(!error, "Failed to serialize snapshot manifest: {}",
+                   glz::format_error(error, json));
+  WriteBytes(staging / "manifest.json", json);
+
+  // Move any previous snapshot aside instead of deleting it, so the only
+  // window without a snapshot at `directory` is between two renames, and a
+  // crash there leaves both copies on disk
+  fs::create_directories(directory.parent_path());
+  std::optional<fs::path> previous;
+  if (fs::exists(directory)) {
+    previous = UniqueSibling(directory, "old");
+    std::error_code error;
+    fs::rename(directory, *previous, error);
+    if (error) {
+      previous.reset(); // a concurrent writer moved it first
+    }
+  }
+
+  std::error_code error;
+  fs::rename(staging, directory, error);
+  if (error) {
+    // Usually a concurrent writer of the same key renamed its copy first
+    SPDLOG_INFO("Keeping the snapshot already at {} ({})", directory.string(),
+                error.message());
+    fs::remove_all(staging, error);
+  }
+  if (previous) {
+    fs::remove_all(*previous, error);
+  }
+}
+
+std::optional<DatabaseSnapshot>
+ReadDatabaseSnapshot(std::filesystem::path const &directory,
+                     std::string const &key,
+                     AssetResolver const &resolveAsset) {
+  const auto manifestPath = directory / "manifest.json";
+  if (!std::filesystem::exists(manifestPath)) {
+    return std::nullopt;
+  }
+
+  SnapshotManifest manifest;
+  const auto json = ReadBytes(manifestPath);
+  if (auto error = glz::read_json(manifest, json)) {
+    SPDLOG_WARN("Ignoring unreadable snapshot manifest {}: {}",
+                manifestPath.string(), glz::format_error(error, json));
+    return std::nullopt;
+  }
+  if (manifest.version != kDatabaseSnapshotVersion || manifest.key != key) {
+    SPDLOG_INFO("Ignoring stale snapshot {} (version {}, key {})",
+                directory.string(), manifest.version, manifest.key);
+    return std::nullopt;
+  }
+
+  DatabaseSnapshot snapshot{.baseTimeframe = manifest.base_timeframe};
+
+  std::vector<epoch_frame::DataFrame> frames(manifest.frames.size());
+  oneapi::tbb::parallel_for(size_t{0}, frames.size(), [&](size_t i) {
+    frames[i] = ReadFrame(directory / manifest.frames[i].file);
+  });
+  for (size_t i = 0; i < frames.size(); ++i) {
+    auto const &entry = manifest.frames[i];
+    snapshot.transformedData[entry.timeframe].insert_or_assign(
+        resolveAsset(entry.asset_id), std::move(frames[i]));
+  }
+
+  snapshot.indexer =
+      ReadIndex(directory / "index.bin", manifest.frames, resolveAsset);
+
+  for (auto const &entry : manifest.reports) {
+    epoch_proto::TearSheet report;
+    AssertFromFormat(report.ParseFromString(ReadBytes(directory / entry.file)),
+                     "Failed to parse snapshot report {}", entry.file);
+    snapshot.reports.emplace(entry.asset_id, std::move(report));
+  }
+
+  for (auto &entry : manifest.event_markers) {
+    snapshot.eventMarkers[entry.asset_id].emplace_back(
+        std::move(entry.title), std::move(entry.schemas),
+        ReadFrame(directory / entry.file), entry.pivot_index, entry.icon);
+  }
+
+  return snapshot;
+}
+
+} // namespace epoch_script::data
@@ -0,0 +1,75 @@
+#pragma once
+//
+// Binary snapshot of a fully transformed database.
+//
+// Layout of a snapshot directory:
+//   manifest.json    - version, key, base timeframe, frame/report/marker lists
+//   frames/<n>.arrow - Arrow IPC file per (timeframe, asset); the index is
+//                      stored as the first column
+//   markers/<n>.arrow- Arrow IPC file per event marker frame
+//   reports/<n>.pb   - serialized TearSheet per asset
+//   index.bin        - DatabaseIndexer as flat int64 (timestamp, start, end)
+//                      triples, sorted by timestamp, so it can be mmap'd
+//
+// Frames are read through memory mapped files and their columns are not
+// copied. Restoring still parses the manifest and reports, rebuilds the
+// indexer's hash maps from index.bin and the database's timestamp index from
+// those, all linear in the number of index entries.
+#include <epoch_script/data/aliases.h>
+#include <epoch_script/transforms/runtime/types.h>
+#include <filesystem>
+#include <functional>
+
+namespace epoch_script::data {
+
+constexpr uint32_t kDatabaseSnapshotVersion = 1;
+
+struct DatabaseSnapshot {
+  std::string baseTimeframe;
+  TransformedDataType transformedData;
+  DatabaseIndexer indexer;
+  epoch_script::runtime::AssetReportMap reports;
+  epoch_script::runtime::AssetEventMarkerMap eventMarkers;
+};
+
+// Borrowed view of live database state, used when writing a snapshot.
+struct DatabaseSnapshotRef {
+  std::string const &baseTimeframe;
+  TransformedDataType const &transformedData;
+  DatabaseIndexer const &indexer;
+  epoch_script::runtime::AssetReportMap const &reports;
+  epoch_script::runtime::AssetEventMarkerMap const &eventMarkers;
+};
+
+// Where a DatabaseImpl persists/restores its state. `key` is usually built with
+// MakeDatabaseSnapshotKey from the script hash, data range and asset set.
+struct DatabaseSnapshotLocation {
+  std::filesystem::path directory;
+  std::string key;
+
+  std::filesystem::path GetPath() const { return directory / key; }
+};
+
+using AssetResolver = std::function<asset::Asset(std::string const &)>;
+
+// Writes into a uniquely named sibling directory, moves any previous snapshot
+// aside and renames the new one into place, so a reader never sees a partial
+// snapshot and a crash never deletes the last complete one. When writers of
+// the same key race, the first rename wins; their contents are equivalent.
+void WriteDatabaseSnapshot(std::filesystem::path const &directory,
+                           std::string const &key,
+                           DatabaseSnapshotRef const &snapshot);
+
+// Returns std::nullopt when no snapshot exists, or when its version or key do
+// not match; throws if a matching snapshot is corrupt.
+std::optional<DatabaseSnapshot>
+ReadDatabaseSnapshot(std::filesystem::path const &directory,
+                     std::string const &key,
+                     AssetResolver const &resolveAsset);
+
+// Stable (process independent) hex digest of the given key parts and of the
+// sources that shape transformed data (EPOCH_SCRIPT_PIPELINE_FINGERPRINT), so
+// a snapshot written by a build with different transforms is not reused.
+std::string MakeDatabaseSnapshotKey(std::vector<std::string> parts);
+
+} // namespace epoch_script::data
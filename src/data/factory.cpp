@@ -24,8 +24,11 @@
 #include <epoch_script/transforms/runtime/transform_manager/itransform_manager.h>
 #include "transforms/runtime/transform_manager/transform_manager.h"
 #include "transforms/components/data_sources/data_category_mapper.h"
+#include <epoch_frame/scalar.h>
+#include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <functional>
 #include <spdlog/spdlog.h>
 #include <unordered_set>
 #include <variant>
@@ -132,6 +135,46 @@ asset::AssetClassMap<IWebSocketManagerPtr> CreateWebSocketManager() {
   // return result;
 }
 
+std::optional<DatabaseSnapshotLocation>
+CreateSnapshotLocation(DataModuleOption const &option) {
+  // Live databases refresh from the raw loaded bars, which a snapshot does
+  // not carry
+  if (!option.snapshot || option.liveUpdates) {
+    return std::nullopt;
+  }
+
+  std::vector<std::string> assetIds;
+  for (auto const &asset : option.loader.dataloaderAssets) {
+    assetIds.emplace_back(asset.GetID());
+  }
+  std::ranges::sort(assetIds);
+
+  std::vector<std::string> parts{
+      option.snapshot->scriptHash,
+      epoch_frame::Scalar{option.loader.startDate}.repr(),
+      epoch_frame::Scalar{option.loader.endDate}.repr()};
+  for (auto const &category : option.loader.categories) {
+    parts.emplace_back(DataCategoryWrapper::ToString(category));
+  }
+  for (auto const &timeframe : option.barResampleTimeFrames) {
+    parts.emplace_back(timeframe.ToString());
+  }
+  if (option.evaluationStart) {
+    parts.emplace_back(epoch_frame::Scalar{*option.evaluationStart}.repr());
+  }
+  if (option.futureContinuation) {
+    parts.emplace_back(std::format(
+        "{}:{}:{}", static_cast<int>(option.futureContinuation->rollover),
+        static_cast<int>(option.futureContinuation->type),
+        option.futureContinuation->arg));
+  }
+  parts.insert(parts.end(), assetIds.begin(), assetIds.end());
+
+  return DatabaseSnapshotLocation{
+      .directory = option.snapshot->directory,
+      .key = MakeDatabaseSnapshotKey(std::move(parts))};
+}
+
     DataModuleFactory::DataModuleFactory(DataModuleOption option)
     : m_option(std::move(option)) {}
 
@@ -145,7 +188,9 @@ std::unique_ptr<Database> DataModuleFactory::CreateDatabase() {
           .dataTransform = CreateTransforms(m_option),
           .futuresContinuationConstructor = CreateFutureContinuations(m_option),
           .resampler = CreateResampler(m_option),
-          .websocketManager = CreateWebSocketManager()}));
+          .websocketManager = CreateWebSocketManager(),
+          .snapshot = CreateSnapshotLocation(m_option),
+          .evaluationStart = m_option.evaluationStart}));
 }
 
 std::array<asset::AssetHashSet, 3>
@@ -261,6 +306,177 @@ ExtractAuxiliaryCategoriesFromTransforms(
   return std::vector<DataCategory>(categorySet.begin(), categorySet.end());
 }
 
+namespace {
+constexpr int64_t kNanosPerMinute = 60'000'000'000;
+constexpr int64_t kNanosPerDay = 24 * 60 * kNanosPerMinute;
+// Minutes in a regular equity session, for counting intraday bars in days
+constexpr int64_t kSessionMinutes = 390;
+
+size_t OwnWarmupBars(epoch_script::transform::TransformConfiguration const &config,
+                     epoch_script::transforms::TransformsMetaData const &metadata) {
+  const auto options = config.GetOptions();
+  double bars = 0;
+  for (auto const &option : metadata.options) {
+    if (!option.isLookback) {
+      continue;
+    }
+    std::optional<epoch_script::MetaDataOptionDefinition> value;
+    if (auto it = options.find(option.id); it != options.end()) {
+      value = it->second;
+    } else {
+      value = option.defaultValue;
+    }
+    if (value && value->IsType<double>()) {
+      bars = std::max(bars, value->GetDecimal());
+    }
+  }
+  return static_cast<size_t>(bars);
+}
+
+// Calendar days spanned by `bars` bars of `timeframe`, with room for
+// weekends and exchange holidays
+int64_t WarmupCalendarDays(epoch_script::TimeFrame const &timeframe,
+                           size_t bars, epoch_frame::Date const &from) {
+  if (bars == 0) {
+    return 0;
+  }
+  const auto offset = timeframe.GetOffset();
+  const auto origin = epoch_frame::Scalar{from}.timestamp();
+  const auto span =
+      offset->mul(static_cast<int64_t>(bars))->add(origin).value - origin.value;
+
+  int64_t tradingDays = 0;
+  switch (offset->type()) {
+  case epoch_core::EpochOffsetType::Day:
+  case epoch_core::EpochOffsetType::BusinessDay:
+    tradingDays = static_cast<int64_t>(bars);
+    break;
+  default:
+    if (timeframe.IsIntraDay()) {
+      tradingDays = (span + kSessionMinutes * kNanosPerMinute - 1) /
+                    (kSessionMinutes * kNanosPerMinute);
+    } else {
+      // Weekly and coarser offsets already span calendar time
+      return (span + kNanosPerDay - 1) / kNanosPerDay;
+    }
+    break;
+  }
+  // ~252 sessions per 365 days, plus a long weekend at either end
+  return (tradingDays * 365 + 251) / 252 + 4;
+}
+} // namespace
+
+DataRequirements AnalyzeDataRequirements(
+    epoch_script::transform::TransformConfigurationPtrList const &configs,
+    DataCategory primaryCategory) {
+  DataRequirements requirements;
+
+  std::unordered_map<std::string,
+                     epoch_script::transform::TransformConfiguration const *>
+      byId;
+  for (auto const &config : configs) {
+    byId.emplace(config->GetId(), config.get());
+  }
+
+  auto sourceCategory = [&](std::string const &type) {
+    auto category =
+        epoch_script::data_sources::GetDataCategoryForTransform(type);
+    return category.value_or(primaryCategory);
+  };
+
+  // Warm-up of a node: its own plus the slowest input on the same timeframe.
+  // Inputs on other timeframes warm up on theirs.
+  std::unordered_map<std::string, size_t> warmup;
+  std::function<size_t(epoch_script::transform::TransformConfiguration const &)>
+      chainWarmup =
+          [&](epoch_script::transform::TransformConfiguration const &config)
+          -> size_t {
+    if (auto it = warmup.find(config.GetId()); it != warmup.end()) {
+      return it->second;
+    }
+    warmup[config.GetId()] = 0; // guards against cycles
+    const auto metadata = config.GetTransformDefinition().GetMetadata();
+    size_t inputs = 0;
+    for (auto const &[_, references] : config.GetInputs()) {
+      for (auto const &reference : references) {
+        auto source = byId.find(reference.substr(0, reference.find('#')));
+        if (source != byId.end() &&
+            source->second->GetTimeframe() == config.GetTimeframe()) {
+          inputs = std::max(inputs, chainWarmup(*source->second));
+        }
+      }
+    }
+    return warmup[config.GetId()] = OwnWarmupBars(config, metadata) + inputs;
+  };
+
+  for (auto const &config : configs) {
+    const auto metadata = config->GetTransformDefinition().GetMetadata();
+
+    for (auto const &[_, references] : config->GetInputs()) {
+      for (auto const &reference : references) {
+        const auto hash = reference.find('#');
+        auto source = byId.find(reference.substr(0, hash));
+        if (hash == std::string::npos || source == byId.end()) {
+          continue;
+        }
+        const auto sourceMetadata =
+            source->second->GetTransformDefinition().GetMetadata();
+        if (sourceMetadata.category ==
+            epoch_core::TransformCategory::DataSource) {
+          requirements.columns[sourceCategory(source->second->GetTransformName())]
+              .insert(reference.substr(hash + 1));
+        }
+      }
+    }
+
+    if (metadata.category != epoch_core::TransformCategory::DataSource) {
+      requirements.columns[primaryCategory].insert(
+          metadata.requiredDataSources.begin(),
+          metadata.requiredDataSources.end());
+    }
+
+    auto &bars = requirements.warmupBars[config->GetTimeframe()];
+    bars = std::max(bars, chainWarmup(*config));
+  }
+  std::erase_if(requirements.columns,
+                [](auto const &entry) { return entry.second.empty(); });
+  std::erase_if(requirements.warmupBars,
+                [](auto const &entry) { return entry.second == 0; });
+  return requirements;
+}
+
+void ApplyDataRequirements(DataRequirements const &requirements,
+                           DataModuleOption &dataModuleOption) {
+  for (auto const &[category, columns] : requirements.columns) {
+    dataModuleOption.requiredColumns[category].insert(columns.begin(),
+                                                      columns.end());
+  }
+
+  const auto requestedStart = dataModuleOption.evaluationStart.value_or(
+      dataModuleOption.loader.startDate);
+  int64_t warmupDays = 0;
+  for (auto const &[timeframe, bars] : requirements.warmupBars) {
+    warmupDays = std::max(warmupDays,
+                          WarmupCalendarDays(timeframe, bars, requestedStart));
+  }
+  if (warmupDays == 0) {
+    return;
+  }
+
+  const auto loadStart =
+      epoch_frame::DateTime::fromtimestamp(
+          epoch_frame::Scalar{requestedStart}.timestamp().value -
+          warmupDays * kNanosPerDay)
+          .date();
+  if (loadStart < dataModuleOption.loader.startDate) {
+    SPDLOG_INFO("Loading data from {} to warm up transforms before {}",
+                epoch_frame::Scalar{loadStart}.repr(),
+                epoch_frame::Scalar{requestedStart}.repr());
+    dataModuleOption.loader.startDate = loadStart;
+    dataModuleOption.evaluationStart = requestedStart;
+  }
+}
+
 void ProcessConfigurations(
     std::vector<std::unique_ptr<
         epoch_script::transform::TransformConfiguration>> const
@@ -277,6 +493,19 @@ void ProcessConfigurations(
 
   auto detectedCategories = ExtractAuxiliaryCategoriesFromTransforms(configurations);
   dataModuleOption.loader.categories.insert(detectedCategories.begin(), detectedCategories.end());
+
+  DataCategory primaryCategory = baseTimeframe.IsIntraDay()
+                                     ? DataCategory::MinuteBars
+                                     : DataCategory::DailyBars;
+  for (auto const &category : dataModuleOption.loader.categories) {
+    if (IsTimeSeriesCategory(category)) {
+      primaryCategory = category;
+      break;
+    }
+  }
+  ApplyDataRequirements(
+      AnalyzeDataRequirements(configurations, primaryCategory),
+      dataModuleOption);
 }
 
 DataModuleOption
@@ -353,6 +582,11 @@ DataModuleOption MakeDataModuleOptionFromStrategy(
             *dataModuleOption.transformManager->GetTransforms());
         dataModuleOption.loader.categories.insert(detectedCategories.begin(),
                                                   detectedCategories.end());
+
+        ApplyDataRequirements(
+            AnalyzeDataRequirements(*dataModuleOption.transformManager->GetTransforms(),
+                                    primaryCategory),
+            dataModuleOption);
     }
 
     return dataModuleOption;
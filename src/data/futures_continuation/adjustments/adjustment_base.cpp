@@ -4,10 +4,34 @@
 #include "adjustment_base.h"
 #include "epoch_frame/factory/array_factory.h"
 #include "epoch_frame/series.h"
+#include <arrow/array/array_primitive.h>
 #include <arrow/table.h>
+#include <epoch_core/macros.h>
+#include <epoch_frame/common.h>
 #include <arrow/type_fwd.h>
 
 namespace epoch_script::futures {
+namespace {
+void AppendUnAdjustedColumns(
+    arrow::FieldVector &fields, arrow::ChunkedArrayVector &data,
+    const FuturesConstructedBars &unAdjustedFrontBarData) {
+  for (epoch_script::BarAttribute::Type const &barAttributeType :
+       AdjustmentMethodBase::g_unAdjustedAttributeType) {
+    const auto barAttributeStr =
+        epoch_script::BarAttribute::fromType(barAttributeType);
+    if (barAttributeType != epoch_script::BarAttribute::Type::Contract) {
+      fields.emplace_back(arrow::field(barAttributeStr, arrow::float64()));
+      data.emplace_back(epoch_frame::factory::array::make_array(
+          unAdjustedFrontBarData[barAttributeType]));
+    } else {
+      fields.emplace_back(arrow::field(barAttributeStr, arrow::utf8()));
+      data.emplace_back(
+          epoch_frame::factory::array::make_array(unAdjustedFrontBarData.s));
+    }
+  }
+}
+} // namespace
+
 // Function to construct the adjusted table
 arrow::TablePtr AdjustmentMethodBase::ConstructAdjustedTable(
     FuturesConstructedBars &bars,
@@ -27,21 +51,33 @@ arrow::TablePtr AdjustmentMethodBase::ConstructAdjustedTable(
         epoch_frame::factory::array::make_array(bars[barAttributeType]));
   }
 
+  AppendUnAdjustedColumns(fields, data, unAdjustedFrontBarData);
+  return arrow::Table::Make(arrow::schema(fields), data);
+}
+
+arrow::TablePtr AdjustmentMethodBase::ConstructAdjustedTable(
+    AdjustedColumns const &columns, int64_t nRows,
+    const FuturesConstructedBars &unAdjustedFrontBarData) {
+  AssertFromFormat(columns.size() == g_adjustedAttributeType.size(),
+                   "Expected {} adjusted columns, got {}",
+                   g_adjustedAttributeType.size(), columns.size());
+  arrow::FieldVector fields;
+  fields.reserve(g_adjustedAttributeType.size() +
+                 g_unAdjustedAttributeType.size());
+  arrow::ChunkedArrayVector data;
+  data.reserve(fields.capacity());
+
+  auto column = columns.begin();
   for (epoch_script::BarAttribute::Type const &barAttributeType :
-       g_unAdjustedAttributeType) {
-    const auto barAttributeStr =
-        epoch_script::BarAttribute::fromType(barAttributeType);
-    if (barAttributeType != epoch_script::BarAttribute::Type::Contract) {
-      fields.emplace_back(arrow::field(barAttributeStr, arrow::float64()));
-      data.emplace_back(epoch_frame::factory::array::make_array(
-          unAdjustedFrontBarData[barAttributeType]));
-    } else {
-      fields.emplace_back(arrow::field(barAttributeStr, arrow::utf8()));
-      data.emplace_back(
-          epoch_frame::factory::array::make_array(unAdjustedFrontBarData.s));
-    }
+       g_adjustedAttributeType) {
+    fields.emplace_back(
+        arrow::field(epoch_script::BarAttribute::fromType(barAttributeType),
+                     arrow::float64()));
+    data.emplace_back(std::make_shared<arrow::ChunkedArray>(
+        std::make_shared<arrow::DoubleArray>(nRows, *column++)));
   }
 
+  AppendUnAdjustedColumns(fields, data, unAdjustedFrontBarData);
   return arrow::Table::Make(arrow::schema(fields), data);
 }
 
@@ -56,6 +92,17 @@ AdjustmentMethodBase::PrepareBarsContainer(int64_t nRows) {
   return bars;
 }
 
+AdjustmentMethodBase::AdjustedColumns
+AdjustmentMethodBase::PrepareAdjustedColumns(int64_t nRows) {
+  AdjustedColumns columns;
+  columns.reserve(g_adjustedAttributeType.size());
+  for (size_t i = 0; i < g_adjustedAttributeType.size(); ++i) {
+    columns.emplace_back(epoch_frame::AssertResultIsOk(
+        arrow::AllocateBuffer(nRows * static_cast<int64_t>(sizeof(double)))));
+  }
+  return columns;
+}
+
 // Function to calculate roll index ranges
 std::vector<std::pair<int64_t, int64_t>>
 AdjustmentMethodBase::CalculateRollIndexRanges(
@@ -6,6 +6,8 @@
 #include "epoch_frame/aliases.h"
 #include "epoch_script/core/bar_attribute.h"
 #include "initializer_list"
+#include <arrow/buffer.h>
+#include <span>
 #include "vector"
 #include <epoch_core/enum_wrapper.h>
 
@@ -35,9 +37,25 @@ struct AdjustmentMethodBase {
   ConstructAdjustedTable(FuturesConstructedBars &bars,
                          const FuturesConstructedBars &unAdjustedFrontBarData);
 
+  // Adjusted price columns in g_adjustedAttributeType order. Each buffer holds
+  // nRows float64 values and is handed to arrow without another copy.
+  using AdjustedColumns = std::vector<std::shared_ptr<arrow::Buffer>>;
+
+  static arrow::TablePtr
+  ConstructAdjustedTable(AdjustedColumns const &columns, int64_t nRows,
+                         const FuturesConstructedBars &unAdjustedFrontBarData);
+
   // Function to prepare the bars container
   static FuturesConstructedBars PrepareBarsContainer(int64_t nRows);
 
+  // Allocates one uninitialized float64 buffer per adjusted attribute
+  static AdjustedColumns PrepareAdjustedColumns(int64_t nRows);
+
+  static std::span<double> MutableColumn(arrow::Buffer &buffer,
+                                         int64_t nRows) {
+    return {buffer.mutable_data_as<double>(), static_cast<size_t>(nRows)};
+  }
+
   virtual epoch_core::AdjustmentType GetType() const = 0;
 
   // Function to calculate roll index ranges
@@ -19,12 +19,19 @@ namespace epoch_script::futures {
             const int64_t nRows = unAdjustedBackBarData.t.size();
             auto rollIndexRange = CalculateRollIndexRanges(rollIndexes, nRows);
 
-            auto bars = PrepareBarsContainer(nRows);
-            Direction::AdjustPriceAttributes(bars, g_adjustedAttributeType,
-                                             rollIndexRange, unAdjustedFrontBarData,
-                                             unAdjustedBackBarData);
+            // Adjusted prices are written straight into the arrow buffers
+            auto columns = PrepareAdjustedColumns(nRows);
+            auto column = columns.begin();
+            for (epoch_script::BarAttribute::Type const &barAttributeType :
+                 g_adjustedAttributeType) {
+                Direction::AdjustPriceAttribute(
+                    MutableColumn(**column++, nRows),
+                    unAdjustedFrontBarData[barAttributeType],
+                    unAdjustedBackBarData[barAttributeType], rollIndexRange);
+            }
 
-            const auto table = ConstructAdjustedTable(bars, unAdjustedFrontBarData);
+            const auto table =
+                ConstructAdjustedTable(columns, nRows, unAdjustedFrontBarData);
 
             return epoch_frame::DataFrame{epoch_frame::factory::index::make_datetime_index(unAdjustedBackBarData.t, "", "UTC"), table};
         }
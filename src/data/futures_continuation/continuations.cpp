@@ -13,7 +13,11 @@
 #include <cstddef>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/series.h>
-#include <tbb/parallel_for_each.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <unordered_map>
 
 namespace epoch_script::data {
 std::unique_ptr<futures::RolloverMethodBase>
@@ -47,6 +51,33 @@ MakeAdjustmentMethod(AdjustmentType adjustmentType) {
   }
 }
 
+namespace {
+// Rows of one contract inside the continuation input, in timestamp order. The
+// cursor only moves forward because the timeline is walked in ascending order,
+// which turns every "first row at or after ts" lookup into an amortized O(1)
+// step instead of a searchsorted + iloc.
+struct ContractRows {
+  std::string contract;
+  std::optional<epoch_frame::Date> expiration;
+  std::vector<int64_t> rows;
+  size_t cursor{0};
+};
+
+std::shared_ptr<arrow::DoubleArray>
+GetDoubleColumn(epoch_frame::DataFrame const &df, std::string const &key) {
+  auto array = df[key].contiguous_array();
+  if (array.type()->id() != arrow::Type::DOUBLE) {
+    array = array.cast(arrow::float64());
+  }
+  return array.to_view<double>();
+}
+
+double GetDoubleValue(arrow::DoubleArray const &array, int64_t row) {
+  return array.IsNull(row) ? std::numeric_limits<double>::quiet_NaN()
+                           : array.Value(row);
+}
+} // namespace
+
   // For Intraday resample to 1D before applying continuation
 epoch_frame::DataFrame
 FuturesContinuation::BuildBars(const epoch_frame::DataFrame &df) const {
@@ -70,40 +101,52 @@ FuturesContinuation::BuildBars(const epoch_frame::DataFrame &df) const {
   const auto openInterestKey =
       epoch_script::EpochStratifyXConstants::instance().OPEN_INTEREST();
 
-  std::vector<std::string> groupKey;
-  groupKey.reserve(df.num_rows());
-
   // throws internally if wrong cast
   const auto timestampView = df.index()->array().to_timestamp_view();
   const auto contractView =
       df[contractKey].contiguous_array().to_view<std::string>();
-
-  for (auto const &[timestamp, contract] :
-       std::views::zip(*timestampView, *contractView)) {
-    auto contractStr = *contract;
-    groupKey.emplace_back(
-        std::format("{}#{}", contractStr,
-                    asset::ContractInfo::GetDecade(std::string(
-                        contractStr.end() - 2, contractStr.end()))));
-  }
-
-  std::vector<std::pair<std::string, DataFrame>> groups;
-  for (auto const &[key, sub_group] :
-       df.group_by_apply(factory::array::make_array(groupKey)).groups()) {
-    auto keyStr = key.repr();
-    keyStr = keyStr.substr(0, keyStr.find('#'));
-    groups.emplace_back(keyStr, df.iloc(Array{sub_group}));
+  const int64_t nRows = static_cast<int64_t>(df.num_rows());
+  const int64_t *timestamps = timestampView->raw_values();
+
+  // Group rows by contract. The previous "{contract}#{decade}" key was derived
+  // from the contract string alone, so grouping on the string is equivalent.
+  // The roll walk below advances per-contract cursors, so it needs the rows
+  // in time order.
+  std::vector<ContractRows> groups;
+  {
+    std::unordered_map<std::string_view, size_t> groupLookup;
+    for (int64_t i = 0; i < nRows; ++i) {
+      if (i > 0 && timestamps[i] < timestamps[i - 1]) {
+        throw std::runtime_error(
+            "FuturesContinuation::BuildBars requires timestamps in "
+            "non-decreasing order; row " +
+            std::to_string(i) + " is earlier than the row before it");
+      }
+      const auto contract = contractView->GetView(i);
+      auto [it, inserted] = groupLookup.try_emplace(contract, groups.size());
+      if (inserted) {
+        groups.push_back({.contract = std::string(contract)});
+      }
+      groups[it->second].rows.push_back(i);
+    }
   }
 
   if (groups.size() == 1) {
     return df;
   }
 
-  std::ranges::sort(groups, [&](auto const &lhs, auto const &rhs) {
-    return GetContractExpiration(lhs.first) < GetContractExpiration(rhs.first);
-  });
+  for (auto &group : groups) {
+    group.expiration = GetContractExpiration(group.contract);
+  }
+  std::ranges::stable_sort(groups, {}, &ContractRows::expiration);
+
+  const auto open = GetDoubleColumn(df, openKey);
+  const auto high = GetDoubleColumn(df, highKey);
+  const auto low = GetDoubleColumn(df, lowKey);
+  const auto close = GetDoubleColumn(df, closeKey);
+  const auto volume = GetDoubleColumn(df, volumeKey);
+  const auto openInterest = GetDoubleColumn(df, openInterestKey);
 
-  auto orderedTimestamps = df.index()->array().unique().to_timestamp_view();
   std::vector<int64_t> rolloverPoints;
   rolloverPoints.reserve(df.num_rows());
 
@@ -113,21 +156,20 @@ FuturesContinuation::BuildBars(const epoch_frame::DataFrame &df) const {
   FuturesConstructedBars backBarData;
   backBarData.reserve(df.num_rows());
 
-  // Capture the bar data for the given contract at the current timestamp.
-  // Note: we must **not** use the timestamp of the `contractData` row because
-  // it might belong to a different trading day (e.g. when the back contract
-  // has not started trading yet). Instead, we use the timeline's current
-  // timestamp so that the `front` and `back` legs are aligned on the same
-  // axis. This behaviour is asserted in the unit‑tests.
-  auto emplace_data = [&](DataFrame const &contractData,
-                          std::string const &frontContract, int64_t timelineTs,
-                          FuturesConstructedBars &result) {
-    result.o.emplace_back(contractData.iloc(0, openKey).as_double());
-    result.h.emplace_back(contractData.iloc(0, highKey).as_double());
-    result.l.emplace_back(contractData.iloc(0, lowKey).as_double());
-    result.c.emplace_back(contractData.iloc(0, closeKey).as_double());
-    result.v.emplace_back(contractData.iloc(0, volumeKey).as_double());
-    result.oi.emplace_back(contractData.iloc(0, openInterestKey).as_double());
+  // Capture the bar data for the given contract row at the current timestamp.
+  // Note: we must **not** use the timestamp of the contract row because it
+  // might belong to a different trading day (e.g. when the back contract has
+  // not started trading yet). Instead, we use the timeline's current timestamp
+  // so that the `front` and `back` legs are aligned on the same axis. This
+  // behaviour is asserted in the unit‑tests.
+  auto emplace_data = [&](int64_t row, std::string const &frontContract,
+                          int64_t timelineTs, FuturesConstructedBars &result) {
+    result.o.emplace_back(GetDoubleValue(*open, row));
+    result.h.emplace_back(GetDoubleValue(*high, row));
+    result.l.emplace_back(GetDoubleValue(*low, row));
+    result.c.emplace_back(GetDoubleValue(*close, row));
+    result.v.emplace_back(GetDoubleValue(*volume, row));
+    result.oi.emplace_back(GetDoubleValue(*openInterest, row));
     result.t.emplace_back(timelineTs);
     result.s.emplace_back(frontContract);
   };
@@ -140,32 +182,62 @@ FuturesContinuation::BuildBars(const epoch_frame::DataFrame &df) const {
     return currentFrontContractIndex == (groups.size() - 1);
   };
 
-  auto get_data = [&](const DataFrame &sub, const Scalar &ts) {
-    if (sub.empty()) {
-      SPDLOG_DEBUG("Empty DataFrame provided to get_data");
-      return DataFrame{};
-    }
+  const auto firstTimestamp = [&](ContractRows const &group) {
+    return timestamps[group.rows.front()];
+  };
+  const auto lastTimestamp = [&](ContractRows const &group) {
+    return timestamps[group.rows.back()];
+  };
 
-    const auto idx = sub.index()->searchsorted(ts, SearchSortedSide::Left);
-    if (idx >= sub.num_rows()) {
-      // Debug information to understand the issue
-      SPDLOG_DEBUG("Timestamp not found in contract data. Timestamp: {}, First "
-                   "timestamp: {}, Last timestamp: {}, idx: {}, num_rows: {}",
-                   ts.repr(), sub.index()->at(0).repr(),
-                   sub.index()->at(-1).repr(), idx, sub.num_rows());
+  // Row of the first bar at or after `ts` (searchsorted left), or -1 when the
+  // contract has no such bar.
+  auto get_row = [&](ContractRows &group, int64_t ts) -> int64_t {
+    while (group.cursor < group.rows.size() &&
+           timestamps[group.rows[group.cursor]] < ts) {
+      ++group.cursor;
+    }
+    if (group.cursor == group.rows.size()) {
+      SPDLOG_DEBUG("Timestamp {} not found in contract {} data", ts,
+                   group.contract);
+      return -1;
+    }
+    return group.rows[group.cursor];
+  };
 
-      // Instead of asserting, return empty DataFrame to indicate no data found
-      return DataFrame{};
+  // Calendar dates only change on day boundaries for UTC/naive indexes, so the
+  // Scalar conversion runs once per day instead of once per bar.
+  const auto &timezone =
+      std::static_pointer_cast<arrow::TimestampType>(timestampView->type())
+          ->timezone();
+  const bool isUtc = timezone.empty() || timezone == "UTC";
+  constexpr int64_t kNanosPerDay = 86'400'000'000'000;
+  std::optional<int64_t> cachedDayKey;
+  std::optional<Date> cachedDate;
+  auto get_date = [&](int64_t ts) {
+    const int64_t dayKey = ts >= 0 ? ts / kNanosPerDay
+                                   : (ts - kNanosPerDay + 1) / kNanosPerDay;
+    if (!isUtc || !cachedDayKey || *cachedDayKey != dayKey) {
+      cachedDate = Scalar(arrow::TimestampScalar{ts, timestampView->type()})
+                       .to_datetime()
+                       .date();
+      cachedDayKey = dayKey;
     }
+    return *cachedDate;
+  };
 
-    return sub.iloc({idx, idx + 1});
+  struct Legs {
+    int64_t front{-1};
+    int64_t back{-1};
+    bool valid() const { return front >= 0 && back >= 0; }
   };
 
   std::optional<epoch_frame::Date> lastDecisionDay;
-  for (const auto &currentTimestamp : *orderedTimestamps) {
-    const Scalar currentTimestampScalar(
-        arrow::TimestampScalar{*currentTimestamp, orderedTimestamps->type()});
-    const Date currentDate = currentTimestampScalar.to_datetime().date();
+  for (int64_t i = 0; i < nRows; ++i) {
+    const int64_t currentTs = timestamps[i];
+    if (i > 0 && timestamps[i - 1] == currentTs) {
+      continue;
+    }
+    const Date currentDate = get_date(currentTs);
 
     const bool newDay = !lastDecisionDay || (currentDate != *lastDecisionDay);
     lastDecisionDay = currentDate;
@@ -174,83 +246,75 @@ FuturesContinuation::BuildBars(const epoch_frame::DataFrame &df) const {
     //    their data. This can advance across multiple contracts if the input
     //    timeline has gaps (e.g. missing trading days).
     while (newDay && !isLastContract() &&
-           currentTimestampScalar >
-               groups[currentFrontContractIndex].second.index()->at(-1)) {
+           currentTs > lastTimestamp(groups[currentFrontContractIndex])) {
       if (rolloverPoints.empty() ||
           static_cast<size_t>(rolloverPoints.back()) != rowIndex)
         rolloverPoints.push_back(rowIndex);
       ++currentFrontContractIndex;
     }
 
-    // After the forced‑roll loop we can safely access the (new) front group
-    // because its last trading day is >= current timestamp.
-    const auto &activeGroup = groups[currentFrontContractIndex].second;
-
-    if (newDay && currentTimestampScalar < activeGroup.index()->at(0)) {
+    if (newDay &&
+        currentTs < firstTimestamp(groups[currentFrontContractIndex])) {
       // Timeline date lies before this contract starts trading – skip it.
       SPDLOG_DEBUG("Skipping current timestamp({}) because it is before the "
-                   "current trading day({}) of the contract({}).",
-                   currentTimestampScalar.repr(),
-                   activeGroup.index()->at(0).repr(),
-                   groups[currentFrontContractIndex].first);
+                   "current trading day of the contract({}).",
+                   currentTs, groups[currentFrontContractIndex].contract);
       continue;
     }
 
-    auto makeRolloverData = [&] {
-      const auto frontData = get_data(activeGroup, currentTimestampScalar);
-      RolloverMethodBase::Input in{.frontData = frontData,
-                                   .backData = frontData,
-                                   .currentDate = currentDate};
+    auto makeLegs = [&] {
+      Legs legs;
+      legs.front = get_row(groups[currentFrontContractIndex], currentTs);
+      legs.back = legs.front;
       if (!isLastContract()) {
         // Avoid forward‑bias: if the next contract has not started trading
         // yet (its earliest timestamp is *after* the timeline's current ts),
-        // reuse the frontData as a placeholder. This prevents us from
+        // reuse the front row as a placeholder. This prevents us from
         // injecting future prices into today's back leg.
-        if (const auto &nextGroup =
-                groups[currentFrontContractIndex + 1].second;
-            currentTimestampScalar >= nextGroup.index()->at(0)) {
-          in.backData = get_data(nextGroup, currentTimestampScalar);
+        if (auto &nextGroup = groups[currentFrontContractIndex + 1];
+            currentTs >= firstTimestamp(nextGroup)) {
+          legs.back = get_row(nextGroup, currentTs);
         }
       }
-      return in;
+      return legs;
     };
 
-    auto currentRollOverData = makeRolloverData();
-    if (currentRollOverData.backData.empty() ||
-        currentRollOverData.frontData.empty()) {
+    auto currentLegs = makeLegs();
+    if (!currentLegs.valid()) {
       SPDLOG_DEBUG("Skipping timestamp {} due to missing front or back data",
-                   currentTimestampScalar.repr());
+                   currentTs);
       continue;
     }
 
     // 2. Strategy‑based roll (e.g. volume, last‑trading‑day offset, etc.)
     if (newDay && !isLastContract() &&
-        m_rolloverMethod->IsRollDate(currentRollOverData)) {
+        m_rolloverMethod->IsRollDate(RolloverMethodBase::Snapshot{
+            .frontContract = std::string(contractView->GetView(currentLegs.front)),
+            .backContract = std::string(contractView->GetView(currentLegs.back)),
+            .frontOpenInterest = GetDoubleValue(*openInterest, currentLegs.front),
+            .backOpenInterest = GetDoubleValue(*openInterest, currentLegs.back),
+            .currentDate = currentDate})) {
       if (rolloverPoints.empty() ||
           static_cast<size_t>(rolloverPoints.back()) != rowIndex)
         rolloverPoints.push_back(rowIndex);
       ++currentFrontContractIndex;
-      currentRollOverData = makeRolloverData();
+      currentLegs = makeLegs();
     }
 
-    if (currentRollOverData.backData.empty() ||
-        currentRollOverData.frontData.empty()) {
+    if (!currentLegs.valid()) {
       SPDLOG_DEBUG(
           "Skipping timestamp {} after roll due to missing front or back data",
-          currentTimestampScalar.repr());
+          currentTs);
       continue;
     }
 
-    auto frontContract = groups[currentFrontContractIndex].first;
-    auto backContractSymbol = isLastContract()
-                                  ? frontContract
-                                  : groups[currentFrontContractIndex + 1].first;
+    const auto &frontContract = groups[currentFrontContractIndex].contract;
+    const auto &backContractSymbol =
+        isLastContract() ? frontContract
+                         : groups[currentFrontContractIndex + 1].contract;
 
-    const int64_t currentTsVal = currentTimestampScalar.timestamp().value;
-    emplace_data(currentRollOverData.frontData, frontContract, currentTsVal,
-                 frontBarData);
-    emplace_data(currentRollOverData.backData, backContractSymbol, currentTsVal,
-                 backBarData);
+    emplace_data(currentLegs.front, frontContract, currentTs, frontBarData);
+    emplace_data(currentLegs.back, backContractSymbol, currentTs, backBarData);
     ++rowIndex;
   }
 
@@ -285,28 +349,36 @@ FuturesContinuationConstructor::FuturesContinuationConstructor(
 
 AssetDataFrameMap FuturesContinuationConstructor::Build(
     AssetDataFrameMap const &inputData) const {
-  AssetDataFrameMap result;
-  std::mutex mtx;
-  std::vector<std::optional<std::pair<asset::Asset, epoch_frame::DataFrame>>>
-      items(inputData.size());
-
-  tbb::parallel_for_each(
-      inputData.begin(), inputData.end(), [&](auto const &item) {
-        if (!item.first.IsFuturesContract()) {
-          return;
-        }
-
-        auto continuation = item.first.MakeFuturesContinuation();
-        auto df = m_barConstructors->BuildBars(item.second);
-        if (df.empty()) {
-          SPDLOG_WARN("No bars built for {}", continuation.ToString());
-          return;
-        }
+  // Roots are independent, so each one is built on its own task and written
+  // to its own slot; only the final map insertion is serial.
+  std::vector<AssetDataFrameMap::const_iterator> roots;
+  roots.reserve(inputData.size());
+  for (auto it = inputData.begin(); it != inputData.end(); ++it) {
+    if (it->first.IsFuturesContract()) {
+      roots.push_back(it);
+    }
+  }
 
-        std::lock_guard lck{mtx};
-        result[continuation] = df;
-      });
+  std::vector<std::optional<std::pair<asset::Asset, epoch_frame::DataFrame>>>
+      items(roots.size());
+  tbb::parallel_for(size_t{0}, roots.size(), [&](size_t i) {
+    auto const &[asset, bars] = *roots[i];
+    auto continuation = asset.MakeFuturesContinuation();
+    auto df = m_barConstructors->BuildBars(bars);
+    if (df.empty()) {
+      SPDLOG_WARN("No bars built for {}", continuation.ToString());
+      return;
+    }
+    items[i].emplace(std::move(continuation), std::move(df));
+  });
 
+  AssetDataFrameMap result;
+  result.reserve(items.size());
+  for (auto &item : items) {
+    if (item) {
+      result.insert_or_assign(std::move(item->first), std::move(item->second));
+    }
+  }
   return result;
 }
 
@@ -9,7 +9,11 @@ class FirstOfMonthRollMethod : public RolloverMethodBase {
 public:
   explicit FirstOfMonthRollMethod(int offset) : RolloverMethodBase(offset) {}
 
-  bool IsRollDate(const Input &input) const final;
+  bool IsRollDate(const Input &input) const final {
+    return IsRollDate(MakeSnapshot(input));
+  }
+
+  bool IsRollDate(const Snapshot &snapshot) const final;
 
   inline epoch_core::RolloverType GetType() const final {
     return epoch_core::RolloverType::FirstOfMonth;
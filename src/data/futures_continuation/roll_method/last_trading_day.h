@@ -9,7 +9,11 @@ class LastTradingDayMethod : public RolloverMethodBase {
 public:
   explicit LastTradingDayMethod(int offset) : RolloverMethodBase(offset) {}
 
-  bool IsRollDate(const Input &input) const final;
+  bool IsRollDate(const Input &input) const final {
+    return IsRollDate(MakeSnapshot(input));
+  }
+
+  bool IsRollDate(const Snapshot &snapshot) const final;
 
   RolloverType GetType() const final {
     return epoch_core::RolloverType::LastTradingDay;
@@ -12,7 +12,12 @@ public:
         m_liquidityRatio(1 + (GetOffset() / 100.0)) {}
 
   inline bool IsRollDate(const Input &input) const final {
-    const double currentOI = GetOpenInterestsRatio(input);
+    return IsRollDate(MakeSnapshot(input));
+  }
+
+  inline bool IsRollDate(const Snapshot &snapshot) const final {
+    const double currentOI =
+        snapshot.backOpenInterest / snapshot.frontOpenInterest;
     return currentOI >= m_liquidityRatio;
   }
 
@@ -22,16 +27,5 @@ public:
 
 private:
   const double m_liquidityRatio;
-  static double GetOpenInterest(const epoch_frame::DataFrame &data) {
-    return data
-        .iloc(
-            0,
-            epoch_script::EpochStratifyXConstants::instance().OPEN_INTEREST())
-        .as_double();
-  }
-
-  static double GetOpenInterestsRatio(const Input &input) {
-    return GetOpenInterest(input.backData) / GetOpenInterest(input.frontData);
-  }
 };
 } // namespace epoch_script::futures
\ No newline at end of file
@@ -11,14 +11,14 @@
 #include <epoch_frame/index.h>
 #include <epoch_data_sdk/model/asset/asset.hpp>
 #include <epoch_data_sdk/model/asset/contract_spec.hpp>
+#include <limits>
 
 namespace epoch_script::futures {
 namespace asset = data_sdk::asset;
 using epoch_core::RolloverType;
-inline epoch_frame::Date GetContractExpiration(std::string const &contract) {
-  return asset::ContractInfo::MakeFuturesContractInfo(contract)
-      .GetExpirationDate();
-}
+// Memoized per contract symbol (bounded); safe to call from concurrent
+// builders.
+epoch_frame::Date GetContractExpiration(std::string const &contract);
 
 // TODO: Add Compound epoch_core::RolloverType
 
@@ -35,6 +35,16 @@ struct RolloverMethodBase {
     }
   };
 
+  // Raw front/back leg values at a single timeline step. The continuation
+  // builder evaluates roll decisions on this instead of one-row frames.
+  struct Snapshot {
+    std::string frontContract;
+    std::string backContract;
+    double frontOpenInterest{std::numeric_limits<double>::quiet_NaN()};
+    double backOpenInterest{std::numeric_limits<double>::quiet_NaN()};
+    epoch_frame::Date currentDate;
+  };
+
   explicit RolloverMethodBase(int offset = 0) : m_offset(offset) {}
 
   inline int GetOffset() const { return m_offset; }
@@ -42,6 +52,16 @@ struct RolloverMethodBase {
 
   virtual bool IsRollDate(const Input &input) const = 0;
 
+  // Defaults to materializing one-row frames so that methods implementing only
+  // the frame overload keep working; built-in methods override this directly.
+  virtual bool IsRollDate(const Snapshot &snapshot) const {
+    return IsRollDate(MakeInput(snapshot));
+  }
+
+  static Snapshot MakeSnapshot(const Input &input);
+
+  static Input MakeInput(const Snapshot &snapshot);
+
   static asset::ContractInfo GetContract(epoch_frame::DataFrame const &data) {
     AssertFromFormat(data.num_rows() > 0, "No data to get contract from");
     return asset::ContractInfo::MakeFuturesContractInfo(
@@ -6,11 +6,53 @@
 #include "liquidity_based.h"
 #include <epoch_script/data/model/exchange_calendar.h>
 #include <epoch_frame/market_calendar.h>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
 #include <epoch_data_sdk/model/builder/asset_builder.hpp>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace epoch_script::futures {
 namespace asset = data_sdk::asset;
 
+namespace {
+// Thread-safe memo for the contract lookups below. New contracts keep
+// arriving for as long as the process runs, so the memo is emptied once it
+// holds kCapacity entries instead of growing without bound.
+template <typename Value> class BoundedMemo {
+public:
+  static constexpr size_t kCapacity = 4096;
+
+  template <typename Compute>
+  Value Get(std::string const &key, Compute const &compute) {
+    {
+      std::shared_lock lock(m_mutex);
+      if (auto it = m_entries.find(key); it != m_entries.end()) {
+        return it->second;
+      }
+    }
+    auto value = compute();
+    std::unique_lock lock(m_mutex);
+    if (m_entries.size() >= kCapacity) {
+      m_entries.clear();
+    }
+    return m_entries.try_emplace(key, std::move(value)).first->second;
+  }
+
+private:
+  std::shared_mutex m_mutex;
+  std::unordered_map<std::string, Value> m_entries;
+};
+} // namespace
+
+epoch_frame::Date GetContractExpiration(std::string const &contract) {
+  static BoundedMemo<epoch_frame::Date> cache;
+  return cache.Get(contract, [&] {
+    return asset::ContractInfo::MakeFuturesContractInfo(contract)
+        .GetExpirationDate();
+  });
+}
+
 epoch_frame::calendar::MarketCalendarPtr
 GetCalendar(asset::ContractInfo const &contractInfo) {
   const auto contract = contractInfo.GetSymbol();  // Already returns std::string
@@ -18,18 +60,66 @@ GetCalendar(asset::ContractInfo const &contractInfo) {
       contract.size() >= 4,
       "invalid contract usually greater than 3 {symbol}{month-code}{Year}");
   const auto root = contract.substr(0, contract.size() - 3);
-  const auto assetSpec = asset::MakeAssetSpec(
-      {.required = std::pair{root,  // root is std::string, matches data_sdk::Symbol
-                             epoch_core::AssetClass::Futures}});
-  return calendar::GetExchangeCalendarFromSpec(assetSpec);
+
+  // Every contract of a root shares the same exchange calendar
+  static BoundedMemo<epoch_frame::calendar::MarketCalendarPtr> cache;
+  return cache.Get(root, [&] {
+    const auto assetSpec = asset::MakeAssetSpec(
+        {.required = std::pair{root,  // root is std::string, matches data_sdk::Symbol
+                               epoch_core::AssetClass::Futures}});
+    return calendar::GetExchangeCalendarFromSpec(assetSpec);
+  });
+}
+
+RolloverMethodBase::Snapshot
+RolloverMethodBase::MakeSnapshot(const Input &input) {
+  const auto &C = epoch_script::EpochStratifyXConstants::instance();
+  AssertFromFormat(input.frontData.num_rows() > 0,
+                   "No data to get contract from");
+
+  const auto readOpenInterest = [&](epoch_frame::DataFrame const &data) {
+    return data.contains(C.OPEN_INTEREST())
+               ? data.iloc(0, C.OPEN_INTEREST()).as_double()
+               : std::numeric_limits<double>::quiet_NaN();
+  };
+
+  Snapshot snapshot{.frontContract = input.frontData.iloc(0, C.CONTRACT()).repr(),
+                    .frontOpenInterest = readOpenInterest(input.frontData),
+                    .currentDate = input.currentDate};
+  if (input.backData.num_rows() > 0) {
+    snapshot.backContract = input.backData.iloc(0, C.CONTRACT()).repr();
+    snapshot.backOpenInterest = readOpenInterest(input.backData);
+  } else {
+    snapshot.backContract = snapshot.frontContract;
+    snapshot.backOpenInterest = snapshot.frontOpenInterest;
+  }
+  return snapshot;
+}
+
+RolloverMethodBase::Input
+RolloverMethodBase::MakeInput(const Snapshot &snapshot) {
+  using namespace epoch_frame;
+  const auto &C = epoch_script::EpochStratifyXConstants::instance();
+
+  const auto makeLeg = [&](std::string const &contract, double openInterest) {
+    return make_dataframe(
+        factory::index::make_datetime_index({DateTime{snapshot.currentDate}}),
+        std::vector{std::vector{Scalar{contract}}, {Scalar{openInterest}}},
+        {arrow::field(C.CONTRACT(), arrow::utf8()),
+         arrow::field(C.OPEN_INTEREST(), arrow::float64())});
+  };
+  return {.frontData =
+              makeLeg(snapshot.frontContract, snapshot.frontOpenInterest),
+          .backData = makeLeg(snapshot.backContract, snapshot.backOpenInterest),
+          .currentDate = snapshot.currentDate};
 }
 
-bool FirstOfMonthRollMethod::IsRollDate(const Input &input) const {
+bool FirstOfMonthRollMethod::IsRollDate(const Snapshot &snapshot) const {
   using namespace epoch_frame;
-  auto contractInfo = GetContract(input.frontData);
+  auto contractInfo =
+      asset::ContractInfo::MakeFuturesContractInfo(snapshot.frontContract);
   epoch_frame::calendar::MarketCalendarPtr calendar = GetCalendar(contractInfo);
 
-  auto currentTimestamp = Scalar{input.currentDate}.timestamp();
   const auto &baseOffset = calendar->holidays();
 
   auto expiry = contractInfo.GetExpirationDate();
@@ -44,17 +134,18 @@ bool FirstOfMonthRollMethod::IsRollDate(const Input &input) const {
   }
 
   auto expectedDate = DateTime::fromtimestamp(expectedDateTime.value).date();
-  return expectedDate == input.currentDate;
+  return expectedDate == snapshot.currentDate;
 }
 
-bool LastTradingDayMethod::IsRollDate(const Input &input) const {
+bool LastTradingDayMethod::IsRollDate(const Snapshot &snapshot) const {
   using namespace epoch_frame;
 
-  auto contractInfo = GetContract(input.frontData);
+  auto contractInfo =
+      asset::ContractInfo::MakeFuturesContractInfo(snapshot.frontContract);
   auto expirationDate = contractInfo.GetExpirationDate();
   epoch_frame::calendar::MarketCalendarPtr calendar = GetCalendar(contractInfo);
 
-  auto currentTimestamp = Scalar{input.currentDate}.timestamp();
+  auto currentTimestamp = Scalar{snapshot.currentDate}.timestamp();
   const auto &baseOffset = calendar->holidays();
   auto expectedTimestamp = baseOffset->mul(GetOffset())->add(currentTimestamp);
   auto expectedDate = Scalar(expectedTimestamp).to_datetime().date();
@@ -0,0 +1,202 @@
+#include "compilation_cache.h"
+
+#include "fingerprints/epoch_script_compiler_fingerprint.h"
+#include "transforms/compiler/ast_compiler.h"
+#include <epoch_script/core/glaze_custom_types.h>
+#include <epoch_script/core/stable_hash.h>
+#include <epoch_script/transforms/core/registry.h>
+#include <glaze/glaze.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+
+namespace epoch_script::strategy {
+
+namespace {
+// Layout of the persisted JSON; bump when CompilationCacheFile changes.
+// Compiler output changes are covered by EPOCH_SCRIPT_COMPILER_FINGERPRINT.
+constexpr uint32_t kFormatVersion = 2;
+
+struct CompilationCacheFile {
+  std::string source;
+  std::vector<AlgorithmNode> nodes;
+  size_t executorCount{};
+};
+
+// One bit per optional compiler pass, for file names
+uint32_t OptionBits(CompilerOptions const &options) {
+  return (options.elementwise_fusion ? 1U : 0U) |
+         (options.algebraic_simplification ? 2U : 0U);
+}
+} // namespace
+
+CompilationCache::CompilationCache() {
+  if (const char *directory = std::getenv("EPOCH_SCRIPT_COMPILE_CACHE_DIR")) {
+    m_directory = std::filesystem::path{directory};
+  }
+  if (const char *size = std::getenv("EPOCH_SCRIPT_COMPILE_CACHE_SIZE")) {
+    m_capacity = std::strtoull(size, nullptr, 10);
+  }
+}
+
+std::shared_ptr<const CompiledSource>
+CompilationCache::GetOrCompile(std::string const &source,
+                               bool skip_sink_validation,
+                               CompilerOptions const &options) {
+  Key key;
+  {
+    std::lock_guard lock(m_mutex);
+    key = Key{RegistryHash(), skip_sink_validation, options, source};
+    if (auto it = m_index.find(key); it != m_index.end()) {
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return it->second->second;
+    }
+  }
+
+  auto compiled = m_directory ? Load(key) : nullptr;
+  if (!compiled) {
+    epoch_script::AlgorithmAstCompiler compiler{options};
+    auto fresh = std::make_shared<CompiledSource>();
+    fresh->nodes = compiler.compile(source, skip_sink_validation);
+    fresh->executorCount = compiler.getExecutorCount();
+    if (m_directory) {
+      Persist(key, *fresh);
+    }
+    compiled = std::move(fresh);
+  }
+
+  // A racing compile of the same key is identical; the first one stored wins
+  std::lock_guard lock(m_mutex);
+  if (auto it = m_index.find(key); it != m_index.end()) {
+    return it->second->second;
+  }
+  m_entries.emplace_front(std::move(key), std::move(compiled));
+  m_index.emplace(m_entries.front().first, m_entries.begin());
+  auto result = m_entries.front().second;
+  Evict();
+  return result;
+}
+
+void CompilationCache::Clear() {
+  std::lock_guard lock(m_mutex);
+  m_index.clear();
+  m_entries.clear();
+  m_registryGeneration.reset();
+}
+
+void CompilationCache::SetCapacity(size_t capacity) {
+  std::lock_guard lock(m_mutex);
+  m_capacity = capacity;
+  Evict();
+}
+
+size_t CompilationCache::Size() {
+  std::lock_guard lock(m_mutex);
+  return m_entries.size();
+}
+
+void CompilationCache::Evict() {
+  while (m_entries.size() > m_capacity) {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+}
+
+// Recomputed after every registration; registration happens at startup, so
+// in practice this hashes the registry once.
+uint64_t CompilationCache::RegistryHash() {
+  auto &instance = epoch_script::transforms::ITransformRegistry::GetInstance();
+  const auto generation = instance.Generation();
+  if (m_registryGeneration == generation) {
+    return m_registryHash;
+  }
+  const auto &registry = instance.GetMetaData();
+
+  std::vector<std::string_view> ids;
+  ids.reserve(registry.size());
+  for (auto const &[id, _] : registry) {
+    ids.push_back(id);
+  }
+  std::ranges::sort(ids);
+
+  StableHasher hasher;
+  hasher.Add(kFormatVersion).Add(EPOCH_SCRIPT_COMPILER_FINGERPRINT);
+  for (auto const id : ids) {
+    hasher.Add(id).Add(
+        glz::write_json(registry.at(std::string{id})).value_or(""));
+  }
+  m_registryGeneration = generation;
+  m_registryHash = hasher.Digest();
+  return m_registryHash;
+}
+
+std::filesystem::path CompilationCache::PathOf(Key const &key) const {
+  auto const &[registryHash, skipSinkValidation, options, source] = key;
+  return *m_directory / std::format("{}-{:016x}-{}-{}.json",
+                                    StableHasher{}.Add(source).HexDigest(),
+                                    registryHash, skipSinkValidation ? 1 : 0,
+                                    OptionBits(options));
+}
+
+std::shared_ptr<const CompiledSource>
+CompilationCache::Load(Key const &key) const {
+  const auto path = PathOf(key);
+  std::ifstream file(path);
+  if (!file) {
+    return nullptr;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+
+  CompilationCacheFile entry;
+  if (auto error = glz::read_json(entry, buffer.str())) {
+    SPDLOG_WARN("Ignoring unreadable compilation cache file {}: {}",
+                path.string(), glz::format_error(error, buffer.str()));
+    return nullptr;
+  }
+  // The file name only carries a hash of the source
+  if (entry.source != std::get<3>(key)) {
+    return nullptr;
+  }
+  return std::make_shared<CompiledSource>(
+      CompiledSource{std::move(entry.nodes), entry.executorCount});
+}
+
+// Written to a temporary file first and renamed into place, so a concurrent
+// reader never loads a partial entry.
+void CompilationCache::Persist(Key const &key,
+                               CompiledSource const &compiled) const {
+  try {
+    std::filesystem::create_directories(*m_directory);
+    const auto path = PathOf(key);
+    const auto staging = std::filesystem::path(
+        path.string() +
+        std::format(".tmp-{}-{}", ::getpid(),
+                    std::hash<std::thread::id>{}(std::this_thread::get_id())));
+
+    const CompilationCacheFile entry{std::get<3>(key), compiled.nodes,
+                                     compiled.executorCount};
+    auto json = glz::write_json(entry);
+    if (!json) {
+      SPDLOG_WARN("Failed to serialize compilation cache entry {}",
+                  path.string());
+      return;
+    }
+    {
+      std::ofstream file(staging, std::ios::binary | std::ios::trunc);
+      file << *json;
+    }
+    std::filesystem::rename(staging, path);
+  } catch (std::exception const &e) {
+    SPDLOG_WARN("Failed to persist compilation cache entry: {}", e.what());
+  }
+}
+
+} // namespace epoch_script::strategy
@@ -0,0 +1,87 @@
+#pragma once
+//
+// Compiled EpochScript sources shared across PythonSource instances
+//
+#include <epoch_script/core/compiler_options.h>
+#include <epoch_script/strategy/metadata.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace epoch_script::strategy {
+
+struct CompiledSource {
+  std::vector<AlgorithmNode> nodes;
+  size_t executorCount{};
+};
+
+/**
+ * Compilation results per (source text, transform metadata registry,
+ * skip_sink_validation, compiler options), so deserializing the same strategy again skips
+ * compilation. The most recently used kDefaultCapacity entries (or
+ * EPOCH_SCRIPT_COMPILE_CACHE_SIZE) are kept in memory and, when
+ * EPOCH_SCRIPT_COMPILE_CACHE_DIR is set, every entry is persisted as
+ * <key>.json for later processes.
+ *
+ * The registry takes part in the key through a hash of every registered
+ * transform's metadata, recomputed after each registration, so registering
+ * or changing transforms invalidates earlier entries. Persisted entries are
+ * also keyed on a build-time hash of the compiler sources
+ * (cmake/SourceFingerprint.cmake), so a build whose compiler output may
+ * differ never reads them.
+ */
+class CompilationCache {
+public:
+  static CompilationCache &Instance() {
+    static CompilationCache cache;
+    return cache;
+  }
+
+  // Compiles on a miss; compilation errors propagate and are not cached
+  std::shared_ptr<const CompiledSource>
+  GetOrCompile(std::string const &source, bool skip_sink_validation,
+               CompilerOptions const &options = {});
+
+  void Clear();
+
+  static constexpr size_t kDefaultCapacity = 256;
+
+  // Entries kept in memory; evicts least recently used ones beyond it
+  void SetCapacity(size_t capacity);
+  size_t Size();
+
+private:
+  CompilationCache();
+
+  using Key = std::tuple<uint64_t, bool, CompilerOptions, std::string>;
+  using Entry = std::pair<const Key, std::shared_ptr<const CompiledSource>>;
+
+  uint64_t RegistryHash();
+  std::filesystem::path PathOf(Key const &key) const;
+  std::shared_ptr<const CompiledSource> Load(Key const &key) const;
+  void Persist(Key const &key, CompiledSource const &compiled) const;
+
+  std::optional<std::filesystem::path> m_directory;
+  std::mutex m_mutex;
+  // Most recently used first; m_index points into it
+  std::list<Entry> m_entries;
+  std::map<std::reference_wrapper<const Key>, std::list<Entry>::iterator,
+           std::less<Key>>
+      m_index;
+  size_t m_capacity{kDefaultCapacity};
+  std::optional<uint64_t> m_registryGeneration;
+  uint64_t m_registryHash{0};
+
+  void Evict();
+};
+
+} // namespace epoch_script::strategy
@@ -8,7 +8,7 @@
 #include <epoch_script/transforms/core/metadata.h>
 #include <epoch_script/transforms/core/registration.h>
 #include <epoch_script/strategy/registration.h>
-#include "transforms/compiler/ast_compiler.h"
+#include "compilation_cache.h"
 #include <epoch_core/macros.h>
 #include <glaze/core/reflect.hpp>
 #include <glaze/json/json_concepts.hpp>
@@ -54,16 +54,21 @@ static bool IsIntraday_(const std::vector<AlgorithmNode> &compilationResult) {
 }
 
 // PythonSource constructor implementation
-PythonSource::PythonSource(std::string src, bool skip_sink_validation) : source_(std::move(src)) {
+PythonSource::PythonSource(std::string src, bool skip_sink_validation,
+                           CompilerOptions options)
+    : source_(std::move(src)) {
   if (source_.empty())
   {
     return;
   }
 
-  // Compile Python source to get algorithm nodes
-  epoch_script::AlgorithmAstCompiler compiler;
-  compilationResult_ = compiler.compile(source_, skip_sink_validation);
-  m_executor_count = compiler.getExecutorCount();
+  // Compile Python source to get algorithm nodes, reusing an earlier
+  // compilation of the same source against the same transform registry
+  const auto compiled =
+      CompilationCache::Instance().GetOrCompile(source_, skip_sink_validation,
+                                                options);
+  compilationResult_ = compiled->nodes;
+  m_executor_count = compiled->executorCount;
 
   isIntraday_ = IsIntraday_(compilationResult_);
 }
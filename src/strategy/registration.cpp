@@ -64,9 +64,20 @@ namespace epoch_script::strategy
   void RegisterStrategyMetadata(
       FileLoaderInterface const &loader,
       std::vector<std::string> const &aiGeneratedAlgorithms,
-      std::vector<std::string> const &aiGeneratedStrategies)
+      std::vector<std::string> const &aiGeneratedStrategies,
+      std::filesystem::path const &transformMetadataSnapshot)
   {
-    transforms::RegisterTransformMetadata(loader);
+    // A build-time snapshot of the transform metadata, when the caller has
+    // one, saves parsing the YAML files and running the C++ builders on
+    // start up
+    if (!transformMetadataSnapshot.empty())
+    {
+      transforms::RegisterTransformMetadata(loader, transformMetadataSnapshot);
+    }
+    else
+    {
+      transforms::RegisterTransformMetadata(loader);
+    }
     // TODO ADD FILTERS/SCREENER
 
     futures_continuation::Registry::GetInstance().Register(
@@ -0,0 +1,458 @@
+//
+// EpochScript Algebraic Simplifier - Implementation
+//
+
+#include "algebraic_simplifier.h"
+#include "node_graph.h"
+#include <utility>
+
+namespace epoch_script
+{
+
+    namespace
+    {
+        std::optional<double> NumberOption(const strategy::AlgorithmNode& node, const std::string& key)
+        {
+            auto it = node.options.find(key);
+            if (it == node.options.end())
+            {
+                return std::nullopt;
+            }
+            const auto value = it->second.GetVariant();
+            if (!std::holds_alternative<double>(value))
+            {
+                return std::nullopt;
+            }
+            return std::get<double>(value);
+        }
+
+        // The single reference wired to an input, or nullptr
+        std::string* SingleInput(strategy::AlgorithmNode& node, const std::string& input)
+        {
+            auto it = node.inputs.find(input);
+            return it == node.inputs.end() || it->second.size() != 1 ? nullptr : &it->second.front();
+        }
+
+        const std::string* SingleInput(const strategy::AlgorithmNode& node, const std::string& input)
+        {
+            return SingleInput(const_cast<strategy::AlgorithmNode&>(node), input);
+        }
+
+        bool SameSchedule(const strategy::AlgorithmNode& a, const strategy::AlgorithmNode& b)
+        {
+            return a.timeframe == b.timeframe && a.session == b.session;
+        }
+
+        // Operator for b <op> a given a <op> b
+        std::string Mirrored(const std::string& type)
+        {
+            if (type == "lt") return "gt";
+            if (type == "gt") return "lt";
+            if (type == "lte") return "gte";
+            if (type == "gte") return "lte";
+            return type;  // eq, neq
+        }
+
+        bool IsCommutative(const std::string& type)
+        {
+            return type == "add" || type == "mul" || type == "eq" || type == "neq" ||
+                   type == "logical_and" || type == "logical_or";
+        }
+    } // namespace
+
+    AlgebraicSimplifier::AlgebraicSimplifier(CompilationContext& context, TypeChecker& type_checker)
+        : context_(context), type_checker_(type_checker)
+    {
+    }
+
+    void AlgebraicSimplifier::Simplify(std::vector<strategy::AlgorithmNode>& algorithms)
+    {
+        algorithms_ = &algorithms;
+        replacements_.clear();
+        schema_refs_ = CollectSchemaReferences(algorithms);
+
+        std::vector<bool> had_readers(algorithms.size());
+        {
+            const NodeGraph graph(algorithms);
+            for (size_t i = 0; i < algorithms.size(); ++i)
+            {
+                had_readers[i] = !graph.Dependents(i).empty() || schema_refs_.contains(algorithms[i].id);
+            }
+        }
+
+        // Node ids and positions are stable until RemoveDeadNodes, so
+        // node_lookup stays valid for Producer and the TypeChecker
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (auto& node : algorithms)
+            {
+                if (replacements_.contains(node.id))
+                {
+                    continue;
+                }
+
+                for (auto& [input_name, refs] : node.inputs)
+                {
+                    for (auto& ref : refs)
+                    {
+                        auto resolved = Resolve(ref);
+                        if (resolved != ref)
+                        {
+                            ref = std::move(resolved);
+                            changed = true;
+                        }
+                    }
+                }
+
+                if (CollapseLag(node) || NormalizeComparison(node) || Canonicalize(node))
+                {
+                    changed = true;
+                }
+
+                if (!schema_refs_.contains(node.id))
+                {
+                    if (auto replacement = FindReplacement(node))
+                    {
+                        replacements_.emplace(node.id, std::move(*replacement));
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        RemoveDeadNodes(had_readers);
+        algorithms_ = nullptr;
+    }
+
+    std::string AlgebraicSimplifier::Resolve(std::string ref) const
+    {
+        for (auto it = replacements_.find(std::string{NodeGraph::NodeIdOf(ref)});
+             it != replacements_.end();
+             it = replacements_.find(std::string{NodeGraph::NodeIdOf(ref)}))
+        {
+            ref = it->second;
+        }
+        return ref;
+    }
+
+    const strategy::AlgorithmNode* AlgebraicSimplifier::Producer(const std::string& ref) const
+    {
+        const std::string node_id{NodeGraph::NodeIdOf(ref)};
+        auto it = context_.node_lookup.find(node_id);
+        if (it == context_.node_lookup.end() || it->second >= algorithms_->size() ||
+            (*algorithms_)[it->second].id != node_id)
+        {
+            return nullptr;
+        }
+        return &(*algorithms_)[it->second];
+    }
+
+    DataType AlgebraicSimplifier::TypeOf(const std::string& ref) const
+    {
+        const auto hash_pos = ref.find('#');
+        if (hash_pos == std::string::npos)
+        {
+            return DataType::Any;
+        }
+        return type_checker_.GetNodeOutputType(ref.substr(0, hash_pos), ref.substr(hash_pos + 1));
+    }
+
+    std::optional<double> AlgebraicSimplifier::LiteralValue(const std::string& ref) const
+    {
+        const auto* producer = Producer(ref);
+        if (!producer)
+        {
+            return std::nullopt;
+        }
+        if (producer->type == "bool_true")
+        {
+            return 1.0;
+        }
+        if (producer->type == "bool_false")
+        {
+            return 0.0;
+        }
+        if (producer->type == "number")
+        {
+            return NumberOption(*producer, "value");
+        }
+        return std::nullopt;
+    }
+
+    bool AlgebraicSimplifier::CollapseLag(strategy::AlgorithmNode& node) const
+    {
+        if (!node.type.starts_with("lag_"))
+        {
+            return false;
+        }
+        auto* input = SingleInput(node, "SLOT");
+        const auto* inner = input ? Producer(*input) : nullptr;
+        if (!inner || inner->type != node.type || !SameSchedule(*inner, node))
+        {
+            return false;
+        }
+        const auto outer_period = NumberOption(node, "period");
+        const auto inner_period = NumberOption(*inner, "period");
+        const auto* inner_input = SingleInput(*inner, "SLOT");
+        if (!outer_period || !inner_period || !inner_input ||
+            (*outer_period > 0) != (*inner_period > 0))
+        {
+            return false;
+        }
+
+        *input = Resolve(*inner_input);
+        node.options["period"] = MetaDataOptionDefinition{*outer_period + *inner_period};
+        return true;
+    }
+
+    std::optional<std::string> AlgebraicSimplifier::FindReplacement(const strategy::AlgorithmNode& node) const
+    {
+        const auto& type = node.type;
+
+        // Readers of the node may only be rewired to a reference produced on
+        // the node's own timeframe and session; otherwise the node is a
+        // resampling step and must stay
+        auto same_schedule = [&](const std::string& ref)
+        {
+            const auto* producer = Producer(ref);
+            return producer && SameSchedule(*producer, node);
+        };
+
+        // x <op> identity, or identity <op> x for commutative operators
+        auto identity_operand = [&](double identity, DataType operand_type, bool commutative) -> std::optional<std::string>
+        {
+            const auto* lhs = SingleInput(node, "SLOT0");
+            const auto* rhs = SingleInput(node, "SLOT1");
+            if (!lhs || !rhs)
+            {
+                return std::nullopt;
+            }
+            if (LiteralValue(*rhs) == identity && TypeOf(*lhs) == operand_type && same_schedule(*lhs))
+            {
+                return *lhs;
+            }
+            if (commutative && LiteralValue(*lhs) == identity && TypeOf(*rhs) == operand_type &&
+                same_schedule(*rhs))
+            {
+                return *rhs;
+            }
+            return std::nullopt;
+        };
+
+        if (type == "mul")
+        {
+            return identity_operand(1.0, DataType::Decimal, true);
+        }
+        if (type == "div")
+        {
+            return identity_operand(1.0, DataType::Decimal, false);
+        }
+        if (type == "sub")
+        {
+            return identity_operand(0.0, DataType::Decimal, false);
+        }
+        if (type == "logical_and")
+        {
+            return identity_operand(1.0, DataType::Boolean, true);
+        }
+        if (type == "logical_or")
+        {
+            return identity_operand(0.0, DataType::Boolean, true);
+        }
+
+        const auto* input = SingleInput(node, "SLOT");
+        if (!input)
+        {
+            return std::nullopt;
+        }
+        const DataType input_type = TypeOf(*input);
+
+        if (type == "logical_not")
+        {
+            const auto* inner = Producer(*input);
+            const auto* inner_input = inner && inner->type == "logical_not" ? SingleInput(*inner, "SLOT") : nullptr;
+            if (inner_input && TypeOf(*inner_input) == DataType::Boolean && SameSchedule(*inner, node) &&
+                same_schedule(*inner_input))
+            {
+                return *inner_input;
+            }
+            return std::nullopt;
+        }
+
+        // Casts that pass their input through unchanged. Integer and Number
+        // inputs of static_cast_to_decimal are kept: the cast turns their
+        // int64 columns into the float64 that Decimal readers expect
+        if ((type == "static_cast_to_decimal" && input_type == DataType::Decimal) ||
+            (type == "static_cast_to_integer" && input_type == DataType::Integer) ||
+            (type == "static_cast_to_boolean" && input_type == DataType::Boolean) ||
+            ((type == "static_cast_to_string" || type == "stringify") && input_type == DataType::String) ||
+            (type == "static_cast_to_timestamp" && input_type == DataType::Timestamp))
+        {
+            if (!same_schedule(*input))
+            {
+                return std::nullopt;
+            }
+            return *input;
+        }
+
+        // Boolean -> Decimal -> Boolean maps true/false to 1/0 and back
+        if (type == "static_cast_to_boolean")
+        {
+            const auto* inner = Producer(*input);
+            const auto* inner_input =
+                inner && inner->type == "static_cast_to_decimal" ? SingleInput(*inner, "SLOT") : nullptr;
+            if (inner_input && TypeOf(*inner_input) == DataType::Boolean && SameSchedule(*inner, node) &&
+                same_schedule(*inner_input))
+            {
+                return *inner_input;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool AlgebraicSimplifier::NormalizeComparison(strategy::AlgorithmNode& node) const
+    {
+        // not (a == b) -> a != b, not (a != b) -> a == b
+        if (node.type == "logical_not")
+        {
+            const auto* input = SingleInput(node, "SLOT");
+            const auto* inner = input ? Producer(*input) : nullptr;
+            if (!inner || (inner->type != "eq" && inner->type != "neq") || !SameSchedule(*inner, node))
+            {
+                return false;
+            }
+            node.type = inner->type == "eq" ? "neq" : "eq";
+            node.inputs = inner->inputs;
+            return true;
+        }
+
+        // (x - y) > 0 -> x > y, 0 < (x - y) -> x > y, likewise for <. Only the
+        // strict comparisons: with x == y == +-inf, x - y is NaN, so
+        // (x - y) >= 0 is false while x >= y is true
+        if (node.type != "lt" && node.type != "gt")
+        {
+            return false;
+        }
+        const auto* lhs = SingleInput(node, "SLOT0");
+        const auto* rhs = SingleInput(node, "SLOT1");
+        if (!lhs || !rhs)
+        {
+            return false;
+        }
+
+        const strategy::AlgorithmNode* difference = nullptr;
+        std::string type = node.type;
+        if (LiteralValue(*rhs) == 0.0)
+        {
+            difference = Producer(*lhs);
+        }
+        else if (LiteralValue(*lhs) == 0.0)
+        {
+            difference = Producer(*rhs);
+            type = Mirrored(type);
+        }
+        if (!difference || difference->type != "sub" || !SameSchedule(*difference, node))
+        {
+            return false;
+        }
+        const auto* x = SingleInput(*difference, "SLOT0");
+        const auto* y = SingleInput(*difference, "SLOT1");
+        if (!x || !y)
+        {
+            return false;
+        }
+
+        node.type = std::move(type);
+        node.inputs = {{"SLOT0", {Resolve(*x)}}, {"SLOT1", {Resolve(*y)}}};
+        return true;
+    }
+
+    bool AlgebraicSimplifier::Canonicalize(strategy::AlgorithmNode& node) const
+    {
+        const bool flip = node.type == "lt" || node.type == "lte";
+        if (!flip && !IsCommutative(node.type))
+        {
+            return false;
+        }
+        auto* lhs = SingleInput(node, "SLOT0");
+        auto* rhs = SingleInput(node, "SLOT1");
+        if (!lhs || !rhs)
+        {
+            return false;
+        }
+
+        // a < b -> b > a, a <= b -> b >= a
+        if (flip)
+        {
+            node.type = Mirrored(node.type);
+            std::swap(*lhs, *rhs);
+            return true;
+        }
+        if (*rhs < *lhs)
+        {
+            std::swap(*lhs, *rhs);
+            return true;
+        }
+        return false;
+    }
+
+    void AlgebraicSimplifier::RemoveDeadNodes(const std::vector<bool>& had_readers)
+    {
+        auto& algorithms = *algorithms_;
+        const NodeGraph graph(algorithms);
+
+        std::vector<size_t> readers(algorithms.size());
+        std::vector<size_t> dead;
+        for (size_t i = 0; i < algorithms.size(); ++i)
+        {
+            readers[i] = graph.Dependents(i).size() + (schema_refs_.contains(algorithms[i].id) ? 1 : 0);
+            if (had_readers[i] && readers[i] == 0)
+            {
+                dead.push_back(i);
+            }
+        }
+        if (dead.empty())
+        {
+            return;
+        }
+
+        // A removed node releases its inputs; the dead vector doubles as the
+        // worklist
+        std::vector<bool> removed(algorithms.size(), false);
+        for (size_t k = 0; k < dead.size(); ++k)
+        {
+            removed[dead[k]] = true;
+            for (size_t input : graph.Inputs(dead[k]))
+            {
+                if (--readers[input] == 0 && had_readers[input] && !removed[input])
+                {
+                    dead.push_back(input);
+                }
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < algorithms.size(); ++i)
+        {
+            if (removed[i])
+            {
+                context_.used_node_ids.erase(algorithms[i].id);
+                continue;
+            }
+            if (kept != i)
+            {
+                algorithms[kept] = std::move(algorithms[i]);
+            }
+            ++kept;
+        }
+        algorithms.resize(kept);
+
+        context_.node_lookup.clear();
+        for (size_t i = 0; i < algorithms.size(); ++i)
+        {
+            context_.node_lookup[algorithms[i].id] = i;
+        }
+    }
+
+} // namespace epoch_script
@@ -0,0 +1,81 @@
+//
+// EpochScript Algebraic Simplifier
+//
+// Rule-based rewrites of the compiled graph that run before CSE, so
+// equivalent expressions reach CSE in one canonical form.
+//
+
+#pragma once
+
+#include "compilation_context.h"
+#include "type_checker.h"
+#include <epoch_script/strategy/metadata.h>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace epoch_script
+{
+
+    /**
+     * @brief Algebraic simplification and canonicalization pass.
+     *
+     * Rules, applied until none fires:
+     * - **Lag chains**: lag_T(a)(lag_T(b)(x)) -> lag_T(a + b)(x) when both
+     *   periods have the same sign and both lags share timeframe and session.
+     *   Lags drop null inputs first, so this holds with gaps too.
+     * - **Identities**: x * 1, 1 * x, x / 1, x - 0 for Decimal x;
+     *   x and True, x or False, not not x for Boolean x. x + 0 is kept
+     *   because it turns -0 into +0.
+     * - **Comparisons**: not (a == b) -> a != b (and the converse);
+     *   (x - y) <op> 0 and 0 <op> (x - y) -> x <op> y for strict < and >,
+     *   which is exact for IEEE doubles (==, !=, <= and >= differ when
+     *   x == y == +-inf); a < b -> b > a, a <= b -> b >= a; operands of add,
+     *   mul, eq, neq, logical_and and logical_or are sorted. not (a > b) is
+     *   kept, since it is true for NaN operands while a <= b is not.
+     * - **Casts**: static_cast_to_T / stringify of a value already of type
+     *   T (Decimal only for static_cast_to_decimal, since Integer and Number
+     *   columns change physical type), and Boolean -> Decimal -> Boolean
+     *   round trips.
+     *
+     * An eliminated node's readers are redirected to its replacement. Nodes
+     * that lose all their readers through a rewrite are removed (nodes that
+     * never had readers are left for orphan removal), and node_lookup is
+     * rebuilt. Nodes referenced from schema options are never eliminated.
+     * Output types come from the TypeChecker, so the pass must run while
+     * node_lookup is current, i.e. before CSE.
+     */
+    class AlgebraicSimplifier
+    {
+    public:
+        AlgebraicSimplifier(CompilationContext& context, TypeChecker& type_checker);
+
+        void Simplify(std::vector<strategy::AlgorithmNode>& algorithms);
+
+    private:
+        CompilationContext& context_;
+        TypeChecker& type_checker_;
+
+        // Per-run state
+        std::vector<strategy::AlgorithmNode>* algorithms_{nullptr};
+        std::unordered_map<std::string, std::string> replacements_;
+        std::unordered_set<std::string> schema_refs_;
+
+        // Follows replacements of an "id#handle" reference
+        std::string Resolve(std::string ref) const;
+        const strategy::AlgorithmNode* Producer(const std::string& ref) const;
+        DataType TypeOf(const std::string& ref) const;
+        std::optional<double> LiteralValue(const std::string& ref) const;
+
+        // Rules; each returns true if it changed the node
+        bool CollapseLag(strategy::AlgorithmNode& node) const;
+        std::optional<std::string> FindReplacement(const strategy::AlgorithmNode& node) const;
+        bool NormalizeComparison(strategy::AlgorithmNode& node) const;
+        bool Canonicalize(strategy::AlgorithmNode& node) const;
+
+        void RemoveDeadNodes(const std::vector<bool>& had_readers);
+    };
+
+} // namespace epoch_script
@@ -4,29 +4,23 @@
 //
 
 #include "ast_compiler.h"
+#include "node_graph.h"
 #include "parser/python_parser.h"
 #include "validators/boolean_select_validator.h"
 #include <epoch_script/transforms/core/transform_registry.h>
 #include <stdexcept>
-#include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <cstdlib>
 #include <format>
+#include <ranges>
+#include <string_view>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 namespace epoch_script
 {
-    // Helper function to extract node_id from "node_id#handle" reference
-    static std::string extractNodeId(const std::string& ref)
-    {
-        auto hash_pos = ref.find('#');
-        if (hash_pos != std::string::npos)
-        {
-            return ref.substr(0, hash_pos);
-        }
-        return ref;
-    }
-
     // Helper function to check if a node type is a scalar/constant
     // Scalars are timeframe-agnostic and should not require timeframe resolution
     // This checks the metadata's category field to determine if it's a Scalar type
@@ -48,104 +42,100 @@ namespace epoch_script
     {
         using AlgorithmNode = epoch_script::strategy::AlgorithmNode;
 
-        // Build node index: node_id -> position in input vector
-        std::unordered_map<std::string, size_t> node_index;
-        for (size_t i = 0; i < nodes.size(); ++i)
+        // Dependencies on internal nodes only (not external like "src")
+        const NodeGraph graph(nodes);
+        std::vector<size_t> in_degree(graph.size());
+        for (size_t i = 0; i < graph.size(); ++i)
         {
-            node_index[nodes[i].id] = i;
+            in_degree[i] = graph.Inputs(i).size();
         }
 
-        // Build dependency graph
-        std::unordered_map<std::string, int> in_degree;  // node_id -> count of dependencies
-        std::unordered_map<std::string, std::vector<std::string>> dependents;  // node_id -> nodes that depend on it
-
-        // Initialize in-degree to 0 for all nodes
-        for (const auto& node : nodes)
+        // Kahn's algorithm: start with nodes that have no dependencies, in
+        // source order; the order vector doubles as the BFS queue
+        std::vector<size_t> order;
+        order.reserve(nodes.size());
+        for (size_t i = 0; i < graph.size(); ++i)
         {
-            in_degree[node.id] = 0;
+            if (in_degree[i] == 0)
+            {
+                order.push_back(i);
+            }
         }
 
-        // Calculate in-degrees and build adjacency list
-        for (const auto& node : nodes)
+        for (size_t head = 0; head < order.size(); ++head)
         {
-            const std::string& node_id = node.id;
-
-            // Process all inputs to find dependencies
-            for (const auto& [input_name, refs] : node.inputs)
+            // Decrease in-degree for all dependents
+            for (size_t dependent : graph.Dependents(order[head]))
             {
-                for (const auto& ref : refs)
+                if (--in_degree[dependent] == 0)
                 {
-                    std::string dep_id = extractNodeId(ref);
-
-                    // Only count dependency if it's an internal node (not external like "src")
-                    if (node_index.find(dep_id) != node_index.end())
-                    {
-                        in_degree[node_id]++;
-                        dependents[dep_id].push_back(node_id);
-                    }
+                    order.push_back(dependent);
                 }
             }
         }
 
-        // Kahn's algorithm: start with nodes that have no dependencies
-        std::queue<std::string> queue;
-        for (const auto& [node_id, degree] : in_degree)
+        // Check for cycles
+        if (order.size() != nodes.size())
         {
-            if (degree == 0)
+            // Collect nodes that are part of the cycle
+            std::string error_msg = "Circular dependency detected in algorithm graph! Remaining nodes: ";
+            bool first = true;
+            for (size_t i = 0; i < nodes.size(); ++i)
             {
-                queue.push(node_id);
+                if (in_degree[i] > 0)
+                {
+                    if (!first) error_msg += ", ";
+                    error_msg += nodes[i].id;
+                    first = false;
+                }
             }
+            throw std::runtime_error(error_msg);
         }
 
-        // Process nodes in topological order
         std::vector<AlgorithmNode> sorted_nodes;
         sorted_nodes.reserve(nodes.size());
-
-        while (!queue.empty())
+        for (size_t i : order)
         {
-            std::string node_id = queue.front();
-            queue.pop();
-
-            // Add this node to sorted output
-            sorted_nodes.push_back(std::move(nodes[node_index[node_id]]));
-
-            // Decrease in-degree for all dependents
-            for (const std::string& dependent_id : dependents[node_id])
-            {
-                in_degree[dependent_id]--;
-                if (in_degree[dependent_id] == 0)
-                {
-                    queue.push(dependent_id);
-                }
-            }
+            sorted_nodes.push_back(std::move(nodes[i]));
         }
+        return sorted_nodes;
+    }
 
-        // Check for cycles
-        if (sorted_nodes.size() != nodes.size())
+    CompilerOptions CompilerOptions::FromEnvironment()
+    {
+        CompilerOptions options;
+        const char* passes = std::getenv("EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS");
+        if (!passes)
         {
-            // Collect nodes that are part of the cycle
-            std::vector<std::string> remaining_nodes;
-            for (const auto& [node_id, degree] : in_degree)
+            return options;
+        }
+        for (const auto name : std::views::split(std::string_view{passes}, ','))
+        {
+            const std::string_view pass{name.begin(), name.end()};
+            if (pass == "all")
             {
-                if (degree > 0)
-                {
-                    remaining_nodes.push_back(node_id);
-                }
+                options.elementwise_fusion = true;
+                options.algebraic_simplification = true;
             }
-
-            std::string error_msg = "Circular dependency detected in algorithm graph! Remaining nodes: ";
-            for (size_t i = 0; i < remaining_nodes.size(); ++i)
+            else if (pass == "elementwise_fusion")
             {
-                if (i > 0) error_msg += ", ";
-                error_msg += remaining_nodes[i];
+                options.elementwise_fusion = true;
+            }
+            else if (pass == "algebraic_simplification")
+            {
+                options.algebraic_simplification = true;
+            }
+            else if (!pass.empty())
+            {
+                SPDLOG_WARN("Ignoring unknown compiler optimization '{}' in "
+                            "EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS", pass);
             }
-            throw std::runtime_error(error_msg);
         }
-
-        return sorted_nodes;
+        return options;
     }
 
-    AlgorithmAstCompiler::AlgorithmAstCompiler()
+    AlgorithmAstCompiler::AlgorithmAstCompiler(CompilerOptions options)
+        : options_(options)
     {
         initializeComponents();
     }
@@ -190,6 +180,9 @@ namespace epoch_script
         // Initialize constant folder for preprocessing
         constant_folder_ = std::make_unique<ConstantFolder>(context_);
 
+        // Initialize algebraic simplifier for canonicalizing expressions ahead of CSE
+        algebraic_simplifier_ = std::make_unique<AlgebraicSimplifier>(context_, *type_checker_);
+
         // Initialize CSE optimizer for deduplicating identical transforms
         cse_optimizer_ = std::make_unique<CSEOptimizer>();
     }
@@ -206,27 +199,66 @@ namespace epoch_script
 
     CompilationResult AlgorithmAstCompiler::compileAST(ModulePtr module, bool skip_sink_validation)
     {
-        // Clear state for fresh compilation
-        context_.algorithms.clear();
-        context_.executor_count = 0;
-        context_.node_lookup.clear();
-        context_.var_to_binding.clear();
-        context_.node_output_types.clear();
-        context_.used_node_ids.clear();
-
-        // Reserve capacity to prevent reallocations (typical algorithm has 50-500 nodes)
-        context_.algorithms.reserve(500);
+        return compileASTFrom(std::move(module), 0, nullptr, {}, skip_sink_validation);
+    }
 
+    CompilationResult AlgorithmAstCompiler::compileASTFrom(ModulePtr module,
+                                                           size_t first_statement,
+                                                           const CompilationContext* resume_from,
+                                                           const StatementCheckpoint& checkpoint,
+                                                           bool skip_sink_validation)
+    {
         // Preprocess module to fold constants (like C++ template metaprogramming)
         // This enables constant variables in subscripts: src.v[lookback_period]
+        // A changed constant can refold any statement, including resumed ones
+        const auto previous_constants = constant_folder_->Constants();
         module = constant_folder_->PreprocessModule(std::move(module));
+        if (!resume_from || first_statement > module->body.size() ||
+            constant_folder_->Constants() != previous_constants)
+        {
+            first_statement = 0;
+            resume_from = nullptr;
+        }
+
+        if (resume_from)
+        {
+            // Resume with the state left by the unchanged statements
+            context_ = *resume_from;
+        }
+        else
+        {
+            // Clear state for fresh compilation
+            context_.algorithms.clear();
+            context_.executor_count = 0;
+            context_.node_lookup.clear();
+            context_.var_to_binding.clear();
+            context_.node_output_types.clear();
+            context_.used_node_ids.clear();
+
+            // Reserve capacity to prevent reallocations (typical algorithm has 50-500 nodes)
+            context_.algorithms.reserve(500);
+        }
 
         // Visit the module - builds algorithms in AST order (source code order)
-        ast_visitor_->VisitModule(*module);
+        for (size_t i = first_statement; i < module->body.size(); ++i)
+        {
+            if (checkpoint)
+            {
+                checkpoint(i, *module->body[i], context_);
+            }
+            ast_visitor_->VisitStmt(*module->body[i]);
+        }
 
         // Verify session dependencies and auto-create missing sessions nodes
         verifySessionDependencies();
 
+        // Algebraic simplification: rewrites equivalent expressions into one
+        // canonical form so CSE can merge them. Needs node_lookup, so before CSE
+        if (options_.algebraic_simplification)
+        {
+            algebraic_simplifier_->Simplify(context_.algorithms);
+        }
+
         // Common Subexpression Elimination (CSE) optimization pass
         // Deduplicates semantically identical transform nodes to reduce computation
         // Runs before topological sort so we can modify the graph structure
@@ -282,6 +314,13 @@ namespace epoch_script
         // This runs AFTER topological sort so input timeframes are available
         resolveTimeframes(base_timeframe.value(), skip_sink_validation);
 
+        // Fuse elementwise operator trees into single nodes
+        // Runs AFTER timeframe resolution so only same-timeframe operators are fused
+        if (options_.elementwise_fusion)
+        {
+            ElementwiseFusion{}.Optimize(context_.algorithms, context_);
+        }
+
         // Update node_lookup indices after reordering
         context_.node_lookup.clear();
         for (size_t i = 0; i < context_.algorithms.size(); ++i)
@@ -319,8 +358,11 @@ namespace epoch_script
         // Literals inherit timeframes from their dependent nodes
         // EXCEPT scalar types which don't need timeframes (runtime handles them)
         const auto& metadata_map = context_.GetRegistry().GetMetaData();
-        for (auto& algo : context_.algorithms)
+        const NodeGraph graph(context_.algorithms);
+        for (size_t i = 0; i < context_.algorithms.size(); ++i)
         {
+            auto& algo = context_.algorithms[i];
+
             // Skip if already resolved
             if (algo.timeframe)
             {
@@ -334,7 +376,12 @@ namespace epoch_script
             }
 
             // Resolve literal timeframe based on usage (for non-scalar literals)
-            auto literal_timeframe = resolver.ResolveLiteralTimeframe(algo.id, context_.algorithms);
+            std::vector<const epoch_script::strategy::AlgorithmNode*> dependents;
+            for (size_t dependent : graph.Dependents(i))
+            {
+                dependents.push_back(&context_.algorithms[dependent]);
+            }
+            auto literal_timeframe = resolver.ResolveLiteralTimeframe(algo.id, dependents);
             if (literal_timeframe)
             {
                 algo.timeframe = literal_timeframe;
@@ -410,21 +457,24 @@ namespace epoch_script
         // These nodes are dead code and should be removed before timeframe resolution
         // to avoid trying to resolve timeframes for nodes that will never execute
 
-        // First, check if at least one sink node exists
-        bool has_sink = false;
-        for (const auto& node : context_.algorithms)
+        // Sink nodes are the starting points for a BFS backwards through
+        // dependencies; the reached vector doubles as the BFS queue
+        const NodeGraph graph(context_.algorithms);
+        std::vector<bool> reachable(graph.size(), false);
+        std::vector<size_t> reached;
+        for (size_t i = 0; i < context_.algorithms.size(); ++i)
         {
-            if (isSinkNode(node.type))
+            if (isSinkNode(context_.algorithms[i].type))
             {
-                has_sink = true;
-                break;
+                reachable[i] = true;
+                reached.push_back(i);
             }
         }
 
         // If no sinks exist:
         // - In strict mode (skip_sink_validation=false): Error - scripts must have output
         // - In permissive mode (skip_sink_validation=true): Skip orphan removal and continue
-        if (!has_sink)
+        if (reached.empty())
         {
             if (!skip_sink_validation)
             {
@@ -437,77 +487,37 @@ namespace epoch_script
             return;  // Skip orphan removal for test scenarios without sinks
         }
 
-        // Build reverse dependency graph using BFS from sink nodes
-        std::unordered_set<std::string> reachable_nodes;
-        std::queue<std::string> queue;
-
-        // Phase 1: Find all sink nodes (starting points for BFS)
-        for (const auto& node : context_.algorithms)
+        // Mark all input dependencies of reachable nodes as reachable
+        for (size_t head = 0; head < reached.size(); ++head)
         {
-            if (isSinkNode(node.type))
+            for (size_t dep : graph.Inputs(reached[head]))
             {
-                queue.push(node.id);
-                reachable_nodes.insert(node.id);
-            }
-        }
-
-        // Phase 2: BFS backwards through dependencies to mark all reachable nodes
-        while (!queue.empty())
-        {
-            std::string node_id = queue.front();
-            queue.pop();
-
-            // Find the node in algorithms vector
-            auto it = std::find_if(context_.algorithms.begin(), context_.algorithms.end(),
-                [&node_id](const auto& n) { return n.id == node_id; });
-
-            if (it != context_.algorithms.end())
-            {
-                // Mark all input dependencies as reachable
-                for (const auto& [input_name, refs] : it->inputs)
+                if (!reachable[dep])
                 {
-                    for (const auto& ref : refs)
-                    {
-                        // Extract node_id from "node_id#handle" format
-                        std::string dep_id = extractNodeId(ref);
-
-                        // Only process if not already marked reachable
-                        if (reachable_nodes.find(dep_id) == reachable_nodes.end())
-                        {
-                            reachable_nodes.insert(dep_id);
-                            queue.push(dep_id);
-                        }
-                    }
+                    reachable[dep] = true;
+                    reached.push_back(dep);
                 }
             }
         }
 
-        // Phase 3: Remove unreachable (orphan) nodes
-        size_t original_count = context_.algorithms.size();
-        context_.algorithms.erase(
-            std::remove_if(context_.algorithms.begin(), context_.algorithms.end(),
-                [&reachable_nodes](const auto& node) {
-                    return reachable_nodes.find(node.id) == reachable_nodes.end();
-                }),
-            context_.algorithms.end()
-        );
-
-        // Phase 4: Update context.used_node_ids to remove deleted IDs
-        for (const auto& node : context_.algorithms)
+        // Remove unreachable (orphan) nodes and release their IDs.
+        // Orphan removal is expected behavior, not an error: users may write
+        // unused variables like: x = 5.0 (never used)
+        size_t kept = 0;
+        for (size_t i = 0; i < context_.algorithms.size(); ++i)
         {
-            if (reachable_nodes.find(node.id) == reachable_nodes.end())
+            if (!reachable[i])
             {
-                context_.used_node_ids.erase(node.id);
+                context_.used_node_ids.erase(context_.algorithms[i].id);
+                continue;
             }
+            if (kept != i)
+            {
+                context_.algorithms[kept] = std::move(context_.algorithms[i]);
+            }
+            ++kept;
         }
-
-        // Log if orphans were removed (useful for debugging)
-        size_t removed_count = original_count - context_.algorithms.size();
-        if (removed_count > 0)
-        {
-            // Orphan removal is expected behavior, not an error
-            // Users may write unused variables like: x = 5.0 (never used)
-        }
+        context_.algorithms.resize(kept);
     }
 
     // Convenience function
@@ -517,4 +527,34 @@ namespace epoch_script
         return compiler.compile(source);
     }
 
+    std::vector<BatchCompilationResult> compileBatch(std::span<const std::string> sources,
+                                                     bool skip_sink_validation,
+                                                     CompilerOptions options)
+    {
+        struct Worker
+        {
+            explicit Worker(CompilerOptions options) : compiler(options) {}
+
+            PythonParser parser;
+            AlgorithmAstCompiler compiler;
+        };
+        tbb::enumerable_thread_specific<Worker> workers(options);
+
+        std::vector<BatchCompilationResult> results(sources.size());
+        tbb::parallel_for(size_t{0}, sources.size(), [&](size_t i)
+        {
+            auto& worker = workers.local();
+            try
+            {
+                results[i].algorithms =
+                    worker.compiler.compileAST(worker.parser.parse(sources[i]), skip_sink_validation);
+            }
+            catch (const std::exception& e)
+            {
+                results[i].error = e.what();
+            }
+        });
+        return results;
+    }
+
 } // namespace epoch_script
@@ -19,12 +19,18 @@
 #include "timeframe_resolver.h"
 #include "constant_folder.h"
 #include "cse_optimizer.h"
+#include "algebraic_simplifier.h"
+#include "elementwise_fusion.h"
 #include "parser/ast_nodes.h"
+#include <epoch_script/core/compiler_options.h>
 #include <epoch_script/strategy/metadata.h>
 #include <epoch_script/core/time_frame.h>
 #include <vector>
 #include <optional>
 #include <memory>
+#include <functional>
+#include <span>
+#include <string>
 
 namespace epoch_script
 {
@@ -35,8 +41,9 @@ namespace epoch_script
     class AlgorithmAstCompiler
     {
     public:
-        // Constructor - initializes all sub-components
-        AlgorithmAstCompiler();
+        // Constructor - initializes all sub-components. Optional passes are
+        // off unless enabled in `options`.
+        explicit AlgorithmAstCompiler(CompilerOptions options = {});
 
         // Main compilation entry point - returns topologically sorted algorithms
         CompilationResult compile(const std::string& source, bool skip_sink_validation = false);
@@ -44,8 +51,34 @@ namespace epoch_script
         // Direct AST compilation (for testing)
         CompilationResult compileAST(ModulePtr module, bool skip_sink_validation = false);
 
+        // Called with the context as it is before each top-level statement is visited
+        using StatementCheckpoint =
+            std::function<void(size_t index, const Stmt& stmt, const CompilationContext& context)>;
+
+        // Resumable AST compilation (for CompileSession). Visits the module's
+        // statements from `first_statement` on, starting from `resume_from`, a
+        // context captured by `checkpoint` before that statement in an earlier
+        // compile of the same prefix. Restarts from the first statement when
+        // the module's folded constants differ from the previous compile's.
+        CompilationResult compileASTFrom(ModulePtr module,
+                                         size_t first_statement,
+                                         const CompilationContext* resume_from,
+                                         const StatementCheckpoint& checkpoint,
+                                         bool skip_sink_validation = false);
+
         size_t getExecutorCount() const { return context_.executor_count; }
 
+        const CompilerOptions& options() const { return options_; }
+
+        // Options of the following compiles
+        void setOptions(const CompilerOptions& options) { options_ = options; }
+
+        // Fuse elementwise operator trees into fused expression nodes (off by default)
+        void setElementwiseFusion(bool enabled) { options_.elementwise_fusion = enabled; }
+
+        // Run algebraic simplification and canonicalization before CSE (off by default)
+        void setAlgebraicSimplification(bool enabled) { options_.algebraic_simplification = enabled; }
+
     private:
         // Compilation context (shared state)
         CompilationContext context_;
@@ -60,7 +93,9 @@ namespace epoch_script
         std::unique_ptr<AstVisitor> ast_visitor_;
         std::unique_ptr<TimeframeResolver> timeframe_resolver_;
         std::unique_ptr<ConstantFolder> constant_folder_;
+        std::unique_ptr<AlgebraicSimplifier> algebraic_simplifier_;
         std::unique_ptr<CSEOptimizer> cse_optimizer_;
+        CompilerOptions options_;
 
         // Initialization helper
         void initializeComponents();
@@ -75,4 +110,20 @@ namespace epoch_script
     // Convenience function (mirrors Python's compile_algorithm)
     CompilationResult compileAlgorithm(const std::string& source);
 
+    // One script's outcome in compileBatch: its nodes, or the error that stopped it
+    struct BatchCompilationResult
+    {
+        CompilationResult algorithms;
+        std::optional<std::string> error;
+    };
+
+    // Compiles scripts in parallel and returns their results in input order.
+    // Each worker thread reuses its own parser and compiler; SQL validation
+    // uses one DuckDB connection per thread. Compilation only reads the
+    // transform and validator registries (plain maps, no locks), so all
+    // registration must finish before the batch starts.
+    std::vector<BatchCompilationResult> compileBatch(std::span<const std::string> sources,
+                                                     bool skip_sink_validation = false,
+                                                     CompilerOptions options = CompilerOptions::FromEnvironment());
+
 } // namespace epoch_script
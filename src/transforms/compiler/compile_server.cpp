@@ -0,0 +1,195 @@
+//
+// EpochScript Compile Server Implementation
+//
+
+#include "compile_server.h"
+#include <cerrno>
+#include <memory>
+#include <mutex>
+#include <glaze/glaze.hpp>
+#include <unistd.h>
+
+namespace epoch_script
+{
+    namespace
+    {
+        // Wire format, one JSON object per line
+        struct CompileRequest
+        {
+            glz::generic id{};
+            std::string code;
+            std::optional<CostEstimateOptions> estimate{};
+            std::optional<CompilerOptions> options{};
+        };
+
+        struct CompileResponse
+        {
+            glz::generic id{};
+            std::string status;
+            std::string message;
+            std::optional<CostEstimate> cost{};
+        };
+
+        // One request stream; responses from concurrent tasks are written whole
+        class Connection
+        {
+        public:
+            Connection(int in_fd, int out_fd, bool owned) : in_fd_(in_fd), out_fd_(out_fd), owned_(owned) {}
+
+            ~Connection()
+            {
+                if (owned_)
+                {
+                    ::close(in_fd_);
+                }
+            }
+
+            Connection(const Connection&) = delete;
+            Connection& operator=(const Connection&) = delete;
+
+            int InFd() const { return in_fd_; }
+
+            void WriteLine(std::string line)
+            {
+                line.push_back('\n');
+                std::lock_guard lock(mutex_);
+                for (size_t sent = 0; sent < line.size();)
+                {
+                    const auto n = ::write(out_fd_, line.data() + sent, line.size() - sent);
+                    if (n < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (n <= 0)
+                    {
+                        return; // client went away
+                    }
+                    sent += static_cast<size_t>(n);
+                }
+            }
+
+        private:
+            int in_fd_;
+            int out_fd_;
+            bool owned_;
+            std::mutex mutex_;
+        };
+    } // namespace
+
+    CompileCheckResult CheckCode(const std::string& code,
+                                 PythonParser& parser,
+                                 AlgorithmAstCompiler& compiler,
+                                 const std::optional<CostEstimateOptions>& estimate)
+    {
+        if (code.empty())
+        {
+            return {"error", "Empty code provided"};
+        }
+
+        try
+        {
+            auto algorithms = compiler.compileAST(parser.parse(code), /*skip_sink_validation=*/true);
+            if (estimate)
+            {
+                return {"ok", "Compilation successful", EstimateCost(algorithms, *estimate)};
+            }
+            return {"ok", "Compilation successful"};
+        }
+        catch (const std::exception& e)
+        {
+            return {"error", e.what()};
+        }
+        catch (...)
+        {
+            return {"error", "Unknown error during compilation"};
+        }
+    }
+
+    // No arena slot is reserved for a master thread and the worker limit is
+    // raised to match: in socket mode no thread ever joins the arena, and
+    // TBB allows no workers at all on a single core by default.
+    CompileServer::CompileServer(int threads, CompilerOptions defaults)
+        : defaults_(defaults),
+          parallelism_(tbb::global_control::max_allowed_parallelism, static_cast<size_t>(threads) + 1),
+          arena_(threads, 0)
+    {
+    }
+
+    CompileServer::~CompileServer()
+    {
+        Wait();
+    }
+
+    std::string CompileServer::HandleRequest(const std::string& line)
+    {
+        CompileResponse response;
+        CompileRequest request;
+        if (auto error = glz::read<glz::opts{.error_on_unknown_keys = false}>(request, line))
+        {
+            response.status = "error";
+            response.message = "Invalid request: " + glz::format_error(error, line);
+        }
+        else
+        {
+            auto& worker = workers_.local();
+            worker.compiler.setOptions(request.options.value_or(defaults_));
+            auto result = CheckCode(request.code, worker.parser, worker.compiler, request.estimate);
+            response.id = std::move(request.id);
+            response.status = std::move(result.status);
+            response.message = std::move(result.message);
+            response.cost = std::move(result.cost);
+        }
+        return glz::write_json(response).value_or(
+            R"({"status": "error", "message": "Failed to serialize response"})");
+    }
+
+    void CompileServer::ServeConnection(int in_fd, int out_fd, bool close_when_done)
+    {
+        // Tasks keep the connection alive until their response is written
+        auto connection = std::make_shared<Connection>(in_fd, out_fd, close_when_done);
+        auto submit = [&](std::string line)
+        {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+            {
+                return;
+            }
+            arena_.execute([&]
+            {
+                group_.run([this, connection, line = std::move(line)]
+                {
+                    connection->WriteLine(HandleRequest(line));
+                });
+            });
+        };
+
+        std::string buffer;
+        char chunk[64 * 1024];
+        for (;;)
+        {
+            const auto n = ::read(connection->InFd(), chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+
+            size_t start = 0;
+            for (size_t end; (end = buffer.find('\n', start)) != std::string::npos; start = end + 1)
+            {
+                submit(buffer.substr(start, end - start));
+            }
+            buffer.erase(0, start);
+        }
+        submit(std::move(buffer));
+    }
+
+    void CompileServer::Wait()
+    {
+        arena_.execute([&] { group_.wait(); });
+    }
+
+} // namespace epoch_script
@@ -0,0 +1,90 @@
+//
+// EpochScript Compile Server
+//
+// Request handling behind epoch_compile_check --serve: newline-delimited
+// JSON compile requests answered by a pool of warm compilers.
+//
+
+#pragma once
+
+#include "ast_compiler.h"
+#include "cost_estimator.h"
+#include "parser/python_parser.h"
+#include <epoch_script/core/compiler_options.h>
+#include <optional>
+#include <string>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+namespace epoch_script
+{
+
+    struct CompileCheckResult
+    {
+        std::string status; // "ok" or "error"
+        std::string message;
+        std::optional<CostEstimate> cost{};
+    };
+
+    // Compiles one script without sink validation, estimating its cost when
+    // asked; never throws
+    CompileCheckResult CheckCode(const std::string& code,
+                                 PythonParser& parser,
+                                 AlgorithmAstCompiler& compiler,
+                                 const std::optional<CostEstimateOptions>& estimate = std::nullopt);
+
+    /**
+     * @brief Answers compile requests concurrently.
+     *
+     * A request is one line, {"id": <any>, "code": "<epochscript_code>"},
+     * optionally with "estimate": {"assets": n, "rows": n,
+     * "rows_by_timeframe": {...}} and "options": {"elementwise_fusion": bool,
+     * "algebraic_simplification": bool} (the server's defaults otherwise).
+     * Its response is one line, {"id": <same>, "status": "ok"|"error",
+     * "message": ..., "cost": ...}; a line that is not a valid request gets
+     * an error response without an id.
+     *
+     * Requests compile as tasks on a fixed-size arena, each with the
+     * compiler and parser of the thread it runs on. Compilers are reused
+     * across requests and nothing is stored per request, so a long-running
+     * server's memory does not grow with the number of distinct scripts (the
+     * process-wide CompilationCache is not involved).
+     */
+    class CompileServer
+    {
+    public:
+        CompileServer(int threads, CompilerOptions defaults);
+        ~CompileServer();
+
+        CompileServer(const CompileServer&) = delete;
+        CompileServer& operator=(const CompileServer&) = delete;
+
+        // Response line (without the newline) for one request line; thread safe
+        std::string HandleRequest(const std::string& line);
+
+        // Reads request lines from in_fd until EOF and submits each to the
+        // pool. Responses are written whole to out_fd as they complete, so
+        // they may arrive out of order; clients match them by id. With
+        // close_when_done, in_fd is closed after the last response.
+        void ServeConnection(int in_fd, int out_fd, bool close_when_done);
+
+        // Blocks until every submitted request has been answered
+        void Wait();
+
+    private:
+        struct Worker
+        {
+            PythonParser parser;
+            AlgorithmAstCompiler compiler;
+        };
+
+        CompilerOptions defaults_;
+        tbb::enumerable_thread_specific<Worker> workers_;
+        tbb::global_control parallelism_;
+        tbb::task_arena arena_;
+        tbb::task_group group_;
+    };
+
+} // namespace epoch_script
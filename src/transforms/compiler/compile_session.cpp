@@ -0,0 +1,171 @@
+//
+// EpochScript Compile Session - Implementation
+//
+
+#include "compile_session.h"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace epoch_script
+{
+
+    namespace
+    {
+        // Row and byte column of a byte offset, as tree-sitter counts them
+        TSPoint PointAt(std::string_view text, size_t offset)
+        {
+            TSPoint point{0, 0};
+            for (size_t i = 0; i < offset; ++i)
+            {
+                if (text[i] == '\n')
+                {
+                    ++point.row;
+                    point.column = 0;
+                }
+                else
+                {
+                    ++point.column;
+                }
+            }
+            return point;
+        }
+
+        TSPoint Advance(TSPoint point, std::string_view text)
+        {
+            const auto last_newline = text.rfind('\n');
+            if (last_newline == std::string_view::npos)
+            {
+                point.column += static_cast<uint32_t>(text.size());
+                return point;
+            }
+            point.row += static_cast<uint32_t>(std::count(text.begin(), text.end(), '\n'));
+            point.column = static_cast<uint32_t>(text.size() - last_newline - 1);
+            return point;
+        }
+    } // namespace
+
+    CompileSession::CompileSession(bool skip_sink_validation, CompilerOptions options)
+        : skip_sink_validation_(skip_sink_validation), compiler_(options)
+    {
+    }
+
+    CompilationResult CompileSession::Open(std::string source)
+    {
+        source_ = std::move(source);
+        tree_.reset();
+        checkpoints_.clear();
+        TrimNodes();
+        return Compile();
+    }
+
+    CompilationResult CompileSession::Edit(const TextEdit& edit)
+    {
+        if (edit.start_byte > edit.old_end_byte || edit.old_end_byte > source_.size())
+        {
+            throw std::out_of_range("Edit range [" + std::to_string(edit.start_byte) + ", " +
+                                    std::to_string(edit.old_end_byte) + ") is outside the " +
+                                    std::to_string(source_.size()) + "-byte source");
+        }
+
+        if (tree_)
+        {
+            const TSPoint start = PointAt(source_, edit.start_byte);
+            const TSInputEdit input_edit{
+                static_cast<uint32_t>(edit.start_byte),
+                static_cast<uint32_t>(edit.old_end_byte),
+                static_cast<uint32_t>(edit.start_byte + edit.new_text.size()),
+                start,
+                Advance(start, std::string_view{source_}.substr(edit.start_byte, edit.old_end_byte - edit.start_byte)),
+                Advance(start, edit.new_text)};
+            ts_tree_edit(tree_.get(), &input_edit);
+        }
+        source_.replace(edit.start_byte, edit.old_end_byte - edit.start_byte, edit.new_text);
+
+        // A statement starting after the edit may now parse differently, and
+        // one starting at it may have joined the statement before
+        std::erase_if(checkpoints_, [&](const Checkpoint& checkpoint)
+                      { return checkpoint.start_byte >= edit.start_byte; });
+        TrimNodes();
+
+        return Compile();
+    }
+
+    CompilationResult CompileSession::Compile()
+    {
+        visited_statements_ = 0;
+        auto module = parser_.parse(source_, tree_);
+
+        // Checkpoints before the edit still start the same statements
+        const Checkpoint* resume = nullptr;
+        if (!checkpoints_.empty())
+        {
+            const auto& last = checkpoints_.back();
+            if (last.statement < module->body.size() &&
+                module->body[last.statement]->start_byte == last.start_byte)
+            {
+                resume = &last;
+            }
+            else
+            {
+                checkpoints_.clear();
+                TrimNodes();
+            }
+        }
+        const size_t first_statement = resume ? resume->statement : 0;
+        const auto resume_context = resume ? std::optional{Restore(*resume)} : std::nullopt;
+
+        auto on_statement = [this](size_t index, const Stmt& stmt, const CompilationContext& context)
+        {
+            ++visited_statements_;
+
+            // Later checkpoints (also all of them on a restart) are stale
+            const auto stale = std::erase_if(checkpoints_, [&](const Checkpoint& checkpoint)
+                                             { return checkpoint.statement > index; });
+            if (stale > 0)
+            {
+                TrimNodes();
+            }
+            if (index > 0 && index % kCheckpointInterval == 0 &&
+                (checkpoints_.empty() || checkpoints_.back().statement < index))
+            {
+                // Only the nodes built since the previous checkpoint are copied
+                const auto& algorithms = context.algorithms;
+                nodes_.insert(nodes_.end(), algorithms.begin() + static_cast<std::ptrdiff_t>(nodes_.size()),
+                              algorithms.end());
+
+                Checkpoint checkpoint{index, stmt.start_byte, algorithms.size(), {}};
+                checkpoint.context.var_to_binding = context.var_to_binding;
+                checkpoint.context.used_node_ids = context.used_node_ids;
+                checkpoint.context.node_output_types = context.node_output_types;
+                checkpoint.context.executor_count = context.executor_count;
+                checkpoints_.push_back(std::move(checkpoint));
+            }
+        };
+
+        return compiler_.compileASTFrom(std::move(module),
+                                        first_statement,
+                                        resume_context ? &*resume_context : nullptr,
+                                        on_statement,
+                                        skip_sink_validation_);
+    }
+
+    void CompileSession::TrimNodes()
+    {
+        const size_t keep = checkpoints_.empty() ? 0 : checkpoints_.back().node_count;
+        nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(keep), nodes_.end());
+    }
+
+    CompilationContext CompileSession::Restore(const Checkpoint& checkpoint) const
+    {
+        CompilationContext context = checkpoint.context;
+        context.algorithms.assign(nodes_.begin(), nodes_.begin() + static_cast<std::ptrdiff_t>(checkpoint.node_count));
+        for (size_t i = 0; i < context.algorithms.size(); ++i)
+        {
+            context.node_lookup[context.algorithms[i].id] = i;
+        }
+        return context;
+    }
+
+} // namespace epoch_script
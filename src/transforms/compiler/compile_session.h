@@ -0,0 +1,101 @@
+//
+// EpochScript Compile Session
+//
+// Incremental re-parsing and re-compilation of one document for editors.
+//
+
+#pragma once
+
+#include "ast_compiler.h"
+#include "compilation_context.h"
+#include "parser/python_parser.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace epoch_script
+{
+
+    // Replacement of source bytes [start_byte, old_end_byte) with new_text
+    struct TextEdit
+    {
+        size_t start_byte{};
+        size_t old_end_byte{};
+        std::string new_text;
+    };
+
+    /**
+     * @brief Compiles a document, then recompiles it after each edit.
+     *
+     * The tree-sitter tree is kept and edited with ts_tree_edit, so a reparse
+     * reuses every subtree outside the edit. Statements compile in order and
+     * only read state left by earlier statements, so the compiler context
+     * before a statement depends only on the text in front of it: the session
+     * keeps a checkpoint of the context every kCheckpointInterval statements
+     * and resumes from the last one in front of the edit, keeping the node ids
+     * and node_output_types of the statements before it. Nodes are final once
+     * the statement that built them has been visited, so checkpoints do not
+     * copy the algorithms: they share one append-only list and each records
+     * the length of its prefix (node_lookup is rebuilt from it on resume).
+     * Statements after the edit are revisited, and the graph-wide passes
+     * (CSE, orphan removal, sorting, timeframe resolution) rerun on the whole
+     * graph.
+     *
+     * A changed constant can refold any statement, so it recompiles from the
+     * top. Results are identical to compiling the edited source from scratch.
+     * Parse and compile errors propagate as from AlgorithmAstCompiler; the
+     * edit is applied regardless, so the next edit continues from it.
+     */
+    class CompileSession
+    {
+    public:
+        static constexpr size_t kCheckpointInterval = 4;
+
+        explicit CompileSession(bool skip_sink_validation = false,
+                                CompilerOptions options = CompilerOptions::FromEnvironment());
+
+        // Replaces the document and compiles it from scratch
+        CompilationResult Open(std::string source);
+
+        // Applies an edit to the document and recompiles it
+        CompilationResult Edit(const TextEdit& edit);
+
+        const std::string& Source() const { return source_; }
+
+        // Top-level statements visited by the last Open/Edit
+        size_t LastVisitedStatements() const { return visited_statements_; }
+
+        // Nodes stored for all checkpoints together
+        size_t CheckpointedNodes() const { return nodes_.size(); }
+
+        // Compiler options (elementwise fusion, algebraic simplification)
+        AlgorithmAstCompiler& Compiler() { return compiler_; }
+
+    private:
+        struct Checkpoint
+        {
+            size_t statement;
+            uint32_t start_byte;
+            size_t node_count;          // prefix of nodes_ built before the statement
+            CompilationContext context; // without algorithms and node_lookup
+        };
+
+        bool skip_sink_validation_;
+        AlgorithmAstCompiler compiler_;
+        PythonParser parser_;
+        std::string source_;
+        SyntaxTree tree_;
+        std::vector<Checkpoint> checkpoints_; // by statement, all before any edit
+        std::vector<strategy::AlgorithmNode> nodes_; // up to the last checkpoint
+        size_t visited_statements_{0};
+
+        CompilationResult Compile();
+
+        // Drops the nodes past the last remaining checkpoint
+        void TrimNodes();
+
+        // Context to resume from at a checkpoint
+        CompilationContext Restore(const Checkpoint& checkpoint) const;
+    };
+
+} // namespace epoch_script
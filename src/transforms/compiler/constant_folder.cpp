@@ -14,7 +14,8 @@ ModulePtr ConstantFolder::PreprocessModule(ModulePtr module)
         return module;
     }
 
-    // First pass: Identify constant assignments
+    // First pass: Identify constant assignments (from this module only)
+    constant_table_.clear();
     IdentifyConstants(*module);
 
     // Second pass: Fold constants by replacing Names with Constants
@@ -45,6 +45,14 @@ public:
      */
     ModulePtr PreprocessModule(ModulePtr module);
 
+    /**
+     * @brief Constants found by the last PreprocessModule call.
+     */
+    const std::unordered_map<std::string, Constant::Value>& Constants() const
+    {
+        return constant_table_;
+    }
+
 private:
     CompilationContext& context_;
 
@@ -0,0 +1,138 @@
+//
+// EpochScript Cost Estimator - Implementation
+//
+
+#include "cost_estimator.h"
+#include <epoch_script/core/time_frame.h>
+#include <epoch_script/transforms/core/registry.h>
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace epoch_script
+{
+
+    namespace
+    {
+        using transforms::CostModel;
+        using transforms::TransformsMetaData;
+
+        // Numeric value of an option on the node, else its declared default
+        std::optional<double> OptionValue(const strategy::AlgorithmNode& node,
+                                          const TransformsMetaData* metadata,
+                                          const std::string& option_id)
+        {
+            if (option_id.empty())
+            {
+                return std::nullopt;
+            }
+            auto numeric = [](const MetaDataOptionDefinition& value) -> std::optional<double>
+            {
+                if (value.IsType<double>())
+                {
+                    return value.GetDecimal();
+                }
+                return std::nullopt;
+            };
+
+            if (auto it = node.options.find(option_id); it != node.options.end())
+            {
+                if (auto value = numeric(it->second))
+                {
+                    return value;
+                }
+            }
+            if (metadata)
+            {
+                for (const auto& option : metadata->options)
+                {
+                    if (option.id == option_id && option.defaultValue)
+                    {
+                        return numeric(*option.defaultValue);
+                    }
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Work on one asset's rows, excluding the per-call overhead: the
+        // per-row updates run on every row, the fit only every stride-th
+        double RowUnits(const CostModel& model, double rows, double scale, double stride)
+        {
+            double growth = 0.0;
+            switch (model.complexity)
+            {
+            case epoch_core::CostComplexity::Constant:
+                break;
+            case epoch_core::CostComplexity::Windowed:
+                growth = rows * scale;
+                break;
+            case epoch_core::CostComplexity::Quadratic:
+                growth = rows * rows;
+                break;
+            default:
+                growth = rows;
+                break;
+            }
+            return model.updateCoefficient * rows + model.coefficient * growth / stride;
+        }
+    } // namespace
+
+    CostEstimate EstimateCost(const std::vector<strategy::AlgorithmNode>& algorithms,
+                              const CostEstimateOptions& options)
+    {
+        std::vector<std::pair<TimeFrame, size_t>> timeframe_rows;
+        timeframe_rows.reserve(options.rows_by_timeframe.size());
+        for (const auto& [timeframe, rows] : options.rows_by_timeframe)
+        {
+            try
+            {
+                timeframe_rows.emplace_back(TimeFrame{timeframe}, rows);
+            }
+            catch (const std::exception& e)
+            {
+                throw std::runtime_error("Invalid timeframe '" + timeframe + "' in cost estimate options: " + e.what());
+            }
+        }
+
+        const auto& registry = transforms::ITransformRegistry::GetInstance();
+        const CostModel default_model{};
+        const auto assets = static_cast<double>(options.assets);
+
+        CostEstimate estimate;
+        estimate.nodes.reserve(algorithms.size());
+        for (const auto& node : algorithms)
+        {
+            size_t rows = options.rows;
+            if (node.timeframe)
+            {
+                auto it = std::ranges::find_if(timeframe_rows, [&](const auto& entry)
+                                               { return entry.first == *node.timeframe; });
+                if (it != timeframe_rows.end())
+                {
+                    rows = it->second;
+                }
+            }
+
+            const auto metadata_ref = registry.GetMetaData(node.type);
+            const TransformsMetaData* metadata = metadata_ref ? &metadata_ref->get() : nullptr;
+            const CostModel& model = (metadata && metadata->costModel) ? *metadata->costModel : default_model;
+
+            const double scale = OptionValue(node, metadata, model.scaleOption).value_or(1.0);
+            const double stride = std::max(1.0, OptionValue(node, metadata, model.strideOption).value_or(1.0));
+            const double row_units = RowUnits(model, static_cast<double>(rows), scale, stride);
+
+            // A cross-sectional transform is called once with every asset
+            const bool cross_sectional = metadata && metadata->isCrossSectional;
+            const double calls = cross_sectional ? 1.0 : assets;
+            const double units = row_units * assets + model.perCallOverhead * calls;
+
+            estimate.nodes.push_back({node.id, node.type, rows, units, units * options.seconds_per_unit});
+            estimate.total_units += units;
+        }
+        estimate.total_seconds = estimate.total_units * options.seconds_per_unit;
+        return estimate;
+    }
+
+} // namespace epoch_script
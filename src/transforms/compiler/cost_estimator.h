@@ -0,0 +1,62 @@
+//
+// EpochScript Cost Estimator
+//
+// Static runtime estimate of a compiled graph from the transforms' cost
+// models, before any data is loaded.
+//
+
+#pragma once
+
+#include <epoch_script/strategy/metadata.h>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace epoch_script
+{
+
+    // Shape of the run being estimated
+    struct CostEstimateOptions
+    {
+        size_t assets{1};
+        size_t rows{0};                                              // rows per asset, default for every timeframe
+        std::unordered_map<std::string, size_t> rows_by_timeframe{}; // e.g. {"1Min", 98280}, {"1D", 252}
+        double seconds_per_unit{1e-9};                               // one elementwise operation on one row
+    };
+
+    struct NodeCostEstimate
+    {
+        std::string id;
+        std::string type;
+        size_t rows{};    // per asset, at the node's timeframe
+        double units{};   // over all assets
+        double seconds{};
+    };
+
+    struct CostEstimate
+    {
+        std::vector<NodeCostEstimate> nodes; // in graph order
+        double total_units{};
+        double total_seconds{};
+    };
+
+    /**
+     * @brief Estimates the work of every node from its transform's CostModel.
+     *
+     * A node's rows come from rows_by_timeframe when its timeframe is listed
+     * there (keys are timeframe strings as written in scripts), else from
+     * rows. Window, iteration and stride values are read from the node's
+     * options, falling back to the option defaults. Cross-sectional nodes pay
+     * their per-call overhead once instead of once per asset. Totals are
+     * sequential: they do not model parallel execution across assets or
+     * nodes, so read them as an upper bound for ranking and rejecting
+     * scripts, not as a wall-clock prediction.
+     *
+     * Throws std::runtime_error for a rows_by_timeframe key that is not a
+     * valid timeframe.
+     */
+    CostEstimate EstimateCost(const std::vector<strategy::AlgorithmNode>& algorithms,
+                              const CostEstimateOptions& options);
+
+} // namespace epoch_script
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <sstream>
+#include <string_view>
 
 namespace epoch_script
 {
@@ -33,19 +34,22 @@ bool CSEOptimizer::IsScalarType(const std::string& type) const
 void CSEOptimizer::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
                            CompilationContext& context)
 {
-    // Map: semantic hash -> canonical node ID (first occurrence)
-    std::unordered_map<size_t, std::string> hash_to_canonical;
+    // Map: semantic hash -> index of the canonical node (first occurrence)
+    std::unordered_map<size_t, size_t> hash_to_canonical;
 
-    // Map: duplicate node ID -> canonical node ID (for redirecting references)
-    std::unordered_map<std::string, std::string> redirect_map;
-
-    // Set of node IDs to remove
-    std::unordered_set<std::string> nodes_to_remove;
+    // Map: duplicate node ID -> index of its canonical node (for redirecting
+    // references). Keys view the duplicates' IDs, which stay in place until
+    // Phase 3.
+    std::unordered_map<std::string_view, size_t> redirect_map;
 
+    // Nodes to remove, by index
+    std::vector<bool> nodes_to_remove(algorithms.size(), false);
 
     // Phase 1: Identify duplicates
-    for (const auto& node : algorithms)
+    for (size_t i = 0; i < algorithms.size(); ++i)
     {
+        const auto& node = algorithms[i];
+
         // Skip nodes that should not be deduplicated
         if (ShouldExcludeFromCSE(node.type))
         {
@@ -54,33 +58,23 @@ void CSEOptimizer::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
 
         size_t h = ComputeSemanticHash(node);
 
-        auto it = hash_to_canonical.find(h);
-        if (it != hash_to_canonical.end())
-        {
-            // Potential duplicate found - verify with full equality check
-            // (hash collision is possible, so we need to confirm)
-            const std::string& canonical_id = it->second;
-
-            // Find the canonical node
-            auto canonical_it = std::find_if(algorithms.begin(), algorithms.end(),
-                [&canonical_id](const strategy::AlgorithmNode& n) {
-                    return n.id == canonical_id;
-                });
-
-            if (canonical_it != algorithms.end() && SemanticEquals(node, *canonical_it))
-            {
-                // True duplicate found
-                redirect_map[node.id] = canonical_id;
-                nodes_to_remove.insert(node.id);
-            }
-        }
-        else
+        // First occurrence of a hash becomes the canonical node. A later one
+        // is a potential duplicate - verify with full equality check
+        // (hash collision is possible, so we need to confirm)
+        auto [it, inserted] = hash_to_canonical.try_emplace(h, i);
+        if (!inserted && SemanticEquals(node, algorithms[it->second]))
         {
-            // First occurrence - this becomes the canonical node
-            hash_to_canonical[h] = node.id;
+            // True duplicate found
+            redirect_map.emplace(node.id, it->second);
+            nodes_to_remove[i] = true;
         }
     }
 
+    if (redirect_map.empty())
+    {
+        return;
+    }
+
     // Phase 2: Rewrite all references to point to canonical nodes
     for (auto& node : algorithms)
     {
@@ -90,20 +84,18 @@ void CSEOptimizer::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
             {
                 // Extract node_id from "node_id#handle" format
                 auto hash_pos = ref.find('#');
-                if (hash_pos != std::string::npos)
+                if (hash_pos == std::string::npos)
                 {
-                    std::string node_id = ref.substr(0, hash_pos);
-                    std::string handle = ref.substr(hash_pos); // includes the '#'
+                    continue;  // external reference like "src", leave unchanged
+                }
 
-                    // Check if this node is a duplicate that needs redirection
-                    auto redirect_it = redirect_map.find(node_id);
-                    if (redirect_it != redirect_map.end())
-                    {
-                        // Redirect to canonical node
-                        ref = redirect_it->second + handle;
-                    }
+                // Check if this node is a duplicate that needs redirection
+                auto redirect_it = redirect_map.find(std::string_view(ref).substr(0, hash_pos));
+                if (redirect_it != redirect_map.end())
+                {
+                    // Redirect to canonical node, keeping the '#handle' suffix
+                    ref.replace(0, hash_pos, algorithms[redirect_it->second].id);
                 }
-                // else: external reference like "src", leave unchanged
             }
         }
     }
@@ -125,25 +117,43 @@ void CSEOptimizer::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
                 continue;  // Skip if serialization failed
             }
 
-            // Replace all node references found in redirect_map
-            // Look for patterns like "node_id#handle" in JSON string values
-            for (const auto& [old_id, new_id] : redirect_map)
+            // Replace node references found in redirect_map in a single scan.
+            // Pattern: "old_id# (appears in select_key and other fields)
+            std::string rewritten;
+            size_t copied = 0;
+            for (size_t quote = json_str.find('"'); quote != std::string::npos;)
             {
-                // Pattern: "old_id# (appears in select_key and other fields)
-                std::string old_pattern = "\"" + old_id + "#";
-                std::string new_pattern = "\"" + new_id + "#";
-
-                size_t pos = 0;
-                while ((pos = json_str.find(old_pattern, pos)) != std::string::npos)
+                const size_t end = json_str.find_first_of("#\"", quote + 1);
+                if (end == std::string::npos)
+                {
+                    break;
+                }
+                if (json_str[end] == '#')
+                {
+                    auto redirect_it = redirect_map.find(
+                        std::string_view(json_str).substr(quote + 1, end - quote - 1));
+                    if (redirect_it != redirect_map.end())
+                    {
+                        rewritten.append(json_str, copied, quote + 1 - copied);
+                        rewritten += algorithms[redirect_it->second].id;
+                        copied = end;
+                    }
+                    quote = json_str.find('"', end);
+                }
+                else
                 {
-                    json_str.replace(pos, old_pattern.length(), new_pattern);
-                    pos += new_pattern.length();
+                    quote = end;
                 }
             }
+            if (copied == 0)
+            {
+                continue;  // No references to redirect
+            }
+            rewritten.append(json_str, copied);
 
             // Deserialize back to the variant
             auto variant = option_def.GetVariant();
-            auto parse_result = glz::read_json(variant, json_str);
+            auto parse_result = glz::read_json(variant, rewritten);
             if (!parse_result)
             {
                 // Successfully parsed - update the option
@@ -153,20 +163,23 @@ void CSEOptimizer::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
         }
     }
 
-    // Phase 3: Remove duplicate nodes from the algorithms vector
-    algorithms.erase(
-        std::remove_if(algorithms.begin(), algorithms.end(),
-            [&nodes_to_remove](const strategy::AlgorithmNode& node) {
-                return nodes_to_remove.count(node.id) > 0;
-            }),
-        algorithms.end()
-    );
-
+    // Phase 3: Remove duplicate nodes from the algorithms vector, and
     // Phase 4: Update context.used_node_ids to remove deleted IDs
-    for (const auto& removed_id : nodes_to_remove)
+    size_t kept = 0;
+    for (size_t i = 0; i < algorithms.size(); ++i)
     {
-        context.used_node_ids.erase(removed_id);
+        if (nodes_to_remove[i])
+        {
+            context.used_node_ids.erase(algorithms[i].id);
+            continue;
+        }
+        if (kept != i)
+        {
+            algorithms[kept] = std::move(algorithms[i]);
+        }
+        ++kept;
     }
+    algorithms.resize(kept);
 }
 
 size_t CSEOptimizer::ComputeSemanticHash(const strategy::AlgorithmNode& node) const
@@ -0,0 +1,349 @@
+//
+// EpochScript Elementwise Fusion - Implementation
+//
+
+#include "elementwise_fusion.h"
+#include "node_graph.h"
+#include <epoch_core/enum_wrapper.h>
+#include <epoch_script/core/constants.h>
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+namespace epoch_script
+{
+
+    namespace
+    {
+        // How an operator's operands must be typed to be fused
+        enum class Operands
+        {
+            Numeric,    // all Integer/Decimal/Number
+            Boolean,    // all Boolean
+            Comparable, // all numeric or all Boolean
+            Select      // Boolean condition, branches of the result type
+        };
+
+        struct OperatorSpec
+        {
+            std::string_view token;
+            std::vector<std::string> inputs; // in operand order
+            DataType result;
+            Operands operands;
+        };
+
+        const std::unordered_map<std::string, OperatorSpec>& FusableOperators()
+        {
+            static const std::vector<std::string> binary{"SLOT0", "SLOT1"};
+            static const std::vector<std::string> select{"condition", "true", "false"};
+            static const std::unordered_map<std::string, OperatorSpec> operators{
+                {"add", {"add", binary, DataType::Decimal, Operands::Numeric}},
+                {"sub", {"sub", binary, DataType::Decimal, Operands::Numeric}},
+                {"mul", {"mul", binary, DataType::Decimal, Operands::Numeric}},
+                {"div", {"div", binary, DataType::Decimal, Operands::Numeric}},
+                {"lt", {"lt", binary, DataType::Boolean, Operands::Numeric}},
+                {"gt", {"gt", binary, DataType::Boolean, Operands::Numeric}},
+                {"lte", {"lte", binary, DataType::Boolean, Operands::Numeric}},
+                {"gte", {"gte", binary, DataType::Boolean, Operands::Numeric}},
+                {"eq", {"eq", binary, DataType::Boolean, Operands::Comparable}},
+                {"neq", {"neq", binary, DataType::Boolean, Operands::Comparable}},
+                {"logical_and", {"and", binary, DataType::Boolean, Operands::Boolean}},
+                {"logical_or", {"or", binary, DataType::Boolean, Operands::Boolean}},
+                {"logical_not", {"not", {"SLOT"}, DataType::Boolean, Operands::Boolean}},
+                {"boolean_select_number", {"select", select, DataType::Decimal, Operands::Select}},
+                {"boolean_select_boolean", {"select", select, DataType::Boolean, Operands::Select}}};
+            return operators;
+        }
+
+        bool IsNumeric(DataType type)
+        {
+            return type == DataType::Integer || type == DataType::Decimal || type == DataType::Number;
+        }
+
+        bool OperandsFit(const OperatorSpec& spec, const std::vector<DataType>& types)
+        {
+            auto all = [&](auto&& pred, size_t from = 0)
+            {
+                return std::all_of(types.begin() + from, types.end(), pred);
+            };
+            auto is_boolean = [](DataType t) { return t == DataType::Boolean; };
+            switch (spec.operands)
+            {
+            case Operands::Numeric:
+                return all(IsNumeric);
+            case Operands::Boolean:
+                return all(is_boolean);
+            case Operands::Comparable:
+                return all(IsNumeric) || all(is_boolean);
+            case Operands::Select:
+                return types[0] == DataType::Boolean &&
+                       (spec.result == DataType::Boolean ? all(is_boolean, 1) : all(IsNumeric, 1));
+            }
+            return false;
+        }
+
+        // Literal nodes inlined as program constants
+        std::optional<double> LiteralValue(const strategy::AlgorithmNode& node)
+        {
+            if (node.type == "bool_true")
+            {
+                return 1.0;
+            }
+            if (node.type == "bool_false")
+            {
+                return 0.0;
+            }
+            if (node.type == "number")
+            {
+                auto it = node.options.find("value");
+                if (it != node.options.end())
+                {
+                    const auto value = it->second.GetVariant();
+                    if (std::holds_alternative<double>(value))
+                    {
+                        return std::get<double>(value);
+                    }
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Declared type of a node output that is read as a leaf
+        DataType OutputType(const strategy::AlgorithmNode& node, std::string_view handle,
+                            const CompilationContext& context)
+        {
+            if (auto node_it = context.node_output_types.find(node.id); node_it != context.node_output_types.end())
+            {
+                if (auto it = node_it->second.find(std::string{handle}); it != node_it->second.end())
+                {
+                    return it->second;
+                }
+            }
+            if (node.type == "number")
+            {
+                return DataType::Decimal;
+            }
+            if (node.type == "bool_true" || node.type == "bool_false")
+            {
+                return DataType::Boolean;
+            }
+
+            const auto& all_metadata = context.GetRegistry().GetMetaData();
+            auto meta_it = all_metadata.find(node.type);
+            if (meta_it == all_metadata.end())
+            {
+                return DataType::Any;
+            }
+            for (const auto& output : meta_it->second.outputs)
+            {
+                if (output.id != handle)
+                {
+                    continue;
+                }
+                switch (output.type)
+                {
+                case epoch_core::IODataType::Boolean:
+                    return DataType::Boolean;
+                case epoch_core::IODataType::Integer:
+                    return DataType::Integer;
+                case epoch_core::IODataType::Decimal:
+                    return DataType::Decimal;
+                case epoch_core::IODataType::Number:
+                    return DataType::Number;
+                default:
+                    return DataType::Any;
+                }
+            }
+            return DataType::Any;
+        }
+    } // namespace
+
+    void ElementwiseFusion::Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
+                                     CompilationContext& context) const
+    {
+        const NodeGraph graph(algorithms);
+        const auto schema_refs = CollectSchemaReferences(algorithms);
+        const size_t n = algorithms.size();
+
+        // Pass 1 (topological order): fusable operators, whose operand types
+        // are their producers' results
+        std::vector<const OperatorSpec*> spec(n, nullptr);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto& node = algorithms[i];
+            auto op_it = FusableOperators().find(node.type);
+            if (op_it == FusableOperators().end() || schema_refs.contains(node.id) ||
+                node.inputs.size() != op_it->second.inputs.size())
+            {
+                continue;
+            }
+
+            std::vector<DataType> types;
+            for (const auto& input : op_it->second.inputs)
+            {
+                auto input_it = node.inputs.find(input);
+                if (input_it == node.inputs.end() || input_it->second.size() != 1)
+                {
+                    break;
+                }
+                const auto& ref = input_it->second.front();
+                const size_t dep = graph.IndexOf(NodeGraph::NodeIdOf(ref));
+                if (dep == NodeGraph::npos || ref.find('#') == std::string::npos)
+                {
+                    break;
+                }
+                types.push_back(spec[dep] ? spec[dep]->result
+                                          : OutputType(algorithms[dep], ref.substr(ref.find('#') + 1), context));
+            }
+            if (types.size() == op_it->second.inputs.size() && OperandsFit(op_it->second, types))
+            {
+                spec[i] = &op_it->second;
+            }
+        }
+
+        // An operator is folded into its only reader when that reader is
+        // fusable on the same timeframe and session
+        std::vector<bool> absorbed(n, false);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto& dependents = graph.Dependents(i);
+            if (!spec[i] || dependents.size() != 1 || !spec[dependents.front()])
+            {
+                continue;
+            }
+            const auto& consumer = algorithms[dependents.front()];
+            absorbed[i] = consumer.timeframe == algorithms[i].timeframe &&
+                          consumer.session == algorithms[i].session;
+        }
+
+        // Pass 2: rewrite each tree root as a fused node
+        std::vector<bool> removed(n, false);
+        std::vector<bool> fused(n, false);
+        std::vector<size_t> inlined;
+        for (size_t root = 0; root < n; ++root)
+        {
+            if (!spec[root] || absorbed[root])
+            {
+                continue;
+            }
+
+            std::string program;
+            std::vector<std::string> leaves;
+            std::vector<size_t> folded;
+            std::vector<size_t> literals;
+            size_t ops = 0;
+
+            // Post-order walk emitting reverse Polish notation
+            auto emit = [&](auto&& self, size_t i) -> void
+            {
+                const auto& node = algorithms[i];
+                for (const auto& input : spec[i]->inputs)
+                {
+                    const auto& ref = node.inputs.at(input).front();
+                    const size_t dep = graph.IndexOf(NodeGraph::NodeIdOf(ref));
+                    if (absorbed[dep])
+                    {
+                        self(self, dep);
+                        folded.push_back(dep);
+                    }
+                    else if (auto value = LiteralValue(algorithms[dep]))
+                    {
+                        program += std::format("#{} ", *value);
+                        literals.push_back(dep);
+                    }
+                    else
+                    {
+                        auto leaf = std::find(leaves.begin(), leaves.end(), ref);
+                        if (leaf == leaves.end())
+                        {
+                            leaf = leaves.insert(leaves.end(), ref);
+                        }
+                        program += std::format("${} ", leaf - leaves.begin());
+                    }
+                }
+                program += spec[i]->token;
+                program += ' ';
+                ++ops;
+            };
+            emit(emit, root);
+
+            // A lone operator gains nothing; a tree without inputs has no length
+            if (ops < 2 || leaves.empty())
+            {
+                continue;
+            }
+            program.pop_back();
+
+            for (size_t i : folded)
+            {
+                removed[i] = true;
+            }
+            inlined.insert(inlined.end(), literals.begin(), literals.end());
+            fused[root] = true;
+
+            auto& node = algorithms[root];
+            node.type = spec[root]->result == DataType::Boolean ? "fused_expression_boolean"
+                                                                : "fused_expression_number";
+            node.options.clear();
+            node.options["program"] = MetaDataOptionDefinition{program};
+            node.inputs.clear();
+            node.inputs[ARG] = std::move(leaves);
+            context.node_output_types[node.id] = {{"result", spec[root]->result}};
+        }
+
+        if (std::find(fused.begin(), fused.end(), true) == fused.end())
+        {
+            return;
+        }
+
+        // Literals are dropped once every reader was fused or folded
+        for (size_t literal : inlined)
+        {
+            const auto& dependents = graph.Dependents(literal);
+            removed[literal] = !schema_refs.contains(algorithms[literal].id) &&
+                               std::all_of(dependents.begin(), dependents.end(),
+                                           [&](size_t d) { return removed[d] || fused[d]; });
+        }
+
+        // Readers of a fused root now read its single "result" output
+        for (size_t root = 0; root < n; ++root)
+        {
+            if (!fused[root])
+            {
+                continue;
+            }
+            for (size_t reader : graph.Dependents(root))
+            {
+                for (auto& [input_name, refs] : algorithms[reader].inputs)
+                {
+                    for (auto& ref : refs)
+                    {
+                        if (NodeGraph::NodeIdOf(ref) == algorithms[root].id && ref.find('#') != std::string::npos)
+                        {
+                            ref.replace(ref.find('#') + 1, std::string::npos, "result");
+                        }
+                    }
+                }
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (removed[i])
+            {
+                context.used_node_ids.erase(algorithms[i].id);
+                continue;
+            }
+            if (kept != i)
+            {
+                algorithms[kept] = std::move(algorithms[i]);
+            }
+            ++kept;
+        }
+        algorithms.resize(kept);
+    }
+
+} // namespace epoch_script
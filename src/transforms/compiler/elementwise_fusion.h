@@ -0,0 +1,48 @@
+//
+// EpochScript Elementwise Fusion
+//
+// Fuses trees of elementwise operator nodes into single fused expression
+// nodes evaluated in one pass at runtime.
+//
+
+#pragma once
+
+#include "compilation_context.h"
+#include <epoch_script/strategy/metadata.h>
+#include <vector>
+
+namespace epoch_script
+{
+
+    /**
+     * @brief Elementwise operator fusion pass.
+     *
+     * Expressions lower to one node per operator, e.g.
+     * `(c - ema20) / atr14 > 1.5 and v > sma(v)` becomes sub, div, gt, gt and
+     * logical_and nodes, each with its own runtime node and full-length
+     * intermediate column. This pass folds every maximal tree of
+     * fusable operators into its root, which becomes a
+     * `fused_expression_number` or `fused_expression_boolean` node with a
+     * reverse Polish "program" option over its leaf inputs (see
+     * FusedExpressionProgram).
+     *
+     * Fusable operators: add, sub, mul, div, lt, gt, lte, gte, eq, neq,
+     * logical_and, logical_or, logical_not, boolean_select_number and
+     * boolean_select_boolean, when every operand is Boolean or numeric
+     * (eq/neq: both Boolean or both numeric). An operator is folded into its
+     * consumer when that consumer is its only reader and has the same
+     * timeframe and session. Number and boolean literals become program
+     * constants. Nodes referenced from schema options are left alone.
+     *
+     * The root keeps its id, timeframe and session, so only references to
+     * its output handle change (to "result"). Must run on a topologically
+     * sorted graph; the order is preserved.
+     */
+    class ElementwiseFusion
+    {
+    public:
+        void Optimize(std::vector<strategy::AlgorithmNode>& algorithms,
+                      CompilationContext& context) const;
+    };
+
+} // namespace epoch_script
@@ -1287,14 +1287,12 @@ namespace epoch_script
 
         // Helper lambda to find the target node by ID
         auto find_target_node = [this](const std::string& node_id) -> epoch_script::strategy::AlgorithmNode* {
-            for (auto& algo : context_.algorithms)
+            auto it = context_.node_lookup.find(node_id);
+            if (it == context_.node_lookup.end())
             {
-                if (algo.id == node_id)
-                {
-                    return &algo;
-                }
+                return nullptr;
             }
-            return nullptr;
+            return &context_.algorithms[it->second];
         };
 
         // Wire keyword arguments to inputs map
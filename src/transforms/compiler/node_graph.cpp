@@ -0,0 +1,80 @@
+//
+// EpochScript Node Graph - Implementation
+//
+
+#include "node_graph.h"
+#include <glaze/glaze.hpp>
+
+namespace epoch_script
+{
+
+    NodeGraph::NodeGraph(const std::vector<strategy::AlgorithmNode>& nodes)
+        : inputs_(nodes.size()), dependents_(nodes.size())
+    {
+        index_.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            index_.emplace(nodes[i].id, i);
+        }
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (const auto& [input_name, refs] : nodes[i].inputs)
+            {
+                for (const auto& ref : refs)
+                {
+                    const size_t dep = IndexOf(NodeIdOf(ref));
+                    if (dep != npos)
+                    {
+                        inputs_[i].push_back(dep);
+                        dependents_[dep].push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t NodeGraph::IndexOf(std::string_view node_id) const
+    {
+        auto it = index_.find(node_id);
+        return it == index_.end() ? npos : it->second;
+    }
+
+    std::string_view NodeGraph::NodeIdOf(std::string_view ref)
+    {
+        return ref.substr(0, ref.find('#'));
+    }
+
+    std::unordered_set<std::string> CollectSchemaReferences(const std::vector<strategy::AlgorithmNode>& nodes)
+    {
+        std::unordered_set<std::string> referenced;
+        for (const auto& node : nodes)
+        {
+            auto schema_it = node.options.find("schema");
+            if (schema_it == node.options.end())
+            {
+                continue;
+            }
+            const std::string json_str = glz::write_json(schema_it->second.GetVariant()).value_or("");
+            for (size_t quote = json_str.find('"'); quote != std::string::npos;)
+            {
+                const size_t end = json_str.find_first_of("#\"", quote + 1);
+                if (end == std::string::npos)
+                {
+                    break;
+                }
+                if (json_str[end] == '#')
+                {
+                    referenced.insert(json_str.substr(quote + 1, end - quote - 1));
+                    quote = json_str.find('"', end);
+                }
+                else
+                {
+                    quote = end;
+                }
+            }
+        }
+        return referenced;
+    }
+
+} // namespace epoch_script
@@ -0,0 +1,63 @@
+//
+// EpochScript Node Graph
+//
+// Dependency graph over compiled AlgorithmNodes, shared by the
+// post-compilation passes (CSE, orphan removal, topological sort,
+// timeframe resolution).
+//
+
+#pragma once
+
+#include <epoch_script/strategy/metadata.h>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace epoch_script
+{
+
+    /**
+     * @brief Input/dependent adjacency over a vector of algorithm nodes.
+     *
+     * Node ids are interned to their position in the vector and every
+     * "node_id#handle" input reference is parsed once, so passes walk integer
+     * adjacency lists instead of searching the vector or re-splitting
+     * reference strings. References to ids outside the vector (e.g. "src")
+     * are not edges.
+     *
+     * The graph views the nodes' id strings: it is invalidated by any change
+     * to the vector or to a node id.
+     */
+    class NodeGraph
+    {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        explicit NodeGraph(const std::vector<strategy::AlgorithmNode>& nodes);
+
+        size_t size() const { return inputs_.size(); }
+
+        // Position of the node with this id (the first one if repeated), or npos
+        size_t IndexOf(std::string_view node_id) const;
+
+        // Nodes a node reads from, once per input reference
+        const std::vector<size_t>& Inputs(size_t node) const { return inputs_[node]; }
+
+        // Nodes reading from a node, once per input reference
+        const std::vector<size_t>& Dependents(size_t node) const { return dependents_[node]; }
+
+        // Node id part of a "node_id#handle" reference (the whole string if no '#')
+        static std::string_view NodeIdOf(std::string_view ref);
+
+    private:
+        std::unordered_map<std::string_view, size_t> index_;
+        std::vector<std::vector<size_t>> inputs_;
+        std::vector<std::vector<size_t>> dependents_;
+    };
+
+    // Ids of nodes referenced as "node_id#handle" from schema options, which
+    // are not input edges
+    std::unordered_set<std::string> CollectSchemaReferences(const std::vector<strategy::AlgorithmNode>& nodes);
+
+} // namespace epoch_script
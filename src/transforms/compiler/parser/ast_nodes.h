@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -137,7 +138,10 @@ struct Subscript : Expr {
 };
 
 // Statement nodes
-struct Stmt : ASTNode {};
+struct Stmt : ASTNode {
+    // Source byte offset of a top-level statement (set by the parser)
+    uint32_t start_byte = 0;
+};
 
 struct Assign : Stmt {
     std::vector<std::unique_ptr<Expr>> targets;
@@ -18,6 +18,10 @@ namespace epoch_script {
 PythonParser::PythonParser() {
     // Initialize parser with Python language
     parser_.emplace(ts::Language{tree_sitter_python()});
+
+    // Raw parser for incremental parses, which need the previous TSTree
+    incremental_parser_.reset(ts_parser_new());
+    ts_parser_set_language(incremental_parser_.get(), tree_sitter_python());
 }
 
 ModulePtr PythonParser::parse(const std::string& source) {
@@ -37,6 +41,23 @@ ModulePtr PythonParser::parse(const std::string& source) {
     return parseModule(root, source);
 }
 
+ModulePtr PythonParser::parse(const std::string& source, SyntaxTree& tree) {
+    tree.reset(ts_parser_parse_string(incremental_parser_.get(), tree.get(),
+                                      source.data(), static_cast<uint32_t>(source.size())));
+    if (!tree) {
+        throw PythonParseError("Failed to parse Python source", 0, 0);
+    }
+
+    ts::Node root{ts_tree_root_node(tree.get())};
+
+    // Check for parse errors
+    if (root.hasError()) {
+        throw PythonParseError("Syntax error in Python source", 0, 0);
+    }
+
+    return parseModule(root, source);
+}
+
 std::string PythonParser::preprocessSource(const std::string& source) {
     std::string result = source;
 
@@ -86,11 +107,10 @@ ModulePtr PythonParser::parseModule(const ts::Node& node, std::string_view sourc
 
         // In tree-sitter v0.23.6, module children might be "assignment" directly or wrapped in other nodes
         // Try to parse as statement, or handle assignment if it appears at module level
-        if (type == "assignment") {
-            if (auto stmt = parseAssignment(child, source)) {
-                module->body.push_back(std::move(stmt));
-            }
-        } else if (auto stmt = parseStatement(child, source)) {
+        StmtPtr stmt = type == "assignment" ? parseAssignment(child, source)
+                                            : parseStatement(child, source);
+        if (stmt) {
+            stmt->start_byte = child.getByteRange().start;
             module->body.push_back(std::move(stmt));
         }
     }
@@ -18,6 +18,7 @@
 #include <string>
 #include <stdexcept>
 #include <optional>
+#include <memory>
 
 namespace epoch_script {
 
@@ -33,6 +34,13 @@ public:
     int col_offset;
 };
 
+struct SyntaxTreeDeleter {
+    void operator()(TSTree* tree) const { ts_tree_delete(tree); }
+};
+
+// Owned tree-sitter tree, kept between parses for incremental reparsing
+using SyntaxTree = std::unique_ptr<TSTree, SyntaxTreeDeleter>;
+
 class PythonParser {
 public:
     PythonParser();
@@ -41,10 +49,21 @@ public:
     // Parse Python source code into AST
     ModulePtr parse(const std::string& source);
 
+    // Incremental parse. `tree` is the previous tree of this document with
+    // the edit already applied via ts_tree_edit (or null), and is replaced by
+    // the new tree even if the source has syntax errors, so unchanged
+    // subtrees are reused on the next edit too.
+    ModulePtr parse(const std::string& source, SyntaxTree& tree);
+
 private:
+    struct ParserDeleter {
+        void operator()(TSParser* parser) const { ts_parser_delete(parser); }
+    };
+
     // Preprocess source to fix common syntax errors
     std::string preprocessSource(const std::string& source);
     std::optional<ts::Parser> parser_;
+    std::unique_ptr<TSParser, ParserDeleter> incremental_parser_;
 
     // Convert tree-sitter nodes to our AST
     ModulePtr parseModule(const ts::Node& node, std::string_view source);
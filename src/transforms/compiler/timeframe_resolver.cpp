@@ -6,6 +6,7 @@
 #include "timeframe_resolver.h"
 #include <epoch_script/transforms/core/transform_registry.h>
 #include <algorithm>
+#include <string_view>
 
 namespace epoch_script
 {
@@ -122,37 +123,48 @@ namespace epoch_script
         }
 
         // Find all nodes that use this literal as an input
-        std::vector<epoch_script::TimeFrame> dependentTimeframes;
-
+        std::vector<const epoch_script::strategy::AlgorithmNode *> dependents;
         for (const auto &node : allNodes)
         {
-            // Skip if this node doesn't have a resolved timeframe yet
-            if (!nodeTimeframes.contains(node.id) || !nodeTimeframes[node.id])
-            {
-                continue;
-            }
-
-            // Check if this node uses our literal
             for (const auto &[inputName, inputRefs] : node.inputs)
             {
                 for (const auto &ref : inputRefs)
                 {
                     // Extract node ID from "node_id#handle"
                     auto hashPos = ref.find('#');
-                    std::string inputNodeId = (hashPos != std::string::npos)
-                        ? ref.substr(0, hashPos)
-                        : ref;
-
-                    if (inputNodeId == nodeId)
+                    if (std::string_view(ref).substr(0, hashPos) == nodeId)
                     {
-                        // This node uses our literal - add its timeframe
-                        dependentTimeframes.push_back(nodeTimeframes[node.id].value());
+                        dependents.push_back(&node);
                         break;
                     }
                 }
             }
         }
 
+        return ResolveLiteralTimeframe(nodeId, dependents);
+    }
+
+    std::optional<epoch_script::TimeFrame> TimeframeResolver::ResolveLiteralTimeframe(
+        const std::string &nodeId,
+        const std::vector<const epoch_script::strategy::AlgorithmNode *> &dependents)
+    {
+        // Check cache first
+        if (nodeTimeframes.contains(nodeId) && nodeTimeframes[nodeId])
+        {
+            return nodeTimeframes[nodeId];
+        }
+
+        std::vector<epoch_script::TimeFrame> dependentTimeframes;
+        for (const auto *node : dependents)
+        {
+            // Skip if this node doesn't have a resolved timeframe yet
+            auto it = nodeTimeframes.find(node->id);
+            if (it != nodeTimeframes.end() && it->second)
+            {
+                dependentTimeframes.push_back(it->second.value());
+            }
+        }
+
         // If we found dependent nodes, inherit their timeframe
         // Use the maximum (lowest resolution) if multiple dependents exist
         if (!dependentTimeframes.empty())
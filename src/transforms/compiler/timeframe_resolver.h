@@ -42,6 +42,11 @@ namespace epoch_script
             const std::string &nodeId,
             const std::vector<epoch_script::strategy::AlgorithmNode> &allNodes);
 
+        // Same as above, given the nodes that use the literal as an input
+        std::optional<epoch_script::TimeFrame> ResolveLiteralTimeframe(
+            const std::string &nodeId,
+            const std::vector<const epoch_script::strategy::AlgorithmNode *> &dependents);
+
         // Cache of resolved timeframes: nodeId -> resolved timeframe
         std::unordered_map<std::string, std::optional<epoch_script::TimeFrame>> nodeTimeframes;
 
@@ -56,12 +56,18 @@ namespace epoch_script
     }
 
     // Explicit registration function - register for all type-specialized variants
+    // Runs once: compilers constructed on several threads must not write the
+    // registry while other compilers read it
     void RegisterBooleanSelectValidator() {
-        auto validator = std::make_shared<BooleanSelectValidator>();
-        SpecialNodeValidatorRegistry::Instance().Register("boolean_select_string", validator);
-        SpecialNodeValidatorRegistry::Instance().Register("boolean_select_number", validator);
-        SpecialNodeValidatorRegistry::Instance().Register("boolean_select_boolean", validator);
-        SpecialNodeValidatorRegistry::Instance().Register("boolean_select_timestamp", validator);
+        static const bool registered = [] {
+            auto validator = std::make_shared<BooleanSelectValidator>();
+            SpecialNodeValidatorRegistry::Instance().Register("boolean_select_string", validator);
+            SpecialNodeValidatorRegistry::Instance().Register("boolean_select_number", validator);
+            SpecialNodeValidatorRegistry::Instance().Register("boolean_select_boolean", validator);
+            SpecialNodeValidatorRegistry::Instance().Register("boolean_select_timestamp", validator);
+            return true;
+        }();
+        (void)registered;
     }
 
 } // namespace epoch_script
@@ -0,0 +1,187 @@
+#include "calendar_day_table.h"
+
+#include <arrow/compute/api.h>
+#include <epoch_frame/calendar_common.h>
+#include <epoch_frame/common.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace epoch_script::transform
+{
+    namespace
+    {
+        int64_t FloorDiv(int64_t value, int64_t divisor)
+        {
+            return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+        }
+
+        int YearOf(int64_t day)
+        {
+            using namespace std::chrono;
+            return static_cast<int>(year_month_day{sys_days{days{day}}}.year());
+        }
+
+        int64_t DayOf(int year, std::chrono::month month, std::chrono::day day)
+        {
+            using namespace std::chrono;
+            return sys_days{std::chrono::year{year} / month / day}.time_since_epoch().count();
+        }
+
+        void MarkHolidays(CalendarDayTable& table, std::string const& calendar_name, int64_t last_day)
+        {
+            using namespace epoch_frame;
+            try
+            {
+                auto holiday_cal = calendar::getHolidayCalendar(calendar_name);
+                auto holidays = holiday_cal->holidays(DateTime(table.firstDay * kNanosPerDay),
+                                                      DateTime(last_day * kNanosPerDay));
+                if (!holidays)
+                {
+                    return;
+                }
+                for (const auto timestamp : holidays->to_vector<int64_t>())
+                {
+                    const int64_t row = table.Row(FloorDiv(timestamp, kNanosPerDay));
+                    if (row >= 0 && row < static_cast<int64_t>(table.size()))
+                    {
+                        table.isHoliday[row] = 1;
+                    }
+                }
+            }
+            catch (std::exception const& e)
+            {
+                // Unknown calendars leave every day a non-holiday, as before
+                SPDLOG_WARN("Holiday calendar {} unavailable: {}", calendar_name, e.what());
+            }
+        }
+
+        std::shared_ptr<const CalendarDayTable> BuildTable(std::string const& calendar,
+                                                           int first_year,
+                                                           int last_year)
+        {
+            using namespace std::chrono;
+            auto table = std::make_shared<CalendarDayTable>();
+            table->firstDay = DayOf(first_year, January, day{1});
+            const int64_t last_day = DayOf(last_year, December, day{31});
+            const size_t N = static_cast<size_t>(last_day - table->firstDay + 1);
+
+            table->monthKey.resize(N);
+            table->dayOfMonth.resize(N);
+            table->weekday.resize(N);
+            table->isHoliday.assign(N, 0);
+            table->tradingOrdinal.resize(N);
+            table->prevHoliday.resize(N);
+            table->nextHoliday.resize(N);
+            table->monthFirst.resize(N);
+            table->monthLast.resize(N);
+
+            for (size_t r = 0; r < N; ++r)
+            {
+                const sys_days date{days{table->firstDay + static_cast<int64_t>(r)}};
+                const year_month_day ymd{date};
+                table->monthKey[r] = static_cast<int>(ymd.year()) * 12 +
+                                     static_cast<int>(static_cast<unsigned>(ymd.month())) - 1;
+                table->dayOfMonth[r] = static_cast<uint8_t>(static_cast<unsigned>(ymd.day()));
+                table->weekday[r] = static_cast<uint8_t>(weekday{date}.iso_encoding() - 1);
+            }
+
+            if (!calendar.empty())
+            {
+                MarkHolidays(*table, calendar, last_day);
+            }
+
+            int32_t ordinal = 0;
+            int32_t previous = CalendarDayTable::kNoHoliday;
+            for (size_t r = 0; r < N; ++r)
+            {
+                table->tradingOrdinal[r] = ordinal;
+                if (table->isHoliday[r])
+                {
+                    previous = ordinal;
+                }
+                table->prevHoliday[r] = previous;
+                ordinal += table->IsTradingDay(r) ? 1 : 0;
+            }
+
+            int32_t next = CalendarDayTable::kNoHoliday;
+            for (size_t r = N; r-- > 0;)
+            {
+                if (table->isHoliday[r])
+                {
+                    next = table->tradingOrdinal[r];
+                }
+                table->nextHoliday[r] = next;
+            }
+
+            // Month boundaries: every month has at least one weekday, and
+            // ordinals of the month's trading days run from the ordinal of its
+            // first day to the ordinal of the next month's first day minus one.
+            for (size_t begin = 0; begin < N;)
+            {
+                size_t end = begin;
+                while (end < N && table->monthKey[end] == table->monthKey[begin])
+                {
+                    ++end;
+                }
+                const int32_t first = table->tradingOrdinal[begin];
+                const int32_t last = table->tradingOrdinal[end - 1] + (table->IsTradingDay(end - 1) ? 1 : 0) - 1;
+                std::fill(table->monthFirst.begin() + begin, table->monthFirst.begin() + end, first);
+                std::fill(table->monthLast.begin() + begin, table->monthLast.begin() + end, last);
+                begin = end;
+            }
+
+            return table;
+        }
+    } // namespace
+
+    std::shared_ptr<const CalendarDayTable> CalendarDayTableCache::Get(std::string const& calendar,
+                                                                       int64_t first_day,
+                                                                       int64_t last_day)
+    {
+        const auto key = std::make_tuple(calendar, YearOf(first_day) - 1, YearOf(last_day) + 1);
+        {
+            std::lock_guard lock(m_mutex);
+            if (auto it = m_tables.find(key); it != m_tables.end())
+            {
+                return it->second;
+            }
+        }
+
+        // Built outside the lock so other calendars are not held up; a racing
+        // build of the same key is identical and the first one stored wins.
+        auto table = BuildTable(calendar, std::get<1>(key), std::get<2>(key));
+        std::lock_guard lock(m_mutex);
+        return m_tables.try_emplace(key, std::move(table)).first->second;
+    }
+
+    std::vector<int64_t> LocalDays(epoch_frame::IndexPtr const& index)
+    {
+        auto array = index->array().value();
+        const auto type = std::static_pointer_cast<arrow::TimestampType>(array->type());
+        if (!type->timezone().empty() && type->timezone() != "UTC")
+        {
+            array = epoch_frame::AssertArrayResultIsOk(
+                arrow::compute::CallFunction("local_timestamp", {array}));
+        }
+
+        int64_t units_per_day = kNanosPerDay;
+        switch (type->unit())
+        {
+            case arrow::TimeUnit::SECOND: units_per_day /= 1'000'000'000; break;
+            case arrow::TimeUnit::MILLI: units_per_day /= 1'000'000; break;
+            case arrow::TimeUnit::MICRO: units_per_day /= 1'000; break;
+            case arrow::TimeUnit::NANO: break;
+        }
+
+        const auto timestamps = std::static_pointer_cast<arrow::TimestampArray>(array);
+        std::vector<int64_t> days(timestamps->length());
+        for (int64_t i = 0; i < timestamps->length(); ++i)
+        {
+            days[i] = FloorDiv(timestamps->Value(i), units_per_day);
+        }
+        return days;
+    }
+
+} // namespace epoch_script::transform
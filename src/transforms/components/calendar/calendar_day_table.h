@@ -0,0 +1,112 @@
+#pragma once
+//
+// Per-calendar day tables shared by the calendar effect transforms
+//
+
+#include <epoch_frame/index.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace epoch_script::transform
+{
+    constexpr int64_t kNanosPerDay = 86'400'000'000'000;
+
+    /**
+     * @brief Calendar attributes for every day of a span of whole years
+     *
+     * Rows are indexed by (day - firstDay), where day counts days since the
+     * Unix epoch. A trading day is a weekday that is not a holiday of the
+     * table's holiday calendar; holiday proximity is expressed in trading
+     * days through tradingOrdinal.
+     */
+    struct CalendarDayTable
+    {
+        static constexpr int32_t kNoHoliday = std::numeric_limits<int32_t>::min() / 2;
+
+        int64_t firstDay{0};
+        std::vector<int32_t> monthKey;       // year * 12 + (month - 1)
+        std::vector<uint8_t> dayOfMonth;     // 1-31
+        std::vector<uint8_t> weekday;        // 0 = Monday ... 6 = Sunday
+        std::vector<uint8_t> isHoliday;
+        std::vector<int32_t> tradingOrdinal; // trading days strictly before the day
+        std::vector<int32_t> prevHoliday;    // ordinal of the last holiday on or before the day
+        std::vector<int32_t> nextHoliday;    // ordinal of the first holiday on or after the day
+        std::vector<int32_t> monthFirst;     // ordinal of the first trading day of the day's month
+        std::vector<int32_t> monthLast;      // ordinal of the last trading day of the day's month
+
+        size_t size() const { return monthKey.size(); }
+
+        int64_t Row(int64_t day) const { return day - firstDay; }
+
+        uint8_t Month(size_t row) const { return static_cast<uint8_t>(monthKey[row] % 12 + 1); }
+        uint8_t Quarter(size_t row) const { return static_cast<uint8_t>(monthKey[row] % 12 / 3 + 1); }
+
+        bool IsTradingDay(size_t row) const { return weekday[row] < 5 && !isHoliday[row]; }
+
+        // True when the trading day is among the last days_before or the first
+        // days_after trading days of its month.
+        bool TurnOfMonth(size_t row, int64_t days_before, int64_t days_after) const
+        {
+            if (!IsTradingDay(row))
+            {
+                return false;
+            }
+            const int64_t ordinal = tradingOrdinal[row];
+            return monthLast[row] - ordinal < days_before || ordinal - monthFirst[row] < days_after;
+        }
+
+        // True when the trading day lies within days_before trading days ahead
+        // of a holiday or days_after trading days behind one.
+        bool NearHoliday(size_t row, int64_t days_before, int64_t days_after) const
+        {
+            if (!IsTradingDay(row))
+            {
+                return false;
+            }
+            const int64_t ordinal = tradingOrdinal[row];
+            return (nextHoliday[row] != kNoHoliday && nextHoliday[row] - ordinal <= days_before) ||
+                   (prevHoliday[row] != kNoHoliday && ordinal - prevHoliday[row] + 1 <= days_after);
+        }
+    };
+
+    /**
+     * @brief Memoized CalendarDayTable per (holiday calendar, year span)
+     *
+     * Every asset on the same calendar over the same years shares one table, so
+     * holidays are generated once per exchange instead of per asset and per
+     * bar. An empty calendar name builds a table without holidays.
+     */
+    class CalendarDayTableCache
+    {
+      public:
+        static CalendarDayTableCache& Instance()
+        {
+            static CalendarDayTableCache cache;
+            return cache;
+        }
+
+        // Table covering [first_day, last_day] plus a year either side, so
+        // holiday proximity near the range ends is not cut off.
+        std::shared_ptr<const CalendarDayTable> Get(std::string const& calendar,
+                                                    int64_t first_day,
+                                                    int64_t last_day);
+
+      private:
+        CalendarDayTableCache() = default;
+
+        std::mutex m_mutex;
+        std::map<std::tuple<std::string, int, int>, std::shared_ptr<const CalendarDayTable>> m_tables;
+    };
+
+    // Local calendar day (days since the epoch) of every timestamp in the
+    // index; tz-aware indexes are converted to wall-clock time first.
+    std::vector<int64_t> LocalDays(epoch_frame::IndexPtr const& index);
+
+} // namespace epoch_script::transform
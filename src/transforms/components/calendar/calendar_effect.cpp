@@ -3,10 +3,8 @@
 //
 
 #include "calendar_effect.h"
-#include <arrow/compute/api.h>
-#include <epoch_frame/calendar_common.h>
-#include <epoch_frame/scalar.h>
-#include <methods/temporal.h>
+#include "calendar_day_table.h"
+#include <algorithm>
 #include <unordered_map>
 
 namespace epoch_script::transform
@@ -47,6 +45,29 @@ namespace epoch_script::transform
             auto it = week_map.find(week);
             return (it != week_map.end()) ? it->second : 1;
         }
+
+        // Evaluates predicate(table, row) for every bar, where row is the bar's
+        // local day in the shared day table of the given holiday calendar
+        template <typename Predicate>
+        epoch_frame::Series CalendarMask(const epoch_frame::DataFrame& bars,
+                                         const std::string& calendar,
+                                         Predicate&& predicate)
+        {
+            using namespace epoch_frame;
+
+            std::vector<bool> mask_data(bars.size(), false);
+            if (bars.size() != 0)
+            {
+                const auto days = LocalDays(bars.index());
+                const auto [first_day, last_day] = std::ranges::minmax(days);
+                const auto table = CalendarDayTableCache::Instance().Get(calendar, first_day, last_day);
+                for (size_t i = 0; i < days.size(); ++i)
+                {
+                    mask_data[i] = predicate(*table, static_cast<size_t>(table->Row(days[i])));
+                }
+            }
+            return Series(bars.index(), factory::array::make_array(mask_data));
+        }
     }
 
     template <epoch_core::CalendarEffectType effect_type>
@@ -129,199 +150,60 @@ namespace epoch_script::transform
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyTurnOfMonth(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Extract day of month using TemporalOperation
-        TemporalOperation<true> temporal(bars.index()->array());
-        auto day_array = temporal.day();
-        Series day_series(bars.index(), day_array.as_chunked_array());
-
-        // Extract month to detect month boundaries
-        auto month_array = temporal.month();
-        Series month_series(bars.index(), month_array.as_chunked_array());
-
-        // Shift month forward by 1 to find next month
-        auto next_month = month_series.shift(-1);
-
-        // Days before end of month: check if month changes in next row
-        auto is_near_end = (month_series != next_month);
-
-        // For days_before, we need last N days of month
-        // Create rolling window to check if we're in last N days
-        Series mask = Series(bars.index(),
-                             factory::array::make_array(std::vector<bool>(bars.size(), false)));
-
-        if (m_days_before > 0)
-        {
-            // Mark last m_days_before days of each month
-            for (int64_t i = 1; i <= m_days_before && i < static_cast<int64_t>(bars.size()); ++i)
-            {
-                auto shifted_month_change = is_near_end.shift(i);
-                mask = mask || shifted_month_change;
-            }
-        }
-
-        if (m_days_after > 0)
-        {
-            // Mark first m_days_after days of each month
-            auto prev_month = month_series.shift(1);
-            auto is_month_start = (month_series != prev_month);
-
-            for (int64_t i = 0; i < m_days_after && i < static_cast<int64_t>(bars.size()); ++i)
-            {
-                auto shifted_month_start = is_month_start.shift(-i);
-                mask = mask || shifted_month_start;
-            }
-        }
-
-        return mask;
+        // Trading days are weekdays; month ends come from the calendar rather
+        // than from later bars, so the mask never looks ahead
+        return CalendarMask(bars, "", [&](const CalendarDayTable& table, size_t row) {
+            return table.TurnOfMonth(row, m_days_before, m_days_after);
+        });
     }
 
     template <epoch_core::CalendarEffectType effect_type>
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyDayOfWeek(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Extract day of week (0=Monday, 6=Sunday by default with ISO calendar)
-        arrow::compute::DayOfWeekOptions dow_options;
-        dow_options.count_from_zero = true;     // 0-6 instead of 1-7
-        dow_options.week_start = 1;             // Monday = 1 (ISO standard)
-
-        TemporalOperation<true> temporal(bars.index()->array());
-        auto dow_array = temporal.day_of_week(dow_options);
-        Series dow_series(bars.index(), dow_array.as_chunked_array());
-
-        // Create mask for target weekday
-        auto mask = (dow_series == Scalar(MakeScalar(static_cast<int64_t>(m_target_value))));
-
-        return mask;
+        // 0=Monday ... 6=Sunday
+        return CalendarMask(bars, "", [&](const CalendarDayTable& table, size_t row) {
+            return table.weekday[row] == m_target_value;
+        });
     }
 
     template <epoch_core::CalendarEffectType effect_type>
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyMonthOfYear(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Extract month (1-12)
-        TemporalOperation<true> temporal(bars.index()->array());
-        auto month_array = temporal.month();
-        Series month_series(bars.index(), month_array.as_chunked_array());
-
-        // Create mask for target month
-        auto mask = (month_series == Scalar(MakeScalar(static_cast<int64_t>(m_target_value))));
-
-        return mask;
+        return CalendarMask(bars, "", [&](const CalendarDayTable& table, size_t row) {
+            return table.Month(row) == m_target_value;
+        });
     }
 
     template <epoch_core::CalendarEffectType effect_type>
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyQuarter(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Extract quarter (1-4)
-        TemporalOperation<true> temporal(bars.index()->array());
-        auto quarter_array = temporal.quarter();
-        Series quarter_series(bars.index(), quarter_array.as_chunked_array());
-
-        // Create mask for target quarter
-        auto mask = (quarter_series == Scalar(MakeScalar(static_cast<int64_t>(m_target_value))));
-
-        return mask;
+        return CalendarMask(bars, "", [&](const CalendarDayTable& table, size_t row) {
+            return table.Quarter(row) == m_target_value;
+        });
     }
 
     template <epoch_core::CalendarEffectType effect_type>
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyHoliday(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Initialize mask with all false
-        std::vector<bool> mask_data(bars.size(), false);
-
-        try {
-            // Get the holiday calendar from registry
-            auto holiday_cal = calendar::getHolidayCalendar(m_country);
-
-            // Get the date range from the index
-            if (bars.size() == 0) {
-                return Series(bars.index(),
-                             factory::array::make_array(mask_data));
-            }
-
-            // Extract start and end dates from index
-            auto first_ts = bars.index()->at(0);
-            auto last_ts = bars.index()->at(bars.size() - 1);
-
-            // Convert scalars to DateTime
-            auto first_val = first_ts.value<int64_t>();
-            auto last_val = last_ts.value<int64_t>();
-            if (!first_val || !last_val) {
-                return Series(bars.index(), factory::array::make_array(mask_data));
-            }
-            auto start_dt = DateTime(first_val.value());
-            auto end_dt = DateTime(last_val.value());
-
-            // Get holidays in this date range
-            auto holidays_index = holiday_cal->holidays(start_dt, end_dt);
-
-            if (holidays_index && holidays_index->size() > 0) {
-                // Convert holidays to a set for fast lookup
-                auto holidays_vec = holidays_index->to_vector<int64_t>();
-                std::unordered_set<int64_t> holiday_set(holidays_vec.begin(), holidays_vec.end());
-
-                // Mark days before/after holidays
-                for (size_t i = 0; i < bars.size(); ++i) {
-                    auto bar_ts = bars.index()->at(i);
-                    auto bar_time_opt = bar_ts.value<int64_t>();
-                    if (!bar_time_opt) continue;
-                    auto bar_time = bar_time_opt.value();
-
-                    // Check if this bar is within the window around any holiday
-                    for (int64_t offset = -m_days_before; offset <= m_days_after; ++offset) {
-                        if (offset == 0) continue;  // Skip the holiday itself
-
-                        // Calculate the offset timestamp
-                        int64_t offset_ts = bar_time + (offset * 86400000000000LL); // nanoseconds in a day
-
-                        // Check if this offset lands on a holiday
-                        if (holiday_set.count(offset_ts) > 0) {
-                            mask_data[i] = true;
-                            break;
-                        }
-                    }
-                }
-            }
-        } catch (const std::exception& e) {
-            // If calendar not found or other error, return all false
-            // This allows the transform to work even without a registered calendar
-        }
-
-        auto mask = Series(bars.index(), factory::array::make_array(mask_data));
-
-        return mask;
+        // Days before/after are counted in trading days of m_country's calendar
+        return CalendarMask(bars, m_country, [&](const CalendarDayTable& table, size_t row) {
+            return table.NearHoliday(row, m_days_before, m_days_after);
+        });
     }
 
     template <epoch_core::CalendarEffectType effect_type>
     epoch_frame::Series
     CalendarEffect<effect_type>::ApplyWeekOfMonth(const epoch_frame::DataFrame& bars) const
     {
-        using namespace epoch_frame;
-
-        // Extract day of month
-        TemporalOperation<true> temporal(bars.index()->array());
-        auto day_array = temporal.day();
-        Series day_series(bars.index(), day_array.as_chunked_array());
-
-        // Calculate week of month (1-5): week = ceil(day / 7)
-        auto week_of_month = ((day_series - Scalar(MakeScalar(1.0))) / Scalar(MakeScalar(7.0))).ceil() + Scalar(MakeScalar(1.0));
-
-        // Create mask for target week
-        auto mask = (week_of_month == Scalar(MakeScalar(static_cast<int64_t>(m_target_value))));
-
-        return mask;
+        // Week of month (1-5): days 1-7 are week 1, days 29-31 week 5
+        // (ceil(day / 7))
+        return CalendarMask(bars, "", [&](const CalendarDayTable& table, size_t row) {
+            return (table.dayOfMonth[row] - 1) / 7 + 1 == m_target_value;
+        });
     }
 
     // Explicit template instantiations
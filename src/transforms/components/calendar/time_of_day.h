@@ -44,19 +44,15 @@ public:
     const auto high_arr = bars[C.HIGH()].contiguous_array();
     const auto low_arr = bars[C.LOW()].contiguous_array();
 
-    // Get UTC index
-    auto index = bars.index();
-    auto utcIndex = index->tz_localize("UTC");
-
-    // Build active/opened/closed masks using existing utility
-    auto state = sessions_utils::BuildActiveMaskUTC(utcIndex, m_range);
+    // Shared active/opened/closed masks for this index and range
+    const auto masks = sessions_utils::GetSessionMasks(bars.index(), m_range);
 
     // Calculate period high/low (same logic as sessions)
     std::vector<double> high(bars.size());
     std::vector<double> low(bars.size());
 
     for (size_t i = 0; i < bars.size(); ++i) {
-      if (state.active[i]) {
+      if (masks->active->Value(i)) {
         high[i] = std::max(high_arr[i].as_double(), i > 0 ? high[i - 1] : 0);
         low[i] = std::min(low_arr[i].as_double(),
                           (i > 0 && low[i - 1] != 0)
@@ -76,9 +72,9 @@ public:
 
     return AssertTableResultIsOk(arrow::Table::Make(
         schema,
-        {factory::array::make_array(state.active),
-         factory::array::make_array(state.opened),
-         factory::array::make_array(state.closed),
+        {std::make_shared<arrow::ChunkedArray>(masks->active),
+         std::make_shared<arrow::ChunkedArray>(masks->opened),
+         std::make_shared<arrow::ChunkedArray>(masks->closed),
          factory::array::make_array(high),
          factory::array::make_array(low)}));
   }
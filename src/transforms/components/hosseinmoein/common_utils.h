@@ -9,7 +9,13 @@
 #include <epoch_frame/dataframe.h>
 #include <epoch_frame/index.h>
 #include <epoch_frame/series.h>
+#include "epoch_frame/common.h"
+#include <arrow/builder.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <limits>
 #include <span>
+#include <vector>
 
 namespace epoch_script::transform {
 template <typename T = double> class SeriesSpan {
@@ -132,6 +138,55 @@ void run_visit(auto const &df, auto &visitor, auto const &arg0,
   visitor.post();
 }
 
+// Runs `visitor` over rows [begin, end) of raw index/value spans, so rolling
+// transforms can visit each window without materializing a Series for it.
+void run_visit_rows(std::span<const int64_t> index, auto &visitor,
+                    std::span<const double> values, size_t begin,
+                    size_t end) {
+  visitor.pre();
+  visitor(index.begin() + begin, index.begin() + end, values.begin() + begin,
+          values.begin() + end);
+  visitor.post();
+}
+
+// Double column holding values[first, n) after `first` nulls.
+inline arrow::ChunkedArrayPtr NullPrefixedColumn(std::vector<double> const &values,
+                                                 size_t first) {
+  const size_t n = values.size();
+  first = std::min(first, n);
+  arrow::DoubleBuilder builder;
+  epoch_frame::AssertStatusIsOk(builder.Reserve(n));
+  epoch_frame::AssertStatusIsOk(builder.AppendNulls(first));
+  epoch_frame::AssertStatusIsOk(
+      builder.AppendValues(values.data() + first, n - first));
+  return std::make_shared<arrow::ChunkedArray>(
+      epoch_frame::AssertResultIsOk(builder.Finish()));
+}
+
+// Evaluates `compute(row)` for rows [first, n) in parallel and returns the
+// results as a double column that is null before `first`. With stride > 1
+// only every stride-th row from `first` is computed; the rows in between
+// repeat the last computed value.
+template <typename Compute>
+arrow::ChunkedArrayPtr StridedRowApply(size_t n, size_t first, size_t stride,
+                                       Compute const &compute) {
+  first = std::min(first, n);
+  stride = std::max<size_t>(stride, 1);
+
+  std::vector<double> values(n, std::numeric_limits<double>::quiet_NaN());
+  const size_t slots = (n - first + stride - 1) / stride;
+  tbb::parallel_for(size_t{0}, slots, [&](size_t slot) {
+    const size_t row = first + slot * stride;
+    values[row] = compute(row);
+  });
+  for (size_t row = first; row < n; ++row) {
+    if ((row - first) % stride != 0) {
+      values[row] = values[row - 1];
+    }
+  }
+  return NullPrefixedColumn(values, first);
+}
+
 template <class Visitor, class... Spans>
 class SingleResultHMDFTransform : public ITransform {
 public:
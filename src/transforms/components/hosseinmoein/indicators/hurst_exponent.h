@@ -5,42 +5,91 @@
 #pragma once
 #include "../common_utils.h"
 #include <epoch_script/transforms/core/itransform.h>
-#include <DataFrame/DataFrameFinancialVisitors.h>
+#include "../statistics/rolling_moments.h"
+#include "rescaled_range.h"
 #include <epoch_frame/factory/dataframe_factory.h>
 
+#include <array>
+#include <cmath>
+#include <vector>
+
 using namespace epoch_frame;
 
 namespace epoch_script::transform {
+// R/S Hurst exponent of hmdf::HurstExponentVisitor: each "range" r splits
+// the window into r chunks of size / r rows, and the exponent is the slope
+// of log(mean chunk R/S) over log(chunk size). Chunk R/S values come from a
+// RescaledRange built once per column, so a row costs O(ranges) lookups
+// instead of a visitor pass over its whole window.
+
+// Hurst exponent over the expanding history. The chunks of range r only
+// move when size / r changes, so the mean R/S is tabulated once per
+// (range, chunk size): N R/S queries per range in total.
 class HurstExponent final : public ITransform {
 public:
   explicit HurstExponent(const TransformConfiguration &config)
       : ITransform(config),
-        m_min_window(config.GetOptionValue("min_period").GetInteger()) {}
+        m_min_window(config.GetOptionValue("min_period").GetInteger()),
+        m_stride(config
+                     .GetOptionValue("stride",
+                                     epoch_script::MetaDataOptionDefinition{1.0})
+                     .GetInteger()) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
-    const auto series =
-        df[GetInputId()]
-            .expanding_apply({.min_periods = static_cast<double>(m_min_window)})
-            .apply([&](Series const &x) {
-              hmdf::HurstExponentVisitor<double> visitor({1, 2, 4, 8});
-              const SeriesSpan span{x};
-              run_visit(x, visitor, span);
-              return Scalar{visitor.get_result()};
-            });
-
-    return series.to_frame(GetOutputId("result"));
+    const DoubleValues values{df[GetInputId()]};
+    const RescaledRange rescaledRange{values.values()};
+    const size_t n = rescaledRange.size();
+
+    // meanRS[r][c]: mean R/S of the r chunks of size c starting at row 0.
+    std::vector<std::vector<double>> meanRS(kRanges.size());
+    for (size_t i = 0; i < kRanges.size(); ++i) {
+      const size_t range = kRanges[i];
+      meanRS[i].resize(n / range + 1);
+      tbb::parallel_for(size_t{0}, meanRS[i].size(), [&, i](size_t size) {
+        double total = 0;
+        for (size_t chunk = 0; chunk < range; ++chunk) {
+          total += rescaledRange(chunk * size, (chunk + 1) * size);
+        }
+        meanRS[i][size] = total / range;
+      });
+    }
+
+    const auto first = static_cast<size_t>(std::max<int64_t>(m_min_window, 1) - 1);
+    auto result = StridedRowApply(
+        n, first, static_cast<size_t>(m_stride), [&](size_t row) {
+          std::array<double, kRanges.size()> logSize{};
+          std::array<double, kRanges.size()> logRS{};
+          for (size_t i = 0; i < kRanges.size(); ++i) {
+            const size_t size = (row + 1) / kRanges[i];
+            logSize[i] = std::log(static_cast<double>(size));
+            logRS[i] = std::log(meanRS[i][size]);
+          }
+          return HurstSlope(logSize, logRS);
+        });
+
+    return make_dataframe(df.index(), {result}, {GetOutputId("result")});
   }
 
 private:
+  static constexpr std::array<size_t, 4> kRanges{1, 2, 4, 8};
+
   int64_t m_min_window;
+  int64_t m_stride;
 };
 
+// Hurst exponent over a rolling window. The chunk size of every range is
+// fixed, so the R/S of each chunk start is computed once and shared by the r
+// windows that contain that chunk.
 class RollingHurstExponent final : public ITransform {
 public:
   explicit RollingHurstExponent(const TransformConfiguration &config)
       : ITransform(config),
         m_window(config.GetOptionValue("window").GetInteger()),
+        m_stride(config
+                     .GetOptionValue("stride",
+                                     epoch_script::MetaDataOptionDefinition{1.0})
+                     .GetInteger()),
         m_lagGrid(lagGrid(m_window)) {
     if (m_lagGrid.empty()) {
       SPDLOG_WARN("No lag grid found for window size {}", m_window);
@@ -50,25 +99,50 @@ public:
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
-    const auto series =
-        df[GetInputId()]
-            .rolling_apply({.window_size = m_window})
-            .apply([&](Series const &x) {
-              auto lagGrid = m_lagGrid;
-              hmdf::HurstExponentVisitor<double> visitor{std::move(lagGrid)};
-              const SeriesSpan<> span{x};
-              run_visit(x, visitor, span);
-              return Scalar{visitor.get_result()};
-            });
-
-    return series.to_frame(GetOutputId("result"));
+    const DoubleValues values{df[GetInputId()]};
+    const RescaledRange rescaledRange{values.values()};
+    const size_t n = rescaledRange.size();
+    const auto window = static_cast<size_t>(m_window);
+
+    // chunkRS[i][b]: R/S of the chunk of range m_lagGrid[i] starting at b.
+    std::vector<std::vector<double>> chunkRS(m_lagGrid.size());
+    for (size_t i = 0; i < m_lagGrid.size(); ++i) {
+      const size_t size = window / m_lagGrid[i];
+      chunkRS[i].resize(n >= size ? n - size + 1 : 0);
+      tbb::parallel_for(size_t{0}, chunkRS[i].size(), [&, i, size](size_t b) {
+        chunkRS[i][b] = rescaledRange(b, b + size);
+      });
+    }
+
+    std::vector<double> logSize(m_lagGrid.size());
+    for (size_t i = 0; i < m_lagGrid.size(); ++i) {
+      logSize[i] = std::log(static_cast<double>(window / m_lagGrid[i]));
+    }
+
+    auto result = StridedRowApply(
+        n, window - 1, static_cast<size_t>(m_stride), [&](size_t row) {
+          const size_t start = row + 1 - window;
+          std::vector<double> logRS(m_lagGrid.size());
+          for (size_t i = 0; i < m_lagGrid.size(); ++i) {
+            const size_t range = m_lagGrid[i];
+            const size_t size = window / range;
+            double total = 0;
+            for (size_t chunk = 0; chunk < range; ++chunk) {
+              total += chunkRS[i][start + chunk * size];
+            }
+            logRS[i] = std::log(total / range);
+          }
+          return HurstSlope(logSize, logRS);
+        });
+
+    return make_dataframe(df.index(), {result}, {GetOutputId("result")});
   }
 
-  static hmdf::HurstExponentVisitor<double>::RangeVec
+  static std::vector<size_t>
   lagGrid(ino64_t w, int64_t base = 2, double maxFrac = 0.25) {
     const auto maxLag = static_cast<int64_t>(std::ceil(w * maxFrac));
     const auto kMax = static_cast<int64_t>(std::log(maxLag) / std::log(base));
-    hmdf::HurstExponentVisitor<double>::RangeVec result;
+    std::vector<size_t> result;
     result.reserve(kMax);
     for (int64_t i = 0; i < kMax; ++i) {
       result.emplace_back(std::pow(base, i));
@@ -78,6 +152,7 @@ public:
 
 private:
   int64_t m_window;
-  hmdf::HurstExponentVisitor<double>::RangeVec m_lagGrid;
+  int64_t m_stride;
+  std::vector<size_t> m_lagGrid;
 };
-} // namespace epoch_script::transform
\ No newline at end of file
+} // namespace epoch_script::transform
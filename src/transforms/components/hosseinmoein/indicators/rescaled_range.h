@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace epoch_script::transform {
+
+// Rescaled range (R/S) of any chunk [begin, end) of a series in
+// O(log² N), as computed by hmdf::HurstExponentVisitor for one chunk:
+//
+//   R/S = (max_k Y_k - min_k Y_k) / stdev,  Y_k = Σ_{b<=i<k} (x_i - mean)
+//
+// Mean and (sample) stdev come from prefix sums. With P_k the prefix sum of
+// x, Y_k = P_k - P_b - (k - b)·mean, so max/min of Y over the chunk are
+// max/min of P_k - k·mean: the mean-slope line touching the upper/lower
+// convex hull of the points (k, P_k). A segment tree stores the hulls of
+// its nodes, and a chunk query binary-searches the O(log N) hulls covering
+// it. Chunks holding a NaN have no R/S (NaN).
+class RescaledRange {
+public:
+  explicit RescaledRange(std::span<const double> values)
+      : m_size(values.size()) {
+    // Centring on the first finite value keeps the prefix sums small.
+    const auto first = std::ranges::find_if(
+        values, [](double v) { return !std::isnan(v); });
+    const double ref = first == values.end() ? 0.0 : *first;
+
+    m_sum.resize(m_size + 1, 0);
+    m_sumSq.resize(m_size + 1, 0);
+    m_nanCount.resize(m_size + 1, 0);
+    for (size_t i = 0; i < m_size; ++i) {
+      const bool nan = std::isnan(values[i]);
+      const long double v = nan ? 0.0L : values[i] - ref;
+      m_sum[i + 1] = m_sum[i] + v;
+      m_sumSq[i + 1] = m_sumSq[i] + v * v;
+      m_nanCount[i + 1] = m_nanCount[i] + (nan ? 1 : 0);
+    }
+    BuildHulls();
+  }
+
+  size_t size() const { return m_size; }
+
+  double operator()(size_t begin, size_t end) const {
+    const size_t n = end - begin;
+    if (end > m_size || n < 2 || m_nanCount[end] != m_nanCount[begin]) {
+      return kNaN;
+    }
+    const long double sum = m_sum[end] - m_sum[begin];
+    const long double mean = sum / n;
+    const long double m2 = m_sumSq[end] - m_sumSq[begin] - sum * mean;
+    const long double stdev = std::sqrt(std::max(m2, 0.0L) / (n - 1));
+
+    // Points begin..end: Y_begin = Y_end = 0, so including begin is harmless.
+    long double high = -std::numeric_limits<long double>::infinity();
+    long double low = std::numeric_limits<long double>::infinity();
+    VisitNodes(begin, end + 1, [&](size_t node) {
+      high = std::max(high, Extreme(m_upper, node, mean, std::greater<>{}));
+      low = std::min(low, Extreme(m_lower, node, mean, std::less<>{}));
+    });
+    return static_cast<double>((high - low) / stdev);
+  }
+
+private:
+  static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+  // Hull vertices of every tree node, concatenated; node i owns
+  // [offsets[i], offsets[i + 1]).
+  struct Hulls {
+    std::vector<uint32_t> vertices;
+    std::vector<size_t> offsets;
+  };
+
+  long double Value(uint32_t k, long double slope) const {
+    return m_sum[k] - slope * k;
+  }
+
+  // True when b turns the chain a->b->c the wrong way for the hull kept by
+  // `keep` (upper: slopes must fall, lower: slopes must rise).
+  template <typename Keep>
+  bool Redundant(uint32_t a, uint32_t b, uint32_t c, Keep keep) const {
+    const long double lhs = (m_sum[b] - m_sum[a]) * (c - b);
+    const long double rhs = (m_sum[c] - m_sum[b]) * (b - a);
+    return !keep(lhs, rhs);
+  }
+
+  // Monotone chain over points [lo, hi); x is already sorted.
+  template <typename Keep>
+  void AppendHull(Hulls &hulls, size_t lo, size_t hi, Keep keep) const {
+    const size_t base = hulls.vertices.size();
+    for (size_t k = lo; k < hi; ++k) {
+      while (hulls.vertices.size() >= base + 2 &&
+             Redundant(hulls.vertices[hulls.vertices.size() - 2],
+                       hulls.vertices.back(), static_cast<uint32_t>(k),
+                       keep)) {
+        hulls.vertices.pop_back();
+      }
+      hulls.vertices.push_back(static_cast<uint32_t>(k));
+    }
+    hulls.offsets.push_back(hulls.vertices.size());
+  }
+
+  void BuildHulls() {
+    const size_t points = m_size + 1;
+    m_leaves = 1;
+    while (m_leaves < points) {
+      m_leaves <<= 1;
+    }
+    for (Hulls *hulls : {&m_upper, &m_lower}) {
+      hulls->offsets.assign(1, 0);
+    }
+    // Node i covers points [lo, hi) of a perfect tree with m_leaves leaves.
+    for (size_t node = 1; node < 2 * m_leaves; ++node) {
+      size_t width = m_leaves;
+      size_t first = 1;
+      while (first * 2 <= node) {
+        first *= 2;
+        width /= 2;
+      }
+      const size_t lo = std::min((node - first) * width, points);
+      const size_t hi = std::min(lo + width, points);
+      AppendHull(m_upper, lo, hi, std::greater<>{});
+      AppendHull(m_lower, lo, hi, std::less<>{});
+    }
+  }
+
+  // Calls visit(node) for the canonical nodes covering points [lo, hi).
+  template <typename Visit>
+  void VisitNodes(size_t lo, size_t hi, Visit const &visit) const {
+    for (lo += m_leaves, hi += m_leaves; lo < hi; lo >>= 1, hi >>= 1) {
+      if (lo & 1) {
+        visit(lo++);
+      }
+      if (hi & 1) {
+        visit(--hi);
+      }
+    }
+  }
+
+  // max (greater) / min (less) of P_k - slope·k over one node's hull: the
+  // first vertex whose outgoing edge no longer improves on the line.
+  template <typename Better>
+  long double Extreme(Hulls const &hulls, size_t node, long double slope,
+                      Better better) const {
+    const size_t first = hulls.offsets[node - 1];
+    const size_t last = hulls.offsets[node];
+    if (first == last) {
+      return better(0.0L, 1.0L) ? std::numeric_limits<long double>::infinity()
+                                : -std::numeric_limits<long double>::infinity();
+    }
+    size_t lo = first;
+    size_t hi = last - 1;
+    while (lo < hi) {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (better(Value(hulls.vertices[mid + 1], slope),
+                 Value(hulls.vertices[mid], slope))) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return Value(hulls.vertices[lo], slope);
+  }
+
+  size_t m_size;
+  size_t m_leaves{1};
+  std::vector<long double> m_sum;
+  std::vector<long double> m_sumSq;
+  std::vector<uint32_t> m_nanCount;
+  Hulls m_upper;
+  Hulls m_lower;
+};
+
+// Slope of the least squares line through (log size, log R/S): the Hurst
+// exponent. NaN if any point is missing.
+inline double HurstSlope(std::span<const double> logSize,
+                         std::span<const double> logRescaledRange) {
+  const size_t n = logSize.size();
+  if (n < 2) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  double meanX = 0, meanY = 0;
+  for (size_t i = 0; i < n; ++i) {
+    meanX += logSize[i];
+    meanY += logRescaledRange[i];
+  }
+  meanX /= n;
+  meanY /= n;
+  double sxy = 0, sxx = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sxy += (logSize[i] - meanX) * (logRescaledRange[i] - meanY);
+    sxx += (logSize[i] - meanX) * (logSize[i] - meanX);
+  }
+  return sxy / sxx;
+}
+
+} // namespace epoch_script::transform
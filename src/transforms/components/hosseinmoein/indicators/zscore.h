@@ -4,33 +4,49 @@
 
 #pragma once
 
+#include "../statistics/rolling_moments.h"
 #include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 
+#include <limits>
+#include <vector>
+
 namespace epoch_script::transform {
 
-// Z-Score using hmdf::ZScoreVisitor over a rolling window
+// Rolling z-score of the last value against its window's mean and sample
+// standard deviation, streamed with RollingMoments. A window holding a NaN
+// yields NaN.
 class ZScore final : public ITransform {
 public:
   explicit ZScore(const TransformConfiguration &config)
       : ITransform(config),
-        m_window(config.GetOptionValue("window").GetInteger()) {}
+        m_window(static_cast<size_t>(
+            config.GetOptionValue("window").GetInteger())) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
     using namespace epoch_frame;
-    const auto input = df[GetInputId()];
-    const auto series =
-        input.rolling_apply({.window_size = m_window})
-            .apply([&](Series const &x) {
-              return (x.iloc(-1) - x.mean()) /
-                     x.stddev(arrow::compute::VarianceOptions(1));
-            });
-    return series.to_frame(GetOutputId("result"));
+    const DoubleValues input{df[GetInputId()]};
+    const auto values = input.values();
+
+    std::vector<double> result(df.num_rows(),
+                               std::numeric_limits<double>::quiet_NaN());
+    RollingPairwiseMoments(values, values, m_window,
+                           [&](size_t i, RollingMoments const &moments) {
+                             if (moments.Count() < m_window) {
+                               return;
+                             }
+                             result[i] = (values[i] - moments.MeanX()) /
+                                         std::sqrt(moments.VarX(1));
+                           });
+
+    return make_dataframe(df.index(),
+                          std::vector{factory::array::make_array(result)},
+                          {GetOutputId("result")});
   }
 
 private:
-  int64_t m_window;
+  size_t m_window;
 };
 
 } // namespace epoch_script::transform
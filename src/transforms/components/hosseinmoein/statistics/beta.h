@@ -3,16 +3,12 @@
 //
 
 #pragma once
-#include "../common_utils.h"
-#include "epoch_frame/common.h"
+#include "rolling_moments.h"
 #include "epoch_frame/dataframe.h"
-#include "epoch_frame/datetime.h"
 #include "epoch_frame/factory/dataframe_factory.h"
-#include "epoch_frame/factory/index_factory.h"
-#include "epoch_frame/scalar.h"
 #include <epoch_script/transforms/core/itransform.h>
-#include <DataFrame/DataFrameStatsVisitors.h>
 
+#include <limits>
 #include <vector>
 
 namespace epoch_script::transform {
@@ -26,41 +22,32 @@ class Beta final : public ITransform {
 public:
   explicit Beta(const TransformConfiguration &config)
       : ITransform(config),
-        m_window(config.GetOptionValue("window").GetInteger()) {}
+        m_window(static_cast<size_t>(
+            config.GetOptionValue("window").GetInteger())) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
     using namespace epoch_frame;
 
-    const Series asset_returns = df[GetInputId("asset_returns")];
-    const Series market_returns = df[GetInputId("market_returns")];
-
-    // Calculate rolling beta using BetaVisitor
-    // Beta = Cov(asset, market) / Var(market)
-    const Series beta =
-        asset_returns.rolling_apply({.window_size = m_window})
-            .apply([&](const Series &asset_window) {
-              const Series market_window = market_returns.loc(asset_window.index());
-
-              // Use beta visitor which calculates cov/var internally
-              hmdf::BetaVisitor<double, int64_t> visitor(
-                  false,  // biased = false (use n-1 for sample statistics)
-                  true,   // skip_nan = true
-                  false   // stable_algo = false
-              );
-
-              const SeriesSpan<> asset_span{asset_window};
-              const SeriesSpan<> market_span{market_window};
-              run_visit(asset_window, visitor, asset_span, market_span);
-
-              return Scalar{visitor.get_result()};
-            });
-
-    return beta.to_frame(GetOutputId("beta"));
+    const DoubleValues asset_returns{df[GetInputId("asset_returns")]};
+    const DoubleValues market_returns{df[GetInputId("market_returns")]};
+
+    // Beta = Cov(asset, market) / Var(market), skipping NaN pairs
+    std::vector<double> beta(df.num_rows(),
+                             std::numeric_limits<double>::quiet_NaN());
+    RollingPairwiseMoments(asset_returns.values(), market_returns.values(),
+                           m_window,
+                           [&](size_t i, RollingMoments const &moments) {
+                             beta[i] = moments.BetaXOnY();
+                           });
+
+    return make_dataframe(df.index(),
+                          std::vector{factory::array::make_array(beta)},
+                          {GetOutputId("beta")});
   }
 
 private:
-  int64_t m_window;
+  size_t m_window;
 };
 
 } // namespace epoch_script::transform
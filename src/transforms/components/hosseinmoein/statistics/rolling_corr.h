@@ -3,21 +3,18 @@
 //
 
 #pragma once
-#include "../common_utils.h"
-#include "epoch_frame/common.h"
+#include "rolling_moments.h"
 #include "epoch_frame/dataframe.h"
-#include "epoch_frame/datetime.h"
 #include "epoch_frame/factory/dataframe_factory.h"
-#include "epoch_frame/factory/index_factory.h"
-#include "epoch_frame/scalar.h"
 #include <epoch_script/transforms/core/itransform.h>
-#include <DataFrame/DataFrameStatsVisitors.h>
 
+#include <limits>
 #include <vector>
 
 namespace epoch_script::transform {
 
-// Rolling correlation (Pearson) using HMDF CorrVisitor
+// Rolling correlation (Pearson), streamed over the window with
+// RollingMoments. NaN pairs are skipped.
 // Inputs: x, y
 // Options: window
 // Outputs: correlation
@@ -25,39 +22,30 @@ class RollingCorr final : public ITransform {
 public:
   explicit RollingCorr(const TransformConfiguration &config)
       : ITransform(config),
-        m_window(config.GetOptionValue("window").GetInteger()) {}
+        m_window(static_cast<size_t>(
+            config.GetOptionValue("window").GetInteger())) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
     using namespace epoch_frame;
 
-    const Series x = df[GetInputId("x")];
-    const Series y = df[GetInputId("y")];
+    const DoubleValues x{df[GetInputId("x")]};
+    const DoubleValues y{df[GetInputId("y")]};
 
-    const Series correlation =
-        x.rolling_apply({.window_size = m_window}).apply([&](const Series &xw) {
-          const Series yw = y.loc(xw.index());
+    std::vector<double> correlation(df.num_rows(),
+                                 std::numeric_limits<double>::quiet_NaN());
+    RollingPairwiseMoments(x.values(), y.values(), m_window,
+                           [&](size_t i, RollingMoments const &moments) {
+                             correlation[i] = moments.Corr();
+                           });
 
-          // Use Pearson correlation visitor
-          hmdf::CorrVisitor<double, int64_t> visitor(
-              hmdf::correlation_type::pearson,
-              false,  // biased = false (use n-1 for sample correlation)
-              true,   // skip_nan = true
-              false   // stable_algo = false
-          );
-
-          const SeriesSpan<> xs{xw};
-          const SeriesSpan<> ys{yw};
-          run_visit(xw, visitor, xs, ys);
-
-          return Scalar{visitor.get_result()};
-        });
-
-    return correlation.to_frame(GetOutputId("correlation"));
+    return make_dataframe(df.index(),
+                          std::vector{factory::array::make_array(correlation)},
+                          {GetOutputId("correlation")});
   }
 
 private:
-  int64_t m_window;
+  size_t m_window;
 };
 
 } // namespace epoch_script::transform
@@ -0,0 +1,158 @@
+#pragma once
+#include "epoch_frame/series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace epoch_script::transform {
+
+// Running first and second moments of (x, y) pairs with O(1) add/remove, used
+// by the rolling correlation/covariance/beta/linear-fit/zscore transforms
+// instead of re-running an HMDF visitor over every window.
+//
+// Updates follow Welford's algorithm; Remove is the exact inverse of Add.
+class RollingMoments {
+public:
+  void Add(double x, double y) {
+    ++m_count;
+    const double n = static_cast<double>(m_count);
+    const double dx = x - m_meanX;
+    const double dy = y - m_meanY;
+    m_meanX += dx / n;
+    m_meanY += dy / n;
+    m_m2x += dx * (x - m_meanX);
+    m_m2y += dy * (y - m_meanY);
+    m_cxy += dx * (y - m_meanY);
+  }
+
+  void Remove(double x, double y) {
+    if (m_count <= 1) {
+      Reset();
+      return;
+    }
+    const double n = static_cast<double>(m_count);
+    const double prevMeanX = m_meanX - (x - m_meanX) / (n - 1);
+    const double prevMeanY = m_meanY - (y - m_meanY) / (n - 1);
+    m_m2x -= (x - prevMeanX) * (x - m_meanX);
+    m_m2y -= (y - prevMeanY) * (y - m_meanY);
+    m_cxy -= (x - prevMeanX) * (y - m_meanY);
+    m_meanX = prevMeanX;
+    m_meanY = prevMeanY;
+    --m_count;
+  }
+
+  void Reset() { *this = RollingMoments{}; }
+
+  size_t Count() const { return m_count; }
+  double MeanX() const { return m_meanX; }
+  double MeanY() const { return m_meanY; }
+
+  double VarX(size_t ddof = 1) const { return Normalize(Clamp(m_m2x), ddof); }
+  double VarY(size_t ddof = 1) const { return Normalize(Clamp(m_m2y), ddof); }
+  double Cov(size_t ddof = 1) const { return Normalize(m_cxy, ddof); }
+
+  double Corr() const {
+    if (m_count < 2) {
+      return kNaN;
+    }
+    return m_cxy / std::sqrt(Clamp(m_m2x) * Clamp(m_m2y));
+  }
+
+  // Cov(x, y) / Var(y): beta of x against the benchmark y.
+  double BetaXOnY() const { return m_count < 2 ? kNaN : m_cxy / Clamp(m_m2y); }
+
+  // Least squares fit of y on x.
+  double Slope() const { return m_count < 2 ? kNaN : m_cxy / Clamp(m_m2x); }
+  double Intercept() const { return m_meanY - Slope() * m_meanX; }
+  double SumSquaredResiduals() const {
+    return m_count < 2 ? kNaN : Clamp(m_m2y - m_cxy * m_cxy / Clamp(m_m2x));
+  }
+
+private:
+  static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+  // Add/Remove cancellation can leave a sum of squares slightly negative.
+  static double Clamp(double m2) { return std::max(m2, 0.0); }
+
+  double Normalize(double sum, size_t ddof) const {
+    return m_count > ddof ? sum / static_cast<double>(m_count - ddof) : kNaN;
+  }
+
+  size_t m_count{0};
+  double m_meanX{0}, m_meanY{0};
+  double m_m2x{0}, m_m2y{0}, m_cxy{0};
+};
+
+// Contiguous double values of a series with nulls read as NaN. Borrows the
+// Arrow buffer when the column has no nulls.
+class DoubleValues {
+public:
+  explicit DoubleValues(epoch_frame::Series const &s)
+      : m_array(s.contiguous_array().to_view<double>()) {
+    const auto length = static_cast<size_t>(m_array->length());
+    if (m_array->null_count() == 0) {
+      m_values = {m_array->raw_values(), length};
+      return;
+    }
+    m_filled.resize(length);
+    for (size_t i = 0; i < length; ++i) {
+      m_filled[i] = m_array->IsNull(i)
+                        ? std::numeric_limits<double>::quiet_NaN()
+                        : m_array->Value(i);
+    }
+    m_values = m_filled;
+  }
+
+  std::span<const double> values() const { return m_values; }
+
+private:
+  std::shared_ptr<arrow::DoubleArray> m_array;
+  std::vector<double> m_filled;
+  std::span<const double> m_values;
+};
+
+// Slides a `window`-row window over x/y and calls `emit(i, moments)` for every
+// row i >= window - 1. Pairs where either side is NaN are left out of the
+// moments (HMDF skip_nan semantics); moments.Count() tells callers how many
+// valid pairs the window holds. The moments are rebuilt from the window every
+// `window` rows so Add/Remove rounding error cannot accumulate; this keeps
+// the total cost O(N) regardless of window size.
+template <typename Emit>
+void RollingPairwiseMoments(std::span<const double> x,
+                            std::span<const double> y, size_t window,
+                            Emit &&emit) {
+  const size_t n = std::min(x.size(), y.size());
+  if (window == 0 || n < window) {
+    return;
+  }
+  auto valid = [&](size_t i) { return !std::isnan(x[i]) && !std::isnan(y[i]); };
+
+  RollingMoments moments;
+  for (size_t i = 0; i < window - 1; ++i) {
+    if (valid(i)) {
+      moments.Add(x[i], y[i]);
+    }
+  }
+  for (size_t i = window - 1; i < n; ++i) {
+    const size_t start = i + 1 - window;
+    if (start > 0 && start % window == 0) {
+      moments.Reset();
+      for (size_t j = start; j < i; ++j) {
+        if (valid(j)) {
+          moments.Add(x[j], y[j]);
+        }
+      }
+    } else if (start > 0 && valid(start - 1)) {
+      moments.Remove(x[start - 1], y[start - 1]);
+    }
+    if (valid(i)) {
+      moments.Add(x[i], y[i]);
+    }
+    emit(i, static_cast<RollingMoments const &>(moments));
+  }
+}
+
+} // namespace epoch_script::transform
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace epoch_script::transform {
+
+// Normal equations of the augmented Dickey-Fuller regression
+//
+//   Δy_t = γ·y_{t-1} + Σ_{j=1..lag} δ_j·Δy_{t-j} + α [+ β·t] + ε_t
+//
+// with O(k²) Add/Remove of one regression row (k = lag + 2, +1 with trend),
+// so a rolling window slides by updating X'X, X'y and y'y instead of
+// rebuilding them. Rows touching a NaN are left out.
+//
+// Reset() re-centres y and re-bases the trend on `anchor`. Neither changes
+// γ or its standard error (the constant absorbs both shifts); they only keep
+// the sums small. Rows added before a Reset must not be removed after it.
+class ADFRegression {
+public:
+  ADFRegression(size_t lag, bool withTrend)
+      : m_lag(lag), m_withTrend(withTrend),
+        m_k(lag + (withTrend ? 3 : 2)), m_xtx(m_k * m_k), m_xty(m_k),
+        m_row(m_k) {}
+
+  // Regression row t needs y[t - lag - 1 .. t].
+  size_t FirstRow() const { return m_lag + 1; }
+
+  void Reset(std::span<const double> y, size_t anchor) {
+    std::ranges::fill(m_xtx, 0.0L);
+    std::ranges::fill(m_xty, 0.0L);
+    m_yty = 0;
+    m_count = 0;
+    m_anchor = anchor;
+    m_ref = std::isnan(y[anchor]) ? 0.0 : y[anchor];
+  }
+
+  void Add(std::span<const double> y, size_t t) { Accumulate(y, t, 1); }
+  void Remove(std::span<const double> y, size_t t) { Accumulate(y, t, -1); }
+
+  size_t Count() const { return m_count; }
+
+  // t statistic of γ; NaN without more rows than regressors or when X'X is
+  // singular.
+  double Statistic() const {
+    if (m_count <= m_k) {
+      return kNaN;
+    }
+    // Cholesky X'X = L·L'.
+    std::vector<long double> l(m_k * m_k, 0.0L);
+    for (size_t i = 0; i < m_k; ++i) {
+      for (size_t j = 0; j <= i; ++j) {
+        long double sum = m_xtx[i * m_k + j];
+        for (size_t p = 0; p < j; ++p) {
+          sum -= l[i * m_k + p] * l[j * m_k + p];
+        }
+        if (i == j) {
+          if (sum <= 0) {
+            return kNaN;
+          }
+          l[i * m_k + i] = std::sqrt(sum);
+        } else {
+          l[i * m_k + j] = sum / l[j * m_k + j];
+        }
+      }
+    }
+    auto forward = [&](std::vector<long double> b) {
+      for (size_t i = 0; i < m_k; ++i) {
+        for (size_t p = 0; p < i; ++p) {
+          b[i] -= l[i * m_k + p] * b[p];
+        }
+        b[i] /= l[i * m_k + i];
+      }
+      return b;
+    };
+
+    // β = L'^-1 z with z = L^-1 X'y; SSE = y'y - z'z.
+    const auto z = forward(m_xty);
+    std::vector<long double> beta = z;
+    for (size_t i = m_k; i-- > 0;) {
+      for (size_t p = i + 1; p < m_k; ++p) {
+        beta[i] -= l[p * m_k + i] * beta[p];
+      }
+      beta[i] /= l[i * m_k + i];
+    }
+    long double sse = m_yty;
+    for (const auto v : z) {
+      sse -= v * v;
+    }
+    const long double sigma2 = std::max(sse, 0.0L) / (m_count - m_k);
+
+    // (X'X)^-1 for γ is |L^-1 e_0|².
+    std::vector<long double> e0(m_k, 0.0L);
+    e0[0] = 1;
+    long double inverse = 0;
+    for (const auto v : forward(std::move(e0))) {
+      inverse += v * v;
+    }
+    return static_cast<double>(beta[0] / std::sqrt(sigma2 * inverse));
+  }
+
+private:
+  static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+  void Accumulate(std::span<const double> y, size_t t, long double sign) {
+    for (size_t i = t - m_lag - 1; i <= t; ++i) {
+      if (std::isnan(y[i])) {
+        return;
+      }
+    }
+    const long double target = y[t] - y[t - 1];
+    m_row[0] = y[t - 1] - m_ref;
+    for (size_t j = 1; j <= m_lag; ++j) {
+      m_row[j] = y[t - j] - y[t - j - 1];
+    }
+    m_row[m_lag + 1] = 1;
+    if (m_withTrend) {
+      m_row[m_lag + 2] = static_cast<long double>(t) - m_anchor;
+    }
+    for (size_t i = 0; i < m_k; ++i) {
+      for (size_t j = 0; j < m_k; ++j) {
+        m_xtx[i * m_k + j] += sign * m_row[i] * m_row[j];
+      }
+      m_xty[i] += sign * m_row[i] * target;
+    }
+    m_yty += sign * target * target;
+    if (sign > 0) {
+      ++m_count;
+    } else {
+      --m_count;
+    }
+  }
+
+  size_t m_lag;
+  bool m_withTrend;
+  size_t m_k;
+  std::vector<long double> m_xtx;
+  std::vector<long double> m_xty;
+  long double m_yty{0};
+  std::vector<long double> m_row;
+  size_t m_count{0};
+  size_t m_anchor{0};
+  double m_ref{0};
+};
+
+// Level KPSS statistic of a sliding window
+//
+//   η = Σ S_j² / (n²·σ²),  S_j = Σ_{i<=j} (x_i - mean)
+//
+// with the Newey-West long-run variance σ² over `lags` Bartlett-weighted
+// autocovariances. Σ S_j² expands into sliding sums of the prefix sums Q_k
+// (Σ Q_k, Σ Q_k², Σ k·Q_k) and each autocovariance into a sliding sum of
+// x_i·x_{i-l}, so Slide() costs O(lags). Windows holding a NaN have no
+// statistic.
+class KPSSWindow {
+public:
+  KPSSWindow(size_t window, size_t lags) : m_window(window), m_lags(lags) {}
+
+  // Newey-West truncation lag used by the transform: ⌊12·(n/100)^¼⌋
+  // (Schwert), capped below the window.
+  static size_t DefaultLags(size_t window) {
+    const auto lags = static_cast<size_t>(
+        std::floor(12.0 * std::pow(static_cast<double>(window) / 100.0, 0.25)));
+    return std::min(lags, window > 1 ? window - 1 : 0);
+  }
+
+  // Rebuilds the sums for the window starting at `start`.
+  void Reset(std::span<const double> x, size_t start) {
+    m_x = x;
+    m_start = start;
+    m_anchor = start;
+    m_ref = std::isnan(x[start]) ? 0.0 : x[start];
+    m_prefix.assign(1, 0.0L);
+    m_sumQ = m_sumQ2 = m_sumKQ = m_sumSq = 0;
+    m_products.assign(m_lags + 1, 0.0L);
+    m_nanCount = 0;
+    for (size_t i = start; i < start + m_window; ++i) {
+      Enter(i);
+    }
+  }
+
+  // Moves the window one row forward.
+  void Slide() {
+    Leave(m_start);
+    ++m_start;
+    Enter(m_start + m_window - 1);
+  }
+
+  double Statistic() const {
+    if (m_nanCount > 0 || m_window < 2) {
+      return kNaN;
+    }
+    const auto n = static_cast<long double>(m_window);
+    const size_t s = m_start - m_anchor;
+    const long double qs = m_prefix[s];
+    const long double total = m_prefix[s + m_window] - qs;
+    const long double mean = total / n;
+
+    // C_j = Q_{s+j+1} - Q_s for j = 0..n-1, i.e. k = s+1..s+n.
+    const long double sumC2 = m_sumQ2 - 2 * qs * m_sumQ + n * qs * qs;
+    const long double sumJC =
+        m_sumKQ - s * m_sumQ - qs * n * (n + 1) / 2; // Σ (j+1)·C_j
+    const long double sumJ2 = n * (n + 1) * (2 * n + 1) / 6;
+    const long double eta =
+        (sumC2 - 2 * mean * sumJC + mean * mean * sumJ2) / (n * n);
+
+    long double variance = m_sumSq - n * mean * mean;
+    for (size_t l = 1; l <= m_lags; ++l) {
+      const long double lead = m_prefix[s + m_window] - m_prefix[s + l];
+      const long double lagged = m_prefix[s + m_window - l] - qs;
+      const long double autocovariance =
+          m_products[l] - mean * (lead + lagged) + (n - l) * mean * mean;
+      variance += 2 * (1.0L - l / (m_lags + 1.0L)) * autocovariance;
+    }
+    variance /= n;
+    return variance > 0 ? static_cast<double>(eta / variance) : kNaN;
+  }
+
+private:
+  static constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+  long double Centred(size_t i) const {
+    return std::isnan(m_x[i]) ? 0.0L : m_x[i] - m_ref;
+  }
+
+  void Enter(size_t i) {
+    m_nanCount += std::isnan(m_x[i]) ? 1 : 0;
+    const long double v = Centred(i);
+    m_prefix.push_back(m_prefix.back() + v);
+    const long double q = m_prefix.back();
+    const long double k = static_cast<long double>(m_prefix.size() - 1);
+    m_sumQ += q;
+    m_sumQ2 += q * q;
+    m_sumKQ += k * q;
+    m_sumSq += v * v;
+    for (size_t l = 1; l <= m_lags && i >= m_start + l; ++l) {
+      m_products[l] += v * Centred(i - l);
+    }
+  }
+
+  void Leave(size_t i) {
+    m_nanCount -= std::isnan(m_x[i]) ? 1 : 0;
+    const long double v = Centred(i);
+    const size_t k = i - m_anchor + 1;
+    const long double q = m_prefix[k];
+    m_sumQ -= q;
+    m_sumQ2 -= q * q;
+    m_sumKQ -= static_cast<long double>(k) * q;
+    m_sumSq -= v * v;
+    for (size_t l = 1; l <= m_lags; ++l) {
+      m_products[l] -= Centred(i + l) * v;
+    }
+  }
+
+  size_t m_window;
+  size_t m_lags;
+  std::span<const double> m_x;
+  size_t m_start{0};
+  size_t m_anchor{0};
+  double m_ref{0};
+  std::vector<long double> m_prefix; // Q_k: sum of x[anchor, anchor + k)
+  long double m_sumQ{0}, m_sumQ2{0}, m_sumKQ{0}, m_sumSq{0};
+  std::vector<long double> m_products; // Σ x_i·x_{i-l} within the window
+  size_t m_nanCount{0};
+};
+
+// Slides a `window`-row window over y and calls `emit(i, regression)` for
+// every row i >= window - 1, with the ADF regression of y[i+1-window, i].
+// As in RollingPairwiseMoments the sums are rebuilt every `window` rows so
+// Add/Remove rounding error cannot accumulate; the total cost stays O(N·k²).
+template <typename Emit>
+void RollingADF(std::span<const double> y, size_t window, size_t lag,
+                bool withTrend, Emit &&emit) {
+  const size_t n = y.size();
+  if (window < lag + 2 || n < window) {
+    return;
+  }
+  ADFRegression regression{lag, withTrend};
+  for (size_t i = window - 1; i < n; ++i) {
+    const size_t start = i + 1 - window;
+    if (start % window == 0) {
+      regression.Reset(y, start);
+      for (size_t t = start + regression.FirstRow(); t <= i; ++t) {
+        regression.Add(y, t);
+      }
+    } else {
+      regression.Remove(y, start - 1 + regression.FirstRow());
+      regression.Add(y, i);
+    }
+    emit(i, static_cast<ADFRegression const &>(regression));
+  }
+}
+
+// KPSS counterpart of RollingADF.
+template <typename Emit>
+void RollingKPSS(std::span<const double> x, size_t window, size_t lags,
+                 Emit &&emit) {
+  const size_t n = x.size();
+  if (window < 2 || n < window) {
+    return;
+  }
+  KPSSWindow kpss{window, std::min(lags, window - 1)};
+  for (size_t i = window - 1; i < n; ++i) {
+    const size_t start = i + 1 - window;
+    if (start % window == 0) {
+      kpss.Reset(x, start);
+    } else {
+      kpss.Slide();
+    }
+    emit(i, static_cast<KPSSWindow const &>(kpss));
+  }
+}
+
+} // namespace epoch_script::transform
@@ -5,92 +5,93 @@
 #pragma once
 
 #include "../common_utils.h"
-#include <epoch_script/transforms/itransform.h>
-#include <DataFrame/DataFrameFinancialVisitors.h>
+#include "rolling_moments.h"
+#include "rolling_stationarity.h"
+#include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 
-CREATE_ENUM(KpssType, Level, Trend);
+#include <limits>
+#include <vector>
 
 namespace epoch_script::transform {
 
-// Stationary check using hmdf::StationaryCheckVisitor over a rolling window
+// Evaluates `statistic(accumulator)` on the rolling accumulators emitted by
+// `slide` (RollingADF/RollingKPSS) for every stride-th row from window - 1,
+// forward filling the rows in between. The accumulators still slide every
+// row, so stride only skips the per-row solve.
+template <typename Slide>
+epoch_frame::DataFrame
+RollingStationaryStatistic(epoch_frame::DataFrame const &df,
+                           std::string const &input, std::string const &output,
+                           int64_t window, int64_t stride, Slide const &slide) {
+  const DoubleValues values{df[input]};
+  const auto first = static_cast<size_t>(std::max<int64_t>(window, 1) - 1);
+  const auto every = static_cast<size_t>(std::max<int64_t>(stride, 1));
+
+  std::vector<double> result(df.num_rows(),
+                             std::numeric_limits<double>::quiet_NaN());
+  slide(values.values(), [&](size_t i, auto const &accumulator) {
+    result[i] = (i - first) % every == 0 ? accumulator.Statistic()
+                                         : result[i - 1];
+  });
+  return epoch_frame::make_dataframe(
+      df.index(), {NullPrefixedColumn(result, first)}, {output});
+}
+
+// Rolling augmented Dickey-Fuller t statistic, see ADFRegression.
 class ADFStationaryCheck final : public ITransform {
 public:
   explicit ADFStationaryCheck(const TransformConfiguration &config)
       : ITransform(config),
         m_window(config.GetOptionValue("window").GetInteger()),
+        m_stride(config
+                     .GetOptionValue("stride",
+                                     epoch_script::MetaDataOptionDefinition{1.0})
+                     .GetInteger()),
         m_adfLag(config.GetOptionValue("adf_lag").GetInteger()),
         m_adfWithTrend(config.GetOptionValue("adf_with_trend").GetBoolean()) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
-    using namespace epoch_frame;
-    const auto input = df[GetInputId()];
-    const auto series =
-        input.rolling_apply({.window_size = m_window})
-            .apply([&](Series const &x) {
-              hmdf::StationaryCheckVisitor<double> visitor(
-                  hmdf::stationary_test::adf,
-                  {.adf_lag = m_adfLag, .adf_with_trend = m_adfWithTrend});
-              const SeriesSpan<> span{x};
-              run_visit(x, visitor, span);
-              return Scalar{visitor.get_adf_statistic()};
-            });
-    return series.to_frame(GetOutputId("result"));
+    return RollingStationaryStatistic(
+        df, GetInputId(), GetOutputId("result"), m_window, m_stride,
+        [&](std::span<const double> values, auto &&emit) {
+          RollingADF(values, static_cast<size_t>(m_window), m_adfLag,
+                     m_adfWithTrend, emit);
+        });
   }
 
 private:
   int64_t m_window;
+  int64_t m_stride;
   size_t m_adfLag;
   bool m_adfWithTrend;
 };
 
+// Rolling level KPSS statistic, see KPSSWindow.
 class KPSSStationaryCheck final : public ITransform {
 public:
   explicit KPSSStationaryCheck(const TransformConfiguration &config)
       : ITransform(config),
-        m_window(config.GetOptionValue("window").GetInteger()) {
-    SetCriticalValues(
-        config.GetOptionValue("type").GetSelectOption<KpssType>());
-  }
+        m_window(config.GetOptionValue("window").GetInteger()),
+        m_stride(config
+                     .GetOptionValue("stride",
+                                     epoch_script::MetaDataOptionDefinition{1.0})
+                     .GetInteger()) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
-    using namespace epoch_frame;
-    const auto input = df[GetInputId()];
-    const auto series = input.rolling_apply({.window_size = m_window})
-                            .apply([&](Series const &x) {
-                              hmdf::StationaryTestParams params;
-                              params.critical_values[0] = m_criticalValues[0];
-                              params.critical_values[1] = m_criticalValues[1];
-                              params.critical_values[2] = m_criticalValues[2];
-                              params.critical_values[3] = m_criticalValues[3];
-                              hmdf::StationaryCheckVisitor<double> visitor(
-                                  hmdf::stationary_test::kpss, params);
-
-                              const SeriesSpan<> span{x};
-                              run_visit(x, visitor, span);
-                              return Scalar{visitor.get_kpss_statistic()};
-                            });
-    return series.to_frame(GetOutputId("result"));
+    const auto window = static_cast<size_t>(m_window);
+    return RollingStationaryStatistic(
+        df, GetInputId(), GetOutputId("result"), m_window, m_stride,
+        [&](std::span<const double> values, auto &&emit) {
+          RollingKPSS(values, window, KPSSWindow::DefaultLags(window), emit);
+        });
   }
 
 private:
   int64_t m_window;
-  std::array<double, 4> m_criticalValues;
-
-  void SetCriticalValues(KpssType type) {
-    switch (type) {
-    case KpssType::Level:
-      m_criticalValues = {0.739, 0.463, 0.347, 0.263};
-      break;
-    case KpssType::Trend:
-      m_criticalValues = {0.119, 0.146, 0.146, 0.146};
-      break;
-    default:
-      throw std::invalid_argument("Invalid KpssType");
-    }
-  }
+  int64_t m_stride;
 };
 
 } // namespace epoch_script::transform
@@ -48,6 +48,11 @@ MakeSageMakerSentimentTransforms() {
           .limitations =
               "Empty or null text returns 'neutral' with score 0.0. "
               "Network latency and AWS costs apply per inference request.",
+          // Remote inference: ~1 ms per text once batched, plus connection setup
+          .costModel = epoch_script::transforms::CostModel{
+              .complexity = epoch_core::CostComplexity::Linear,
+              .coefficient = 1e6,
+              .perCallOverhead = 5e7},
       });
 
   return metadataList;
@@ -0,0 +1,291 @@
+#include "fused_expression.h"
+
+#include <arrow/compute/api.h>
+#include <arrow/util/bit_util.h>
+#include <epoch_core/macros.h>
+#include <epoch_frame/common.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+namespace epoch_script::transform {
+
+namespace {
+using OpCode = FusedExpressionProgram::OpCode;
+
+// Rows evaluated per pass over the program; one stack entry of a block is
+// 9 KiB, so a typical expression's stack stays in L1/L2.
+constexpr int64_t kBlockRows = 1024;
+
+struct Operand {
+  double values[kBlockRows];
+  uint8_t valid[kBlockRows];
+};
+
+// Input column as raw buffers, read one block at a time
+struct Column {
+  arrow::ArrayPtr array;
+  const double *values{nullptr}; // float64 values, offset applied
+  const uint8_t *bits{nullptr};  // boolean value bitmap
+  const uint8_t *validity{nullptr};
+  int64_t offset{0};
+
+  void Load(int64_t start, int64_t n, Operand &out) const {
+    if (values) {
+      std::memcpy(out.values, values + start, n * sizeof(double));
+    } else {
+      for (int64_t j = 0; j < n; ++j) {
+        out.values[j] = arrow::bit_util::GetBit(bits, offset + start + j);
+      }
+    }
+    if (validity) {
+      for (int64_t j = 0; j < n; ++j) {
+        out.valid[j] = arrow::bit_util::GetBit(validity, offset + start + j);
+      }
+    } else {
+      std::fill_n(out.valid, n, uint8_t{1});
+    }
+  }
+};
+
+Column MakeColumn(arrow::ArrayPtr array) {
+  if (array->type_id() != arrow::Type::DOUBLE &&
+      array->type_id() != arrow::Type::BOOL) {
+    array = epoch_frame::AssertResultIsOk(
+        arrow::compute::Cast(*array, arrow::float64()));
+  }
+  Column column{.array = array,
+                .validity = array->null_count() == 0
+                                ? nullptr
+                                : array->null_bitmap_data(),
+                .offset = array->offset()};
+  if (array->type_id() == arrow::Type::DOUBLE) {
+    column.values =
+        static_cast<const arrow::DoubleArray &>(*array).raw_values();
+  } else {
+    column.bits = array->data()->buffers[1]->data();
+  }
+  return column;
+}
+
+template <typename Fn>
+void Binary(Operand &a, Operand const &b, int64_t n, Fn &&fn) {
+  for (int64_t j = 0; j < n; ++j) {
+    a.values[j] = fn(a.values[j], b.values[j]);
+    a.valid[j] &= b.valid[j];
+  }
+}
+
+// Pops two operands and pushes the result in place of the first
+void ApplyBinary(OpCode op, Operand &a, Operand const &b, int64_t n) {
+  switch (op) {
+  case OpCode::Add:
+    return Binary(a, b, n, [](double x, double y) { return x + y; });
+  case OpCode::Sub:
+    return Binary(a, b, n, [](double x, double y) { return x - y; });
+  case OpCode::Mul:
+    return Binary(a, b, n, [](double x, double y) { return x * y; });
+  case OpCode::Div:
+    return Binary(a, b, n, [](double x, double y) { return x / y; });
+  case OpCode::Lt:
+    return Binary(a, b, n, [](double x, double y) { return double(x < y); });
+  case OpCode::Gt:
+    return Binary(a, b, n, [](double x, double y) { return double(x > y); });
+  case OpCode::Lte:
+    return Binary(a, b, n, [](double x, double y) { return double(x <= y); });
+  case OpCode::Gte:
+    return Binary(a, b, n, [](double x, double y) { return double(x >= y); });
+  case OpCode::Eq:
+    return Binary(a, b, n, [](double x, double y) { return double(x == y); });
+  case OpCode::Neq:
+    return Binary(a, b, n, [](double x, double y) { return double(x != y); });
+  case OpCode::And:
+    return Binary(a, b, n, [](double x, double y) {
+      return double(x != 0.0 && y != 0.0);
+    });
+  case OpCode::Or:
+    return Binary(a, b, n, [](double x, double y) {
+      return double(x != 0.0 || y != 0.0);
+    });
+  default:
+    throw std::runtime_error("FusedExpression: not a binary operator");
+  }
+}
+
+const std::unordered_map<std::string_view, OpCode> &Operators() {
+  static const std::unordered_map<std::string_view, OpCode> operators{
+      {"add", OpCode::Add},   {"sub", OpCode::Sub}, {"mul", OpCode::Mul},
+      {"div", OpCode::Div},   {"lt", OpCode::Lt},   {"gt", OpCode::Gt},
+      {"lte", OpCode::Lte},   {"gte", OpCode::Gte}, {"eq", OpCode::Eq},
+      {"neq", OpCode::Neq},   {"and", OpCode::And}, {"or", OpCode::Or},
+      {"not", OpCode::Not},   {"select", OpCode::Select}};
+  return operators;
+}
+
+// Number of operands an instruction pops
+size_t Arity(OpCode op) {
+  switch (op) {
+  case OpCode::Input:
+  case OpCode::Constant:
+    return 0;
+  case OpCode::Not:
+    return 1;
+  case OpCode::Select:
+    return 3;
+  default:
+    return 2;
+  }
+}
+} // namespace
+
+FusedExpressionProgram::FusedExpressionProgram(std::string_view program) {
+  size_t depth = 0;
+  for (size_t pos = 0; pos < program.size();) {
+    const size_t end = std::min(program.find(' ', pos), program.size());
+    const auto token = program.substr(pos, end - pos);
+    pos = end + 1;
+    if (token.empty()) {
+      continue;
+    }
+
+    Instruction instruction{};
+    if (token.front() == '$' || token.front() == '#') {
+      const auto *first = token.data() + 1;
+      const auto *last = token.data() + token.size();
+      std::from_chars_result parsed;
+      if (token.front() == '$') {
+        instruction.op = OpCode::Input;
+        parsed = std::from_chars(first, last, instruction.input);
+        m_inputCount = std::max<size_t>(m_inputCount, instruction.input + 1);
+      } else {
+        instruction.op = OpCode::Constant;
+        parsed = std::from_chars(first, last, instruction.constant);
+      }
+      AssertFromFormat(parsed.ec == std::errc{} && parsed.ptr == last,
+                       "FusedExpression: invalid token '{}' in '{}'", token,
+                       program);
+    } else {
+      auto it = Operators().find(token);
+      AssertFromFormat(it != Operators().end(),
+                       "FusedExpression: unknown operator '{}' in '{}'", token,
+                       program);
+      instruction.op = it->second;
+    }
+
+    const size_t arity = Arity(instruction.op);
+    AssertFromFormat(depth >= arity,
+                     "FusedExpression: '{}' is missing operands in '{}'", token,
+                     program);
+    depth = depth - arity + 1;
+    m_maxDepth = std::max(m_maxDepth, depth);
+    m_code.push_back(instruction);
+  }
+  AssertFromFormat(depth == 1,
+                   "FusedExpression: '{}' must leave exactly one value, "
+                   "leaves {}",
+                   program, depth);
+}
+
+arrow::ArrayPtr
+FusedExpressionProgram::Evaluate(std::vector<arrow::ArrayPtr> const &inputs,
+                                 bool booleanResult) const {
+  AssertFromFormat(!inputs.empty(), "FusedExpression requires an input");
+  const int64_t N = inputs.front()->length();
+
+  std::vector<Column> columns;
+  columns.reserve(inputs.size());
+  for (auto const &input : inputs) {
+    AssertFromFormat(input->length() == N,
+                     "FusedExpression input lengths differ: {} vs {}",
+                     input->length(), N);
+    columns.push_back(MakeColumn(input));
+  }
+
+  auto validity = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  std::shared_ptr<arrow::Buffer> data;
+  if (booleanResult) {
+    data = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  } else {
+    data = epoch_frame::AssertResultIsOk(
+        arrow::AllocateBuffer(N * sizeof(double)));
+  }
+  int64_t nullCount = 0;
+
+  std::vector<Operand> stack(m_maxDepth);
+  for (int64_t start = 0; start < N; start += kBlockRows) {
+    const int64_t n = std::min(kBlockRows, N - start);
+    size_t top = 0;
+    for (auto const &instruction : m_code) {
+      switch (instruction.op) {
+      case OpCode::Input:
+        columns[instruction.input].Load(start, n, stack[top++]);
+        break;
+      case OpCode::Constant: {
+        auto &out = stack[top++];
+        std::fill_n(out.values, n, instruction.constant);
+        std::fill_n(out.valid, n, uint8_t{1});
+        break;
+      }
+      case OpCode::Not: {
+        auto &a = stack[top - 1];
+        for (int64_t j = 0; j < n; ++j) {
+          a.values[j] = a.values[j] == 0.0;
+        }
+        break;
+      }
+      case OpCode::Select: {
+        auto &condition = stack[top - 3];
+        auto const &whenTrue = stack[top - 2];
+        auto const &whenFalse = stack[top - 1];
+        for (int64_t j = 0; j < n; ++j) {
+          const bool pick = condition.values[j] != 0.0;
+          condition.values[j] =
+              pick ? whenTrue.values[j] : whenFalse.values[j];
+          condition.valid[j] &=
+              pick ? whenTrue.valid[j] : whenFalse.valid[j];
+        }
+        top -= 2;
+        break;
+      }
+      default:
+        ApplyBinary(instruction.op, stack[top - 2], stack[top - 1], n);
+        --top;
+        break;
+      }
+    }
+
+    auto const &result = stack[0];
+    auto *out = data->mutable_data();
+    for (int64_t j = 0; j < n; ++j) {
+      if (result.valid[j]) {
+        arrow::bit_util::SetBit(validity->mutable_data(), start + j);
+      } else {
+        ++nullCount;
+      }
+    }
+    if (booleanResult) {
+      for (int64_t j = 0; j < n; ++j) {
+        if (result.valid[j] && result.values[j] != 0.0) {
+          arrow::bit_util::SetBit(out, start + j);
+        }
+      }
+    } else {
+      std::memcpy(reinterpret_cast<double *>(out) + start, result.values,
+                  n * sizeof(double));
+    }
+  }
+
+  if (nullCount == 0) {
+    validity = nullptr;
+  }
+  if (booleanResult) {
+    return std::make_shared<arrow::BooleanArray>(N, std::move(data),
+                                                 std::move(validity), nullCount);
+  }
+  return std::make_shared<arrow::DoubleArray>(N, std::move(data),
+                                              std::move(validity), nullCount);
+}
+
+} // namespace epoch_script::transform
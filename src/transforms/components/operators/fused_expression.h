@@ -0,0 +1,99 @@
+#pragma once
+
+#include <arrow/api.h>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_script/transforms/core/itransform.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace epoch_script::transform {
+
+/**
+ * A tree of elementwise operators fused by the compiler, in reverse Polish
+ * notation. Tokens are separated by spaces:
+ *   $i        the i-th connected input
+ *   #<value>  a numeric constant (booleans are 1 and 0)
+ *   add sub mul div lt gt lte gte eq neq and or not select
+ *
+ * Every value is evaluated as a double; boolean inputs and results are 1/0.
+ * A null operand makes the result null, except that `select` only depends on
+ * the branch it picks.
+ */
+class FusedExpressionProgram {
+public:
+  enum class OpCode : uint8_t {
+    Input,
+    Constant,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Lt,
+    Gt,
+    Lte,
+    Gte,
+    Eq,
+    Neq,
+    And,
+    Or,
+    Not,
+    Select
+  };
+
+  struct Instruction {
+    OpCode op;
+    uint32_t input{};
+    double constant{};
+  };
+
+  explicit FusedExpressionProgram(std::string_view program);
+
+  size_t InputCount() const { return m_inputCount; }
+  size_t MaxDepth() const { return m_maxDepth; }
+
+  /**
+   * Evaluates the program over equal-length input columns in cache-sized
+   * row blocks, without materializing any intermediate column. Inputs that
+   * are neither float64 nor boolean are cast to float64 once.
+   */
+  arrow::ArrayPtr Evaluate(std::vector<arrow::ArrayPtr> const &inputs,
+                           bool booleanResult) const;
+
+private:
+  std::vector<Instruction> m_code;
+  size_t m_inputCount{0};
+  size_t m_maxDepth{0};
+};
+
+template <bool BooleanResult> class FusedExpression : public ITransform {
+public:
+  explicit FusedExpression(const TransformConfiguration &config)
+      : ITransform(config),
+        m_program(config.GetOptionValue("program").GetString()) {}
+
+  [[nodiscard]] epoch_frame::DataFrame
+  TransformData(epoch_frame::DataFrame const &bars) const override {
+    std::vector<arrow::ArrayPtr> inputs;
+    for (auto const &column : GetInputIds()) {
+      inputs.push_back(bars[column].contiguous_array().value());
+    }
+    AssertFromFormat(inputs.size() >= m_program.InputCount(),
+                     "FusedExpression program reads {} inputs, {} connected",
+                     m_program.InputCount(), inputs.size());
+
+    auto result = m_program.Evaluate(inputs, BooleanResult);
+    return epoch_frame::make_dataframe(
+        bars.index(), {std::make_shared<arrow::ChunkedArray>(result)},
+        {GetOutputId()});
+  }
+
+private:
+  FusedExpressionProgram m_program;
+};
+
+using FusedExpressionNumber = FusedExpression<false>;
+using FusedExpressionBoolean = FusedExpression<true>;
+
+} // namespace epoch_script::transform
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <epoch_script/transforms/core/metadata.h>
+#include "fused_expression.h"
+
+namespace epoch_script::transform {
+
+// Function to create metadata for fused expression transforms
+inline std::vector<epoch_script::transforms::TransformsMetaData> MakeFusedExpressionMetaData() {
+  using namespace epoch_script::transforms;
+  std::vector<TransformsMetaData> metadataList;
+
+  const auto makeMetaData = [](std::string const &id, std::string const &name,
+                               IOMetaData const &output) {
+    return TransformsMetaData{
+      .id = id,
+      .category = epoch_core::TransformCategory::Utility,
+      .name = name,
+      .options = {
+        MetaDataOption{
+          .id = "program",
+          .name = "Program",
+          .type = epoch_core::MetaDataOptionType::String,
+          .isRequired = true,
+          .desc = "Fused operator tree in reverse Polish notation over the connected inputs"
+        }
+      },
+      .isCrossSectional = false,
+      .desc = "Internal compiler-inserted transform evaluating a fused tree of elementwise arithmetic, "
+              "comparison, logical and select operators in a single pass. Not intended for direct use in scripts.",
+      .inputs = {IOMetaData{epoch_core::IODataType::Any, ARG, "", true}},
+      .outputs = {output},
+      .atLeastOneInputRequired = true,
+      .tags = {"internal", "compiler", "optimization"},
+      .requiresTimeFrame = false,
+      .allowNullInputs = true,
+      .strategyTypes = {},
+      .relatedTransforms = {},
+      .assetRequirements = {"single-asset"},
+      .usageContext = "Automatically inserted by the compiler's elementwise fusion pass. Not for direct use.",
+      .limitations = "Internal use only. Should not appear in user-written scripts."
+    };
+  };
+
+  // FusedExpressionNumber - fused tree with a numeric result
+  metadataList.emplace_back(makeMetaData(
+    "fused_expression_number", "Fused Expression (Number)",
+    IOMetaDataConstants::DECIMAL_OUTPUT_METADATA));
+
+  // FusedExpressionBoolean - fused tree with a boolean result
+  metadataList.emplace_back(makeMetaData(
+    "fused_expression_boolean", "Fused Expression (Boolean)",
+    IOMetaDataConstants::BOOLEAN_OUTPUT_METADATA));
+
+  return metadataList;
+}
+
+} // namespace epoch_script::transform
@@ -3,7 +3,8 @@
 #include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/dataframe.h>
-#include "dataframe_utils.h"
+#include <epoch_frame/factory/array_factory.h>
+#include "groupby_kernels.h"
 
 // Numeric aggregation types for GroupBy
 CREATE_ENUM(GroupByNumericAgg,
@@ -44,41 +45,29 @@ struct GroupByAggTransform final : ITransform {
 private:
   AggEnum m_agg_type;
 
-  // Helper to get aggregated dataframe based on aggregation type
-  epoch_frame::DataFrame ApplyAggregation(
-      epoch_frame::DataFrame const &df,
-      std::string const &group_key_col,
-      std::string const &value_col) const;
+  // Helper to get the aggregated value of every group based on aggregation type
+  arrow::ChunkedArrayPtr ApplyAggregation(groupby::GroupedValues const &grouped) const;
 };
 
 // Specialization for Numeric aggregations
 template <>
-inline epoch_frame::DataFrame GroupByAggTransform<epoch_core::GroupByNumericAgg>::ApplyAggregation(
-    epoch_frame::DataFrame const &df,
-    std::string const &group_key_col,
-    std::string const &value_col) const {
-
-  // Drop null group keys - grouping by null doesn't make semantic sense
-  // Select only the columns we need, then drop any row with nulls in the key
-  auto temp_df = df[{group_key_col, value_col}];
-  auto non_null_df = epoch_script::transform::utils::drop_by_key(temp_df, group_key_col);
-  auto grouped = non_null_df.group_by_agg(group_key_col);
-
+inline arrow::ChunkedArrayPtr GroupByAggTransform<epoch_core::GroupByNumericAgg>::ApplyAggregation(
+    groupby::GroupedValues const &grouped) const {
   switch (m_agg_type) {
     case epoch_core::GroupByNumericAgg::sum:
-      return grouped.sum();
+      return grouped.Sum();
     case epoch_core::GroupByNumericAgg::mean:
-      return grouped.mean();
+      return grouped.Mean();
     case epoch_core::GroupByNumericAgg::count:
-      return grouped.count();
+      return grouped.Count();
     case epoch_core::GroupByNumericAgg::first:
-      return grouped.first();
+      return grouped.First();
     case epoch_core::GroupByNumericAgg::last:
-      return grouped.last();
+      return grouped.Last();
     case epoch_core::GroupByNumericAgg::min:
-      return grouped.min();
+      return grouped.Min();
     case epoch_core::GroupByNumericAgg::max:
-      return grouped.max();
+      return grouped.Max();
     default:
       throw std::runtime_error("Unsupported numeric aggregation type");
   }
@@ -86,34 +75,37 @@ inline epoch_frame::DataFrame GroupByAggTransform<epoch_core::GroupByNumericAgg>
 
 // Specialization for Boolean aggregations
 template <>
-inline epoch_frame::DataFrame GroupByAggTransform<epoch_core::GroupByBooleanAgg>::ApplyAggregation(
-    epoch_frame::DataFrame const &df,
-    std::string const &group_key_col,
-    std::string const &value_col) const {
-
-  // Drop null group keys - grouping by null doesn't make semantic sense
-  // Select only the columns we need, then drop any row with nulls in the key
-  auto temp_df = df[{group_key_col, value_col}];
-  auto non_null_df = epoch_script::transform::utils::drop_by_key(temp_df, group_key_col);
-  auto grouped = non_null_df.group_by_agg(group_key_col);
-
+inline arrow::ChunkedArrayPtr GroupByAggTransform<epoch_core::GroupByBooleanAgg>::ApplyAggregation(
+    groupby::GroupedValues const &grouped) const {
   switch (m_agg_type) {
     case epoch_core::GroupByBooleanAgg::AllOf:
-      return grouped.all();
+      return grouped.All();
     case epoch_core::GroupByBooleanAgg::AnyOf:
-      return grouped.any();
-    case epoch_core::GroupByBooleanAgg::NoneOf: {
+      return grouped.Any();
+    case epoch_core::GroupByBooleanAgg::NoneOf:
       // NoneOf is equivalent to NOT(AnyOf) = all values are false
-      auto any_result = grouped.any();
-      // Negate the boolean result
-      auto series = any_result.to_series();
-      return (!series).to_frame(value_col);
-    }
+      return grouped.None();
     default:
       throw std::runtime_error("Unsupported boolean aggregation type");
   }
 }
 
+// Specialization for Any aggregations (Any -> Boolean)
+template <>
+inline arrow::ChunkedArrayPtr GroupByAggTransform<epoch_core::GroupByAnyAgg>::ApplyAggregation(
+    groupby::GroupedValues const &grouped) const {
+  switch (m_agg_type) {
+    case epoch_core::GroupByAnyAgg::IsEqual:
+      // Check if all values in the group are equal
+      return grouped.AllEqual();
+    case epoch_core::GroupByAnyAgg::IsUnique:
+      // Check if all values in the group are unique (no duplicates)
+      return grouped.AllUnique();
+    default:
+      throw std::runtime_error("Unsupported Any aggregation type");
+  }
+}
+
 // Main TransformData implementation
 template <typename AggEnum>
 epoch_frame::DataFrame GroupByAggTransform<AggEnum>::TransformData(
@@ -126,125 +118,35 @@ epoch_frame::DataFrame GroupByAggTransform<AggEnum>::TransformData(
   std::string group_key_col = inputs[0];  // First input is group_key
   std::string value_col = inputs[1];      // Second input is value
 
-  // Step 1: Create a position column with integer positions (0, 1, 2, ...)
-  std::vector<int64_t> positions;
-  positions.reserve(bars.size());
-  for (int64_t i = 0; i < static_cast<int64_t>(bars.size()); ++i) {
-    positions.push_back(i);
-  }
-  auto position_array = epoch_frame::factory::array::make_array(positions);
+  // Step 1: Encode group keys once; rows with a null key or value belong to
+  // no group, and groups are ordered by first appearance
+  auto values = bars[value_col].contiguous_array().value();
+  auto groups = groupby::EncodeGroups(
+      bars[group_key_col].contiguous_array().value(), values);
 
-  // Create DataFrame with [group_key, value, position]
-  epoch_frame::DataFrame df_with_positions = epoch_frame::make_dataframe(
-      bars.index(),
-      {bars[group_key_col].array(), bars[value_col].array(), position_array},
-      {group_key_col, value_col, "__position__"}
-  );
+  // Step 2: Aggregate the value column over the group codes
+  auto aggregated = ApplyAggregation(groupby::GroupedValues{groups, values});
 
-  // Step 2: Group by group_key and aggregate value column
-  epoch_frame::DataFrame value_agg = ApplyAggregation(
-      df_with_positions,
-      group_key_col,
-      value_col
-  );
-  // Reset index to get group_key back as a column
-  value_agg = value_agg.reset_index(group_key_col);
-
-  // Step 3: Group by group_key and get position for index selection based on aggregation type
+  // Step 3: Select the index row of each group based on aggregation type
   // - If agg is 'first', use first position
-  // - If agg is 'last', use last position
-  // - Otherwise (sum, mean, count, min, max), default to last position
-  // Drop null group keys - grouping by null doesn't make semantic sense
-  // Select only the columns we need, then drop any row with nulls in the key
-  auto temp_pos_df = df_with_positions[{group_key_col, "__position__"}];
-  auto non_null_pos_df = epoch_script::transform::utils::drop_by_key(temp_pos_df, group_key_col);
-  auto grouped_positions = non_null_pos_df.group_by_agg(group_key_col);
-  epoch_frame::DataFrame position_agg;
-
+  // - Otherwise (last, sum, mean, count, min, max, boolean and any
+  //   aggregations), use last position
+  bool use_first = false;
   if constexpr (std::is_same_v<AggEnum, epoch_core::GroupByNumericAgg>) {
-    if (m_agg_type == epoch_core::GroupByNumericAgg::first) {
-      position_agg = grouped_positions.first();
-    } else if (m_agg_type == epoch_core::GroupByNumericAgg::last) {
-      position_agg = grouped_positions.last();
-    } else {
-      // Default to last for sum, mean, count, min, max
-      position_agg = grouped_positions.last();
-    }
-  } else {
-    // For boolean and any aggregations, default to last
-    position_agg = grouped_positions.last();
+    use_first = m_agg_type == epoch_core::GroupByNumericAgg::first;
   }
-  // Reset index to get group_key back as a column
-  position_agg = position_agg.reset_index(group_key_col);
-
-  // Step 4: Use the aggregated positions to select rows from original dataframe
-  // The position_agg dataframe has the __position__ column with the selected positions
-  // Cast to int64 to ensure correct type for iloc (aggregations may have converted to double)
-  auto selected_positions_array = position_agg["__position__"].array();
-  auto selected_positions_series = epoch_frame::Series(selected_positions_array, "__position__");
-  auto selected_positions_int64 = selected_positions_series.cast(arrow::int64());
-  epoch_frame::Array index_array(selected_positions_int64.array());
-  epoch_frame::DataFrame selected_rows = bars.iloc(index_array);
-  auto result_index = selected_rows.index();
-
-  // Step 6: Build output DataFrame with [grouped_index, group_key, aggregated_value]
-  auto group_key_series = value_agg[group_key_col];
-  auto value_series = value_agg[value_col];
+  epoch_frame::Array index_array{epoch_frame::factory::array::make_contiguous_array(
+      use_first ? groups.firstRow : groups.lastRow)};
+  auto result_index = bars[std::vector{value_col}].iloc(index_array).index();
 
+  // Step 4: Build output DataFrame with [grouped_index, group_key, aggregated_value]
   return epoch_frame::make_dataframe(
       result_index,
-      {group_key_series.array(), value_series.array()},
+      {groups.keys, aggregated},
       {GetOutputId("group_key"), GetOutputId("value")}
   );
 }
 
-// Specialization for Any aggregations (Any -> Boolean)
-template <>
-inline epoch_frame::DataFrame GroupByAggTransform<epoch_core::GroupByAnyAgg>::ApplyAggregation(
-    epoch_frame::DataFrame const &df,
-    std::string const &group_key_col,
-    std::string const &value_col) const {
-
-  // Drop null group keys - grouping by null doesn't make semantic sense
-  // Select only the columns we need, then drop any row with nulls in the key
-  auto temp_df = df[{group_key_col, value_col}];
-  auto non_null_df = epoch_script::transform::utils::drop_by_key(temp_df, group_key_col);
-  auto grouped = non_null_df.group_by_agg(group_key_col);
-
-  switch (m_agg_type) {
-    case epoch_core::GroupByAnyAgg::IsEqual: {
-      // Check if all values in the group are equal
-      // If min == max, then all values are identical
-      auto min_df = grouped.min();
-      auto max_df = grouped.max();
-      auto min_series = min_df[value_col];
-      auto max_series = max_df[value_col];
-      auto result = min_series == max_series;
-      return result.to_frame(value_col);
-    }
-    case epoch_core::GroupByAnyAgg::IsUnique: {
-      // Check if all values in the group are unique (no duplicates)
-      // If count == 1, trivially unique
-      // Otherwise, check if first != last (heuristic for small groups)
-      auto count_df = grouped.count();
-      auto first_df = grouped.first();
-      auto last_df = grouped.last();
-      auto count_series = count_df[value_col];
-      auto first_series = first_df[value_col];
-      auto last_series = last_df[value_col];
-
-      // Result: (count == 1) OR (first != last)
-      // This is a simple heuristic - not perfect for groups > 2
-      auto is_single = count_series == epoch_frame::Scalar(static_cast<int64_t>(1));
-      auto is_different = first_series != last_series;
-      auto result = is_single || is_different;
-      return result.to_frame(value_col);
-    }
-    default:
-      throw std::runtime_error("Unsupported Any aggregation type");
-  }
-}
-
 // Concrete transform classes - one for numeric, one for boolean, one for any
 using GroupByNumericAggTransform = GroupByAggTransform<epoch_core::GroupByNumericAgg>;
 using GroupByBooleanAggTransform = GroupByAggTransform<epoch_core::GroupByBooleanAgg>;
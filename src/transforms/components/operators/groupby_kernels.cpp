@@ -0,0 +1,304 @@
+#include "groupby_kernels.h"
+
+#include <arrow/compute/api.h>
+#include <arrow/util/bit_util.h>
+#include <epoch_core/macros.h>
+#include <epoch_frame/common.h>
+#include <epoch_frame/factory/array_factory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace epoch_script::transform::groupby {
+
+namespace {
+// Dictionary-encodes a column unless it already is one; codes follow the
+// order in which values first appear.
+std::shared_ptr<arrow::DictionaryArray> Encode(arrow::ArrayPtr const &column) {
+  if (column->type_id() == arrow::Type::DICTIONARY) {
+    return std::static_pointer_cast<arrow::DictionaryArray>(column);
+  }
+  return std::static_pointer_cast<arrow::DictionaryArray>(
+      epoch_frame::AssertResultIsOk(arrow::compute::DictionaryEncode(column))
+          .make_array());
+}
+
+// Dictionary indices as int32, whatever their width
+std::shared_ptr<arrow::Int32Array>
+Indices(arrow::DictionaryArray const &encoded) {
+  auto indices = encoded.indices();
+  if (indices->type_id() != arrow::Type::INT32) {
+    indices = epoch_frame::AssertResultIsOk(
+        arrow::compute::Cast(*indices, arrow::int32()));
+  }
+  return std::static_pointer_cast<arrow::Int32Array>(indices);
+}
+
+arrow::ChunkedArrayPtr MakeBooleanColumn(std::vector<uint8_t> const &values) {
+  const auto N = static_cast<int64_t>(values.size());
+  auto bitmap = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  for (int64_t i = 0; i < N; ++i) {
+    if (values[i]) {
+      arrow::bit_util::SetBit(bitmap->mutable_data(), i);
+    }
+  }
+  return std::make_shared<arrow::ChunkedArray>(
+      std::make_shared<arrow::BooleanArray>(N, std::move(bitmap)));
+}
+
+// Values as a flat C array of the accumulator type
+template <typename T>
+std::shared_ptr<arrow::NumericArray<typename arrow::CTypeTraits<T>::ArrowType>>
+ValuesAs(arrow::ArrayPtr const &values) {
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  auto type = arrow::TypeTraits<ArrowType>::type_singleton();
+  auto cast = values->type()->Equals(*type)
+                  ? values
+                  : epoch_frame::AssertResultIsOk(
+                        arrow::compute::Cast(*values, type));
+  return std::static_pointer_cast<arrow::NumericArray<ArrowType>>(cast);
+}
+} // namespace
+
+GroupCodes EncodeGroups(arrow::ArrayPtr const &key,
+                        arrow::ArrayPtr const &value) {
+  AssertFromFormat(key->length() == value->length(),
+                   "GroupBy key and value lengths differ: {} vs {}",
+                   key->length(), value->length());
+
+  const auto encoded = Encode(key);
+  const auto indices = Indices(*encoded);
+  const auto dictionary = encoded->dictionary();
+
+  // Dictionary codes are in order of first appearance over all rows; groups
+  // are renumbered over the rows kept, so a key seen only next to null
+  // values yields no group.
+  const int64_t N = key->length();
+  GroupCodes groups;
+  groups.rowGroup.assign(N, -1);
+  std::vector<int32_t> groupOfCode(dictionary->length(), -1);
+  std::vector<int64_t> codeOfGroup;
+  for (int64_t i = 0; i < N; ++i) {
+    if (indices->IsNull(i) || value->IsNull(i)) {
+      continue;
+    }
+    const int32_t code = indices->Value(i);
+    int32_t &group = groupOfCode[code];
+    if (group < 0) {
+      group = static_cast<int32_t>(codeOfGroup.size());
+      codeOfGroup.push_back(code);
+      groups.firstRow.push_back(i);
+      groups.lastRow.push_back(i);
+      groups.rows.push_back(0);
+    }
+    groups.rowGroup[i] = group;
+    groups.lastRow[group] = i;
+    ++groups.rows[group];
+  }
+
+  const auto take =
+      epoch_frame::factory::array::make_contiguous_array(codeOfGroup);
+  groups.keys = std::make_shared<arrow::ChunkedArray>(
+      epoch_frame::AssertResultIsOk(arrow::compute::Take(*dictionary, *take)));
+  return groups;
+}
+
+GroupedValues::GroupedValues(GroupCodes const &groups, arrow::ArrayPtr values)
+    : m_groups(groups), m_values(std::move(values)) {}
+
+template <typename Fn>
+arrow::ChunkedArrayPtr GroupedValues::Dispatch(Fn &&reduce) const {
+  if (arrow::is_integer(m_values->type_id())) {
+    return reduce(*ValuesAs<int64_t>(m_values));
+  }
+  return reduce(*ValuesAs<double>(m_values));
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Sum() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    using T = typename Array::value_type;
+    const T *v = values.raw_values();
+    std::vector<T> sum(m_groups.size(), T{0});
+    for (size_t i = 0; i < m_groups.rowGroup.size(); ++i) {
+      if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+        sum[g] += v[i];
+      }
+    }
+    return epoch_frame::factory::array::make_array(sum);
+  });
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Mean() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    const auto *v = values.raw_values();
+    std::vector<double> mean(m_groups.size(), 0.0);
+    for (size_t i = 0; i < m_groups.rowGroup.size(); ++i) {
+      if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+        mean[g] += static_cast<double>(v[i]);
+      }
+    }
+    for (size_t g = 0; g < mean.size(); ++g) {
+      mean[g] /= static_cast<double>(m_groups.rows[g]);
+    }
+    return epoch_frame::factory::array::make_array(mean);
+  });
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Count() const {
+  return epoch_frame::factory::array::make_array(m_groups.rows);
+}
+
+arrow::ChunkedArrayPtr GroupedValues::First() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    using T = typename Array::value_type;
+    std::vector<T> first(m_groups.size());
+    for (size_t g = 0; g < first.size(); ++g) {
+      first[g] = values.Value(m_groups.firstRow[g]);
+    }
+    return epoch_frame::factory::array::make_array(first);
+  });
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Last() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    using T = typename Array::value_type;
+    std::vector<T> last(m_groups.size());
+    for (size_t g = 0; g < last.size(); ++g) {
+      last[g] = values.Value(m_groups.lastRow[g]);
+    }
+    return epoch_frame::factory::array::make_array(last);
+  });
+}
+
+// NaN is skipped unless the whole group is NaN
+arrow::ChunkedArrayPtr GroupedValues::Min() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    using T = typename Array::value_type;
+    const T *v = values.raw_values();
+    std::vector<T> min(m_groups.size());
+    for (size_t g = 0; g < min.size(); ++g) {
+      min[g] = v[m_groups.firstRow[g]];
+    }
+    for (size_t i = 0; i < m_groups.rowGroup.size(); ++i) {
+      if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+        if constexpr (std::is_floating_point_v<T>) {
+          min[g] = std::fmin(min[g], v[i]);
+        } else {
+          min[g] = std::min(min[g], v[i]);
+        }
+      }
+    }
+    return epoch_frame::factory::array::make_array(min);
+  });
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Max() const {
+  return Dispatch([&]<typename Array>(Array const &values) {
+    using T = typename Array::value_type;
+    const T *v = values.raw_values();
+    std::vector<T> max(m_groups.size());
+    for (size_t g = 0; g < max.size(); ++g) {
+      max[g] = v[m_groups.firstRow[g]];
+    }
+    for (size_t i = 0; i < m_groups.rowGroup.size(); ++i) {
+      if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+        if constexpr (std::is_floating_point_v<T>) {
+          max[g] = std::fmax(max[g], v[i]);
+        } else {
+          max[g] = std::max(max[g], v[i]);
+        }
+      }
+    }
+    return epoch_frame::factory::array::make_array(max);
+  });
+}
+
+std::vector<uint8_t> GroupedValues::BooleanValues() const {
+  AssertFromFormat(m_values->type_id() == arrow::Type::BOOL,
+                   "Boolean GroupBy aggregation requires a boolean column, "
+                   "got {}",
+                   m_values->type()->ToString());
+  const auto &values = static_cast<const arrow::BooleanArray &>(*m_values);
+  std::vector<uint8_t> out(values.length());
+  for (int64_t i = 0; i < values.length(); ++i) {
+    out[i] = values.Value(i);
+  }
+  return out;
+}
+
+arrow::ChunkedArrayPtr GroupedValues::All() const {
+  const auto values = BooleanValues();
+  std::vector<uint8_t> all(m_groups.size(), 1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+      all[g] &= values[i];
+    }
+  }
+  return MakeBooleanColumn(all);
+}
+
+arrow::ChunkedArrayPtr GroupedValues::Any() const {
+  const auto values = BooleanValues();
+  std::vector<uint8_t> any(m_groups.size(), 0);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+      any[g] |= values[i];
+    }
+  }
+  return MakeBooleanColumn(any);
+}
+
+arrow::ChunkedArrayPtr GroupedValues::None() const {
+  const auto values = BooleanValues();
+  std::vector<uint8_t> none(m_groups.size(), 1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+      none[g] &= values[i] ^ 1;
+    }
+  }
+  return MakeBooleanColumn(none);
+}
+
+// Equal values share a code; booleans are their own codes
+std::vector<int32_t> GroupedValues::ValueCodes() const {
+  if (m_values->type_id() == arrow::Type::BOOL) {
+    const auto values = BooleanValues();
+    return {values.begin(), values.end()};
+  }
+  const auto indices = Indices(*Encode(m_values));
+  return {indices->raw_values(), indices->raw_values() + indices->length()};
+}
+
+arrow::ChunkedArrayPtr GroupedValues::AllEqual() const {
+  const auto codes = ValueCodes();
+  std::vector<int32_t> firstCode(m_groups.size());
+  for (size_t g = 0; g < firstCode.size(); ++g) {
+    firstCode[g] = codes[m_groups.firstRow[g]];
+  }
+  std::vector<uint8_t> equal(m_groups.size(), 1);
+  for (size_t i = 0; i < codes.size(); ++i) {
+    if (const auto g = m_groups.rowGroup[i]; g >= 0) {
+      equal[g] &= codes[i] == firstCode[g];
+    }
+  }
+  return MakeBooleanColumn(equal);
+}
+
+arrow::ChunkedArrayPtr GroupedValues::AllUnique() const {
+  const auto codes = ValueCodes();
+  std::unordered_set<uint64_t> seen;
+  seen.reserve(codes.size());
+  std::vector<uint8_t> unique(m_groups.size(), 1);
+  for (size_t i = 0; i < codes.size(); ++i) {
+    if (const auto g = m_groups.rowGroup[i]; g >= 0 && unique[g]) {
+      const auto pair = (static_cast<uint64_t>(g) << 32) |
+                        static_cast<uint32_t>(codes[i]);
+      unique[g] = seen.insert(pair).second;
+    }
+  }
+  return MakeBooleanColumn(unique);
+}
+
+} // namespace epoch_script::transform::groupby
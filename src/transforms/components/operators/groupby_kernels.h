@@ -0,0 +1,66 @@
+#pragma once
+
+#include <arrow/api.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace epoch_script::transform::groupby {
+
+/**
+ * Rows of a key column mapped to dense group ids, numbered in order of first
+ * appearance. The key column is dictionary-encoded once, so string keys are
+ * hashed a single time and every aggregate runs over integer codes. Rows
+ * with a null key or a null value belong to no group.
+ */
+struct GroupCodes {
+  std::vector<int32_t> rowGroup; ///< group of each row, -1 when skipped
+  std::vector<int64_t> firstRow; ///< first row of each group
+  std::vector<int64_t> lastRow;  ///< last row of each group
+  std::vector<int64_t> rows;     ///< number of rows in each group
+  arrow::ChunkedArrayPtr keys;   ///< key of each group
+
+  size_t size() const { return firstRow.size(); }
+};
+
+GroupCodes EncodeGroups(arrow::ArrayPtr const &key,
+                        arrow::ArrayPtr const &value);
+
+/**
+ * Single-pass hash aggregates of a value column over GroupCodes. Each
+ * aggregate fills one flat accumulator per group and returns one value per
+ * group, in group order.
+ */
+class GroupedValues {
+public:
+  GroupedValues(GroupCodes const &groups, arrow::ArrayPtr values);
+
+  // Numeric: integer columns aggregate as int64, others as float64
+  arrow::ChunkedArrayPtr Sum() const;
+  arrow::ChunkedArrayPtr Mean() const;
+  arrow::ChunkedArrayPtr Count() const;
+  arrow::ChunkedArrayPtr First() const;
+  arrow::ChunkedArrayPtr Last() const;
+  arrow::ChunkedArrayPtr Min() const;
+  arrow::ChunkedArrayPtr Max() const;
+
+  // Boolean
+  arrow::ChunkedArrayPtr All() const;
+  arrow::ChunkedArrayPtr Any() const;
+  arrow::ChunkedArrayPtr None() const;
+
+  // Any type
+  arrow::ChunkedArrayPtr AllEqual() const;
+  arrow::ChunkedArrayPtr AllUnique() const;
+
+private:
+  // Calls reduce with the values as an Int64Array or a DoubleArray
+  template <typename Fn> arrow::ChunkedArrayPtr Dispatch(Fn &&reduce) const;
+  std::vector<uint8_t> BooleanValues() const;
+  std::vector<int32_t> ValueCodes() const;
+
+  GroupCodes const &m_groups;
+  arrow::ArrayPtr m_values;
+};
+
+} // namespace epoch_script::transform::groupby
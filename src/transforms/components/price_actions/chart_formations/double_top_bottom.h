@@ -2,6 +2,7 @@
 
 #include "../infrastructure/flexible_pivot_detector.h"
 #include "../infrastructure/pattern_validator.h"
+#include "../infrastructure/pivot_scan.h"
 #include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 
@@ -29,46 +30,21 @@ public:
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
     using namespace pattern_utils;
-    const auto &C = epoch_script::EpochStratifyXConstants::instance();
     constexpr double nan = std::numeric_limits<double>::quiet_NaN();
 
-    const size_t N = bars.num_rows();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
+    const HighLowSpans prices{bars};
+    const size_t N = prices.size();
+    const auto high = prices.high;
+    const auto low = prices.low;
 
     std::vector<bool> pattern_detected(N, false);
     std::vector<double> breakout_level(N, nan);
     std::vector<double> target_price(N, nan);
 
-    // Detect pivots (Python uses left_count=3, right_count=3 by default)
-    std::vector<size_t> pivot_high_indices;
-    std::vector<size_t> pivot_low_indices;
-    std::vector<double> pivot_high_values;
-    std::vector<double> pivot_low_values;
-
-    constexpr size_t pivot_window = 3;
-    for (size_t i = pivot_window; i < N - pivot_window; ++i) {
-      bool is_pivot_high = true;
-      bool is_pivot_low = true;
-
-      for (size_t j = i - pivot_window; j <= i + pivot_window; ++j) {
-        if (j == i)
-          continue;
-        if (high[i].as_double() < high[j].as_double())
-          is_pivot_high = false;
-        if (low[i].as_double() > low[j].as_double())
-          is_pivot_low = false;
-      }
-
-      if (is_pivot_high) {
-        pivot_high_indices.push_back(i);
-        pivot_high_values.push_back(high[i].as_double());
-      }
-      if (is_pivot_low) {
-        pivot_low_indices.push_back(i);
-        pivot_low_values.push_back(low[i].as_double());
-      }
-    }
+    // Pivots (Python uses left_count=3, right_count=3 by default), shared
+    // with the other chart formations through PivotCache
+    const auto pivots_ptr = PivotCache::Get(prices, 3, 3);
+    const PivotFlags &pivots = *pivots_ptr;
 
     // Convert similarity_tolerance to Python ratio format
     // For tops: tolerance 0.01 → tops_max_ratio = 1.01
@@ -76,29 +52,27 @@ public:
     const double tops_max_ratio = 1.0 + m_similarity_tolerance;
     const double bottoms_min_ratio = 1.0 - m_similarity_tolerance;
 
+    // Scratch buffers reused across candles
+    std::vector<size_t> pivot_indx;
+    std::vector<double> pivot_pos;
+
     // Pattern detection - direct port from Python lines 57-87
     for (size_t candle_idx = m_lookback; candle_idx < N; ++candle_idx) {
       // Python line 58: Get sub_ohlc window
       // Python line 60: Collect pivot indices where pivot != 0
-      std::vector<size_t> pivot_indx;
-      std::vector<double> pivot_pos;
+      pivot_indx.clear();
+      pivot_pos.clear();
 
       // Collect all pivots (both high and low) in the window
       // Python mixes highs and lows in order of appearance
       for (size_t i = candle_idx - m_lookback; i <= candle_idx && i < N; ++i) {
-        // Check if i is a pivot high
-        auto high_it = std::find(pivot_high_indices.begin(), pivot_high_indices.end(), i);
-        if (high_it != pivot_high_indices.end()) {
+        if (pivots[i] & kPivotHigh) {
           pivot_indx.push_back(i);
-          size_t idx = std::distance(pivot_high_indices.begin(), high_it);
-          pivot_pos.push_back(pivot_high_values[idx]);
+          pivot_pos.push_back(high[i]);
         }
-        // Check if i is a pivot low
-        auto low_it = std::find(pivot_low_indices.begin(), pivot_low_indices.end(), i);
-        if (low_it != pivot_low_indices.end()) {
+        if (pivots[i] & kPivotLow) {
           pivot_indx.push_back(i);
-          size_t idx = std::distance(pivot_low_indices.begin(), low_it);
-          pivot_pos.push_back(pivot_low_values[idx]);
+          pivot_pos.push_back(low[i]);
         }
       }
 
@@ -2,6 +2,7 @@
 
 #include "../infrastructure/flexible_pivot_detector.h"
 #include "../infrastructure/pattern_validator.h"
+#include "../infrastructure/pivot_scan.h"
 #include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/factory/series_factory.h>
@@ -43,57 +44,35 @@ public:
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
     using namespace pattern_utils;
-    const auto &C = epoch_script::EpochStratifyXConstants::instance();
     constexpr double nan = std::numeric_limits<double>::quiet_NaN();
 
-    const size_t N = bars.num_rows();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
+    const HighLowSpans prices{bars};
+    const size_t N = prices.size();
+    const auto high = prices.high;
+    const auto low = prices.low;
 
     // Python line 65-66: Find pivot points with TWO levels
-    // Main pivots: pivot_interval=10
-    std::vector<int64_t> pivot(N, 0);
-    for (size_t i = m_pivot_interval; i < N - m_pivot_interval; ++i) {
-      bool is_pivot_high = true;
-      bool is_pivot_low = true;
-
-      for (size_t j = i - m_pivot_interval; j <= i + m_pivot_interval; ++j) {
-        if (j == i) continue;
-        if (high[i].as_double() < high[j].as_double())
-          is_pivot_high = false;
-        if (low[i].as_double() > low[j].as_double())
-          is_pivot_low = false;
-      }
-
-      if (is_pivot_high && is_pivot_low) pivot[i] = 3;
-      else if (is_pivot_low) pivot[i] = 1;
-      else if (is_pivot_high) pivot[i] = 2;
-    }
-
-    // Short pivots: short_pivot_interval=5
-    std::vector<int64_t> short_pivot(N, 0);
-    for (size_t i = m_short_pivot_interval; i < N - m_short_pivot_interval; ++i) {
-      bool is_pivot_high = true;
-      bool is_pivot_low = true;
-
-      for (size_t j = i - m_short_pivot_interval; j <= i + m_short_pivot_interval; ++j) {
-        if (j == i) continue;
-        if (high[i].as_double() < high[j].as_double())
-          is_pivot_high = false;
-        if (low[i].as_double() > low[j].as_double())
-          is_pivot_low = false;
-      }
-
-      if (is_pivot_high && is_pivot_low) short_pivot[i] = 3;
-      else if (is_pivot_low) short_pivot[i] = 1;
-      else if (is_pivot_high) short_pivot[i] = 2;
-    }
+    // Main pivots: pivot_interval=10, short pivots: short_pivot_interval=5.
+    // Both scans are shared with other formations through PivotCache.
+    const auto pivot_ptr =
+        PivotCache::Get(prices, m_pivot_interval, m_pivot_interval);
+    const auto short_pivot_ptr = PivotCache::Get(
+        prices, m_short_pivot_interval, m_short_pivot_interval);
+    const PivotFlags &pivot = *pivot_ptr;
+    const PivotFlags &short_pivot = *short_pivot_ptr;
 
     // Pattern detection results
     std::vector<bool> pattern_detected(N, false);
     std::vector<double> neckline_level(N, nan);
     std::vector<double> target_price(N, nan);
 
+    // Scratch buffers reused across candles
+    std::vector<double> maxim;
+    std::vector<double> minim;
+    std::vector<size_t> xxmax;
+    std::vector<size_t> xxmin;
+    std::vector<double> xx_neckline;
+
     // Python line 73: Scan for Head & Shoulders pattern
     for (size_t candle_idx = m_lookback; candle_idx < N; ++candle_idx) {
       // Python line 75-76: Must be pivot high on BOTH levels
@@ -110,22 +89,22 @@ public:
         continue;
       }
 
-      std::vector<double> maxim;
-      std::vector<double> minim;
-      std::vector<size_t> xxmax;
-      std::vector<size_t> xxmin;
+      maxim.clear();
+      minim.clear();
+      xxmax.clear();
+      xxmin.clear();
       size_t maxbcount = 0, minbcount = 0, maxacount = 0, minacount = 0;
 
       // Python lines 42-56: Collect short pivots in window
       for (size_t i = idx - half_lookback; i <= idx + half_lookback && i < N; ++i) {
         if (short_pivot[i] == 1) {
-          minim.push_back(low[i].as_double());
+          minim.push_back(low[i]);
           xxmin.push_back(i);
           if (i < idx) minbcount++;
           else if (i > idx) minacount++;
         }
         if (short_pivot[i] == 2) {
-          maxim.push_back(high[i].as_double());
+          maxim.push_back(high[i]);
           xxmax.push_back(i);
           if (i < idx) maxbcount++;
           else if (i > idx) maxacount++;
@@ -138,9 +117,9 @@ public:
       }
 
       // Python line 84-85: Calculate neckline slope
-      auto neckline_reg = PatternValidator::calculate_linear_regression(
-          std::vector<double>(xxmin.begin(), xxmin.end()),
-          minim);
+      xx_neckline.assign(xxmin.begin(), xxmin.end());
+      auto neckline_reg =
+          PatternValidator::calculate_linear_regression(xx_neckline, minim);
       double slmin = neckline_reg.slope;
 
       // Python line 85: Find head (argmax)
@@ -2,6 +2,7 @@
 
 #include "../infrastructure/flexible_pivot_detector.h"
 #include "../infrastructure/pattern_validator.h"
+#include "../infrastructure/pivot_scan.h"
 #include <epoch_script/transforms/core/itransform.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 
@@ -29,59 +30,44 @@ public:
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
     using namespace pattern_utils;
-    const auto &C = epoch_script::EpochStratifyXConstants::instance();
     constexpr double nan = std::numeric_limits<double>::quiet_NaN();
 
-    const size_t N = bars.num_rows();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
+    const HighLowSpans prices{bars};
+    const size_t N = prices.size();
+    const auto high = prices.high;
+    const auto low = prices.low;
 
     std::vector<bool> bull_pennant(N, false);
     std::vector<bool> bear_pennant(N, false);
     std::vector<double> slmax_result(N, nan);
     std::vector<double> slmin_result(N, nan);
 
-    // Detect pivots (Python uses left_count=3, right_count=3 by default)
-    std::vector<size_t> pivot_high_indices;
-    std::vector<size_t> pivot_low_indices;
-
-    constexpr size_t pivot_window = 3;
-    for (size_t i = pivot_window; i < N - pivot_window; ++i) {
-      bool is_pivot_high = true;
-      bool is_pivot_low = true;
-
-      for (size_t j = i - pivot_window; j <= i + pivot_window; ++j) {
-        if (j == i)
-          continue;
-        if (high[i].as_double() < high[j].as_double())
-          is_pivot_high = false;
-        if (low[i].as_double() > low[j].as_double())
-          is_pivot_low = false;
-      }
+    // Pivots (Python uses left_count=3, right_count=3 by default), shared
+    // with the other chart formations through PivotCache
+    const auto pivots_ptr = PivotCache::Get(prices, 3, 3);
+    const PivotFlags &pivots = *pivots_ptr;
 
-      if (is_pivot_high)
-        pivot_high_indices.push_back(i);
-      if (is_pivot_low)
-        pivot_low_indices.push_back(i);
-    }
+    // Scratch buffers reused across candles
+    std::vector<double> maxim;
+    std::vector<double> minim;
+    std::vector<double> xxmin;
+    std::vector<double> xxmax;
 
     // Pattern detection - direct port from Python lines 78-115
     for (size_t candle_idx = m_lookback; candle_idx < N; ++candle_idx) {
-      std::vector<double> maxim;
-      std::vector<double> minim;
-      std::vector<double> xxmin;
-      std::vector<double> xxmax;
+      maxim.clear();
+      minim.clear();
+      xxmin.clear();
+      xxmax.clear();
 
       // Collect pivots in window [candle_idx-lookback, candle_idx+1]
-      for (size_t idx : pivot_low_indices) {
-        if (idx >= candle_idx - m_lookback && idx <= candle_idx) {
-          minim.push_back(low[idx].as_double());
+      for (size_t idx = candle_idx - m_lookback; idx <= candle_idx; ++idx) {
+        if (pivots[idx] & kPivotLow) {
+          minim.push_back(low[idx]);
           xxmin.push_back(static_cast<double>(idx));
         }
-      }
-      for (size_t idx : pivot_high_indices) {
-        if (idx >= candle_idx - m_lookback && idx <= candle_idx) {
-          maxim.push_back(high[idx].as_double());
+        if (pivots[idx] & kPivotHigh) {
+          maxim.push_back(high[idx]);
           xxmax.push_back(static_cast<double>(idx));
         }
       }
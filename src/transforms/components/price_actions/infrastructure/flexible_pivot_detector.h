@@ -4,6 +4,7 @@
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/factory/series_factory.h>
 #include <epoch_frame/factory/table_factory.h>
+#include "pivot_scan.h"
 #include <limits>
 
 namespace epoch_script::transform {
@@ -36,60 +37,28 @@ public:
 
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
-    const auto &C = epoch_script::EpochStratifyXConstants::instance();
     constexpr double nan = std::numeric_limits<double>::quiet_NaN();
 
-    const size_t N = bars.num_rows();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
+    const pattern_utils::HighLowSpans prices{bars};
+    const size_t N = prices.size();
+    const auto pivots_ptr =
+        pattern_utils::PivotCache::Get(prices, m_left_count, m_right_count);
+    const pattern_utils::PivotFlags &pivots = *pivots_ptr;
 
     std::vector<int64_t> pivot_type(N, 0);
     std::vector<double> pivot_level(N, nan);
     std::vector<int64_t> pivot_index(N, -1);
 
-    // Process each candle
     for (size_t i = 0; i < N; ++i) {
-      // Check boundary conditions
-      if (i < m_left_count || i + m_right_count >= N) {
+      if (pivots[i] == pattern_utils::kPivotNone) {
         continue;
       }
-
-      bool is_pivot_high = true;
-      bool is_pivot_low = true;
-
-      const double current_high = high[i].as_double();
-      const double current_low = low[i].as_double();
-
-      // Check left and right bars
-      for (size_t j = i - m_left_count; j <= i + m_right_count; ++j) {
-        if (j == i) continue;
-
-        const double check_high = high[j].as_double();
-        const double check_low = low[j].as_double();
-
-        if (current_high < check_high) {
-          is_pivot_high = false;
-        }
-        if (current_low > check_low) {
-          is_pivot_low = false;
-        }
-      }
-
-      // Set pivot type
-      if (is_pivot_high && is_pivot_low) {
-        pivot_type[i] = 3; // Both
-        pivot_level[i] = current_high; // Use high for plotting
-      } else if (is_pivot_high) {
-        pivot_type[i] = 2;
-        pivot_level[i] = current_high;
-      } else if (is_pivot_low) {
-        pivot_type[i] = 1;
-        pivot_level[i] = current_low;
-      }
-
-      if (pivot_type[i] != 0) {
-        pivot_index[i] = static_cast<int64_t>(i);
-      }
+      pivot_type[i] = pivots[i];
+      // Use high for plotting when the candle is both
+      pivot_level[i] = (pivots[i] & pattern_utils::kPivotHigh)
+                           ? prices.high[i]
+                           : prices.low[i];
+      pivot_index[i] = static_cast<int64_t>(i);
     }
 
     return AssertTableResultIsOk(arrow::Table::Make(
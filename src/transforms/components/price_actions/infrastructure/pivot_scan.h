@@ -0,0 +1,284 @@
+#pragma once
+
+#include <epoch_script/core/bar_attribute.h>
+#include <epoch_script/core/stable_hash.h>
+#include <epoch_frame/dataframe.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace epoch_script::transform::pattern_utils {
+
+/**
+ * Pivot flags per candle, same encoding as FlexiblePivotDetector's
+ * pivot_type: 0=none, 1=pivot_low, 2=pivot_high, 3=both.
+ */
+enum PivotFlag : uint8_t {
+  kPivotNone = 0,
+  kPivotLow = 1,
+  kPivotHigh = 2,
+  kPivotBoth = kPivotLow | kPivotHigh
+};
+using PivotFlags = std::vector<uint8_t>;
+
+/**
+ * Raw high/low buffers of a bar frame. Keeps the Arrow arrays alive for as
+ * long as the spans are used.
+ */
+class HighLowSpans {
+public:
+  explicit HighLowSpans(epoch_frame::DataFrame const &bars) {
+    const auto &C = epoch_script::EpochStratifyXConstants::instance();
+    m_highArray = bars[C.HIGH()].contiguous_array().to_view<double>();
+    m_lowArray = bars[C.LOW()].contiguous_array().to_view<double>();
+    high = {m_highArray->raw_values(),
+            static_cast<size_t>(m_highArray->length())};
+    low = {m_lowArray->raw_values(), static_cast<size_t>(m_lowArray->length())};
+  }
+
+  size_t size() const { return high.size(); }
+
+  // Buffers owning the spans, used to tell whether a cached scan is stale.
+  std::shared_ptr<arrow::Buffer> high_buffer() const {
+    return m_highArray->data()->buffers[1];
+  }
+  std::shared_ptr<arrow::Buffer> low_buffer() const {
+    return m_lowArray->data()->buffers[1];
+  }
+
+  std::span<const double> high;
+  std::span<const double> low;
+
+private:
+  std::shared_ptr<arrow::DoubleArray> m_highArray;
+  std::shared_ptr<arrow::DoubleArray> m_lowArray;
+};
+
+/**
+ * O(N) pivot scan. Candle i is a pivot high when no high in
+ * [i - left_count, i + right_count] exceeds high[i] (pivot low likewise with
+ * lows); candles without a full window on both sides are never pivots.
+ *
+ * Window extremes come from monotonic deques, replacing the nested
+ * O(N * window) loop. NaN neighbours never disqualify a candle, and a NaN
+ * candle is both a pivot high and low, exactly as the pairwise comparisons
+ * behaved.
+ */
+inline PivotFlags DetectPivots(std::span<const double> high,
+                               std::span<const double> low, size_t left_count,
+                               size_t right_count) {
+  const size_t N = std::min(high.size(), low.size());
+  PivotFlags flags(N, kPivotNone);
+  if (N <= left_count + right_count) {
+    return flags;
+  }
+
+  std::deque<size_t> maxHigh; // indices with decreasing highs
+  std::deque<size_t> minLow;  // indices with increasing lows
+  auto push = [&](size_t j) {
+    if (!std::isnan(high[j])) {
+      while (!maxHigh.empty() && high[maxHigh.back()] <= high[j]) {
+        maxHigh.pop_back();
+      }
+      maxHigh.push_back(j);
+    }
+    if (!std::isnan(low[j])) {
+      while (!minLow.empty() && low[minLow.back()] >= low[j]) {
+        minLow.pop_back();
+      }
+      minLow.push_back(j);
+    }
+  };
+
+  for (size_t j = 0; j < left_count + right_count; ++j) {
+    push(j);
+  }
+  for (size_t i = left_count; i + right_count < N; ++i) {
+    push(i + right_count);
+    const size_t windowStart = i - left_count;
+    while (!maxHigh.empty() && maxHigh.front() < windowStart) {
+      maxHigh.pop_front();
+    }
+    while (!minLow.empty() && minLow.front() < windowStart) {
+      minLow.pop_front();
+    }
+
+    uint8_t flag = kPivotNone;
+    if (std::isnan(high[i]) || high[i] >= high[maxHigh.front()]) {
+      flag |= kPivotHigh;
+    }
+    if (std::isnan(low[i]) || low[i] <= low[minLow.front()]) {
+      flag |= kPivotLow;
+    }
+    flags[i] = flag;
+  }
+  return flags;
+}
+
+/**
+ * Pivot scans shared between transforms. Several chart formations scan the
+ * same bars with the same window, so a scan is memoized per (high buffer,
+ * low buffer, length, content fingerprint, window).
+ *
+ * Entries hold weak references to the price buffers and are only served
+ * while those buffers are alive, and the key carries a fingerprint of
+ * sampled prices, so a freed buffer whose address is reused by another frame
+ * never returns that frame's pivots. The cache is an LRU bounded by the
+ * bytes of the flag vectors it holds; stale entries are dropped as soon as
+ * they are looked up or reach the LRU tail.
+ */
+class PivotCache {
+public:
+  static constexpr size_t kDefaultMaxBytes = 64 << 20;
+
+  static std::shared_ptr<const PivotFlags> Get(HighLowSpans const &prices,
+                                               size_t left_count,
+                                               size_t right_count) {
+    return Instance().GetOrCompute(prices, left_count, right_count);
+  }
+
+  // Bytes of cached flags; evicts least recently used scans down to the new
+  // bound.
+  static void SetMaxBytes(size_t bytes) {
+    auto &cache = Instance();
+    std::lock_guard lock(cache.m_mutex);
+    cache.m_maxBytes = bytes;
+    cache.Evict();
+  }
+
+  static size_t Bytes() {
+    auto &cache = Instance();
+    std::lock_guard lock(cache.m_mutex);
+    return cache.m_bytes;
+  }
+
+  static size_t Size() {
+    auto &cache = Instance();
+    std::lock_guard lock(cache.m_mutex);
+    return cache.m_entries.size();
+  }
+
+private:
+  struct Key {
+    const double *high;
+    const double *low;
+    size_t size;
+    uint64_t fingerprint;
+    size_t left_count;
+    size_t right_count;
+
+    bool operator==(Key const &) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(Key const &key) const {
+      size_t seed = std::hash<const double *>{}(key.high);
+      for (size_t v : {reinterpret_cast<size_t>(key.low), key.size,
+                       static_cast<size_t>(key.fingerprint), key.left_count,
+                       key.right_count}) {
+        seed ^= std::hash<size_t>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+      return seed;
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::weak_ptr<arrow::Buffer> high;
+    std::weak_ptr<arrow::Buffer> low;
+    std::shared_ptr<const PivotFlags> flags;
+
+    bool Expired() const { return high.expired() || low.expired(); }
+  };
+  using Lru = std::list<Entry>;
+
+  static PivotCache &Instance() {
+    static PivotCache cache;
+    return cache;
+  }
+
+  // Hash of up to kFingerprintSamples evenly spaced highs and lows (always
+  // including the last bar). O(1) per lookup, unlike hashing whole columns.
+  static uint64_t Fingerprint(HighLowSpans const &prices) {
+    constexpr size_t kFingerprintSamples = 64;
+    StableHasher hasher;
+    const size_t n = prices.size();
+    hasher.Add(static_cast<uint64_t>(n));
+    if (n == 0) {
+      return hasher.Digest();
+    }
+    const size_t step = std::max<size_t>(1, n / kFingerprintSamples);
+    for (size_t i = 0; i < n; i += step) {
+      hasher.Add(prices.high[i]).Add(prices.low[i]);
+    }
+    hasher.Add(prices.high[n - 1]).Add(prices.low[n - 1]);
+    return hasher.Digest();
+  }
+
+  static size_t BytesOf(Entry const &entry) { return entry.flags->size(); }
+
+  std::shared_ptr<const PivotFlags> GetOrCompute(HighLowSpans const &prices,
+                                                 size_t left_count,
+                                                 size_t right_count) {
+    const Key key{prices.high.data(), prices.low.data(), prices.size(),
+                  Fingerprint(prices), left_count,   right_count};
+    const auto highBuffer = prices.high_buffer();
+    const auto lowBuffer = prices.low_buffer();
+    {
+      std::lock_guard lock(m_mutex);
+      if (auto it = m_entries.find(key); it != m_entries.end()) {
+        const auto entry = it->second;
+        if (entry->high.lock() == highBuffer &&
+            entry->low.lock() == lowBuffer) {
+          m_lru.splice(m_lru.begin(), m_lru, entry);
+          return entry->flags;
+        }
+        Erase(entry);
+      }
+    }
+
+    auto flags = std::make_shared<const PivotFlags>(
+        DetectPivots(prices.high, prices.low, left_count, right_count));
+
+    std::lock_guard lock(m_mutex);
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+      Erase(it->second);
+    }
+    m_lru.push_front(Entry{key, highBuffer, lowBuffer, flags});
+    m_entries.emplace(key, m_lru.begin());
+    m_bytes += BytesOf(m_lru.front());
+    Evict();
+    return flags;
+  }
+
+  void Erase(Lru::iterator entry) {
+    m_bytes -= BytesOf(*entry);
+    m_entries.erase(entry->key);
+    m_lru.erase(entry);
+  }
+
+  // Drops stale entries from the tail, then least recently used ones while
+  // over the byte bound.
+  void Evict() {
+    while (!m_lru.empty() &&
+           (m_lru.back().Expired() || m_bytes > m_maxBytes)) {
+      Erase(std::prev(m_lru.end()));
+    }
+  }
+
+  std::mutex m_mutex;
+  Lru m_lru; // most recently used first
+  std::unordered_map<Key, Lru::iterator, KeyHash> m_entries;
+  size_t m_bytes{0};
+  size_t m_maxBytes{kDefaultMaxBytes};
+};
+
+} // namespace epoch_script::transform::pattern_utils
@@ -6,8 +6,13 @@
 #include <epoch_frame/factory/series_factory.h>
 #include <epoch_frame/factory/table_factory.h>
 
+#include "zone_scan.h"
+
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 namespace epoch_script::transform {
@@ -60,23 +65,17 @@ private:
     using arrow::float64;
     using arrow::int64;
 
-    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
-    const Scalar null_d{NaN};
-
     /* --- column shortcuts ----------------------------------------- */
     const auto &C = epoch_script::EpochStratifyXConstants::instance();
 
-    const auto open = bars[C.OPEN()].contiguous_array();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
-    const auto close = bars[C.CLOSE()].contiguous_array();
-
     /* change these two strings if your column names differ */
     constexpr auto HL_COL = "high_low";
     constexpr auto LVL_COL = "level";
 
-    const auto high_low = bars[GetInputId(HL_COL)].contiguous_array();
-    const auto lvl_arr = bars[GetInputId(LVL_COL)].contiguous_array();
+    const auto high_low =
+        bars[GetInputId(HL_COL)].contiguous_array().to_view<int64_t>();
+    const auto lvl_arr = smc_utils::ValuesOrNaN(
+        *bars[GetInputId(LVL_COL)].contiguous_array().to_view<double>());
 
     const std::size_t N = static_cast<std::size_t>(bars.num_rows());
 
@@ -98,11 +97,11 @@ private:
     /*        1. Detect bos_v / choch_v on the swing‑structure sequence   */
     /* -------------------------------------------------------------- */
     for (std::size_t i = 0; i < N; ++i) {
-      if (high_low[i].is_null())
+      if (high_low->IsNull(i))
         continue;
 
-      highs_lows_order.push_back(high_low[i].as_int64());
-      level_order.push_back(lvl_arr[i].as_double());
+      highs_lows_order.push_back(high_low->Value(i));
+      level_order.push_back(lvl_arr[i]);
 
       if (level_order.size() < 4) {
         last_positions.push_back(i);
@@ -168,57 +167,50 @@ private:
     /* -------------------------------------------------------------- */
     /*        2. Find the candle that actually breaks the level       */
     /* -------------------------------------------------------------- */
-    const auto break_key_or_high = m_close_break ? C.CLOSE() : C.HIGH();
-    const auto break_key_or_low = m_close_break ? C.CLOSE() : C.LOW();
+    auto column = [&](std::string const &name) {
+      return smc_utils::ValuesOrNaN(
+          *bars[name].contiguous_array().to_view<double>());
+    };
+    const auto break_high = column(m_close_break ? C.CLOSE() : C.HIGH());
+    const auto break_low = column(m_close_break ? C.CLOSE() : C.LOW());
+    const smc_utils::HighTree break_high_tree{break_high};
+    const smc_utils::LowTree break_low_tree{break_low};
+
+    // Broken structures by break candle, latest break on top: these are the
+    // only candidates the invalidation below can clear.
+    std::priority_queue<std::pair<int64_t, std::size_t>> broken_marks;
 
     for (std::size_t i = 0; i < N; ++i) {
       if (bos_v[i] == 0 && choch_v[i] == 0)
         continue;
 
-      /* build the mask */
-      std::optional<int64_t> break_index{};
+      /* the level is compared at float precision */
+      const double lvl = static_cast<float>(level_v[i]);
+      std::size_t j = smc_utils::npos;
       if (bos_v[i] == 1 or choch_v[i] == 1) {
-        auto y = bars[break_key_or_high]
-                     .iloc({i + 2, std::nullopt})
-                     .contiguous_array()
-                     .to_view<double>();
-        auto iter =
-            std::find_if(y->begin(), y->end(), [lvl = level_v[i]](auto x) {
-              return x && (*x > static_cast<float>(lvl));
-            });
-        if (iter != y->end()) {
-          break_index = std::distance(y->begin(), iter);
-        }
+        j = break_high_tree.FirstReaching(
+            i + 2, [lvl](double x) { return x > lvl; });
       } else if (bos_v[i] == -1 or choch_v[i] == -1) {
-        auto y = bars[break_key_or_low]
-                     .iloc({i + 2, std::nullopt})
-                     .contiguous_array()
-                     .to_view<double>();
-        auto iter =
-            std::find_if(y->begin(), y->end(), [lvl = level_v[i]](auto x) {
-              return x && (*x < static_cast<float>(lvl));
-            });
-        if (iter != y->end()) {
-          break_index = std::distance(y->begin(), iter);
-        }
+        j = break_low_tree.FirstReaching(
+            i + 2, [lvl](double x) { return x < lvl; });
       }
 
-      if (!break_index) {
+      if (j == smc_utils::npos) {
         continue;
       }
 
-      auto j = *break_index + i + 2;
-      broken_v[i] = j;
+      broken_v[i] = static_cast<int64_t>(j);
 
       /* invalidate earlier bos_v/choch_v that survive past this break */
-      for (std::size_t k = 0; k < N; ++k) {
-        if ((bos_v[k] != 0 || choch_v[k] != 0) &&
-            ((k < i) && broken_v[k] >= static_cast<int64_t>(j))) {
-          bos_v[k] = 0;
-          choch_v[k] = 0;
-          level_v[k] = 0;
-        }
+      while (!broken_marks.empty() &&
+             broken_marks.top().first >= static_cast<int64_t>(j)) {
+        const auto k = broken_marks.top().second;
+        broken_marks.pop();
+        bos_v[k] = 0;
+        choch_v[k] = 0;
+        level_v[k] = 0;
       }
+      broken_marks.emplace(broken_v[i], i);
     }
 
     /* 3. Drop any structure that never broke ----------------------- */
@@ -233,32 +225,13 @@ private:
     /* -------------------------------------------------------------- */
     /*                    4. Build Arrow arrays                       */
     /* -------------------------------------------------------------- */
-    auto vec_to_arr = []<typename T>(const std::vector<T> &tmp) {
-      typename arrow::CTypeTraits<T>::BuilderType builder;
-      AssertStatusIsOk(builder.Reserve(tmp.size()));
-
-      for (T v : tmp) {
-        if constexpr (std::is_same_v<T, double>) {
-          if (std::isnan(v) || v == 0) {
-            builder.UnsafeAppendNull();
-          } else {
-            builder.UnsafeAppend(v);
-          }
-        } else {
-          if (v == 0) {
-            builder.UnsafeAppendNull();
-          } else {
-            builder.UnsafeAppend(v);
-          }
-        }
-      }
-      return AssertResultIsOk(builder.Finish());
+    auto non_zero = [](const auto &values) {
+      return [&values](int64_t i) { return values[i] != 0; };
     };
-
-    Array bos_arr{vec_to_arr(bos_v)};
-    Array choch_arr{vec_to_arr(choch_v)};
-    Array level_arr{vec_to_arr(level_v)};
-    Array broken_arr{vec_to_arr(broken_v)}; // 0 → null handled
+    auto level_arr = smc_utils::MakeNullableColumn<double>(
+        level_v, [&](int64_t i) {
+          return !std::isnan(level_v[i]) && level_v[i] != 0;
+        });
 
     /* -------------------------------------------------------------- */
     /*                          Return table                          */
@@ -268,9 +241,14 @@ private:
                        {GetOutputId("level"), arrow::float64()},
                        {GetOutputId("broken_index"), arrow::int64()}});
 
-    return AssertTableResultIsOk(
-        arrow::Table::Make(schema, {bos_arr.value(), choch_arr.value(),
-                                    level_arr.value(), broken_arr.value()}));
+    return AssertTableResultIsOk(arrow::Table::Make(
+        schema,
+        arrow::ArrayVector{
+            smc_utils::MakeNullableColumn<int64_t>(bos_v, non_zero(bos_v)),
+            smc_utils::MakeNullableColumn<int64_t>(choch_v, non_zero(choch_v)),
+            level_arr,
+            smc_utils::MakeNullableColumn<int64_t>(broken_v,
+                                                   non_zero(broken_v))}));
   }
 
   /* ------------------------------------------------------------------ */
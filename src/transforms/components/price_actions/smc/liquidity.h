@@ -7,8 +7,10 @@
 #include <epoch_frame/factory/table_factory.h>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <numeric>
+#include <span>
 #include <vector>
 
 namespace epoch_script::transform {
@@ -48,6 +50,133 @@ private:
     return AssertResultIsOk(builder.Finish());
   }
 
+  /**
+   * For every candidate k, the first index j > candidates[k] whose price
+   * reaches threshold(candidates[k]) (>= when `bullish`, <= otherwise), or 0
+   * when the range is never swept.
+   *
+   * Candidates are answered right to left against a monotonic stack of the
+   * strict running extremes after the candidate: the first price reaching a
+   * threshold is always one of them, so each query is a binary search
+   * instead of a forward scan over the remaining bars.
+   */
+  template <typename Threshold>
+  static std::vector<index_t>
+  FirstSweep(std::span<const double> prices,
+             std::vector<index_t> const &candidates, Threshold &&threshold,
+             bool bullish) {
+    const auto reaches = [bullish](double price, double level) {
+      return bullish ? price >= level : price <= level;
+    };
+
+    std::vector<index_t> swept(candidates.size(), 0);
+    // Nearest index at the back; prices get strictly more extreme toward
+    // the front.
+    std::vector<index_t> extremes;
+    index_t pushed = prices.size();
+    for (size_t k = candidates.size(); k-- > 0;) {
+      const index_t i = candidates[k];
+      for (; pushed > i + 1; --pushed) {
+        const double price = prices[pushed - 1];
+        if (std::isnan(price))
+          continue;
+        while (!extremes.empty() && reaches(price, prices[extremes.back()])) {
+          extremes.pop_back();
+        }
+        extremes.push_back(pushed - 1);
+      }
+
+      const double level = threshold(i);
+      const auto reached = std::partition_point(
+          extremes.begin(), extremes.end(),
+          [&](index_t j) { return reaches(prices[j], level); });
+      if (reached != extremes.begin()) {
+        swept[k] = *std::prev(reached);
+      }
+    }
+    return swept;
+  }
+
+  /**
+   * Candidates of one side sorted by level, answering "the earliest
+   * candidate still present whose level lies in [low, high]" in O(log K):
+   * the level range is a contiguous run of the sorted order, and a segment
+   * tree over that order keeps the smallest candidate position per node.
+   * Grouping then costs O(K log K) in total, since every reported candidate
+   * is removed. NaN levels never fall in a range and are left out.
+   */
+  class LevelIndex {
+  public:
+    explicit LevelIndex(std::vector<double> const &levels)
+        : m_absent(levels.size()) {
+      for (size_t k = 0; k < levels.size(); ++k) {
+        if (!std::isnan(levels[k])) {
+          m_order.push_back(k);
+        }
+      }
+      std::ranges::stable_sort(m_order, {},
+                               [&](size_t k) { return levels[k]; });
+      m_sorted.reserve(m_order.size());
+      m_position.assign(levels.size(), m_order.size());
+      for (size_t p = 0; p < m_order.size(); ++p) {
+        m_sorted.push_back(levels[m_order[p]]);
+        m_position[m_order[p]] = p;
+      }
+
+      m_leaves = 1;
+      while (m_leaves < m_order.size()) {
+        m_leaves <<= 1;
+      }
+      m_tree.assign(2 * m_leaves, m_absent);
+      for (size_t p = 0; p < m_order.size(); ++p) {
+        m_tree[m_leaves + p] = m_order[p];
+      }
+      for (size_t node = m_leaves; node-- > 1;) {
+        m_tree[node] = std::min(m_tree[2 * node], m_tree[2 * node + 1]);
+      }
+    }
+
+    void Remove(size_t k) {
+      size_t node = m_position[k];
+      if (node >= m_order.size()) {
+        return;
+      }
+      node += m_leaves;
+      m_tree[node] = m_absent;
+      for (node >>= 1; node > 0; node >>= 1) {
+        m_tree[node] = std::min(m_tree[2 * node], m_tree[2 * node + 1]);
+      }
+    }
+
+    // Smallest present k with low <= level <= high, or the number of
+    // candidates when there is none.
+    size_t First(double low, double high) const {
+      if (!(low <= high)) {
+        return m_absent;
+      }
+      size_t lo = std::ranges::lower_bound(m_sorted, low) - m_sorted.begin();
+      size_t hi = std::ranges::upper_bound(m_sorted, high) - m_sorted.begin();
+      size_t first = m_absent;
+      for (lo += m_leaves, hi += m_leaves; lo < hi; lo >>= 1, hi >>= 1) {
+        if (lo & 1) {
+          first = std::min(first, m_tree[lo++]);
+        }
+        if (hi & 1) {
+          first = std::min(first, m_tree[--hi]);
+        }
+      }
+      return first;
+    }
+
+  private:
+    size_t m_absent;
+    std::vector<size_t> m_order;    // candidates by level
+    std::vector<double> m_sorted;   // their levels
+    std::vector<size_t> m_position; // candidate -> place in m_order
+    size_t m_leaves{1};
+    std::vector<size_t> m_tree;
+  };
+
   arrow::TablePtr BuildTable(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
     const auto &C = epoch_script::EpochStratifyXConstants::instance();
@@ -74,137 +203,100 @@ private:
     const double pip_range = (max_high - min_low) * m_range_percent;
 
     // Initialize output arrays with NaN
-    std::vector<double> liquidity(N, std::numeric_limits<double>::quiet_NaN());
-    std::vector<double> liquidity_level(
-        N, std::numeric_limits<double>::quiet_NaN());
-    std::vector<double> liquidity_end(N,
-                                      std::numeric_limits<double>::quiet_NaN());
-    std::vector<double> liquidity_swept(
-        N, std::numeric_limits<double>::quiet_NaN());
-
-    // Copy high_low and level to allow marking used candidates
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> liquidity(N, nan);
+    std::vector<double> liquidity_level(N, nan);
+    std::vector<double> liquidity_end(N, nan);
+    std::vector<double> liquidity_swept(N, nan);
+
+    // Copy high_low and level to allow marking used candidates, and read
+    // null prices as NaN so they never sweep a range
     std::vector<int64_t> shl_HL(N);
     std::vector<double> shl_Level(N);
+    std::vector<double> high_values(N);
+    std::vector<double> low_values(N);
     for (index_t i = 0; i < N; ++i) {
       shl_HL[i] = high_low->IsNull(i) ? 0 : high_low->Value(i);
       shl_Level[i] = level->IsNull(i) ? 0.0 : level->Value(i);
+      high_values[i] = high->IsNull(i) ? nan : high->Value(i);
+      low_values[i] = low->IsNull(i) ? nan : low->Value(i);
     }
 
-    // Process bullish liquidity (HighLow == 1)
+    // Swing candidates of each side, in index order
     std::vector<index_t> bull_indices;
+    std::vector<index_t> bear_indices;
     for (index_t i = 0; i < N; ++i) {
-      if (!high_low->IsNull(i) && high_low->Value(i) == 1) {
+      if (shl_HL[i] == 1) {
         bull_indices.push_back(i);
+      } else if (shl_HL[i] == -1) {
+        bear_indices.push_back(i);
       }
     }
 
-    for (auto i : bull_indices) {
-      // Skip if this candidate has already been used
-      if (shl_HL[i] != 1)
-        continue;
-
-      double high_level = shl_Level[i];
-      double range_low = high_level - pip_range;
-      double range_high = high_level + pip_range;
-      std::vector<double> group_levels = {high_level};
-      index_t group_end = i;
-
-      // Determine the swept index
-      index_t swept = 0;
-      index_t c_start = i + 1;
-      if (c_start < N) {
-        for (index_t j = c_start; j < N; ++j) {
-          if (!high->IsNull(j) && high->Value(j) >= range_high) {
-            swept = j;
-            break;
-          }
-        }
+    const auto group = [&](std::vector<index_t> const &candidates,
+                           std::span<const double> prices, int64_t side) {
+      // Bullish ranges are swept by the first later high at or above the
+      // range, bearish ones by the first later low at or below it.
+      const bool bullish = side == 1;
+      const auto swept = FirstSweep(
+          prices, candidates,
+          [&](index_t i) {
+            return bullish ? shl_Level[i] + pip_range
+                           : shl_Level[i] - pip_range;
+          },
+          bullish);
+
+      // Candidates still free to join a group, searchable by level.
+      const size_t K = candidates.size();
+      std::vector<double> levels(K);
+      for (size_t k = 0; k < K; ++k) {
+        levels[k] = shl_Level[candidates[k]];
       }
+      LevelIndex unused{levels};
 
-      // Find other swing highs within range
-      for (auto j : bull_indices) {
-        if (j <= i)
+      std::vector<double> group_levels;
+      for (size_t k = 0; k < K; ++k) {
+        const index_t i = candidates[k];
+        unused.Remove(k);
+        // Skip if this candidate has already been used
+        if (shl_HL[i] != side)
           continue;
-        if (swept && j >= swept)
-          break;
-
-        if (shl_HL[j] == 1 && range_low <= shl_Level[j] &&
-            shl_Level[j] <= range_high) {
-          group_levels.push_back(shl_Level[j]);
-          group_end = j;
-          shl_HL[j] = 0; // mark as used
-        }
-      }
 
-      // Record if more than one candidate is grouped
-      if (group_levels.size() > 1) {
-        double avg_level =
-            std::accumulate(group_levels.begin(), group_levels.end(), 0.0) /
-            group_levels.size();
-        liquidity[i] = 1.0;
-        liquidity_level[i] = avg_level;
-        liquidity_end[i] = static_cast<double>(group_end);
-        liquidity_swept[i] = static_cast<double>(swept);
-      }
-    }
+        const double range_low = shl_Level[i] - pip_range;
+        const double range_high = shl_Level[i] + pip_range;
+        group_levels.assign(1, shl_Level[i]);
+        index_t group_end = i;
 
-    // Process bearish liquidity (HighLow == -1)
-    std::vector<index_t> bear_indices;
-    for (index_t i = 0; i < N; ++i) {
-      if (!high_low->IsNull(i) && high_low->Value(i) == -1) {
-        bear_indices.push_back(i);
-      }
-    }
-
-    for (auto i : bear_indices) {
-      // Skip if this candidate has already been used
-      if (shl_HL[i] != -1)
-        continue;
-
-      double low_level = shl_Level[i];
-      double range_low = low_level - pip_range;
-      double range_high = low_level + pip_range;
-      std::vector<double> group_levels = {low_level};
-      index_t group_end = i;
-
-      // Determine the swept index
-      index_t swept = 0;
-      index_t c_start = i + 1;
-      if (c_start < N) {
-        for (index_t j = c_start; j < N; ++j) {
-          if (!low->IsNull(j) && low->Value(j) <= range_low) {
-            swept = j;
+        // Other swings within range before the sweep, earliest first. Every
+        // candidate before k has left the index, so these all follow i.
+        for (size_t m = unused.First(range_low, range_high); m < K;
+             m = unused.First(range_low, range_high)) {
+          const index_t j = candidates[m];
+          if (swept[k] && j >= swept[k])
             break;
-          }
-        }
-      }
-
-      // Find other swing lows within range
-      for (auto j : bear_indices) {
-        if (j <= i)
-          continue;
-        if (swept && j >= swept)
-          break;
-
-        if (shl_HL[j] == -1 && range_low <= shl_Level[j] &&
-            shl_Level[j] <= range_high) {
           group_levels.push_back(shl_Level[j]);
           group_end = j;
           shl_HL[j] = 0; // mark as used
+          unused.Remove(m);
         }
-      }
 
-      // Record if more than one candidate is grouped
-      if (group_levels.size() > 1) {
-        double avg_level =
-            std::accumulate(group_levels.begin(), group_levels.end(), 0.0) /
-            group_levels.size();
-        liquidity[i] = -1.0;
-        liquidity_level[i] = avg_level;
-        liquidity_end[i] = static_cast<double>(group_end);
-        liquidity_swept[i] = static_cast<double>(swept);
+        // Record if more than one candidate is grouped
+        if (group_levels.size() > 1) {
+          double avg_level =
+              std::accumulate(group_levels.begin(), group_levels.end(), 0.0) /
+              group_levels.size();
+          liquidity[i] = static_cast<double>(side);
+          liquidity_level[i] = avg_level;
+          liquidity_end[i] = static_cast<double>(group_end);
+          liquidity_swept[i] = static_cast<double>(swept[k]);
+        }
       }
-    }
+    };
+
+    // Process bullish liquidity (HighLow == 1)
+    group(bull_indices, high_values, 1);
+    // Process bearish liquidity (HighLow == -1)
+    group(bear_indices, low_values, -1);
 
     // Convert to Arrow arrays
     auto liquidity_arr = ToArrow(liquidity);
@@ -6,10 +6,15 @@
 #include <epoch_frame/factory/series_factory.h>
 #include <epoch_frame/factory/table_factory.h>
 
+#include "zone_scan.h"
+
 #include <algorithm>
-#include <limits>
-#include <numeric>
-#include <ranges>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <tuple>
 #include <vector>
 
 namespace epoch_script::transform {
@@ -18,7 +23,8 @@ namespace epoch_script::transform {
  * OrderBlocks ‑ detects bullish and bearish order‑block zones.
  * The implementation is a C++ port of the reference Python algorithm, but the
  * logic is decomposed into small helpers so that each part can be unit‑tested
- * and reasoned about in isolation.
+ * and reasoned about in isolation. Instead of re-testing every active block
+ * on every bar, each block is visited only at the bars that change it.
  */
 class OrderBlocks : public ITransform {
   /* --------------------------------------------------------------------- */
@@ -43,9 +49,15 @@ private:
   using i64_vec = std::vector<std::int64_t>;
   using dbl_vec = std::vector<double>;
 
+  static constexpr size_t kBullish = 0;
+  static constexpr size_t kBearish = 1;
+
   /* --------------------------------------------------------------------- */
   /*                                State                                  */
   /* --------------------------------------------------------------------- */
+  // Block state is indexed by the block candle and shared by both sides: a
+  // bullish and a bearish block on the same candle overwrite each other, as
+  // in the reference algorithm.
   struct OBState {
     i64_vec ob{};                ///<  1 = bullish, ‑1 = bearish, 0 = none
     dbl_vec top{};               ///<  top of block
@@ -55,67 +67,146 @@ private:
     dbl_vec high_volume{};       ///<  helper
     dbl_vec percentage{};        ///<  strength metric
     i64_vec mitigated_idx{};     ///< index at which block was mitigated
-    std::vector<bool> breaker{}; ///<  breaker flag per candle
+    std::vector<uint8_t> breaker{}; ///<  breaker flag per candle
 
     explicit OBState(index_t n)
         : ob(n, 0), top(n, 0.0), bottom(n, 0.0), ob_volume(n, 0.0),
           low_volume(n, 0.0), high_volume(n, 0.0), percentage(n, 0.0),
-          mitigated_idx(n, 0), breaker(n, false) {}
+          mitigated_idx(n, 0), breaker(n, 0) {}
   };
 
   /* --------------------------------------------------------------------- */
-  /*                         Helper: utils / math                          */
+  /*                          Price series                                 */
   /* --------------------------------------------------------------------- */
-  [[nodiscard]] static inline double nan() {
-    return std::numeric_limits<double>::quiet_NaN();
-  }
-
-  template <typename T>
-  [[nodiscard]] static auto ToArrow(const std::vector<T> &v,
-                                    const i64_vec &ob) {
-    using namespace epoch_frame;
-    // build arrow array with nulls where ob is 0
-    using Builder = typename arrow::CTypeTraits<T>::BuilderType;
-    Builder builder;
-    AssertStatusIsOk(builder.Reserve(v.size()));
-    for (auto const &[val, obs_ref] : std::views::zip(v, ob)) {
-      (obs_ref == 0) ? builder.UnsafeAppendNull() : builder.UnsafeAppend(val);
+  // Per-bar prices the blocks are tested against, each with the segment tree
+  // that finds the next bar crossing a block level.
+  struct Series {
+    dbl_vec high, low, close, volume;
+    dbl_vec bullish_price; ///< price that mitigates a bullish block
+    dbl_vec bearish_price; ///< price that mitigates a bearish block
+    smc_utils::HighTree high_tree;
+    smc_utils::LowTree low_tree;
+    smc_utils::LowTree bullish_tree;
+    smc_utils::HighTree bearish_tree;
+
+    Series(dbl_vec open, dbl_vec high_, dbl_vec low_, dbl_vec close_,
+           dbl_vec volume_, bool close_mitigation)
+        : high(std::move(high_)), low(std::move(low_)),
+          close(std::move(close_)), volume(std::move(volume_)),
+          bullish_price(close_mitigation ? MinOf(open, close) : low),
+          bearish_price(close_mitigation ? MaxOf(open, close) : high),
+          high_tree(high), low_tree(low), bullish_tree(bullish_price),
+          bearish_tree(bearish_price) {}
+
+    static dbl_vec MinOf(const dbl_vec &a, const dbl_vec &b) {
+      dbl_vec out(a.size());
+      for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = std::min(a[i], b[i]);
+      }
+      return out;
     }
-    return AssertResultIsOk(builder.Finish());
-  }
 
-  template <typename T>
-  [[nodiscard]] static auto ToArrow(const std::vector<T> &v) {
-    // For the ob array itself
-    using namespace epoch_frame;
-    using Builder = typename arrow::CTypeTraits<T>::BuilderType;
-    Builder builder;
-    AssertStatusIsOk(builder.Reserve(v.size()));
-    for (auto val : v) {
-      (val == 0) ? builder.UnsafeAppendNull() : builder.UnsafeAppend(val);
+    static dbl_vec MaxOf(const dbl_vec &a, const dbl_vec &b) {
+      dbl_vec out(a.size());
+      for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = std::max(a[i], b[i]);
+      }
+      return out;
     }
-    return AssertResultIsOk(builder.Finish());
-  }
+  };
 
   /* --------------------------------------------------------------------- */
-  /*                       Helper: swing‑index extraction                  */
+  /*                        Active block schedule                          */
   /* --------------------------------------------------------------------- */
-  void ExtractSwingIndices(const arrow::Int64Array &high_low,
-                           i64_vec &swing_high, i64_vec &swing_low) const {
-    const auto N = high_low.length();
-    swing_high.reserve(N / 2);
-    swing_low.reserve(N / 2);
-    for (index_t i = 0; i < static_cast<index_t>(N); ++i) {
-      if (high_low.IsNull(i))
-        continue;
-      const auto v = static_cast<std::int64_t>(high_low.Value(i));
-      if (v == 1) {
-        swing_high.push_back(static_cast<std::int64_t>(i));
-      } else if (v == -1) {
-        swing_low.push_back(static_cast<std::int64_t>(i));
+  /**
+   * Active blocks per side, kept as flat per-candle flags instead of a list
+   * walked on every bar. Each active block is woken only at the next bar
+   * that mitigates or invalidates it; a pending wake-up carries the block's
+   * generation and is dropped once the block changes and is rescheduled.
+   */
+  class ActiveBlocks {
+  public:
+    struct Wake {
+      index_t bar;
+      size_t side;
+      index_t idx;
+      uint32_t generation;
+
+      bool operator>(const Wake &other) const {
+        return std::tie(bar, side) > std::tie(other.bar, other.side);
+      }
+    };
+
+    ActiveBlocks(const OBState &state, const Series &series, index_t n)
+        : m_state(state), m_series(series) {
+      for (auto side : {kBullish, kBearish}) {
+        m_active[side].assign(n, 0);
+        m_generation[side].assign(n, 0);
       }
     }
-  }
+
+    bool IsActive(size_t side, index_t idx) const {
+      return m_active[side][idx] != 0;
+    }
+
+    void Activate(size_t side, index_t idx, index_t from) {
+      m_active[side][idx] = 1;
+      Schedule(side, idx, from);
+    }
+
+    void Deactivate(size_t side, index_t idx) {
+      m_active[side][idx] = 0;
+      ++m_generation[side][idx];
+    }
+
+    // Re-evaluates a block of `side` against the block state from bar `from`
+    void Schedule(size_t side, index_t idx, index_t from) {
+      const auto generation = ++m_generation[side][idx];
+      const index_t bar = NextEvent(side, idx, from);
+      if (bar != smc_utils::npos) {
+        m_queue.push(Wake{bar, side, idx, generation});
+      }
+    }
+
+    // Pops the next live wake-up of `side` due at `bar`
+    std::optional<index_t> Next(index_t bar, size_t side) {
+      while (!m_queue.empty() && m_queue.top().bar == bar &&
+             m_queue.top().side == side) {
+        const auto wake = m_queue.top();
+        m_queue.pop();
+        if (IsActive(side, wake.idx) &&
+            m_generation[side][wake.idx] == wake.generation) {
+          return wake.idx;
+        }
+      }
+      return std::nullopt;
+    }
+
+  private:
+    index_t NextEvent(size_t side, index_t idx, index_t from) const {
+      const double top = m_state.top[idx];
+      const double bottom = m_state.bottom[idx];
+      if (m_state.breaker[idx]) {
+        // already mitigated – next full invalidation
+        return side == kBullish
+                   ? m_series.high_tree.FirstReaching(
+                         from, [top](double v) { return v > top; })
+                   : m_series.low_tree.FirstReaching(
+                         from, [bottom](double v) { return v < bottom; });
+      }
+      return side == kBullish
+                 ? m_series.bullish_tree.FirstReaching(
+                       from, [bottom](double v) { return v < bottom; })
+                 : m_series.bearish_tree.FirstReaching(
+                       from, [top](double v) { return v > top; });
+    }
+
+    const OBState &m_state;
+    const Series &m_series;
+    std::array<std::vector<uint8_t>, 2> m_active;
+    std::array<std::vector<uint32_t>, 2> m_generation;
+    std::priority_queue<Wake, std::vector<Wake>, std::greater<>> m_queue;
+  };
 
   /* --------------------------------------------------------------------- */
   /*                 Helper: reset order‑block at given idx                */
@@ -125,105 +216,61 @@ private:
     S.top[idx] = S.bottom[idx] = S.ob_volume[idx] = S.percentage[idx] = 0.0;
     S.low_volume[idx] = S.high_volume[idx] = 0.0;
     S.mitigated_idx[idx] = 0;
-    S.breaker[idx] = false;
+    S.breaker[idx] = 0;
   }
 
   /* --------------------------------------------------------------------- */
   /*         Helper: bullish / bearish order‑block processors              */
   /* --------------------------------------------------------------------- */
+  // Applies the wake-ups of one side at close_idx. A block that changes is
+  // rescheduled, and so is the other side's block on the same candle since
+  // it reads the same state; bearish blocks are processed after bullish ones
+  // on the same bar.
   template <bool is_bullish>
-  void ProcessActiveOB(const index_t close_idx, const arrow::DoubleArray &open,
-                       const arrow::DoubleArray &high,
-                       const arrow::DoubleArray &low,
-                       const arrow::DoubleArray &close, OBState &S,
-                       i64_vec &active) const {
-    /* Generic routine shared by bullish & bearish blocks */
-    auto cmp_price = [&](double price, double level) {
-      if constexpr (is_bullish) {
-        return price < level;
-      } else {
-        return price > level;
-      }
-    };
-
-    for (auto it = active.begin(); it != active.end();) {
-      const auto idx = static_cast<index_t>(*it);
+  static void ProcessActiveOB(const index_t close_idx, OBState &S,
+                              ActiveBlocks &active) {
+    constexpr size_t side = is_bullish ? kBullish : kBearish;
+    constexpr size_t other = is_bullish ? kBearish : kBullish;
+    const index_t other_from = is_bullish ? close_idx : close_idx + 1;
+
+    while (const auto next = active.Next(close_idx, side)) {
+      const index_t idx = *next;
       if (S.breaker[idx]) {
-        // block already mitigated – look for full invalidation
-        bool invalidate = is_bullish ? (high.Value(close_idx) > S.top[idx])
-                                     : (low.Value(close_idx) < S.bottom[idx]);
-        if (invalidate) {
-          ResetOB(S, idx);
-          it = active.erase(it);
-          continue;
-        }
+        // block already mitigated – fully invalidated
+        ResetOB(S, idx);
+        active.Deactivate(side, idx);
       } else {
-        // check for mitigation
-        if constexpr (is_bullish) {
-          double price = m_close_mitigation ? std::min(open.Value(close_idx),
-                                                       close.Value(close_idx))
-                                            : low.Value(close_idx);
-
-          if (cmp_price(price, S.bottom[idx])) {
-            S.breaker[idx] = true;
-            S.mitigated_idx[idx] = static_cast<std::int64_t>(close_idx - 1);
-          }
-        } else {
-          double price = m_close_mitigation ? std::max(open.Value(close_idx),
-                                                       close.Value(close_idx))
-                                            : high.Value(close_idx);
-
-          if (cmp_price(price, S.top[idx])) {
-            S.breaker[idx] = true;
-            S.mitigated_idx[idx] = static_cast<std::int64_t>(close_idx);
-          }
-        }
+        S.breaker[idx] = 1;
+        S.mitigated_idx[idx] = static_cast<std::int64_t>(
+            is_bullish ? close_idx - 1 : close_idx);
+        active.Schedule(side, idx, close_idx + 1);
+      }
+      if (active.IsActive(other, idx)) {
+        active.Schedule(other, idx, other_from);
       }
-      ++it;
-    }
-  }
-
-  template <typename ArrowArrayT,
-            typename CType = typename ArrowArrayT::value_type>
-  static std::optional<int64_t>
-  last_index_equal_to(const ArrowArrayT &arr, CType target,
-                      int64_t offset_in_parent = 0) {
-    for (int64_t i = arr.length() - 1; i >= 0; --i) {
-      if (!arr.IsNull(i) && arr.Value(i) == target)
-        return offset_in_parent + i;
     }
-    return std::nullopt;
   }
 
   template <bool is_bullish>
-  void
-  TryCreateOB(const index_t close_idx, const arrow::DoubleArray &high,
-              const arrow::DoubleArray &low, const arrow::DoubleArray &close,
-              const arrow::DoubleArray &volume, const i64_vec &swings,
-              std::vector<bool> &crossed, OBState &S, i64_vec &active) const {
-    auto cmp_close_cross = [&](double c, double lvl) {
-      return is_bullish ? (c > lvl) : (c < lvl);
-    };
-    auto cmp_seg_extreme = [&](const arrow::DoubleArray &seg) {
-      std::span<const double> view{seg.raw_values(),
-                                   static_cast<size_t>(seg.length())};
-      return is_bullish ? std::ranges::min(view) : std::ranges::max(view);
-    };
-
+  static void TryCreateOB(const index_t close_idx, const Series &P,
+                          const i64_vec &swings, size_t &next_swing,
+                          std::vector<uint8_t> &crossed, OBState &S,
+                          ActiveBlocks &active) {
     /* Locate last swing point behind current candle */
-    auto it =
-        std::ranges::lower_bound(swings, static_cast<std::int64_t>(close_idx));
-    if (it == swings.begin() || it == swings.end())
+    while (next_swing < swings.size() &&
+           swings[next_swing] < static_cast<std::int64_t>(close_idx)) {
+      ++next_swing;
+    }
+    if (next_swing == 0 || next_swing == swings.size())
       return; // no prior swing
-    const auto swing_idx = static_cast<index_t>(*(--it));
+    const auto swing_idx = static_cast<index_t>(swings[next_swing - 1]);
 
-    const bool cond = cmp_close_cross(close.Value(close_idx),
-                                      is_bullish ? high.Value(swing_idx)
-                                                 : low.Value(swing_idx)) &&
+    const bool cond = (is_bullish ? P.close[close_idx] > P.high[swing_idx]
+                                  : P.close[close_idx] < P.low[swing_idx]) &&
                       !crossed[swing_idx];
     if (!cond)
       return; // no cross
-    crossed[swing_idx] = true;
+    crossed[swing_idx] = 1;
 
     /* Find default block (candle before current) */
     const auto default_idx = static_cast<index_t>(close_idx - 1);
@@ -232,38 +279,25 @@ private:
 
     if constexpr (is_bullish) {
       // For bullish blocks - note inconsistency in Python implementation
-      ob_top = low.Value(default_idx);
-      ob_bottom = high.Value(default_idx);
+      ob_top = P.low[default_idx];
+      ob_bottom = P.high[default_idx];
     } else {
       // For bearish blocks
-      ob_top = high.Value(default_idx);
-      ob_bottom = low.Value(default_idx);
+      ob_top = P.high[default_idx];
+      ob_bottom = P.low[default_idx];
     }
 
-    /* Scan between swing and close for better extreme */
-    if ((close_idx - swing_idx) > 1) {
-      const auto start = swing_idx + 1;
-      const auto end = close_idx;
-      if (end > start) {
-        const auto len = end - start;
-        auto seg = is_bullish ? low.Slice(start, len) : high.Slice(start, len);
-        auto seg_view = epoch_frame::PtrCast<arrow::DoubleArray>(seg);
-        auto extreme = cmp_seg_extreme(*seg_view);
-        auto last = last_index_equal_to(*seg_view, extreme);
-        if (last) {
-          ob_idx = start + *last;
-          if constexpr (is_bullish) {
-            // For bullish blocks - note inconsistency with the default
-            // assignment
-            ob_top = high.Value(ob_idx);
-            ob_bottom = low.Value(ob_idx);
-          } else {
-            // For bearish blocks
-            ob_top = high.Value(ob_idx);
-            ob_bottom = low.Value(ob_idx);
-          }
-        }
-      }
+    /* Scan between swing and close for better extreme: the last candle
+       holding the lowest low (highest high). As with a linear scan seeded
+       by the first candle, a NaN first candle keeps the default. */
+    const auto start = swing_idx + 1;
+    if (close_idx > start &&
+        !std::isnan(is_bullish ? P.low[start] : P.high[start])) {
+      const auto last = is_bullish ? P.low_tree.Extreme(start, close_idx)
+                                   : P.high_tree.Extreme(start, close_idx);
+      ob_idx = last;
+      ob_top = P.high[ob_idx];
+      ob_bottom = P.low[ob_idx];
     }
 
     /* Fill state vectors */
@@ -273,25 +307,30 @@ private:
 
     auto close_idx_2 = close_idx >= 2 ? close_idx - 2 : 0;
     auto close_idx_1 = close_idx >= 1 ? close_idx - 1 : 0;
+    const auto &volume = P.volume;
 
-    S.ob_volume[ob_idx] = volume.Value(close_idx) + volume.Value(close_idx_1) +
-                          volume.Value(close_idx_2);
+    S.ob_volume[ob_idx] =
+        volume[close_idx] + volume[close_idx_1] + volume[close_idx_2];
 
     if constexpr (is_bullish) {
-      S.low_volume[ob_idx] = volume.Value(close_idx_2);
-      S.high_volume[ob_idx] =
-          volume.Value(close_idx) + volume.Value(close_idx_1);
+      S.low_volume[ob_idx] = volume[close_idx_2];
+      S.high_volume[ob_idx] = volume[close_idx] + volume[close_idx_1];
     } else {
-      S.low_volume[ob_idx] =
-          volume.Value(close_idx) + volume.Value(close_idx_1);
-      S.high_volume[ob_idx] = volume.Value(close_idx_2);
+      S.low_volume[ob_idx] = volume[close_idx] + volume[close_idx_1];
+      S.high_volume[ob_idx] = volume[close_idx_2];
     }
     const double max_v = std::max(S.high_volume[ob_idx], S.low_volume[ob_idx]);
     S.percentage[ob_idx] =
         max_v == 0.0 ? 100.0
                      : (std::min(S.high_volume[ob_idx], S.low_volume[ob_idx]) /
                         max_v * 100.0);
-    active.push_back(static_cast<std::int64_t>(ob_idx));
+
+    constexpr size_t side = is_bullish ? kBullish : kBearish;
+    constexpr size_t other = is_bullish ? kBearish : kBullish;
+    active.Activate(side, ob_idx, close_idx + 1);
+    if (active.IsActive(other, ob_idx)) {
+      active.Schedule(other, ob_idx, close_idx + 1);
+    }
   }
 
   /* --------------------------------------------------------------------- */
@@ -302,11 +341,13 @@ private:
     const auto &C = epoch_script::EpochStratifyXConstants::instance();
 
     /* Column shortcuts */
-    const auto open = bars[C.OPEN()].contiguous_array().to_view<double>();
-    const auto high = bars[C.HIGH()].contiguous_array().to_view<double>();
-    const auto low = bars[C.LOW()].contiguous_array().to_view<double>();
-    const auto close = bars[C.CLOSE()].contiguous_array().to_view<double>();
-    const auto volume = bars[C.VOLUME()].contiguous_array().to_view<double>();
+    auto column = [&](std::string const &name) {
+      return smc_utils::ValuesOrNaN(
+          *bars[name].contiguous_array().to_view<double>());
+    };
+    const Series P{column(C.OPEN()),  column(C.HIGH()),
+                   column(C.LOW()),   column(C.CLOSE()),
+                   column(C.VOLUME()), m_close_mitigation};
 
     /* Input columns coming from previous transform */
     const auto high_low =
@@ -316,32 +357,35 @@ private:
 
     /* Pre‑computed swing indices */
     i64_vec swing_high, swing_low;
-    ExtractSwingIndices(*high_low, swing_high, swing_low);
+    for (index_t i = 0; i < N; ++i) {
+      if (high_low->IsNull(i))
+        continue;
+      if (high_low->Value(i) == 1) {
+        swing_high.push_back(static_cast<std::int64_t>(i));
+      } else if (high_low->Value(i) == -1) {
+        swing_low.push_back(static_cast<std::int64_t>(i));
+      }
+    }
 
     /* Working state */
     OBState S(N);
-    std::vector<bool> crossed(N, false);
-    i64_vec active_bullish, active_bearish;
+    std::vector<uint8_t> crossed(N, 0);
+    ActiveBlocks active(S, P, N);
+    size_t next_swing_high = 0, next_swing_low = 0;
 
     /* Main loop */
     for (index_t i = 0; i < N; ++i) {
-      ProcessActiveOB<true>(i, *open, *high, *low, *close, S, active_bullish);
-      ProcessActiveOB<false>(i, *open, *high, *low, *close, S, active_bearish);
+      ProcessActiveOB<true>(i, S, active);
+      ProcessActiveOB<false>(i, S, active);
 
-      TryCreateOB<true>(i, *high, *low, *close, *volume, swing_high, crossed, S,
-                        active_bullish);
-      TryCreateOB<false>(i, *high, *low, *close, *volume, swing_low, crossed, S,
-                         active_bearish);
+      TryCreateOB<true>(i, P, swing_high, next_swing_high, crossed, S,
+                        active);
+      TryCreateOB<false>(i, P, swing_low, next_swing_low, crossed, S,
+                         active);
     }
 
-    /* Convert to Arrow arrays */
-    auto ob_arr = ToArrow(S.ob);
-    auto top_arr = ToArrow(S.top, S.ob);
-    auto bottom_arr = ToArrow(S.bottom, S.ob);
-    auto ob_volume_arr = ToArrow(S.ob_volume, S.ob);
-    auto mitigated_arr = ToArrow(S.mitigated_idx, S.ob);
-    auto percentage_arr = ToArrow(S.percentage, S.ob);
-
+    /* Convert to Arrow arrays, null where there is no block */
+    auto has_block = [&](int64_t i) { return S.ob[i] != 0; };
     auto schema = arrow::schema({
         {GetOutputId("ob"), arrow::int64()},
         {GetOutputId("top"), arrow::float64()},
@@ -352,8 +396,15 @@ private:
     });
 
     return AssertTableResultIsOk(arrow::Table::Make(
-        schema, std::vector{ob_arr, top_arr, bottom_arr, ob_volume_arr,
-                            mitigated_arr, percentage_arr}));
+        schema,
+        arrow::ArrayVector{
+            smc_utils::MakeNullableColumn<std::int64_t>(S.ob, has_block),
+            smc_utils::MakeNullableColumn<double>(S.top, has_block),
+            smc_utils::MakeNullableColumn<double>(S.bottom, has_block),
+            smc_utils::MakeNullableColumn<double>(S.ob_volume, has_block),
+            smc_utils::MakeNullableColumn<std::int64_t>(S.mitigated_idx,
+                                                        has_block),
+            smc_utils::MakeNullableColumn<double>(S.percentage, has_block)}));
   }
 
   /* --------------------------------------------------------------------- */
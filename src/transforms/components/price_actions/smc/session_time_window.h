@@ -1,6 +1,7 @@
 #pragma once
 
 #include <epoch_script/transforms/core/itransform.h>
+#include <epoch_script/transforms/core/sessions_utils.h>
 #include <epoch_script/core/time_frame.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include "date_time/date_offsets.h"
@@ -10,7 +11,8 @@ namespace epoch_script::transform {
 /**
  * SessionTimeWindow - Detects when bars are exactly X minutes from session boundaries
  *
- * Returns true when a bar's timestamp equals the computed offset from session start/end
+ * Returns true when a bar's timestamp equals the computed offset from session
+ * start/end, evaluated in the session's local timezone
  */
 class SessionTimeWindow : public ITransform {
 public:
@@ -18,7 +20,10 @@ public:
       : ITransform(config),
         m_session_type(config.GetOptionValue("session_type").GetSelectOption<epoch_core::SessionType>()),
         m_minute_offset(config.GetOptionValue("minute_offset").GetInteger()),
-        m_boundary_type(config.GetOptionValue("boundary_type").GetString()) {}
+        m_boundary_type(config.GetOptionValue("boundary_type").GetString()),
+        m_window_range(MakeWindowRange(
+            epoch_script::kSessionRegistry.at(m_session_type), m_minute_offset,
+            m_boundary_type)) {}
 
   [[nodiscard]] epoch_frame::DataFrame
   TransformData(epoch_frame::DataFrame const &df) const override {
@@ -28,72 +33,68 @@ public:
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
 
-    const size_t N = bars.num_rows();
-    std::vector<bool> in_window(N, false);
-
-    // Get the index (timestamps) from the dataframe
-    auto index = bars.index();
-
-    // Build session range from session_type
-    epoch_frame::SessionRange range = epoch_script::kSessionRegistry.at(m_session_type);
-
-    // Convert session times to UTC and compute boundaries
-    const auto startHMS = range.start;
-    const auto endHMS = range.end;
-
-    // Cache for current session boundary
-    std::optional<int64_t> cachedDate;
-    int64_t targetTimestamp = 0;
-
-    for (size_t i = 0; i < N; ++i) {
-      auto dt = index->at(i);
-      int64_t dtUTC = dt.timestamp().value;
-
-      // Extract date component (UTC date at midnight)
-      int64_t currentDate = (dtUTC / 86400000000LL) * 86400000000LL;
-
-      // If date changed, recompute session boundaries
-      if (!cachedDate || *cachedDate != currentDate) {
-        cachedDate = currentDate;
-
-        // Compute session start/end in UTC
-        int64_t sessionStartUTC = currentDate +
-          (startHMS.hour.count() * 3600LL + startHMS.minute.count() * 60LL + startHMS.second.count()) * 1000000LL;
-        int64_t sessionEndUTC = currentDate +
-          (endHMS.hour.count() * 3600LL + endHMS.minute.count() * 60LL + endHMS.second.count()) * 1000000LL;
-
-        // Handle session crossing midnight
-        if (sessionEndUTC <= sessionStartUTC) {
-          sessionEndUTC += 86400000000LL; // Add 24 hours
-        }
-
-        // Apply minute offset based on boundary_type
-        int64_t offsetMicroseconds = m_minute_offset * 60LL * 1000000LL;
-
-        if (m_boundary_type == "start") {
-          // X minutes from session start
-          targetTimestamp = sessionStartUTC + offsetMicroseconds;
-        } else if (m_boundary_type == "end") {
-          // X minutes before session end (negative offset)
-          targetTimestamp = sessionEndUTC - offsetMicroseconds;
-        } else {
-          throw std::runtime_error("Invalid boundary_type: must be 'start' or 'end'");
-        }
-      }
-
-      // Check if current bar timestamp matches target
-      in_window[i] = (dtUTC == targetTimestamp);
-    }
+    // The offset boundary is the open (or close) of a shifted session, so the
+    // shared session masks answer it directly
+    const auto masks =
+        sessions_utils::GetSessionMasks(bars.index(), m_window_range);
+    const auto &in_window =
+        m_boundary_type == "start" ? masks->opened : masks->closed;
 
     return AssertTableResultIsOk(arrow::Table::Make(
         arrow::schema({{GetOutputId("value"), arrow::boolean()}}),
-        {factory::array::make_array(in_window)}));
+        {std::make_shared<arrow::ChunkedArray>(in_window)}));
   }
 
 private:
   epoch_core::SessionType m_session_type;
   int64_t m_minute_offset;
   std::string m_boundary_type;
+  epoch_frame::SessionRange m_window_range;
+
+  static constexpr int64_t kSecondsPerDay = 86400;
+
+  static int64_t SecondsOfDay(epoch_frame::Time const &time) {
+    return time.hour.count() * 3600LL + time.minute.count() * 60LL +
+           time.second.count();
+  }
+
+  // Session time shifted by `minutes`, wrapped to the same day
+  static epoch_frame::Time ShiftTime(epoch_frame::Time const &time,
+                                     int64_t minutes) {
+    int64_t seconds = SecondsOfDay(time) + minutes * 60LL;
+    seconds = (seconds % kSecondsPerDay + kSecondsPerDay) % kSecondsPerDay;
+    return epoch_frame::Time{std::chrono::hours(seconds / 3600),
+                             std::chrono::minutes(seconds / 60 % 60),
+                             std::chrono::seconds(seconds % 60),
+                             std::chrono::microseconds(0), time.tz};
+  }
+
+  // X minutes after session start moves the start; X minutes before session
+  // end moves the end. An offset past the other boundary would wrap into
+  // another session, so it is rejected.
+  static epoch_frame::SessionRange
+  MakeWindowRange(epoch_frame::SessionRange range, int64_t minute_offset,
+                  std::string const &boundary_type) {
+    // Sessions crossing midnight end on the next day
+    int64_t length = (SecondsOfDay(range.end) - SecondsOfDay(range.start) +
+                      kSecondsPerDay) % kSecondsPerDay;
+    length = length == 0 ? kSecondsPerDay : length;
+    if (minute_offset < 0 || minute_offset * 60 > length) {
+      throw std::runtime_error(
+          "Invalid minute_offset " + std::to_string(minute_offset) +
+          ": must be between 0 and the session length of " +
+          std::to_string(length / 60) + " minutes");
+    }
+    if (boundary_type == "start") {
+      range.start = ShiftTime(range.start, minute_offset);
+    } else if (boundary_type == "end") {
+      range.end = ShiftTime(range.end, -minute_offset);
+    } else {
+      throw std::runtime_error(
+          "Invalid boundary_type: must be 'start' or 'end'");
+    }
+    return range;
+  }
 };
 
 } // namespace epoch_script::transform
@@ -70,16 +70,14 @@ private:
     const auto high_arr = bars[C.HIGH()].contiguous_array();
     const auto low_arr = bars[C.LOW()].contiguous_array();
 
-    auto barsIndexUTC = bars.index()->tz_localize("UTC");
-
-    auto [active, opened, closed] =
-        sessions_utils::BuildActiveMaskUTC(barsIndexUTC, m_time_range);
+    const auto masks =
+        sessions_utils::GetSessionMasks(bars.index(), m_time_range);
     std::vector<double> high(bars.size());
     std::vector<double> low(bars.size());
 
     for (size_t i = 0; i < bars.size(); ++i) {
 
-      if (active[i]) {
+      if (masks->active->Value(i)) {
         high[i] = std::max(high_arr[i].as_double(), i > 0 ? high[i - 1] : 0);
         low[i] = std::min(low_arr[i].as_double(),
                           (i > 0 && low[i - 1] != 0)
@@ -98,9 +96,10 @@ private:
 
     return AssertTableResultIsOk(arrow::Table::Make(
         schema,
-        {factory::array::make_array(active), factory::array::make_array(opened),
-         factory::array::make_array(closed), factory::array::make_array(high),
-         factory::array::make_array(low)}));
+        {std::make_shared<arrow::ChunkedArray>(masks->active),
+         std::make_shared<arrow::ChunkedArray>(masks->opened),
+         std::make_shared<arrow::ChunkedArray>(masks->closed),
+         factory::array::make_array(high), factory::array::make_array(low)}));
   }
 
   /* ------------------------------------------------------------------ */
@@ -1,52 +1,211 @@
 #include <epoch_script/transforms/core/sessions_utils.h>
-#include <epoch_frame/factory/array_factory.h>
+#include <arrow/buffer.h>
+#include <arrow/util/bit_util.h>
+#include <epoch_core/macros.h>
+#include <epoch_frame/common.h>
 #include <epoch_frame/factory/series_factory.h>
 #include <epoch_frame/index.h>
 
+#include <chrono>
+#include <deque>
+#include <format>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
 namespace epoch_script::transform::sessions_utils {
 
-SessionState BuildActiveMaskUTC(const epoch_frame::IndexPtr &utcIndex,
-                                const epoch_frame::SessionRange &range) {
-  SessionState state;
-  state.active.resize(utcIndex->size(), false);
-  state.opened.resize(utcIndex->size(), false);
-  state.closed.resize(utcIndex->size(), false);
-
-  // Determine session tz: prefer range.start/end tz, fallback to UTC
-  const std::string sessionTz =
-      !range.start.tz.empty()
-          ? range.start.tz
-          : (!range.end.tz.empty() ? range.end.tz : std::string("UTC"));
-
-  // Cache computed [startUTC, endUTC] per local date to avoid recompute
-  std::optional<epoch_frame::Date> cachedDate;
-  epoch_frame::DateTime cachedStartUTC;
-  epoch_frame::DateTime cachedEndUTC;
-
-  for (size_t i = 0; i < utcIndex->size(); ++i) {
-    const auto dtUTC = utcIndex->at(i).to_datetime();
-    const auto dtLocal = dtUTC.tz_convert(sessionTz);
-    const auto localDate = dtLocal.date();
-
-    if (!cachedDate || *cachedDate != localDate) {
-      cachedDate = localDate;
-      // Build local start/end DateTime for this date
-      auto startLocal = epoch_frame::DateTime{localDate, range.start};
-      auto endLocal = epoch_frame::DateTime{localDate, range.end};
-      if (range.end < range.start) {
-        endLocal = epoch_frame::DateTime{localDate + chrono_days(1), range.end};
+namespace {
+constexpr int64_t kNanosPerDay = 86'400'000'000'000;
+
+int64_t FloorDiv(int64_t value, int64_t divisor) {
+  return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+// Session boundaries of one local calendar date, in UTC nanoseconds
+struct SessionDay {
+  int64_t date{0}; // local date, days since the epoch
+  int64_t midnight{0};
+  int64_t nextMidnight{0};
+  int64_t start{0};
+  int64_t end{0};
+};
+
+// Walks local dates of the session timezone. Timezone conversions happen
+// once per local date (its midnights and session bounds); each timestamp is
+// then placed by integer comparison against the current date's midnights.
+class SessionDayTable {
+public:
+  explicit SessionDayTable(const epoch_frame::SessionRange &range)
+      : m_range(range),
+        // Determine session tz: prefer range.start/end tz, fallback to UTC
+        m_tz(!range.start.tz.empty()
+                 ? range.start.tz
+                 : (!range.end.tz.empty() ? range.end.tz
+                                          : std::string("UTC"))) {}
+
+  const SessionDay &Locate(int64_t timestamp) {
+    if (m_day && m_day->midnight <= timestamp &&
+        timestamp < m_day->nextMidnight) {
+      return *m_day;
+    }
+    // The local date is within a day of the UTC date
+    m_day = Build(m_day && timestamp >= m_day->nextMidnight &&
+                          timestamp - m_day->nextMidnight < kNanosPerDay
+                      ? m_day->date + 1
+                      : FloorDiv(timestamp, kNanosPerDay));
+    while (timestamp < m_day->midnight) {
+      m_day = Build(m_day->date - 1);
+    }
+    while (timestamp >= m_day->nextMidnight) {
+      m_day = Build(m_day->date + 1);
+    }
+    return *m_day;
+  }
+
+private:
+  static epoch_frame::Date ToDate(int64_t date) {
+    const std::chrono::year_month_day ymd{
+        std::chrono::sys_days{std::chrono::days{date}}};
+    return epoch_frame::Date{ymd.year(), ymd.month(), ymd.day()};
+  }
+
+  int64_t ToUTC(const epoch_frame::Date &date,
+                const epoch_frame::Time &time) const {
+    return epoch_frame::DateTime{date, time}
+        .tz_convert("UTC")
+        .m_nanoseconds.count();
+  }
+
+  SessionDay Build(int64_t date) const {
+    const epoch_frame::Time midnight{
+        std::chrono::hours(0), std::chrono::minutes(0),
+        std::chrono::seconds(0), std::chrono::microseconds(0), m_tz};
+    const auto localDate = ToDate(date);
+    const auto nextDate = ToDate(date + 1);
+
+    SessionDay day;
+    day.date = date;
+    day.midnight = ToUTC(localDate, midnight);
+    day.nextMidnight = ToUTC(nextDate, midnight);
+    day.start = ToUTC(localDate, m_range.start);
+    day.end = ToUTC(m_range.end < m_range.start ? nextDate : localDate,
+                    m_range.end);
+    return day;
+  }
+
+  const epoch_frame::SessionRange &m_range;
+  std::string m_tz;
+  std::optional<SessionDay> m_day;
+};
+
+std::shared_ptr<const SessionMasks>
+BuildSessionMasks(const arrow::TimestampArray &timestamps,
+                  const epoch_frame::SessionRange &range) {
+  const int64_t N = timestamps.length();
+  auto active = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  auto opened = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  auto closed = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+
+  SessionDayTable days{range};
+  const int64_t *values = timestamps.raw_values();
+  for (int64_t i = 0; i < N; ++i) {
+    const int64_t t = values[i];
+    const auto &day = days.Locate(t);
+    if (day.start <= t && t <= day.end) {
+      arrow::bit_util::SetBit(active->mutable_data(), i);
+    }
+    if (day.start == t) {
+      arrow::bit_util::SetBit(opened->mutable_data(), i);
+    }
+    if (day.end == t) {
+      arrow::bit_util::SetBit(closed->mutable_data(), i);
+    }
+  }
+
+  auto masks = std::make_shared<SessionMasks>();
+  masks->active = std::make_shared<arrow::BooleanArray>(N, std::move(active));
+  masks->opened = std::make_shared<arrow::BooleanArray>(N, std::move(opened));
+  masks->closed = std::make_shared<arrow::BooleanArray>(N, std::move(closed));
+  return masks;
+}
+
+std::string RangeKey(const epoch_frame::SessionRange &range) {
+  auto time = [](const epoch_frame::Time &t) {
+    return std::format("{}:{}:{} {}", t.hour.count(), t.minute.count(),
+                       t.second.count(), t.tz);
+  };
+  return time(range.start) + "-" + time(range.end);
+}
+
+/**
+ * Masks keyed by the identity of the index values buffer and the session
+ * range. Entries hold the buffer so its address cannot be reused by another
+ * index while cached; the oldest entries are evicted past kCapacity.
+ */
+class SessionMaskCache {
+public:
+  static SessionMaskCache &Instance() {
+    static SessionMaskCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const SessionMasks>
+  Get(const std::shared_ptr<arrow::TimestampArray> &timestamps,
+      const epoch_frame::SessionRange &range) {
+    const Key key{timestamps->values()->data(), timestamps->offset(),
+                  timestamps->length(), RangeKey(range)};
+    {
+      std::lock_guard lock(m_mutex);
+      if (auto it = m_entries.find(key); it != m_entries.end()) {
+        return it->second.masks;
       }
-      // Convert to UTC once
-      cachedStartUTC = startLocal.tz_convert("UTC");
-      cachedEndUTC = endLocal.tz_convert("UTC");
     }
-    state.opened[i] = (cachedStartUTC == dtUTC);
-    state.closed[i] = (cachedEndUTC == dtUTC);
 
-    state.active[i] = (cachedStartUTC <= dtUTC && dtUTC <= cachedEndUTC);
+    auto masks = BuildSessionMasks(*timestamps, range);
+    std::lock_guard lock(m_mutex);
+    auto [it, inserted] =
+        m_entries.try_emplace(key, Entry{timestamps->values(), masks});
+    if (inserted) {
+      m_order.push_back(key);
+      if (m_order.size() > kCapacity) {
+        m_entries.erase(m_order.front());
+        m_order.pop_front();
+      }
+    }
+    return it->second.masks;
   }
 
-  return state;
+private:
+  static constexpr size_t kCapacity = 256;
+
+  using Key = std::tuple<const uint8_t *, int64_t, int64_t, std::string>;
+  struct Entry {
+    std::shared_ptr<arrow::Buffer> buffer;
+    std::shared_ptr<const SessionMasks> masks;
+  };
+
+  std::mutex m_mutex;
+  std::map<Key, Entry> m_entries;
+  std::deque<Key> m_order;
+};
+} // namespace
+
+std::shared_ptr<const SessionMasks>
+GetSessionMasks(const epoch_frame::IndexPtr &index,
+                const epoch_frame::SessionRange &range) {
+  // Timestamp values are UTC for both naive and tz-aware indexes
+  const auto timestamps = index->array().to_timestamp_view();
+  AssertFromFormat(
+      std::static_pointer_cast<arrow::TimestampType>(timestamps->type())
+              ->unit() == arrow::TimeUnit::NANO,
+      "Session masks require a nanosecond timestamp index");
+  if (timestamps->length() == 0) {
+    return BuildSessionMasks(*timestamps, range);
+  }
+  return SessionMaskCache::Instance().Get(timestamps, range);
 }
 
 epoch_frame::DataFrame
@@ -56,8 +215,8 @@ SliceBySessionUTC(const epoch_frame::DataFrame &dfUTC,
     return dfUTC;
   auto mask = epoch_frame::make_series(
       dfUTC.index(),
-      epoch_frame::factory::array::make_array(
-          BuildActiveMaskUTC(dfUTC.index(), range).active),
+      std::make_shared<arrow::ChunkedArray>(
+          GetSessionMasks(dfUTC.index(), range)->active),
       "__session_active");
   return dfUTC.loc(mask);
 }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "../infrastructure/pivot_scan.h"
 #include <epoch_script/transforms/core/itransform.h>
 
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/factory/series_factory.h>
 #include <epoch_frame/factory/table_factory.h>
 
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
 namespace epoch_script::transform {
 /**
     Swing Highs and Lows
@@ -28,116 +34,139 @@ public:
 
   arrow::TablePtr Call(epoch_frame::DataFrame const &bars) const {
     using namespace epoch_frame;
-    const auto &C = epoch_script::EpochStratifyXConstants::instance();
-    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
-    const Scalar null{nan};
-
-    size_t N = bars.num_rows();
-    const auto high = bars[C.HIGH()].contiguous_array();
-    const auto low = bars[C.LOW()].contiguous_array();
-
-    const auto min_next_low =
-        Series{low.shift(-(m_swing_length / 2)).value()}
-            .to_frame()
-            .rolling_agg({.window_size = static_cast<int64_t>(m_swing_length)})
-            .min()
-            .to_series()
-            .contiguous_array();
-    const auto max_next_high =
-        Series{high.shift(-(m_swing_length / 2)).value()}
-            .to_frame()
-            .rolling_agg({.window_size = static_cast<int64_t>(m_swing_length)})
-            .max()
-            .to_series()
-            .contiguous_array();
-
-    auto replacement =
-        Array{factory::array::make_contiguous_array(std::vector(N, -1L))}.where(
-            low == min_next_low, Scalar{});
-    auto swing_highs_lows =
-        Array{factory::array::make_contiguous_array(std::vector(N, 1L))}.where(
-            high == max_next_high, replacement);
-
-    while (true) {
-      auto pos = swing_highs_lows.is_not_null().where().to_vector<uint64_t>();
-      const auto P = pos.size();
-      if (P < 2)
-        break;
-
-      std::vector<bool> remove_flag(P, false);
-
-      for (size_t k = 0; k < P - 1; ++k) {
-        const auto cur = swing_highs_lows[pos[k]].as_int64();
-        const auto nxt = swing_highs_lows[pos[k + 1]].as_int64();
-
-        if (cur == 1 && nxt == 1) {
-          const double h_cur = high[pos[k]].as_double();
-          const double h_nxt = high[pos[k + 1]].as_double();
-          if (h_cur < h_nxt)
-            remove_flag[k] = true;
-          else
-            remove_flag[k + 1] = true;
-        } else if (cur == -1 && nxt == -1) {
-          const double l_cur = low[pos[k]].as_double();
-          const double l_nxt = low[pos[k + 1]].as_double();
-          if (l_cur > l_nxt)
-            remove_flag[k] = true;
-          else
-            remove_flag[k + 1] = true;
-        }
-      }
-
-      if (std::ranges::none_of(remove_flag, [](bool x) { return x; }))
-        break;
 
-      // rebuild array with nans where flagged
-      auto shl_vec =
-          swing_highs_lows.cast(arrow::float64()).to_vector<double>();
-      for (size_t k = 0; k < P; ++k)
-        if (remove_flag[k])
-          shl_vec[pos[k]] = nan;
+    const pattern_utils::HighLowSpans prices{bars};
+    const size_t N = prices.size();
+    const auto high = prices.high;
+    const auto low = prices.low;
+
+    const auto is_max_high =
+        MatchesWindowExtreme(high, std::greater_equal<double>{});
+    const auto is_min_low = MatchesWindowExtreme(low, std::less_equal<double>{});
+
+    // 1 = swing high, -1 = swing low, 0 = none. A candle without a full
+    // high window stays empty, as does one that is neither extreme.
+    std::vector<int64_t> swing_highs_lows(N, 0);
+    for (size_t i = 0; i < N; ++i) {
+      if (!is_max_high[i]) {
+        continue;
+      }
+      if (*is_max_high[i]) {
+        swing_highs_lows[i] = 1;
+      } else if (is_min_low[i].value_or(false)) {
+        swing_highs_lows[i] = -1;
+      }
+    }
 
-      swing_highs_lows =
-          Array{factory::array::make_contiguous_array(shl_vec)}.cast(
-              arrow::int64());
+    // Collapse consecutive swings of the same kind into the highest high /
+    // lowest low (the earliest one on ties). Swings of the opposite kind are
+    // never removed, so each run only has to be compared against the last
+    // swing kept.
+    std::optional<size_t> first_swing;
+    std::optional<size_t> last_swing;
+    for (size_t i = 0; i < N; ++i) {
+      if (swing_highs_lows[i] == 0) {
+        continue;
+      }
+      if (!first_swing) {
+        first_swing = i;
+      }
+      if (last_swing && swing_highs_lows[*last_swing] == swing_highs_lows[i]) {
+        const size_t prev = *last_swing;
+        const bool replace = swing_highs_lows[i] == 1 ? high[prev] < high[i]
+                                                      : low[prev] > low[i];
+        if (!replace) {
+          swing_highs_lows[i] = 0;
+          continue;
+        }
+        swing_highs_lows[prev] = 0;
+        if (first_swing == prev) {
+          first_swing = i;
+        }
+      }
+      last_swing = i;
     }
-    // -----------------------------------------------------------------
 
     // --- “pad” the ends safely --------------------------------------
-    {
-      auto shl_vec =
-          swing_highs_lows.cast(arrow::float64()).to_vector<double>();
-      std::vector<size_t> pos;
-      for (int64_t i = 0; i < swing_highs_lows.length(); ++i)
-        if (!std::isnan(shl_vec[i]))
-          pos.push_back(static_cast<size_t>(i));
-
-      if (!pos.empty()) {
-        if (shl_vec[pos.front()] == 1)
-          shl_vec[0] = -1.0;
-        else
-          shl_vec[0] = 1.0;
-
-        if (shl_vec[pos.back()] == -1)
-          shl_vec.back() = 1.0;
-        else
-          shl_vec.back() = -1.0;
-      }
-      swing_highs_lows =
-          Array{factory::array::make_contiguous_array(shl_vec)}.cast(
-              arrow::int64());
+    if (first_swing) {
+      const int64_t first = swing_highs_lows[*first_swing];
+      const int64_t last = swing_highs_lows[*last_swing];
+      swing_highs_lows.front() = first == 1 ? -1 : 1;
+      swing_highs_lows.back() = last == -1 ? 1 : -1;
     }
 
-    auto level = high.where(swing_highs_lows == Scalar{1L}, low);
-    level = level.where(swing_highs_lows.is_not_null(), null);
+    arrow::Int64Builder high_low_builder;
+    arrow::DoubleBuilder level_builder;
+    AssertStatusIsOk(high_low_builder.Reserve(N));
+    AssertStatusIsOk(level_builder.Reserve(N));
+    for (size_t i = 0; i < N; ++i) {
+      if (swing_highs_lows[i] == 0) {
+        high_low_builder.UnsafeAppendNull();
+        level_builder.UnsafeAppendNull();
+        continue;
+      }
+      high_low_builder.UnsafeAppend(swing_highs_lows[i]);
+      level_builder.UnsafeAppend(swing_highs_lows[i] == 1 ? high[i] : low[i]);
+    }
 
     return AssertTableResultIsOk(arrow::Table::Make(
         arrow::schema({{GetOutputId("high_low"), arrow::int64()},
                        {GetOutputId("level"), arrow::float64()}}),
-        {swing_highs_lows.value(), level.value()}));
+        {AssertResultIsOk(high_low_builder.Finish()),
+         AssertResultIsOk(level_builder.Finish())}));
   }
 
 private:
+  /**
+   * For each candle i, whether values[i] is the extreme of
+   * values[i - half + 1, i + half] (the window the shift(-half) +
+   * rolling(swing_length) formulation compares against). Rows before
+   * swing_length - 1, rows without half candles after them and windows
+   * holding a NaN have no value, matching the null rolling aggregate.
+   *
+   * `dominates(a, b)` is true when a replaces b as the window extreme; a
+   * monotonic deque keeps the whole scan O(N).
+   */
+  template <typename Dominates>
+  std::vector<std::optional<bool>>
+  MatchesWindowExtreme(std::span<const double> values,
+                       Dominates dominates) const {
+    const size_t N = values.size();
+    const size_t half = m_swing_length / 2;
+    std::vector<std::optional<bool>> result(N);
+    if (half == 0) {
+      return result;
+    }
+
+    std::deque<size_t> extremes;
+    std::optional<size_t> last_nan;
+    for (size_t end = 0; end < N; ++end) {
+      if (std::isnan(values[end])) {
+        last_nan = end;
+      } else {
+        while (!extremes.empty() &&
+               dominates(values[end], values[extremes.back()])) {
+          extremes.pop_back();
+        }
+        extremes.push_back(end);
+      }
+
+      if (end + 1 < m_swing_length + half) {
+        continue;
+      }
+      const size_t i = end - half;
+      const size_t start = i + 1 - half;
+      while (!extremes.empty() && extremes.front() < start) {
+        extremes.pop_front();
+      }
+      if (last_nan && *last_nan >= start) {
+        continue;
+      }
+      result[i] = values[i] == values[extremes.front()];
+    }
+    return result;
+  }
+
   size_t m_swing_length;
 };
-} // namespace epoch_script::transform
\ No newline at end of file
+} // namespace epoch_script::transform
@@ -0,0 +1,159 @@
+#pragma once
+//
+// Columnar scans shared by the SMC zone transforms (order blocks, fair value
+// gaps, BOS/CHoCH)
+//
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/type_traits.h>
+#include <arrow/util/bit_util.h>
+#include <epoch_frame/common.h>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace epoch_script::transform::smc_utils {
+
+constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+/**
+ * Segment tree over one price series answering the two questions zone
+ * transforms ask for every live zone: the first bar at or after a position
+ * whose price reaches a level, and the extreme bar of a range. NaN prices
+ * never reach a level and never become the extreme. Better is std::less<>
+ * for low-side series and std::greater<> for high-side series.
+ */
+template <typename Better> class PriceExtremeTree {
+public:
+  explicit PriceExtremeTree(std::span<const double> values)
+      : m_values(values) {
+    while (m_leaves < values.size()) {
+      m_leaves <<= 1;
+    }
+    m_best.assign(2 * m_leaves, npos);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (!std::isnan(values[i])) {
+        m_best[m_leaves + i] = i;
+      }
+    }
+    for (size_t node = m_leaves; node-- > 1;) {
+      m_best[node] = Combine(m_best[2 * node], m_best[2 * node + 1]);
+    }
+  }
+
+  // First index >= from whose value satisfies reaches, or npos. reaches must
+  // hold for a node's extreme whenever it holds for any value below it, e.g.
+  // `v < level` on a std::less<> tree.
+  template <typename Reaches>
+  size_t FirstReaching(size_t from, Reaches &&reaches) const {
+    if (from >= m_values.size()) {
+      return npos;
+    }
+    return First(1, 0, m_leaves, from, reaches);
+  }
+
+  // Index of the extreme value in [first, last), the later one on ties, or
+  // npos when the range holds no comparable value.
+  size_t Extreme(size_t first, size_t last) const {
+    return Best(1, 0, m_leaves, first, last);
+  }
+
+private:
+  size_t Combine(size_t left, size_t right) const {
+    if (left == npos) {
+      return right;
+    }
+    if (right == npos) {
+      return left;
+    }
+    return Better{}(m_values[left], m_values[right]) ? left : right;
+  }
+
+  template <typename Reaches>
+  size_t First(size_t node, size_t lo, size_t hi, size_t from,
+               Reaches &reaches) const {
+    if (hi <= from || m_best[node] == npos ||
+        !reaches(m_values[m_best[node]])) {
+      return npos;
+    }
+    if (hi - lo == 1) {
+      return lo;
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    if (const auto left = First(2 * node, lo, mid, from, reaches);
+        left != npos) {
+      return left;
+    }
+    return First(2 * node + 1, mid, hi, from, reaches);
+  }
+
+  size_t Best(size_t node, size_t lo, size_t hi, size_t first,
+              size_t last) const {
+    if (last <= lo || hi <= first) {
+      return npos;
+    }
+    if (first <= lo && hi <= last) {
+      return m_best[node];
+    }
+    const size_t mid = lo + (hi - lo) / 2;
+    return Combine(Best(2 * node, lo, mid, first, last),
+                   Best(2 * node + 1, mid, hi, first, last));
+  }
+
+  std::span<const double> m_values;
+  size_t m_leaves{1};
+  std::vector<size_t> m_best; // index of the node's extreme, npos if none
+};
+
+using LowTree = PriceExtremeTree<std::less<>>;
+using HighTree = PriceExtremeTree<std::greater<>>;
+
+// Values of a double column with nulls read as NaN
+inline std::vector<double> ValuesOrNaN(const arrow::DoubleArray &array) {
+  std::vector<double> values(array.raw_values(),
+                             array.raw_values() + array.length());
+  if (array.null_count() > 0) {
+    for (int64_t i = 0; i < array.length(); ++i) {
+      if (array.IsNull(i)) {
+        values[i] = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+  }
+  return values;
+}
+
+/**
+ * Arrow column over values with the null bitmap written in one pass from
+ * is_valid(row), instead of appending row by row through a builder.
+ */
+template <typename T, typename IsValid>
+arrow::ArrayPtr MakeNullableColumn(std::span<const T> values,
+                                   IsValid &&is_valid) {
+  const auto N = static_cast<int64_t>(values.size());
+  std::shared_ptr<arrow::Buffer> data = epoch_frame::AssertResultIsOk(
+      arrow::AllocateBuffer(N * static_cast<int64_t>(sizeof(T))));
+  if (N > 0) {
+    std::memcpy(data->mutable_data(), values.data(), N * sizeof(T));
+  }
+
+  auto bitmap = epoch_frame::AssertResultIsOk(arrow::AllocateEmptyBitmap(N));
+  int64_t null_count = 0;
+  for (int64_t i = 0; i < N; ++i) {
+    if (is_valid(i)) {
+      arrow::bit_util::SetBit(bitmap->mutable_data(), i);
+    } else {
+      ++null_count;
+    }
+  }
+
+  using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      arrow::TypeTraits<ArrowType>::type_singleton(), N,
+      {std::move(bitmap), std::move(data)}, null_count));
+}
+
+} // namespace epoch_script::transform::smc_utils
@@ -27,6 +27,7 @@
 #include "hosseinmoein/statistics/beta.h"
 #include "hosseinmoein/statistics/ewm_corr.h"
 #include "hosseinmoein/statistics/ewm_cov.h"
+#include "hosseinmoein/statistics/stationary_check.h"
 
 // Chart Formation Pattern Transforms
 #include "price_actions/infrastructure/flexible_pivot_detector.h"
@@ -118,6 +119,7 @@
 #include "operators/modulo.h"
 #include "operators/power.h"
 #include "operators/groupby_agg.h"
+#include "operators/fused_expression.h"
 #include "scalar.h"
 #include "tulip/tulip_model.h"
 #include "volatility/volatility.h"
@@ -128,9 +130,10 @@ namespace epoch_script::transform {
 void InitializeTransforms(
     std::function<YAML::Node(std::string const &)> const &loader,
     std::vector<std::string> const &algorithmBuffers,
-    std::vector<std::string> const &strategyBuffers) {
-  epoch_script::strategy::RegisterStrategyMetadata(loader, algorithmBuffers,
-                                                     strategyBuffers);
+    std::vector<std::string> const &strategyBuffers,
+    std::filesystem::path const &transformMetadataSnapshot) {
+  epoch_script::strategy::RegisterStrategyMetadata(
+      loader, algorithmBuffers, strategyBuffers, transformMetadataSnapshot);
 
   // Scalar Transforms
   REGISTER_TRANSFORM(number, NumericScalarDataFrameTransform);
@@ -199,6 +202,10 @@ void InitializeTransforms(
   REGISTER_TRANSFORM(static_cast_to_string, StaticCastToString);
   REGISTER_TRANSFORM(static_cast_to_timestamp, StaticCastToTimestamp);
 
+  // Fused elementwise expressions (compiler-inserted)
+  REGISTER_TRANSFORM(fused_expression_number, FusedExpressionNumber);
+  REGISTER_TRANSFORM(fused_expression_boolean, FusedExpressionBoolean);
+
   REGISTER_TRANSFORM(modulo, ModuloTransform);
   REGISTER_TRANSFORM(power_op, PowerTransform);
 
@@ -390,6 +397,8 @@ void InitializeTransforms(
   REGISTER_TRANSFORM(beta, Beta);
   REGISTER_TRANSFORM(ewm_corr, EWMCorr);
   REGISTER_TRANSFORM(ewm_cov, EWMCov);
+  REGISTER_TRANSFORM(rolling_adf, ADFStationaryCheck);
+  REGISTER_TRANSFORM(rolling_kpss, KPSSStationaryCheck);
 
   REGISTER_TRANSFORM(trade_executor_adapter, TradeExecutorAdapter);
   REGISTER_TRANSFORM(trade_signal_executor, TradeExecutorTransform);
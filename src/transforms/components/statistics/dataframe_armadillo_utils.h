@@ -7,6 +7,7 @@
 #include <armadillo>
 #include <arrow/table.h>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -89,6 +90,83 @@ MatFromDataFrame(const epoch_frame::DataFrame &df,
   return X;
 }
 
+/**
+ * @brief Observation matrix [num_columns x num_rows], one observation per
+ * column as mlpack expects, plus the Arrow arrays backing it.
+ */
+struct ObservationMatrix {
+  arma::mat X;
+  std::vector<epoch_frame::Array> columns;
+};
+
+/**
+ * @brief Builds the mlpack observation layout straight from DataFrame columns
+ *
+ * A single double column without nulls is viewed in place (no copy); the
+ * view stays valid for as long as the returned ObservationMatrix holds the
+ * column. Otherwise values are copied, with nulls read as NaN. With several
+ * columns each value is copied once into its transposed position, instead of
+ * MatFromDataFrame followed by .t().
+ */
+inline ObservationMatrix
+ObservationsFromDataFrame(const epoch_frame::DataFrame &df,
+                          const std::vector<std::string> &column_names) {
+  if (column_names.empty()) {
+    throw std::runtime_error("No columns specified for matrix conversion");
+  }
+
+  const size_t T = df.num_rows();
+  const size_t D = column_names.size();
+
+  ObservationMatrix result;
+  result.columns.reserve(D);
+  for (const auto &col_name : column_names) {
+    auto column_array = df[col_name].contiguous_array();
+    if (column_array.type()->id() != arrow::Type::DOUBLE) {
+      column_array = column_array.cast(arrow::float64());
+    }
+    result.columns.emplace_back(std::move(column_array));
+  }
+
+  if (T == 0) {
+    result.X = arma::mat(D, 0);
+    return result;
+  }
+
+  std::vector<std::shared_ptr<arrow::DoubleArray>> views;
+  views.reserve(D);
+  bool has_nulls = false;
+  for (const auto &column : result.columns) {
+    views.emplace_back(column.template to_view<double>());
+    has_nulls = has_nulls || views.back()->null_count() > 0;
+  }
+
+  if (D == 1 && !has_nulls) {
+    // A 1 x T matrix has the same layout as the column itself
+    result.X = arma::mat(const_cast<double *>(views[0]->raw_values()), 1, T,
+                         /*copy_aux_mem=*/false, /*strict=*/true);
+    return result;
+  }
+
+  // Null slots hold arbitrary bytes in the value buffer; read them as NaN
+  result.X.set_size(D, T);
+  for (size_t j = 0; j < D; ++j) {
+    const auto &view = *views[j];
+    const double *raw_data = view.raw_values();
+    for (size_t t = 0; t < T; ++t) {
+      result.X(j, t) = raw_data[t];
+    }
+    if (view.null_count() > 0) {
+      for (size_t t = 0; t < T; ++t) {
+        if (view.IsNull(static_cast<int64_t>(t))) {
+          result.X(j, t) = std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    }
+  }
+  return result;
+}
+
 /**
  * @brief Converts a single column from DataFrame to Armadillo column vector
  *
@@ -4,6 +4,8 @@
 //
 #include "dataframe_armadillo_utils.h"
 #include "epoch_frame/aliases.h"
+#include "hmm_model_cache.h"
+#include <epoch_script/transforms/core/asset_scope.h>
 #include <epoch_script/transforms/core/itransform.h>
 #include <arrow/array.h>
 #include <arrow/array/builder_base.h>
@@ -14,6 +16,7 @@
 #include <arrow/type.h>
 #include <arrow/util/macros.h>
 #include <cmath>
+#include <span>
 #include <epoch_frame/factory/array_factory.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 
@@ -30,9 +33,6 @@ using mlpack::GaussianDistribution;
 
 namespace epoch_script::transform {
 
-// Concrete Gaussian HMM type alias (mlpack observations are column-oriented)
-using HMMGaussian = mlpack::HMM<GaussianDistribution<>>;
-
 /**
  * @brief Hidden Markov Model Transform for Financial Time Series
  *
@@ -47,6 +47,12 @@ using HMMGaussian = mlpack::HMM<GaussianDistribution<>>;
  * - Volatility state identification (low/medium/high)
  * - Trend change detection
  * - Risk state assessment
+ *
+ * Trained models are cached per (graph, node, timeframe, asset, input
+ * columns, options) together with a hash of the training window: rerunning
+ * on an identical window skips Baum-Welch. `warm_start` starts EM from the
+ * series' previous model instead of a blank one (walk-forward), and
+ * `freeze_model` reuses that model as-is and only predicts (live refresh).
  */
 template <size_t N_STATES>
 class HMMTransform final : public ITransform {
@@ -82,6 +88,17 @@ public:
         cfg.GetOptionValue("lookback_window",
                            epoch_script::MetaDataOptionDefinition{0.0})
             .GetInteger());
+
+    // Model reuse options
+    m_warm_start =
+        cfg.GetOptionValue("warm_start",
+                           epoch_script::MetaDataOptionDefinition{false})
+            .GetBoolean();
+
+    m_freeze_model =
+        cfg.GetOptionValue("freeze_model",
+                           epoch_script::MetaDataOptionDefinition{false})
+            .GetBoolean();
   }
 
   [[nodiscard]] epoch_frame::DataFrame
@@ -92,51 +109,47 @@ public:
           "HMMTransform requires at least one input column.");
     }
 
-    // Convert DataFrame to Armadillo matrix
-    arma::mat X = utils::MatFromDataFrame(bars, cols);
+    // Observations as columns (dimensionality x T), viewing the input
+    // buffer directly for a single feature
+    const auto observations = utils::ObservationsFromDataFrame(bars, cols);
+    const arma::mat &X = observations.X;
+    const size_t T = X.n_cols;
 
-    if (X.n_rows < m_min_training_samples) {
+    if (T < m_min_training_samples) {
       throw std::runtime_error("Insufficient training samples for HMM");
     }
 
     // Split into training and prediction sets
-    arma::mat training_data;
-    arma::mat prediction_data;
+    size_t training_end = T;
+    size_t prediction_begin = 0;
     epoch_frame::IndexPtr prediction_index;
 
-    if (m_lookback_window > 0 && X.n_rows > m_lookback_window) {
-      // Train on first m_lookback_window bars
-      training_data = X.rows(0, m_lookback_window - 1);
-
-      // Predict on remaining bars (bars after training window)
-      prediction_data = X.rows(m_lookback_window, X.n_rows - 1);
-
-      // Index for prediction window
+    if (m_lookback_window > 0 && T > m_lookback_window) {
+      // Train on first m_lookback_window bars, predict on the bars after the
+      // training window
+      training_end = m_lookback_window;
+      prediction_begin = m_lookback_window;
       prediction_index = bars.index()->iloc(
-          {static_cast<int64_t>(m_lookback_window),
-           static_cast<int64_t>(X.n_rows)});
+          {static_cast<int64_t>(m_lookback_window), static_cast<int64_t>(T)});
     } else {
       // If no lookback specified, use all data for both training and prediction
       // (Research mode - acceptable look-ahead for exploratory analysis)
-      training_data = X;
-      prediction_data = X;
       prediction_index = bars.index();
     }
 
-    // Compute preprocessing parameters from training data
-    auto preprocess_params = ComputePreprocessParams(training_data);
-
-    // Apply preprocessing to training data
-    training_data = ApplyPreprocessParams(training_data, preprocess_params);
+    // Leading observation columns are contiguous, so the training window
+    // is viewed rather than copied
+    const arma::mat training_window(const_cast<double *>(X.memptr()),
+                                    X.n_rows, training_end,
+                                    /*copy_aux_mem=*/false, /*strict=*/true);
+    const auto model = GetOrTrainModel(training_window);
 
-    // Train HMM model on preprocessed training data
-    auto hmm = TrainHMM(training_data);
-
-    // Apply SAME preprocessing parameters to prediction data
-    prediction_data = ApplyPreprocessParams(prediction_data, preprocess_params);
+    // Apply the training window's preprocessing to the prediction data
+    const arma::mat prediction_data =
+        ApplyPreprocessParams(X.cols(prediction_begin, T - 1), *model);
 
     // Generate predictions on prediction data (not training data)
-    return GenerateOutputs(prediction_index, hmm, prediction_data);
+    return GenerateOutputs(prediction_index, model->hmm, prediction_data);
   }
 
   // Note: GetOutputMetaData() is handled in separate metadata repo
@@ -153,52 +166,104 @@ private:
   size_t m_min_training_samples{100};
   size_t m_lookback_window{0}; // 0 = use all available data
 
-  // Preprocessing parameters structure
-  struct PreprocessParams {
-    std::vector<double> means;
-    std::vector<double> stds;
-  };
+  // Model reuse
+  bool m_warm_start{false};
+  bool m_freeze_model{false};
+
+  // Cache key of this transform's model for the current asset. The node id,
+  // timeframe and graph scope keep nodes of one script, and the same node id
+  // in different scripts, apart. Without an asset scope (direct calls) models
+  // are only shared between identical training windows, so unrelated series
+  // never warm start from each other.
+  std::string SeriesKey(uint64_t windowHash) const {
+    StableHasher hasher;
+    hasher.Add(ScopedAssetContext::CurrentGraphId())
+        .Add(GetId())
+        .Add(GetTimeframe().ToString())
+        .Add(N_STATES)
+        .Add(m_max_iterations)
+        .Add(m_tolerance)
+        .Add(m_compute_zscore)
+        .Add(m_min_training_samples)
+        .Add(m_lookback_window)
+        .Add(m_warm_start)
+        .Add(m_freeze_model);
+    for (auto const &col : GetInputIds()) {
+      hasher.Add(col);
+    }
+    const auto &asset = ScopedAssetContext::CurrentAssetId();
+    hasher.Add(asset);
+    if (asset.empty()) {
+      hasher.Add(windowHash);
+    }
+    return std::format("hmm{}-{}", N_STATES, hasher.HexDigest());
+  }
+
+  std::shared_ptr<const HMMModel>
+  GetOrTrainModel(const arma::mat &training_window) const {
+    const uint64_t windowHash =
+        StableHasher{}
+            .Add(training_window.n_rows)
+            .Add(std::span<const double>{training_window.memptr(),
+                                         training_window.n_elem})
+            .Digest();
+
+    return HMMModelCache::Instance().GetOrTrain(
+        SeriesKey(windowHash),
+        [&](const HMMModel &previous) {
+          return previous.windowHash == windowHash || m_freeze_model;
+        },
+        [&](std::shared_ptr<const HMMModel> const &previous) {
+          auto model = std::make_shared<HMMModel>();
+          model->windowHash = windowHash;
+          ComputePreprocessParams(training_window, *model);
+          model->hmm =
+              TrainHMM(ApplyPreprocessParams(training_window, *model),
+                       m_warm_start && previous ? &previous->hmm : nullptr);
+          return model;
+        });
+  }
 
-  // Compute preprocessing parameters from training data
-  PreprocessParams ComputePreprocessParams(const arma::mat &X) const {
-    PreprocessParams params;
+  // Compute preprocessing parameters (per feature row) from training data
+  void ComputePreprocessParams(const arma::mat &X, HMMModel &model) const {
     if (!m_compute_zscore) {
-      return params; // Return empty params if not using zscore
+      return; // Leave params empty if not using zscore
     }
 
-    params.means.resize(X.n_cols);
-    params.stds.resize(X.n_cols);
+    model.means.resize(X.n_rows);
+    model.stds.resize(X.n_rows);
 
-    for (size_t i = 0; i < X.n_cols; ++i) {
-      params.means[i] = arma::mean(X.col(i));
-      params.stds[i] = arma::stddev(X.col(i));
+    for (size_t i = 0; i < X.n_rows; ++i) {
+      const arma::rowvec feature = X.row(i);
+      model.means[i] = arma::mean(feature);
+      model.stds[i] = arma::stddev(feature);
     }
-
-    return params;
   }
 
   // Apply preprocessing parameters to data
-  arma::mat ApplyPreprocessParams(arma::mat X,
-                                  const PreprocessParams &params) const {
-    if (!m_compute_zscore) {
+  arma::mat ApplyPreprocessParams(arma::mat X, const HMMModel &model) const {
+    if (!m_compute_zscore || model.means.empty()) {
       return X; // Return unchanged if not using zscore
     }
 
-    for (size_t i = 0; i < X.n_cols; ++i) {
-      if (params.stds[i] > 1e-10) {
-        X.col(i) = (X.col(i) - params.means[i]) / params.stds[i];
+    for (size_t i = 0; i < X.n_rows; ++i) {
+      if (model.stds[i] > 1e-10) {
+        X.row(i) = (X.row(i) - model.means[i]) / model.stds[i];
       }
     }
 
     return X;
   }
 
-  HMMGaussian TrainHMM(const arma::mat &X) const {
+  // X holds one observation per column. EM starts from `warm_start` when
+  // given (same dimensionality), otherwise from a blank model.
+  HMMGaussian TrainHMM(const arma::mat &X,
+                       const HMMGaussian *warm_start) const {
     // Number of dimensions (features)
-    const size_t dimensionality = X.n_cols;
+    const size_t dimensionality = X.n_rows;
 
     // Check for feature correlation issues before training
-    arma::mat corr_matrix = arma::cor(X);
+    arma::mat corr_matrix = arma::cor(X.t());
     for (size_t i = 0; i < dimensionality; ++i) {
       for (size_t j = i + 1; j < dimensionality; ++j) {
         if (std::abs(corr_matrix(i, j)) > 0.95) {
@@ -213,14 +278,20 @@ private:
       }
     }
 
-    // Initialize Gaussian HMM with N_STATES and given dimensionality
-    HMMGaussian hmm(N_STATES, GaussianDistribution<>(dimensionality),
-                    m_tolerance);
+    // Initialize Gaussian HMM with N_STATES and given dimensionality, or
+    // continue from the previous window's parameters
+    HMMGaussian hmm =
+        warm_start && warm_start->Emission().front().Dimensionality() ==
+                          dimensionality
+            ? *warm_start
+            : HMMGaussian(N_STATES, GaussianDistribution<>(dimensionality),
+                          m_tolerance);
+    hmm.Tolerance() = m_tolerance;
 
     // Prepare sequences (each matrix is dimensionality x T, observations in
     // columns)
     std::vector<arma::mat> sequences;
-    sequences.emplace_back(X.t());
+    sequences.emplace_back(X);
 
     // Unsupervised training (Baum-Welch) with error handling
     try {
@@ -248,20 +319,20 @@ private:
   epoch_frame::DataFrame GenerateOutputs(const epoch_frame::IndexPtr &index,
                                          const HMMGaussian &hmm,
                                          const arma::mat &X) const {
-    const size_t T = X.n_rows;
+    const size_t T = X.n_cols;
     std::vector<std::string> output_columns;
     std::vector<arrow::ChunkedArrayPtr> output_arrays;
 
     // Most likely state sequence (Viterbi path)
     arma::Row<size_t> viterbi_path;
-    hmm.Predict(X.t(), viterbi_path);
+    hmm.Predict(X, viterbi_path);
 
     // Forward-backward probabilities (state probabilities)
     arma::mat stateLogProb;
     arma::mat forwardLogProb;
     arma::mat backwardLogProb;
     arma::vec logScales;
-    hmm.LogEstimate(X.t(), stateLogProb, forwardLogProb, backwardLogProb,
+    hmm.LogEstimate(X, stateLogProb, forwardLogProb, backwardLogProb,
                     logScales);
     arma::mat state_probs = arma::exp(stateLogProb);
 
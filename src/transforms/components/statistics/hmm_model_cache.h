@@ -0,0 +1,240 @@
+#pragma once
+//
+// Trained HMM models shared across runs of the HMM transforms
+//
+#include <cereal/types/vector.hpp>
+#include <epoch_script/core/stable_hash.h>
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hmm/hmm.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unistd.h>
+
+namespace epoch_script::transform {
+
+// Concrete Gaussian HMM type alias (mlpack observations are column-oriented)
+using HMMGaussian = mlpack::HMM<mlpack::GaussianDistribution<>>;
+
+// A trained model together with the z-score parameters of its training
+// window (empty when compute_zscore is off).
+struct HMMModel {
+  HMMGaussian hmm;
+  std::vector<double> means;
+  std::vector<double> stds;
+  uint64_t windowHash{0};
+
+  template <typename Archive>
+  void serialize(Archive &ar, const uint32_t /* version */) {
+    ar(CEREAL_NVP(hmm), CEREAL_NVP(means), CEREAL_NVP(stds),
+       CEREAL_NVP(windowHash));
+  }
+};
+
+/**
+ * Latest trained model per series, where a series is one asset under one HMM
+ * configuration (states, input columns, options). The most recently used
+ * kDefaultCapacity models (or EPOCH_HMM_MODEL_CACHE_SIZE) are kept in memory
+ * and, when EPOCH_HMM_MODEL_CACHE_DIR is set, persisted as <key>.bin so a
+ * later process can reuse or warm start from them.
+ */
+class HMMModelCache {
+public:
+  static HMMModelCache &Instance() {
+    static HMMModelCache cache;
+    return cache;
+  }
+
+  static constexpr size_t kDefaultCapacity = 64;
+
+  /**
+   * The series' model when `reusable` accepts it, otherwise
+   * train(previous model or nullptr), stored as the series' new model.
+   * Single-flight per series: concurrent callers wait for a running
+   * training of the same key and then re-check its result instead of
+   * training again. A training that throws stores nothing.
+   */
+  template <typename Reusable, typename Train>
+  std::shared_ptr<const HMMModel> GetOrTrain(std::string const &seriesKey,
+                                             Reusable const &reusable,
+                                             Train const &train) {
+    std::promise<void> done;
+    {
+      std::unique_lock lock(m_mutex);
+      for (auto it = m_inFlight.find(seriesKey); it != m_inFlight.end();
+           it = m_inFlight.find(seriesKey)) {
+        auto pending = it->second;
+        lock.unlock();
+        pending.wait();
+        lock.lock();
+      }
+      if (auto model = Lookup(seriesKey); model && reusable(*model)) {
+        return model;
+      }
+      m_inFlight.emplace(seriesKey, done.get_future().share());
+    }
+    const FlightGuard guard{*this, seriesKey, done};
+
+    auto previous = Find(seriesKey);
+    if (previous && reusable(*previous)) {
+      return previous;
+    }
+    std::shared_ptr<const HMMModel> model = train(previous);
+    Store(seriesKey, model);
+    return model;
+  }
+
+  // Models kept in memory; evicts least recently used ones beyond it
+  void SetCapacity(size_t capacity) {
+    std::lock_guard lock(m_mutex);
+    m_capacity = capacity;
+    Evict();
+  }
+
+  size_t Size() {
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+  }
+
+  void Clear() {
+    std::lock_guard lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+  }
+
+private:
+  using Entry = std::pair<std::string, std::shared_ptr<const HMMModel>>;
+
+  HMMModelCache() {
+    if (const char *directory = std::getenv("EPOCH_HMM_MODEL_CACHE_DIR")) {
+      m_directory = std::filesystem::path{directory};
+    }
+    if (const char *size = std::getenv("EPOCH_HMM_MODEL_CACHE_SIZE")) {
+      m_capacity = std::strtoull(size, nullptr, 10);
+    }
+  }
+
+  // Ends a GetOrTrain flight whether training returned or threw
+  struct FlightGuard {
+    HMMModelCache &cache;
+    std::string const &seriesKey;
+    std::promise<void> &done;
+
+    ~FlightGuard() {
+      {
+        std::lock_guard lock(cache.m_mutex);
+        cache.m_inFlight.erase(seriesKey);
+      }
+      done.set_value();
+    }
+  };
+
+  // In-memory model, marked most recently used. Caller holds m_mutex.
+  std::shared_ptr<const HMMModel> Lookup(std::string const &seriesKey) {
+    auto it = m_index.find(seriesKey);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+  }
+
+  // Caller holds m_mutex
+  void Insert(std::string const &seriesKey,
+              std::shared_ptr<const HMMModel> model) {
+    if (auto it = m_index.find(seriesKey); it != m_index.end()) {
+      it->second->second = std::move(model);
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+    } else {
+      m_entries.emplace_front(seriesKey, std::move(model));
+      m_index.emplace(seriesKey, m_entries.begin());
+    }
+    Evict();
+  }
+
+  void Evict() {
+    while (m_entries.size() > m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+  }
+
+  std::shared_ptr<const HMMModel> Find(std::string const &seriesKey) {
+    {
+      std::lock_guard lock(m_mutex);
+      if (auto model = Lookup(seriesKey)) {
+        return model;
+      }
+    }
+    if (!m_directory) {
+      return nullptr;
+    }
+
+    const auto path = *m_directory / (seriesKey + ".bin");
+    if (!std::filesystem::exists(path)) {
+      return nullptr;
+    }
+    auto model = std::make_shared<HMMModel>();
+    if (!mlpack::data::Load(path.string(), "model", *model, false,
+                            mlpack::data::format::binary)) {
+      SPDLOG_WARN("Ignoring unreadable HMM model cache file {}",
+                  path.string());
+      return nullptr;
+    }
+
+    std::lock_guard lock(m_mutex);
+    Insert(seriesKey, model);
+    return model;
+  }
+
+  void Store(std::string const &seriesKey,
+             std::shared_ptr<const HMMModel> model) {
+    if (m_directory) {
+      Persist(seriesKey, *model);
+    }
+    std::lock_guard lock(m_mutex);
+    Insert(seriesKey, std::move(model));
+  }
+
+  // Written to a temporary file first and renamed into place, so a
+  // concurrent reader never loads a partial model.
+  void Persist(std::string const &seriesKey, HMMModel const &model) const {
+    try {
+      std::filesystem::create_directories(*m_directory);
+      const auto path = *m_directory / (seriesKey + ".bin");
+      const auto staging = std::filesystem::path(
+          path.string() + std::format(".tmp-{}-{}", ::getpid(),
+                                      std::hash<std::thread::id>{}(
+                                          std::this_thread::get_id())));
+      HMMModel copy = model;
+      if (mlpack::data::Save(staging.string(), "model", copy, false,
+                             mlpack::data::format::binary)) {
+        std::filesystem::rename(staging, path);
+      } else {
+        SPDLOG_WARN("Failed to persist HMM model {}", path.string());
+      }
+    } catch (std::exception const &e) {
+      SPDLOG_WARN("Failed to persist HMM model {}: {}", seriesKey, e.what());
+    }
+  }
+
+  std::optional<std::filesystem::path> m_directory;
+  std::mutex m_mutex;
+  // Most recently used first; m_index points into it
+  std::list<Entry> m_entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+  size_t m_capacity{kDefaultCapacity};
+  std::unordered_map<std::string, std::shared_future<void>> m_inFlight;
+};
+
+} // namespace epoch_script::transform
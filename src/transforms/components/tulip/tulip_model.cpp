@@ -3,6 +3,8 @@
 //
 #include "tulip_model.h"
 #include "boost/algorithm/algorithm.hpp"
+#include <arrow/buffer.h>
+#include <arrow/util/bit_util.h>
 #include <epoch_frame/factory/array_factory.h>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/factory/index_factory.h>
@@ -45,130 +47,154 @@ TulipModelImpl<IsIndicator>::TulipModelImpl(
     m_required_bar_inputs =
         std::vector<std::string>{C.OPEN(), C.HIGH(), C.LOW(), C.CLOSE()};
   }
-}
 
-template <bool IsIndicator>
-std::pair<std::vector<std::string>, std::vector<std::vector<double>>>
-TulipModelImpl<IsIndicator>::MakeEmptyOutputVector(int64_t length) const {
-  const auto outputMetaData = GetOutputMetaData();
-  std::vector<std::string> keys(outputMetaData.size());
-  std::vector<std::vector<double>> output(outputMetaData.size());
-
-  std::transform(outputMetaData.begin(), outputMetaData.end(), keys.begin(),
-                 output.begin(), [&](const auto &metaData, std::string &key) {
-                   key = GetOutputId(metaData.id);
-                   return std::vector<double>(length, IsIndicator ? NAN : 0);
-                 });
-  return std::pair{keys, output};
-}
+  m_input_keys = m_required_bar_inputs;
+  for (auto const &key : GetInputIds()) {
+    m_input_keys.push_back(key);
+  }
+  // Swap inputs for crossunder to implement it as crossover with reversed
+  // inputs
+  if (GetName() == "crossunder" && m_input_keys.size() >= 2) {
+    std::swap(m_input_keys[m_input_keys.size() - 2],
+              m_input_keys[m_input_keys.size() - 1]);
+  }
 
-template <bool IsIndicator>
-epoch_frame::DataFrame TulipModelImpl<IsIndicator>::MakeDataFrame(
-    const std::pair<std::vector<std::string>, std::vector<std::vector<double>>>
-        &outputPair,
-    epoch_frame::IndexPtr const &index) const {
-  std::vector<std::string> columns;
-  columns.reserve(outputPair.first.size());
-
-  arrow::ChunkedArrayVector arrayList;
-  arrayList.reserve(outputPair.first.size());
-
-  for (auto const &[k, v, outputMetadata] : std::views::zip(
-           outputPair.first, outputPair.second, m_config.GetOutputs())) {
-    columns.emplace_back(k);
-    auto arr = epoch_frame::factory::array::make_array(v);
-    if (outputMetadata.type == epoch_core::IODataType::Boolean) {
-      arr = epoch_frame::AssertArrayResultIsOk(
-          arrow::compute::Cast(arr, arrow::boolean()));
-    }
-    arrayList.emplace_back(arr);
+  for (auto const &outputMetaData : GetOutputMetaData()) {
+    m_output_ids.emplace_back(GetOutputId(outputMetaData.id));
+    m_boolean_outputs.push_back(outputMetaData.type ==
+                                epoch_core::IODataType::Boolean);
   }
 
-  return epoch_frame::make_dataframe(index, arrayList, columns);
+  if constexpr (IsIndicator) {
+    for (auto const &optionMetaData : GetOptionsMetaData()) {
+      m_options.push_back(GetOption(optionMetaData.id).GetNumericValue());
+    }
+    m_start = m_info->start(m_options.data());
+  } else {
+    m_candle_config = tc_config{
+        .period = static_cast<int>(GetOption("period").GetInteger()),
+        .body_none = GetOption("body_none").GetNumericValue(),
+        .body_short = GetOption("body_short").GetNumericValue(),
+        .body_long = GetOption("body_long").GetNumericValue(),
+        .wick_none = GetOption("wick_none").GetNumericValue(),
+        .wick_long = GetOption("wick_long").GetNumericValue(),
+        .near = GetOption("near").GetNumericValue()};
+  }
 }
 
 template <bool IsIndicator>
 epoch_frame::DataFrame TulipModelImpl<IsIndicator>::TransformData(
     const epoch_frame::DataFrame &bars) const {
-  auto inputKeys = m_required_bar_inputs;
-  for (auto const &key : GetInputIds()) {
-    inputKeys.push_back(key);
-  }
+  Scratch scratch;
+  return Run(bars, scratch);
+}
 
-  // Swap inputs for crossunder to implement it as crossover with reversed inputs
-  if (GetName() == "crossunder" && inputKeys.size() >= 2) {
-    std::swap(inputKeys[inputKeys.size() - 2], inputKeys[inputKeys.size() - 1]);
+template <bool IsIndicator>
+std::vector<epoch_frame::DataFrame>
+TulipModelImpl<IsIndicator>::TransformDataBatch(
+    std::span<const epoch_frame::DataFrame> bars) const {
+  Scratch scratch;
+  std::vector<epoch_frame::DataFrame> result;
+  result.reserve(bars.size());
+  for (auto const &frame : bars) {
+    result.emplace_back(Run(frame, scratch));
   }
+  return result;
+}
 
+template <bool IsIndicator>
+epoch_frame::DataFrame
+TulipModelImpl<IsIndicator>::Run(const epoch_frame::DataFrame &bars,
+                                 Scratch &scratch) const {
   const int64_t length = bars.num_rows();
   const epoch_frame::IndexPtr index = bars.index();
 
-  std::vector<const double *> inputs(inputKeys.size());
-  std::vector<epoch_frame::Array> casted(inputKeys.size());
-
-  std::transform(
-      inputKeys.begin(), inputKeys.end(), casted.begin(), inputs.begin(),
-      [&bars](const std::string &key, epoch_frame::Array &currentArray) {
-        currentArray = bars[key].contiguous_array();
-        if (currentArray.type()->id() != arrow::Type::DOUBLE) {
-          currentArray = currentArray.cast(arrow::float64());
-        }
-
-        const auto rawArray = currentArray.to_view<double>();
-        return rawArray->raw_values();
-      });
-
-  std::vector<double> options [[maybe_unused]];
-  int64_t start = 0;
-  if constexpr (IsIndicator) {
-    for (auto const &optionMetaData : GetOptionsMetaData()) {
-      options.push_back(GetOption(optionMetaData.id).GetNumericValue());
+  const size_t nInputs = m_input_keys.size();
+  scratch.casted.resize(nInputs);
+  scratch.inputs.resize(nInputs);
+  for (size_t i = 0; i < nInputs; ++i) {
+    auto &currentArray = scratch.casted[i];
+    currentArray = bars[m_input_keys[i]].contiguous_array();
+    if (currentArray.type()->id() != arrow::Type::DOUBLE) {
+      currentArray = currentArray.cast(arrow::float64());
     }
-    start = m_info->start(options.data());
-    if (start < 0) {
-      auto outputPair = MakeEmptyOutputVector(length);
-      return MakeDataFrame(outputPair, index);
+    scratch.inputs[i] = currentArray.to_view<double>()->raw_values();
+  }
+
+  // A negative start means the options are invalid: emit the fill value for
+  // every row without running the indicator.
+  const int64_t start = m_start;
+  const int64_t outputLength =
+      start < 0 ? length : std::max<int64_t>(0, length - start);
+  const double fill = IsIndicator ? NAN : 0;
+
+  const size_t nOutputs = m_output_ids.size();
+  std::vector<std::shared_ptr<arrow::Buffer>> values(nOutputs);
+  scratch.outputs.resize(nOutputs);
+  scratch.booleans.resize(nOutputs);
+  for (size_t i = 0; i < nOutputs; ++i) {
+    if (m_boolean_outputs[i]) {
+      scratch.booleans[i].assign(outputLength, fill);
+      scratch.outputs[i] = scratch.booleans[i].data();
+      continue;
     }
+    values[i] = epoch_frame::AssertResultIsOk(
+        arrow::AllocateBuffer(outputLength * sizeof(double)));
+    scratch.outputs[i] = reinterpret_cast<double *>(values[i]->mutable_data());
+    std::fill_n(scratch.outputs[i], outputLength, fill);
   }
 
-  const auto outputLength = std::max(0, static_cast<int>(length - start));
-  auto outputPair = MakeEmptyOutputVector(outputLength);
+  auto makeDataFrame = [&](epoch_frame::IndexPtr const &outputIndex) {
+    arrow::ChunkedArrayVector arrayList;
+    arrayList.reserve(nOutputs);
+    for (size_t i = 0; i < nOutputs; ++i) {
+      arrow::ArrayPtr arr;
+      if (m_boolean_outputs[i]) {
+        // Same truthiness as casting the double column to boolean
+        auto bitmap = epoch_frame::AssertResultIsOk(
+            arrow::AllocateEmptyBitmap(outputLength));
+        for (int64_t j = 0; j < outputLength; ++j) {
+          if (scratch.booleans[i][j] != 0) {
+            arrow::bit_util::SetBit(bitmap->mutable_data(), j);
+          }
+        }
+        arr = std::make_shared<arrow::BooleanArray>(outputLength,
+                                                    std::move(bitmap));
+      } else {
+        arr = std::make_shared<arrow::DoubleArray>(outputLength, values[i]);
+      }
+      arrayList.emplace_back(std::make_shared<arrow::ChunkedArray>(arr));
+    }
+    return epoch_frame::make_dataframe(outputIndex, arrayList, m_output_ids);
+  };
+
+  if (start < 0) {
+    return makeDataFrame(index);
+  }
   if (outputLength == 0) {
-    return MakeDataFrame(outputPair, index->iloc({0, 0}));
+    return makeDataFrame(index->iloc({0, 0}));
   }
 
   int returnCode{};
   if constexpr (!IsIndicator) {
-    tc_config cfg{.period = static_cast<int>(GetOption("period").GetInteger()),
-                  .body_none = GetOption("body_none").GetNumericValue(),
-                  .body_short = GetOption("body_short").GetNumericValue(),
-                  .body_long = GetOption("body_long").GetNumericValue(),
-                  .wick_none = GetOption("wick_none").GetNumericValue(),
-                  .wick_long = GetOption("wick_long").GetNumericValue(),
-                  .near = GetOption("near").GetNumericValue()};
-
+    tc_config cfg = m_candle_config;
     auto outcnd = tc_result_new();
-    returnCode = tc_run(m_info->pattern, length, inputs.data(), &cfg, outcnd);
+    returnCode =
+        tc_run(m_info->pattern, length, scratch.inputs.data(), &cfg, outcnd);
     const auto size = tc_result_count(outcnd);
 
     for (int i = 0; i < size; ++i) {
       const tc_hit &h = tc_result_get(outcnd, i);
-      outputPair.second[0][h.index] = 1;
+      scratch.outputs[0][h.index] = 1;
     }
     tc_result_free(outcnd);
   } else {
-    std::vector<double *> outputsPtr(outputPair.second.size(), nullptr);
-
-    std::ranges::transform(
-        outputPair.second, outputsPtr.begin(),
-        [&](std::vector<double> &v) -> double * { return v.data(); });
-
-    returnCode = m_info->indicator(length, inputs.data(), options.data(),
-                                   outputsPtr.data());
+    returnCode = m_info->indicator(length, scratch.inputs.data(),
+                                   m_options.data(), scratch.outputs.data());
   }
 
   if (returnCode == TI_OKAY) {
-    return MakeDataFrame(outputPair, index->iloc({start}));
+    return makeDataFrame(index->iloc({start}));
   }
   std::stringstream ss;
   ss << "Error computing technical Indicator:\n";
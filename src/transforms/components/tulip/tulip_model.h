@@ -14,6 +14,7 @@
 #include <cmath>
 #include <epoch_core/macros.h>
 #include <mutex>
+#include <span>
 
 namespace epoch_script::transform {
 
@@ -24,20 +25,37 @@ public:
   explicit TulipModelImpl(const TransformConfiguration &config);
   ~TulipModelImpl() override = default;
 
-  std::pair<std::vector<std::string>, std::vector<std::vector<double>>>
-  MakeEmptyOutputVector(int64_t length) const;
-
   epoch_frame::DataFrame
   TransformData(const epoch_frame::DataFrame &bars) const override;
 
+  // Runs the indicator over every frame (typically one per asset) in the
+  // calling task, reusing the input and scratch buffers between frames.
+  std::vector<epoch_frame::DataFrame>
+  TransformDataBatch(std::span<const epoch_frame::DataFrame> bars) const;
+
 protected:
+  // Working memory of one run; outputs are written straight into Arrow
+  // buffers, only boolean outputs go through a double scratch column.
+  struct Scratch {
+    std::vector<epoch_frame::Array> casted;
+    std::vector<const double *> inputs;
+    std::vector<double *> outputs;
+    std::vector<std::vector<double>> booleans;
+  };
+
+  epoch_frame::DataFrame Run(const epoch_frame::DataFrame &bars,
+                             Scratch &scratch) const;
+
   std::vector<std::string> m_required_bar_inputs;
   const InfoType *m_info;
 
-  epoch_frame::DataFrame
-  MakeDataFrame(const std::pair<std::vector<std::string>,
-                                std::vector<std::vector<double>>> &data,
-                epoch_frame::IndexPtr const &index) const;
+  // Resolved once at construction
+  std::vector<std::string> m_input_keys;
+  std::vector<std::string> m_output_ids;
+  std::vector<bool> m_boolean_outputs;
+  std::vector<double> m_options;
+  int64_t m_start{0};
+  tc_config m_candle_config{};
 };
 
 extern template class TulipModelImpl<true>;
@@ -29,6 +29,16 @@ void IOMetaData::decode(const YAML::Node &element) {
   }
 }
 
+void CostModel::decode(const YAML::Node &element) {
+  complexity = epoch_core::CostComplexityWrapper::FromString(
+      element["complexity"].as<std::string>("Linear"));
+  scaleOption = element["scaleOption"].as<std::string>("");
+  strideOption = element["strideOption"].as<std::string>("");
+  coefficient = element["coefficient"].as<double>(1.0);
+  updateCoefficient = element["updateCoefficient"].as<double>(0.0);
+  perCallOverhead = element["perCallOverhead"].as<double>(0.0);
+}
+
 void TransformsMetaData::decode(const YAML::Node &element) {
   id = element["id"].as<std::string>();
   name = element["name"].as<std::string>();
@@ -58,6 +68,10 @@ void TransformsMetaData::decode(const YAML::Node &element) {
   assetRequirements = element["assetRequirements"].as<std::vector<std::string>>(std::vector<std::string>{});
   usageContext = element["usageContext"].as<std::string>("");
   limitations = element["limitations"].as<std::string>("");
+
+  if (const auto cost = element["costModel"]) {
+    costModel = cost.as<CostModel>();
+  }
 }
 
 
@@ -230,7 +244,8 @@ TransformsMetaData MakeValueCompareMetaData(
       .type = epoch_core::MetaDataOptionType::Integer,
       .defaultValue =
           MetaDataOptionDefinition(static_cast<double>(default_periods)),
-      .isRequired = true}};
+      .isRequired = true,
+      .isLookback = true}};
 
   // Input/Output
   metadata.inputs = {IOMetaDataConstants::DECIMAL_INPUT_METADATA};
@@ -361,7 +376,8 @@ std::vector<TransformsMetaData> MakeComparativeMetaData() {
                            .min = 0,
                            .max = 10000,
                            .desc = "Number of historical bars to calculate percentile from",
-                           .tuningGuidance = "Shorter lookback (10-20) for responsive adaptation. Longer (50-100) for stable thresholds."},
+                           .tuningGuidance = "Shorter lookback (10-20) for responsive adaptation. Longer (50-100) for stable thresholds.",
+                           .isLookback = true},
             MetaDataOption{.id = "percentile",
                            .name = "Percentile Threshold",
                            .type = epoch_core::MetaDataOptionType::Integer,
@@ -496,7 +512,8 @@ std::vector<TransformsMetaData> MakeLagMetaData() {
                            .defaultValue = MetaDataOptionDefinition(static_cast<double>(1)),
                            .min = 1,
                            .desc = "Number of periods to shift the data backward",
-                           .tuningGuidance = "Lag 1 for previous bar comparison. Larger lags for detecting longer-term patterns or creating features for machine learning models. Common: 1 (prev bar), 5 (prev week on daily), 20 (prev month)."}
+                           .tuningGuidance = "Lag 1 for previous bar comparison. Larger lags for detecting longer-term patterns or creating features for machine learning models. Common: 1 (prev bar), 5 (prev week on daily), 20 (prev month).",
+                           .isLookback = true}
         },
         .desc = std::string("Shifts each element in the input by the specified period, creating a lagged series. Typed variant for ") + inputType + " data.",
         .inputs = {IOMetaData{.type = epoch_core::IODataTypeWrapper::FromString(inputType), .id = "SLOT", .name = ""}},
@@ -876,7 +893,7 @@ TransformsMetaData MakeCalendarEffectMetaData(
   } else if (effect_type == "week_of_month") {
     metadata.id = custom_id.empty() ? "week_of_month" : custom_id;
     metadata.name = custom_name.empty() ? "Week of Month" : custom_name;
-    metadata.desc = "Detects specific weeks within a month (first week, last week, etc.). Returns true during the specified week of the month.";
+    metadata.desc = "Detects specific weeks within a month (first week, last week, etc.). Returns true during the specified week of the month: days 1-7 are the first week, 8-14 the second, 15-21 the third, 22-28 the fourth and 29-31 the last.";
     metadata.usageContext = "Implement week-of-month patterns. First week can show momentum continuation from prior month. Last week may show turn-of-month effect buildup. Useful for intramonth timing strategies.";
     metadata.strategyTypes = {"calendar-anomaly", "seasonal", "timing"};
     metadata.tags = {"calendar", "week", "seasonal", "intramonth"};
@@ -978,7 +995,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 20,
                          .max = 200,
                          .desc = "Number of bars to search for pattern formation",
-                         .tuningGuidance = "30-50 for intraday, 50-100 for daily charts. Longer lookback detects larger patterns but increases lag."},
+                         .tuningGuidance = "30-50 for intraday, 50-100 for daily charts. Longer lookback detects larger patterns but increases lag.",
+                         .isLookback = true},
           MetaDataOption{.id = "head_ratio_before",
                          .name = "Head Height Ratio (Before)",
                          .type = epoch_core::MetaDataOptionType::Decimal,
@@ -1033,7 +1051,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 20,
                          .max = 200,
                          .desc = "Number of bars to search for pattern formation",
-                         .tuningGuidance = "30-50 for intraday, 50-100 for daily charts. Longer lookback detects larger patterns but increases lag."},
+                         .tuningGuidance = "30-50 for intraday, 50-100 for daily charts. Longer lookback detects larger patterns but increases lag.",
+                         .isLookback = true},
           MetaDataOption{.id = "head_ratio_before",
                          .name = "Head Depth Ratio (Before)",
                          .type = epoch_core::MetaDataOptionType::Decimal,
@@ -1088,7 +1107,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 10,
                          .max = 100,
                          .desc = "Number of bars to search for pattern",
-                         .tuningGuidance = "20-30 for shorter-term patterns, 50-100 for major reversal patterns."},
+                         .tuningGuidance = "20-30 for shorter-term patterns, 50-100 for major reversal patterns.",
+                         .isLookback = true},
           MetaDataOption{.id = "pattern_type",
                          .name = "Pattern Type",
                          .type = epoch_core::MetaDataOptionType::Select,
@@ -1133,7 +1153,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 10,
                          .max = 100,
                          .desc = "Number of bars to search for consolidation",
-                         .tuningGuidance = "20-30 for typical flags. Longer periods may detect larger patterns but flag should be relatively brief."},
+                         .tuningGuidance = "20-30 for typical flags. Longer periods may detect larger patterns but flag should be relatively brief.",
+                         .isLookback = true},
           MetaDataOption{.id = "min_pivot_points",
                          .name = "Minimum Pivot Points",
                          .type = epoch_core::MetaDataOptionType::Integer,
@@ -1189,7 +1210,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 20,
                          .max = 200,
                          .desc = "Number of bars to search for triangle formation",
-                         .tuningGuidance = "40-60 for typical triangles. Larger patterns need longer lookback (100+). Shorter lookback (20-30) for intraday."},
+                         .tuningGuidance = "40-60 for typical triangles. Larger patterns need longer lookback (100+). Shorter lookback (20-30) for intraday.",
+                         .isLookback = true},
           MetaDataOption{.id = "triangle_type",
                          .name = "Triangle Type",
                          .type = epoch_core::MetaDataOptionType::Select,
@@ -1235,7 +1257,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 10,
                          .max = 50,
                          .desc = "Number of bars to search for pennant",
-                         .tuningGuidance = "15-25 typical. Pennants are brief consolidations. Longer lookback may confuse with triangles."},
+                         .tuningGuidance = "15-25 typical. Pennants are brief consolidations. Longer lookback may confuse with triangles.",
+                         .isLookback = true},
           MetaDataOption{.id = "min_pivot_points",
                          .name = "Minimum Pivot Points",
                          .type = epoch_core::MetaDataOptionType::Integer,
@@ -1334,7 +1357,8 @@ std::vector<TransformsMetaData> MakeChartFormationMetaData() {
                          .min = 20,
                          .max = 150,
                          .desc = "Number of bars to search for consolidation box",
-                         .tuningGuidance = "30-50 for typical boxes on intraday. 60-100 for daily/longer timeframes. Consolidation should span multiple swings."},
+                         .tuningGuidance = "30-50 for typical boxes on intraday. 60-100 for daily/longer timeframes. Consolidation should span multiple swings.",
+                         .isLookback = true},
           MetaDataOption{.id = "min_pivot_points",
                          .name = "Minimum Pivot Points",
                          .type = epoch_core::MetaDataOptionType::Integer,
@@ -3,10 +3,12 @@
 //
 #include <epoch_script/transforms/core/registration.h>
 #include "../core/doc_deserialization_helper.h"
+#include "fingerprints/epoch_script_metadata_fingerprint.h"
 #include <epoch_script/transforms/core/registry.h>
 #include "components/sql/sql_query_metadata.h"
 #include "components/operators/validation_metadata.h"
 #include "components/operators/static_cast_metadata.h"
+#include "components/operators/fused_expression_metadata.h"
 #include "components/operators/stringify_metadata.h"
 #include "components/operators/groupby_agg_metadata.h"
 #include "components/data_sources/polygon_metadata.h"
@@ -24,8 +26,28 @@
 #include "components/indicators/intraday_returns.h"
 #include "components/datetime/datetime_metadata.h"
 #include "components/ml/sagemaker_sentiment_metadata.h"
+#include <glaze/glaze.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
 
 namespace epoch_script::transforms {
+namespace {
+// Bump whenever TransformsMetaData changes shape, so a snapshot written by an
+// older build is rejected instead of silently dropping fields.
+constexpr uint32_t kSnapshotFormatVersion = 3;
+
+struct TransformMetadataSnapshot {
+  uint32_t version{};
+  // EPOCH_SCRIPT_METADATA_FINGERPRINT of the writing build, so a snapshot
+  // left over from edited YAML or metadata builders is rejected
+  std::string fingerprint;
+  std::vector<TransformsMetaData> transforms;
+};
+} // namespace
+
 void RegisterStrategyMetaData(const std::string &name,
                               const TransformsMetaDataCreator &metaData) {
   ITransformRegistry::GetInstance().Register(metaData(name));
@@ -49,6 +71,7 @@ void RegisterTransformMetadata(FileLoaderInterface const &loader) {
   metaDataList.emplace_back(MakeStringTransformMetaData());
   metaDataList.emplace_back(epoch_script::transform::MakeValidationMetaData());
   metaDataList.emplace_back(epoch_script::transform::MakeStaticCastMetaData());
+  metaDataList.emplace_back(epoch_script::transform::MakeFusedExpressionMetaData());
   metaDataList.emplace_back(epoch_script::transform::MakeStringifyMetaData());
   // metaDataList.emplace_back(epoch_script::transform::MakeSQLQueryMetaData()); // DISABLED
   metaDataList.emplace_back(epoch_script::transform::MakeGroupByNumericAggMetaData());
@@ -85,4 +108,73 @@ void RegisterTransformMetadata(FileLoaderInterface const &loader) {
     ITransformRegistry::GetInstance().Register(indicator);
   }
 }
+
+std::string SerializeTransformMetadataSnapshot() {
+  const auto &registry = ITransformRegistry::GetInstance().GetMetaData();
+  TransformMetadataSnapshot snapshot{kSnapshotFormatVersion,
+                                     EPOCH_SCRIPT_METADATA_FINGERPRINT, {}};
+  snapshot.transforms.reserve(registry.size());
+  for (auto const &[_, metadata] : registry) {
+    snapshot.transforms.push_back(metadata);
+  }
+  // Sorted so the same registry always produces the same bytes
+  std::ranges::sort(snapshot.transforms, {}, &TransformsMetaData::id);
+
+  auto serialized = glz::write_json(snapshot);
+  if (!serialized) {
+    throw std::runtime_error("Failed to serialize transform metadata snapshot: " +
+                             glz::format_error(serialized.error()));
+  }
+  return std::move(*serialized);
+}
+
+std::vector<TransformsMetaData>
+ReadTransformMetadataSnapshot(std::string_view snapshot) {
+  TransformMetadataSnapshot decoded;
+  if (auto error = glz::read_json(decoded, snapshot)) {
+    throw std::runtime_error("Failed to read transform metadata snapshot: " +
+                             glz::format_error(error, snapshot));
+  }
+  if (decoded.version != kSnapshotFormatVersion) {
+    throw std::runtime_error(
+        "Transform metadata snapshot has format version " +
+        std::to_string(decoded.version) + ", expected " +
+        std::to_string(kSnapshotFormatVersion) + "; regenerate it");
+  }
+  if (decoded.fingerprint != EPOCH_SCRIPT_METADATA_FINGERPRINT) {
+    throw std::runtime_error(
+        "Transform metadata snapshot was written from other metadata sources "
+        "(fingerprint '" + decoded.fingerprint + "', expected '" +
+        EPOCH_SCRIPT_METADATA_FINGERPRINT + "'); regenerate it");
+  }
+  return std::move(decoded.transforms);
+}
+
+void RegisterTransformMetadataSnapshot(std::string_view snapshot) {
+  for (auto &metadata : ReadTransformMetadataSnapshot(snapshot)) {
+    ITransformRegistry::GetInstance().Register(std::move(metadata));
+  }
+}
+
+bool RegisterTransformMetadata(FileLoaderInterface const &loader,
+                               std::filesystem::path const &snapshotPath) {
+  if (std::ifstream file{snapshotPath, std::ios::binary}) {
+    const std::string snapshot{std::istreambuf_iterator<char>{file}, {}};
+    try {
+      // Decoded in full first, so a bad snapshot registers nothing
+      for (auto &metadata : ReadTransformMetadataSnapshot(snapshot)) {
+        ITransformRegistry::GetInstance().Register(std::move(metadata));
+      }
+      return true;
+    } catch (std::exception const &e) {
+      SPDLOG_WARN("Ignoring transform metadata snapshot {}: {}",
+                  snapshotPath.string(), e.what());
+    }
+  } else {
+    SPDLOG_WARN("Transform metadata snapshot {} not found, loading YAML",
+                snapshotPath.string());
+  }
+  RegisterTransformMetadata(loader);
+  return false;
+}
 } // namespace epoch_script::transforms
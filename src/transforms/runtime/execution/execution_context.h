@@ -1,6 +1,7 @@
 #pragma once
 #include "iintermediate_storage.h"
 #include "thread_safe_logger.h"
+#include <epoch_script/transforms/runtime/types.h>
 // Removed: #include <model/asset/asset.h> - not needed here
 
 namespace epoch_script::runtime {
@@ -8,6 +9,12 @@ namespace epoch_script::runtime {
 struct ExecutionContext {
   std::unique_ptr<IIntermediateStorage> cache;
   ILoggerPtr logger;
+  // Per asset start of the requested period; see
+  // IDataFlowOrchestrator::SetEvaluationStart
+  AssetTimestampMap evaluationStart;
+  // Fingerprint of the transform configurations, published to transforms
+  // through ScopedAssetContext::CurrentGraphId
+  std::string graphId;
 };
 
 } // namespace epoch_script::runtime
\ No newline at end of file
@@ -11,7 +11,9 @@
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/index.h>
 #include <epoch_script/core/time_frame.h>
+#include <epoch_script/transforms/core/asset_scope.h>
 #include <epoch_script/transforms/core/sessions_utils.h>
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
@@ -90,6 +92,32 @@ SliceBySession(epoch_frame::DataFrame const &df,
   return epoch_script::transform::sessions_utils::SliceBySessionUTC(df,
                                                                       range);
 }
+
+// Reporters and event markers describe the requested period only
+static inline bool
+ReadsEvaluationPeriod(const epoch_script::transform::ITransformBase &transformer) {
+  const auto category =
+      transformer.GetConfiguration().GetTransformDefinition().GetMetadata().category;
+  return category == epoch_core::TransformCategory::Reporter ||
+         category == epoch_core::TransformCategory::EventMarker;
+}
+
+// Drops the warm-up rows before the asset's evaluation start
+static inline epoch_frame::DataFrame
+TrimToEvaluationStart(epoch_frame::DataFrame const &df,
+                      std::string const &asset_id, ExecutionContext const &msg) {
+  const auto start = msg.evaluationStart.find(asset_id);
+  if (start == msg.evaluationStart.end() || df.num_rows() == 0 ||
+      df.index()->dtype()->id() != arrow::Type::TIMESTAMP) {
+    return df;
+  }
+  const auto timestamps = df.index()->array().to_timestamp_view();
+  const int64_t *begin = timestamps->raw_values();
+  const int64_t *end = begin + timestamps->length();
+  const auto first = std::lower_bound(begin, end, start->second) - begin;
+  return first > 0 ? df.iloc({first, end - begin}) : df;
+}
+
 void ApplyDefaultTransform(
     const epoch_script::transform::ITransformBase &transformer,
     ExecutionContext &msg) {
@@ -120,6 +148,9 @@ void ApplyDefaultTransform(
     // If metadata structure doesn't contain the flag yet, ignore
   }
 
+  const bool trimWarmup =
+      !msg.evaluationStart.empty() && ReadsEvaluationPeriod(transformer);
+
   // Lambda for processing a single asset
   auto processAsset = [&](auto const &asset_id) {
     try {
@@ -140,6 +171,9 @@ void ApplyDefaultTransform(
                        .allowNullInputs
                    ? result
                    : result.drop_null();
+      if (trimWarmup) {
+        result = TrimToEvaluationStart(result, asset_id, msg);
+      }
 
       // Apply session slicing if required by metadata and session is resolvable
       bool requiresSession = false;
@@ -168,6 +202,8 @@ void ApplyDefaultTransform(
       }
 
       if (!result.empty()) {
+        epoch_script::transform::ScopedAssetContext assetScope{
+            asset_id, msg.graphId};
         result = transformer.TransformData(result);
       } else {
         SPDLOG_WARN(
@@ -269,6 +305,9 @@ void ApplyCrossSectionTransform(
   } catch (...) {
   }
 
+  const bool trimWarmup =
+      !msg.evaluationStart.empty() && ReadsEvaluationPeriod(transformer);
+
   std::vector<epoch_frame::FrameOrSeries> inputPerAsset;
   inputPerAsset.reserve(asset_ids.size());
 
@@ -288,6 +327,9 @@ void ApplyCrossSectionTransform(
 
       auto assetDataFrame =
           msg.cache->GatherInputs(asset_id, transformer).drop_null();
+      if (trimWarmup) {
+        assetDataFrame = TrimToEvaluationStart(assetDataFrame, asset_id, msg);
+      }
       // Apply session slicing if required
       bool requiresSession = false;
       std::optional<epoch_frame::SessionRange> sessionRange =
@@ -6,7 +6,10 @@
 #include <boost/container_hash/hash.hpp>
 #include <epoch_script/transforms/core/registration.h>
 #include <epoch_script/core/constants.h>
+#include <epoch_script/core/stable_hash.h>
+#include <algorithm>
 #include <format>
+#include <map>
 #include <spdlog/spdlog.h>
 
 #include <epoch_script/transforms/core/transform_registry.h>
@@ -23,6 +26,50 @@ namespace {
     return metadata.category == epoch_core::TransformCategory::Reporter;
   }
 
+  // Stable digest of every node's id, type, timeframe, options and inputs.
+  // Maps are sorted first, so rebuilding the same graph (e.g. per
+  // walk-forward window) gives the same digest.
+  std::string GraphFingerprint(
+      std::vector<std::unique_ptr<epoch_script::transform::ITransformBase>> const
+          &transforms) {
+    std::vector<std::string> nodes;
+    nodes.reserve(transforms.size());
+    for (auto const &transform : transforms) {
+      const auto config = transform->GetConfiguration();
+      const auto timeframe = config.GetTransformDefinition().GetData().timeframe;
+      epoch_script::StableHasher node;
+      node.Add(config.GetId())
+          .Add(config.GetTransformName())
+          .Add(timeframe ? timeframe->ToString() : std::string{});
+
+      std::map<std::string, std::string> options;
+      for (auto const &[key, option] : config.GetOptions()) {
+        options.emplace(key, option.ToString());
+      }
+      for (auto const &[key, value] : options) {
+        node.Add(key).Add(value);
+      }
+
+      const auto inputs = config.GetInputs();
+      std::map<std::string, std::vector<std::string>> sortedInputs(
+          inputs.begin(), inputs.end());
+      for (auto const &[key, handles] : sortedInputs) {
+        node.Add(key).Add(static_cast<uint64_t>(handles.size()));
+        for (auto const &handle : handles) {
+          node.Add(handle);
+        }
+      }
+      nodes.push_back(node.HexDigest());
+    }
+    std::ranges::sort(nodes);
+
+    epoch_script::StableHasher graph;
+    for (auto const &node : nodes) {
+      graph.Add(node);
+    }
+    return graph.HexDigest();
+  }
+
 }
 
 namespace epoch_script::runtime {
@@ -56,6 +103,7 @@ DataFlowRuntimeOrchestrator::DataFlowRuntimeOrchestrator(
   // Build transform instances from configurations (validates ordering)
   auto transforms = transformManager->BuildTransforms();
   SPDLOG_DEBUG("BuildTransforms returned {} transforms", transforms.size());
+  m_executionContext.graphId = GraphFingerprint(transforms);
 
   // Track unique IDs to prevent actual duplicates
   std::unordered_set<std::string> usedIds;
@@ -125,6 +173,11 @@ void DataFlowRuntimeOrchestrator::RegisterTransform(
   m_dependentNodes.emplace_back(std::move(node));
 }
 
+void DataFlowRuntimeOrchestrator::SetEvaluationStart(
+    AssetTimestampMap evaluationStart) {
+  m_executionContext.evaluationStart = std::move(evaluationStart);
+}
+
 TimeFrameAssetDataFrameMap
 DataFlowRuntimeOrchestrator::ExecutePipeline(TimeFrameAssetDataFrameMap data) {
   // Initialize cache with input data
@@ -36,6 +36,8 @@ namespace epoch_script::runtime {
          */
         TimeFrameAssetDataFrameMap ExecutePipeline(TimeFrameAssetDataFrameMap) override;
 
+        void SetEvaluationStart(AssetTimestampMap evaluationStart) override;
+
         AssetReportMap GetGeneratedReports() const override;
 
         AssetEventMarkerMap GetGeneratedEventMarkers() const override;
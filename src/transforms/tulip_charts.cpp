@@ -424,7 +424,8 @@ std::vector<MetaDataOption> MakeCandleOptions() {
                              static_cast<double>(defaults->period)},
                      .isRequired = true,
                      .min = 1, // Period must be at least 1
-                     .max = 1000};
+                     .max = 1000,
+                     .isLookback = true};
     options.push_back(o);
   }
 
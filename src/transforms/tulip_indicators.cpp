@@ -966,6 +966,9 @@ inline MetaDataOption MakeTulipOptions(std::string const &option, std::string co
     optionMetaData.defaultValue = std::nullopt;
   }
 
+  // Tulip names every bar-count option "... period"
+  optionMetaData.isLookback = option.ends_with("period");
+
   return optionMetaData;
 };
 
@@ -0,0 +1,402 @@
+//
+// Algebraic Simplifier Unit Tests
+//
+
+#include <catch2/catch_all.hpp>
+#include "transforms/compiler/algebraic_simplifier.h"
+#include "transforms/compiler/ast_compiler.h"
+#include "transforms/compiler/compilation_context.h"
+#include "transforms/compiler/compile_session.h"
+#include "transforms/compiler/type_checker.h"
+#include <epoch_script/strategy/metadata.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using namespace epoch_script;
+using namespace epoch_script::strategy;
+
+namespace
+{
+    AlgorithmNode MakeNode(std::string id, std::string type, InputMapping inputs = {})
+    {
+        AlgorithmNode node;
+        node.id = std::move(id);
+        node.type = std::move(type);
+        node.inputs = std::move(inputs);
+        return node;
+    }
+
+    AlgorithmNode MakeNumber(std::string id, double value)
+    {
+        AlgorithmNode node = MakeNode(std::move(id), "number");
+        node.options["value"] = MetaDataOptionDefinition(value);
+        return node;
+    }
+
+    AlgorithmNode MakeLag(std::string id, std::string input, double period)
+    {
+        AlgorithmNode node = MakeNode(std::move(id), "lag_number", {{"SLOT", {std::move(input)}}});
+        node.options["period"] = MetaDataOptionDefinition(period);
+        return node;
+    }
+
+    const AlgorithmNode* FindNode(const std::vector<AlgorithmNode>& algorithms, const std::string& id)
+    {
+        auto it = std::find_if(algorithms.begin(), algorithms.end(),
+                               [&](const AlgorithmNode& node) { return node.id == id; });
+        return it == algorithms.end() ? nullptr : &*it;
+    }
+
+    // Runs the pass over a hand-built graph; src outputs are Decimal and
+    // cond_0 is Boolean
+    void Simplify(std::vector<AlgorithmNode>& algorithms, CompilationContext& context)
+    {
+        for (size_t i = 0; i < algorithms.size(); ++i)
+        {
+            context.node_lookup[algorithms[i].id] = i;
+            context.used_node_ids.insert(algorithms[i].id);
+        }
+        for (const auto* handle : {"c", "o", "v"})
+        {
+            context.node_output_types["src"][handle] = DataType::Decimal;
+        }
+        context.node_output_types["cond_0"]["result"] = DataType::Boolean;
+
+        TypeChecker type_checker(context);
+        AlgebraicSimplifier(context, type_checker).Simplify(algorithms);
+    }
+
+    // Two lags that collapse into one and two comparisons that canonicalize
+    // to the same node
+    const std::string kSimplifiableSource = R"(
+src = market_data_source(timeframe="1D")()
+prev = src.c[2]
+older = prev[3]
+up = src.c > src.o
+down = src.o < src.c
+a = older if up else 0.0
+b = older if down else 1.0
+numeric_cards_report(category="Test", title="A")(a)
+numeric_cards_report(category="Test", title="B")(b)
+)";
+
+    size_t CountType(const std::vector<AlgorithmNode>& algorithms, const std::string& type)
+    {
+        return std::count_if(algorithms.begin(), algorithms.end(),
+                             [&](const AlgorithmNode& node) { return node.type == type; });
+    }
+}
+
+TEST_CASE("Algebraic Simplifier - Rewrites", "[algebraic_simplifier]")
+{
+    SECTION("Collapses lag chains")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeLag("lag_0", "src#c", 2),
+            MakeLag("lag_1", "lag_0#result", 3),
+            MakeNode("executor", "trade_signal_executor", {{"enter_long", {"lag_1#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        REQUIRE(FindNode(algorithms, "lag_0") == nullptr);
+        REQUIRE(context.used_node_ids.count("lag_0") == 0);
+        const auto* lag = FindNode(algorithms, "lag_1");
+        REQUIRE(lag->inputs.at("SLOT").front() == "src#c");
+        REQUIRE(lag->options.at("period").GetDecimal() == 5.0);
+        REQUIRE(context.node_lookup.at("executor") == 2);
+    }
+
+    SECTION("Keeps lag chains across timeframes or with mixed signs")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeLag("lag_0", "src#c", 2),
+            MakeLag("lag_1", "lag_0#result", -3),
+            MakeLag("lag_2", "lag_0#result", 1),
+            MakeNode("executor", "trade_signal_executor",
+                     {{"enter_long", {"lag_1#result"}}, {"exit_long", {"lag_2#result"}}}),
+        };
+        algorithms[3].timeframe = TimeFrame("1H");
+
+        Simplify(algorithms, context);
+
+        REQUIRE(algorithms.size() == 5);
+        REQUIRE(FindNode(algorithms, "lag_1")->inputs.at("SLOT").front() == "lag_0#result");
+        REQUIRE(FindNode(algorithms, "lag_2")->inputs.at("SLOT").front() == "lag_0#result");
+    }
+
+    SECTION("Removes identity operators and no-op casts")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNumber("number_0", 1.0),
+            MakeNode("cond_0", "gt", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+            MakeNode("mul_0", "mul", {{"SLOT0", {"number_0#result"}}, {"SLOT1", {"src#c"}}}),
+            MakeNode("static_cast_to_decimal_0", "static_cast_to_decimal", {{"SLOT", {"mul_0#result"}}}),
+            MakeNode("static_cast_to_decimal_1", "static_cast_to_decimal", {{"SLOT", {"cond_0#result"}}}),
+            MakeNode("static_cast_to_boolean_0", "static_cast_to_boolean",
+                     {{"SLOT", {"static_cast_to_decimal_1#result"}}}),
+            MakeNode("executor", "trade_signal_executor",
+                     {{"enter_long", {"static_cast_to_boolean_0#result"}},
+                      {"exit_long", {"static_cast_to_decimal_0#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        const auto* executor = FindNode(algorithms, "executor");
+        REQUIRE(executor->inputs.at("enter_long").front() == "cond_0#result");
+        REQUIRE(executor->inputs.at("exit_long").front() == "src#c");
+        REQUIRE(algorithms.size() == 3);
+    }
+
+    SECTION("Keeps identity operators and no-op casts across timeframes")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNumber("number_0", 1.0),
+            MakeNode("cond_0", "gt", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+            MakeNode("mul_0", "mul", {{"SLOT0", {"number_0#result"}}, {"SLOT1", {"src#c"}}}),
+            MakeNode("static_cast_to_decimal_0", "static_cast_to_decimal", {{"SLOT", {"src#o"}}}),
+            MakeNode("static_cast_to_decimal_1", "static_cast_to_decimal", {{"SLOT", {"cond_0#result"}}}),
+            MakeNode("static_cast_to_boolean_0", "static_cast_to_boolean",
+                     {{"SLOT", {"static_cast_to_decimal_1#result"}}}),
+            MakeNode("executor", "trade_signal_executor",
+                     {{"enter_long", {"static_cast_to_boolean_0#result"}},
+                      {"exit_long", {"mul_0#result"}},
+                      {"exit_short", {"static_cast_to_decimal_0#result"}}}),
+        };
+        // Each rewrite would skip the resampling onto 1H
+        for (const size_t i : {3, 4, 6})
+        {
+            algorithms[i].timeframe = TimeFrame("1H");
+        }
+
+        Simplify(algorithms, context);
+
+        const auto* executor = FindNode(algorithms, "executor");
+        REQUIRE(executor->inputs.at("enter_long").front() == "static_cast_to_boolean_0#result");
+        REQUIRE(executor->inputs.at("exit_long").front() == "mul_0#result");
+        REQUIRE(executor->inputs.at("exit_short").front() == "static_cast_to_decimal_0#result");
+    }
+
+    SECTION("Does not fold x + 0")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNumber("number_0", 0.0),
+            MakeNode("add_0", "add", {{"SLOT0", {"src#c"}}, {"SLOT1", {"number_0#result"}}}),
+            MakeNode("executor", "trade_signal_executor", {{"enter_long", {"add_0#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        REQUIRE(FindNode(algorithms, "add_0") != nullptr);
+        REQUIRE(FindNode(algorithms, "executor")->inputs.at("enter_long").front() == "add_0#result");
+    }
+
+    SECTION("Canonicalizes comparisons")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNumber("number_0", 0.0),
+            MakeNode("sub_0", "sub", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+            // (c - o) > 0, 0 < (c - o) and o < c all become c > o
+            MakeNode("gt_0", "gt", {{"SLOT0", {"sub_0#result"}}, {"SLOT1", {"number_0#result"}}}),
+            MakeNode("lt_0", "lt", {{"SLOT0", {"number_0#result"}}, {"SLOT1", {"sub_0#result"}}}),
+            MakeNode("lt_1", "lt", {{"SLOT0", {"src#o"}}, {"SLOT1", {"src#c"}}}),
+            // not (v == c) becomes c != v
+            MakeNode("eq_0", "eq", {{"SLOT0", {"src#v"}}, {"SLOT1", {"src#c"}}}),
+            MakeNode("logical_not_0", "logical_not", {{"SLOT", {"eq_0#result"}}}),
+            MakeNode("executor", "trade_signal_executor",
+                     {{"enter_long", {"gt_0#result"}},
+                      {"enter_short", {"lt_0#result"}},
+                      {"exit_long", {"lt_1#result"}},
+                      {"exit_short", {"logical_not_0#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        const InputMapping c_over_o{{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}};
+        for (const auto* id : {"gt_0", "lt_0", "lt_1"})
+        {
+            const auto* node = FindNode(algorithms, id);
+            REQUIRE(node->type == "gt");
+            REQUIRE(node->inputs == c_over_o);
+        }
+
+        const auto* not_node = FindNode(algorithms, "logical_not_0");
+        REQUIRE(not_node->type == "neq");
+        REQUIRE(not_node->inputs.at("SLOT0").front() == "src#c");
+        REQUIRE(not_node->inputs.at("SLOT1").front() == "src#v");
+
+        for (const auto* id : {"sub_0", "number_0", "eq_0"})
+        {
+            REQUIRE(FindNode(algorithms, id) == nullptr);
+        }
+    }
+
+    SECTION("Keeps not over ordered comparisons")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNode("cond_0", "gt", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+            MakeNode("logical_not_0", "logical_not", {{"SLOT", {"cond_0#result"}}}),
+            MakeNode("executor", "trade_signal_executor", {{"enter_long", {"logical_not_0#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        REQUIRE(FindNode(algorithms, "logical_not_0")->type == "logical_not");
+        REQUIRE(FindNode(algorithms, "cond_0")->type == "gt");
+    }
+
+    SECTION("Keeps non-strict comparisons of differences")
+    {
+        // With c == o == +-inf, c - o is NaN: (c - o) >= 0 is false while
+        // c >= o is true, and likewise for <=, == and !=
+        for (const auto* type : {"gte", "lte", "eq", "neq"})
+        {
+            DYNAMIC_SECTION(type)
+            {
+                CompilationContext context;
+                std::vector<AlgorithmNode> algorithms{
+                    MakeNode("src", "market_data_source"),
+                    MakeNumber("number_0", 0.0),
+                    MakeNode("sub_0", "sub", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+                    MakeNode("cmp_0", type, {{"SLOT0", {"sub_0#result"}}, {"SLOT1", {"number_0#result"}}}),
+                    MakeNode("executor", "trade_signal_executor", {{"enter_long", {"cmp_0#result"}}}),
+                };
+
+                Simplify(algorithms, context);
+
+                REQUIRE(FindNode(algorithms, "sub_0") != nullptr);
+                const auto& inputs = FindNode(algorithms, "cmp_0")->inputs;
+                const bool reads_difference = inputs.at("SLOT0").front() == "sub_0#result" ||
+                                              inputs.at("SLOT1").front() == "sub_0#result";
+                REQUIRE(reads_difference);
+            }
+        }
+    }
+
+    SECTION("Keeps decimal casts of Integer and Number values")
+    {
+        // The cast turns an int64 column into the float64 Decimal readers expect
+        CompilationContext context;
+        context.node_output_types["int_0"]["result"] = DataType::Integer;
+        context.node_output_types["num_0"]["result"] = DataType::Number;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("int_0", "int_source"),
+            MakeNode("num_0", "num_source"),
+            MakeNode("static_cast_to_decimal_0", "static_cast_to_decimal", {{"SLOT", {"int_0#result"}}}),
+            MakeNode("static_cast_to_decimal_1", "static_cast_to_decimal", {{"SLOT", {"num_0#result"}}}),
+            MakeNode("executor", "trade_signal_executor",
+                     {{"enter_long", {"static_cast_to_decimal_0#result"}},
+                      {"exit_long", {"static_cast_to_decimal_1#result"}}}),
+        };
+
+        Simplify(algorithms, context);
+
+        const auto* executor = FindNode(algorithms, "executor");
+        REQUIRE(executor->inputs.at("enter_long").front() == "static_cast_to_decimal_0#result");
+        REQUIRE(executor->inputs.at("exit_long").front() == "static_cast_to_decimal_1#result");
+    }
+}
+
+TEST_CASE("Algebraic Simplifier - Difference comparisons with infinities", "[algebraic_simplifier]")
+{
+    // The rewrite (x - y) <op> 0 -> x <op> y is kept only where it is exact
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<double> values{-inf, -1.5, -0.0, 0.0, 2.0, inf, nan};
+    for (const double x : values)
+    {
+        for (const double y : values)
+        {
+            INFO("x = " << x << ", y = " << y);
+            REQUIRE(((x - y) > 0) == (x > y));
+            REQUIRE(((x - y) < 0) == (x < y));
+            REQUIRE((0 < (x - y)) == (x > y));
+            REQUIRE((0 > (x - y)) == (x < y));
+        }
+    }
+
+    for (const double x : {-inf, inf})
+    {
+        REQUIRE_FALSE((x - x) >= 0);
+        REQUIRE(x >= x);
+        REQUIRE_FALSE((x - x) == 0);
+        REQUIRE(x == x);
+    }
+}
+
+TEST_CASE("Algebraic Simplifier - Compiler integration", "[algebraic_simplifier]")
+{
+    AlgorithmAstCompiler plain;
+    auto unsimplified = plain.compile(kSimplifiableSource);
+    REQUIRE(CountType(unsimplified, "lag_number") == 2);
+    REQUIRE(CountType(unsimplified, "lt") == 1);
+
+    AlgorithmAstCompiler compiler;
+    compiler.setAlgebraicSimplification(true);
+    auto simplified = compiler.compile(kSimplifiableSource);
+
+    // One lag of 5, and CSE merges the two comparisons
+    REQUIRE(CountType(simplified, "lag_number") == 1);
+    auto lag = std::find_if(simplified.begin(), simplified.end(),
+                            [](const AlgorithmNode& node) { return node.type == "lag_number"; });
+    REQUIRE(lag->options.at("period").GetDecimal() == 5.0);
+    REQUIRE(lag->inputs.at("SLOT").front() == "src#c");
+    REQUIRE(CountType(simplified, "lt") == 0);
+    REQUIRE(CountType(simplified, "gt") == 1);
+}
+
+TEST_CASE("Algebraic Simplifier - Compile option of every entry point", "[algebraic_simplifier]")
+{
+    const CompilerOptions simplify{.algebraic_simplification = true};
+    auto is_simplified = [](const std::vector<AlgorithmNode>& algorithms)
+    {
+        return CountType(algorithms, "lag_number") == 1;
+    };
+
+    REQUIRE(is_simplified(AlgorithmAstCompiler{simplify}.compile(kSimplifiableSource)));
+
+    const std::vector<std::string> sources{kSimplifiableSource};
+    REQUIRE(is_simplified(compileBatch(sources, false, simplify).front().algorithms));
+    REQUIRE_FALSE(is_simplified(compileBatch(sources, false, CompilerOptions{}).front().algorithms));
+
+    CompileSession session{false, simplify};
+    REQUIRE(is_simplified(session.Open(kSimplifiableSource)));
+
+    // The compilation cache keys on the options, so both forms are served
+    REQUIRE(is_simplified(PythonSource(kSimplifiableSource, false, simplify).GetCompilationResult()));
+    REQUIRE_FALSE(
+        is_simplified(PythonSource(kSimplifiableSource, false, CompilerOptions{}).GetCompilationResult()));
+}
+
+TEST_CASE("Algebraic Simplifier - Enabled from the environment", "[algebraic_simplifier]")
+{
+    constexpr auto kVariable = "EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS";
+
+    ::setenv(kVariable, "algebraic_simplification", 1);
+    REQUIRE(CompilerOptions::FromEnvironment() == CompilerOptions{.algebraic_simplification = true});
+
+    ::setenv(kVariable, "elementwise_fusion,algebraic_simplification", 1);
+    REQUIRE(CompilerOptions::FromEnvironment() ==
+            CompilerOptions{.elementwise_fusion = true, .algebraic_simplification = true});
+
+    ::setenv(kVariable, "all", 1);
+    REQUIRE(CompilerOptions::FromEnvironment() ==
+            CompilerOptions{.elementwise_fusion = true, .algebraic_simplification = true});
+
+    ::unsetenv(kVariable);
+}
@@ -454,3 +454,32 @@ report = numeric_cards_report(agg="sum", category="Test", title="Test")(result)
         REQUIRE(valid_timeframe);
     }
 }
+
+TEST_CASE("Compiler: compileBatch compiles in parallel in input order", "[epoch_script_compiler][batch]")
+{
+    std::vector<std::string> sources;
+    for (int i = 0; i < 64; ++i)
+    {
+        sources.push_back(
+            "src = market_data_source(timeframe=\"1D\")()\n"
+            "fast = ema(period=" + std::to_string(i + 2) + ")(src.c)\n"
+            "numeric_cards_report(category=\"Test\", title=\"Fast\")(fast)\n");
+    }
+    sources[17] = "src = market_data_source(timeframe=\"1D\")()\nx = unknown_transform()(src.c)\n";
+
+    auto results = compileBatch(sources);
+
+    REQUIRE(results.size() == sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        INFO("Script " << i);
+        if (i == 17)
+        {
+            REQUIRE(results[i].error.has_value());
+            REQUIRE(results[i].algorithms.empty());
+            continue;
+        }
+        REQUIRE_FALSE(results[i].error.has_value());
+        REQUIRE(results[i].algorithms == compileAlgorithm(sources[i]));
+    }
+}
@@ -0,0 +1,209 @@
+//
+// Compile Server Unit Tests
+//
+
+#include <catch2/catch_all.hpp>
+#include "transforms/compiler/compile_server.h"
+#include "strategy/compilation_cache.h"
+#include <glaze/glaze.hpp>
+#include <set>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace epoch_script;
+
+namespace
+{
+    const std::string kValidSource = R"(src = market_data_source(timeframe="1D")
+m = sma(period=20)(src.c)
+numeric_cards_report(agg="sum", category="Test", title="SMA")(m)
+)";
+
+    std::string Request(int id, const std::string& code, const std::string& extra = "")
+    {
+        return R"({"id": )" + std::to_string(id) + R"(, "code": )" + glz::write_json(code).value() + extra + "}";
+    }
+
+    glz::generic Parse(const std::string& line)
+    {
+        auto json = glz::read_json<glz::generic>(line);
+        REQUIRE(json.has_value());
+        return std::move(json.value());
+    }
+
+    // Writes every line to fd, closes the write side and reads until EOF
+    std::vector<std::string> Exchange(int fd, const std::vector<std::string>& lines)
+    {
+        std::string requests;
+        for (const auto& line : lines)
+        {
+            requests += line + "\n";
+        }
+        for (size_t sent = 0; sent < requests.size();)
+        {
+            const auto n = ::write(fd, requests.data() + sent, requests.size() - sent);
+            REQUIRE(n > 0);
+            sent += static_cast<size_t>(n);
+        }
+        ::shutdown(fd, SHUT_WR);
+
+        std::string received;
+        char chunk[4096];
+        for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;)
+        {
+            received.append(chunk, static_cast<size_t>(n));
+        }
+        ::close(fd);
+
+        std::vector<std::string> responses;
+        for (size_t start = 0, end; (end = received.find('\n', start)) != std::string::npos; start = end + 1)
+        {
+            responses.push_back(received.substr(start, end - start));
+        }
+        return responses;
+    }
+}
+
+TEST_CASE("Compile Server - Wire format", "[compile_server]")
+{
+    CompileServer server{2, CompilerOptions{}};
+
+    SECTION("Echoes the id with the compile status")
+    {
+        auto response = Parse(server.HandleRequest(Request(7, kValidSource)));
+        REQUIRE(response["id"].get<double>() == 7);
+        REQUIRE(response["status"].get<std::string>() == "ok");
+        REQUIRE(response["message"].get<std::string>() == "Compilation successful");
+        REQUIRE_FALSE(response.contains("cost"));
+
+        auto named = Parse(server.HandleRequest(R"({"id": "doc-1", "code": )" +
+                                                glz::write_json(kValidSource).value() + "}"));
+        REQUIRE(named["id"].get<std::string>() == "doc-1");
+    }
+
+    SECTION("Adds a cost estimate when asked")
+    {
+        auto response = Parse(server.HandleRequest(
+            Request(1, kValidSource, R"(, "estimate": {"assets": 10, "rows": 252})")));
+        REQUIRE(response["status"].get<std::string>() == "ok");
+        REQUIRE(response["cost"]["total_units"].get<double>() > 0);
+    }
+
+    SECTION("Takes compiler options and ignores unknown keys")
+    {
+        auto response = Parse(server.HandleRequest(Request(
+            2, kValidSource,
+            R"(, "options": {"elementwise_fusion": true, "algebraic_simplification": true}, "client": "x")")));
+        REQUIRE(response["status"].get<std::string>() == "ok");
+    }
+}
+
+TEST_CASE("Compile Server - Errors", "[compile_server]")
+{
+    CompileServer server{2, CompilerOptions{}};
+
+    SECTION("Compile errors keep the id")
+    {
+        auto response = Parse(server.HandleRequest(Request(3, "x = undefined_transform()(1)")));
+        REQUIRE(response["id"].get<double>() == 3);
+        REQUIRE(response["status"].get<std::string>() == "error");
+        REQUIRE_FALSE(response["message"].get<std::string>().empty());
+
+        // The worker's compiler is reused after a failure
+        auto next = Parse(server.HandleRequest(Request(4, kValidSource)));
+        REQUIRE(next["status"].get<std::string>() == "ok");
+    }
+
+    SECTION("Empty code")
+    {
+        auto response = Parse(server.HandleRequest(Request(5, "")));
+        REQUIRE(response["status"].get<std::string>() == "error");
+        REQUIRE(response["message"].get<std::string>() == "Empty code provided");
+    }
+
+    SECTION("Invalid requests")
+    {
+        for (const auto* line : {"not json", R"({"id": 1, "code": 42})", R"({"id": 1)"})
+        {
+            auto response = Parse(server.HandleRequest(line));
+            REQUIRE(response["status"].get<std::string>() == "error");
+            REQUIRE(response["message"].get<std::string>().starts_with("Invalid request"));
+        }
+    }
+
+    SECTION("Invalid estimate timeframes")
+    {
+        auto response = Parse(server.HandleRequest(
+            Request(6, kValidSource, R"(, "estimate": {"rows_by_timeframe": {"not_a_timeframe": 1}})")));
+        REQUIRE(response["status"].get<std::string>() == "error");
+    }
+}
+
+TEST_CASE("Compile Server - Concurrent clients", "[compile_server]")
+{
+    constexpr int kClients = 4;
+    constexpr int kRequests = 25;
+
+    const size_t cached = strategy::CompilationCache::Instance().Size();
+    CompileServer server{4, CompilerOptions{}};
+
+    // Every client sends distinct scripts, odd ids invalid, interleaved with
+    // blank lines; each must get exactly its own responses back
+    std::vector<std::vector<std::string>> responses(kClients);
+    std::vector<std::thread> clients;
+    std::vector<std::thread> readers;
+    for (int client = 0; client < kClients; ++client)
+    {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        readers.emplace_back([&server, fd = fds[0]] { server.ServeConnection(fd, fd, true); });
+
+        std::vector<std::string> lines;
+        for (int i = 0; i < kRequests; ++i)
+        {
+            const int id = client * kRequests + i;
+            const std::string period = std::to_string(2 + id);
+            lines.push_back(id % 2 == 0
+                                ? Request(id, "src = market_data_source(timeframe=\"1D\")\nm = sma(period=" + period +
+                                                  ")(src.c)\nnumeric_cards_report(agg=\"sum\", category=\"Test\", "
+                                                  "title=\"SMA\")(m)\n")
+                                : Request(id, "m = sma(period=" + period + ")(missing.c)"));
+            lines.emplace_back(" ");
+        }
+        clients.emplace_back([&responses, client, fd = fds[1], lines]
+        {
+            responses[client] = Exchange(fd, lines);
+        });
+    }
+    for (auto& thread : clients)
+    {
+        thread.join();
+    }
+    for (auto& thread : readers)
+    {
+        thread.join();
+    }
+    server.Wait();
+
+    for (int client = 0; client < kClients; ++client)
+    {
+        INFO("client " << client);
+        REQUIRE(responses[client].size() == kRequests);
+        std::set<int> ids;
+        for (const auto& line : responses[client])
+        {
+            auto response = Parse(line);
+            const int id = static_cast<int>(response["id"].get<double>());
+            REQUIRE(id / kRequests == client);
+            REQUIRE(response["status"].get<std::string>() == (id % 2 == 0 ? "ok" : "error"));
+            ids.insert(id);
+        }
+        REQUIRE(ids.size() == kRequests);
+    }
+
+    // Requests never go through the compilation cache
+    REQUIRE(strategy::CompilationCache::Instance().Size() == cached);
+}
@@ -0,0 +1,153 @@
+//
+// Compile Session Unit Tests
+//
+
+#include <catch2/catch_all.hpp>
+#include "transforms/compiler/compile_session.h"
+#include "transforms/compiler/ast_compiler.h"
+#include <stdexcept>
+#include <string>
+
+using namespace epoch_script;
+
+namespace
+{
+    // src, ten emas, their sum and a report: 13 top-level statements
+    std::string MakeScript()
+    {
+        std::string source = "src = market_data_source(timeframe=\"1D\")()\n";
+        std::string total = "total = e0";
+        for (int i = 0; i < 10; ++i)
+        {
+            source += "e" + std::to_string(i) + " = ema(period=" + std::to_string(i + 2) + ")(src.c)\n";
+            if (i > 0)
+            {
+                total += " + e" + std::to_string(i);
+            }
+        }
+        source += total + "\n";
+        source += "numeric_cards_report(category=\"Test\", title=\"Total\")(total)\n";
+        return source;
+    }
+
+    TextEdit Replace(const std::string& source, const std::string& from, const std::string& to)
+    {
+        const auto pos = source.find(from);
+        REQUIRE(pos != std::string::npos);
+        return TextEdit{pos, pos + from.size(), to};
+    }
+
+    CompilationResult CompileFresh(const std::string& source)
+    {
+        AlgorithmAstCompiler compiler;
+        return compiler.compile(source);
+    }
+}
+
+TEST_CASE("Compile Session - Incremental recompilation", "[compile_session]")
+{
+    CompileSession session;
+    const auto opened = session.Open(MakeScript());
+    REQUIRE(opened == CompileFresh(MakeScript()));
+    REQUIRE(session.LastVisitedStatements() == 13);
+
+    SECTION("Edits near the end revisit only the statements after a checkpoint")
+    {
+        auto result = session.Edit(Replace(session.Source(), "title=\"Total\"", "title=\"Sum\""));
+
+        REQUIRE(result == CompileFresh(session.Source()));
+        REQUIRE(session.LastVisitedStatements() == 1);  // resumed at statement 12
+    }
+
+    SECTION("Edits keep the node ids of earlier statements")
+    {
+        auto result = session.Edit(Replace(session.Source(), "period=10", "period=30"));
+
+        REQUIRE(result == CompileFresh(session.Source()));
+        REQUIRE(session.LastVisitedStatements() == 5);  // resumed at statement 8
+        REQUIRE(session.Source().find("period=30") != std::string::npos);
+    }
+
+    SECTION("Edits at the top recompile everything")
+    {
+        auto result = session.Edit(Replace(session.Source(), "\"1D\"", "\"1H\""));
+
+        REQUIRE(result == CompileFresh(session.Source()));
+        REQUIRE(session.LastVisitedStatements() == 13);
+    }
+
+    SECTION("Successive edits stay consistent")
+    {
+        session.Edit(Replace(session.Source(), "period=3)", "period=4)"));
+        session.Edit(Replace(session.Source(), "period=11", "period=12"));
+        auto result = session.Edit(TextEdit{session.Source().size(), session.Source().size(),
+                                            "extra = ema(period=7)(src.c)\n"});
+
+        REQUIRE(result == CompileFresh(session.Source()));
+        REQUIRE(session.LastVisitedStatements() == 2);
+    }
+
+    SECTION("Recovers from a syntax error")
+    {
+        const auto broken = Replace(session.Source(), "(src.c)\ne5", "(src.c\ne5");
+        REQUIRE_THROWS(session.Edit(broken));
+
+        auto result = session.Edit(TextEdit{broken.start_byte, broken.start_byte + 6, "(src.c)"});
+        REQUIRE(result == opened);
+    }
+
+    SECTION("Constant edits refold earlier statements")
+    {
+        CompileSession constants;
+        std::string source = MakeScript();
+        source.replace(source.find("period=2)"), 9, "period=p)");
+        source += "p = 5\n";
+        constants.Open(source);
+
+        auto result = constants.Edit(Replace(constants.Source(), "p = 5", "p = 6"));
+
+        REQUIRE(result == CompileFresh(constants.Source()));
+        REQUIRE(constants.LastVisitedStatements() == 14);
+    }
+
+    SECTION("Rejects edits outside the source")
+    {
+        REQUIRE_THROWS_AS(session.Edit(TextEdit{0, session.Source().size() + 1, ""}), std::out_of_range);
+    }
+}
+
+TEST_CASE("Compile Session - Checkpoints share the compiled nodes", "[compile_session]")
+{
+    // src, 200 emas and their sum: 50 checkpoints
+    std::string source = "src = market_data_source(timeframe=\"1D\")()\n";
+    std::string total = "total = e0";
+    for (int i = 0; i < 200; ++i)
+    {
+        source += "e" + std::to_string(i) + " = ema(period=" + std::to_string(i + 2) + ")(src.c)\n";
+        if (i > 0)
+        {
+            total += " + e" + std::to_string(i);
+        }
+    }
+    source += total + "\n";
+    source += "numeric_cards_report(category=\"Test\", title=\"Total\")(total)\n";
+
+    CompileSession session;
+    const auto opened = session.Open(source);
+    REQUIRE(opened == CompileFresh(source));
+
+    // Each node is stored once, not once per checkpoint after it
+    REQUIRE(session.CheckpointedNodes() > 0);
+    REQUIRE(session.CheckpointedNodes() <= opened.size());
+
+    // Edits drop the nodes of invalidated checkpoints and resume from the rest
+    const size_t before = session.CheckpointedNodes();
+    auto result = session.Edit(Replace(session.Source(), "period=101)", "period=300)"));
+    REQUIRE(result == CompileFresh(session.Source()));
+    REQUIRE(session.LastVisitedStatements() < 110);
+    REQUIRE(session.CheckpointedNodes() == before);
+
+    result = session.Edit(Replace(session.Source(), "\"1D\"", "\"1H\""));
+    REQUIRE(result == CompileFresh(session.Source()));
+    REQUIRE(session.CheckpointedNodes() == before);
+}
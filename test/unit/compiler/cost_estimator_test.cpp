@@ -0,0 +1,131 @@
+//
+// Cost Estimator Unit Tests
+//
+
+#include <catch2/catch_all.hpp>
+#include "transforms/compiler/cost_estimator.h"
+#include "transforms/compiler/ast_compiler.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace epoch_script;
+
+namespace
+{
+    CompilationResult Compile(const std::string& hurst_options)
+    {
+        const std::string source = R"(
+intraday = market_data_source(timeframe="1Min")
+daily = market_data_source(timeframe="1D")
+h = rolling_hurst_exponent()" + hurst_options + R"()(intraday.c)
+m = sma(period=20)(daily.c)
+numeric_cards_report(agg="sum", category="Test", title="Hurst")(h)
+numeric_cards_report(agg="sum", category="Test", title="SMA")(m)
+)";
+        AlgorithmAstCompiler compiler;
+        return compiler.compile(source);
+    }
+
+    CompilationResult CompileAdf(const std::string& adf_options)
+    {
+        const std::string source = R"(
+intraday = market_data_source(timeframe="1Min")
+adf = rolling_adf()" + adf_options + R"()(intraday.c)
+numeric_cards_report(agg="sum", category="Test", title="ADF")(adf)
+)";
+        AlgorithmAstCompiler compiler;
+        return compiler.compile(source);
+    }
+
+    const NodeCostEstimate& NodeOfType(const CostEstimate& estimate, const std::string& type)
+    {
+        auto it = std::ranges::find(estimate.nodes, type, &NodeCostEstimate::type);
+        REQUIRE(it != estimate.nodes.end());
+        return *it;
+    }
+
+    CostEstimateOptions Options()
+    {
+        CostEstimateOptions options;
+        options.assets = 500;
+        options.rows = 252;
+        options.rows_by_timeframe = {{"1Min", 98280}};
+        return options;
+    }
+}
+
+TEST_CASE("Cost Estimator - Static runtime estimates", "[cost_estimator]")
+{
+    SECTION("Windowed transforms scale with rows, window and assets")
+    {
+        const auto estimate = EstimateCost(Compile("window=200"), Options());
+
+        const auto& hurst = NodeOfType(estimate, "rolling_hurst_exponent");
+        REQUIRE(hurst.rows == 98280);
+        REQUIRE(hurst.units == Catch::Approx(1.0 * 98280 * 200 * 500));
+        REQUIRE(hurst.seconds == Catch::Approx(hurst.units * 1e-9));
+
+        // It dominates the script
+        for (const auto& node : estimate.nodes)
+        {
+            REQUIRE(node.units <= hurst.units);
+        }
+    }
+
+    SECTION("Stride divides the work")
+    {
+        const auto every_bar = EstimateCost(Compile("window=200"), Options());
+        const auto strided = EstimateCost(Compile("window=200, stride=10"), Options());
+
+        REQUIRE(NodeOfType(strided, "rolling_hurst_exponent").units ==
+                Catch::Approx(NodeOfType(every_bar, "rolling_hurst_exponent").units / 10.0));
+    }
+
+    SECTION("Stride leaves the per-row updates")
+    {
+        // rolling_adf slides its accumulators on every row (20 units) and
+        // solves the regression only every stride-th row (80 units)
+        const auto every_bar = EstimateCost(CompileAdf("window=100"), Options());
+        const auto strided = EstimateCost(CompileAdf("window=100, stride=10"), Options());
+
+        REQUIRE(NodeOfType(every_bar, "rolling_adf").units == Catch::Approx((20.0 + 80.0) * 98280 * 500));
+        REQUIRE(NodeOfType(strided, "rolling_adf").units == Catch::Approx((20.0 + 80.0 / 10) * 98280 * 500));
+    }
+
+    SECTION("Missing options fall back to their defaults")
+    {
+        const auto estimate = EstimateCost(Compile(""), Options());
+        REQUIRE(NodeOfType(estimate, "rolling_hurst_exponent").units == Catch::Approx(1.0 * 98280 * 100 * 500));
+    }
+
+    SECTION("Transforms without a cost model are linear at their own timeframe")
+    {
+        const auto estimate = EstimateCost(Compile("window=200"), Options());
+
+        const auto& sma = NodeOfType(estimate, "sma");
+        REQUIRE(sma.rows == 252);
+        REQUIRE(sma.units == Catch::Approx(252.0 * 500));
+    }
+
+    SECTION("Totals add up the nodes")
+    {
+        const auto estimate = EstimateCost(Compile("window=200"), Options());
+
+        double units = 0.0;
+        for (const auto& node : estimate.nodes)
+        {
+            units += node.units;
+        }
+        REQUIRE(estimate.nodes.size() == Compile("window=200").size());
+        REQUIRE(estimate.total_units == Catch::Approx(units));
+        REQUIRE(estimate.total_seconds == Catch::Approx(units * 1e-9));
+    }
+
+    SECTION("Rejects unknown timeframes")
+    {
+        auto options = Options();
+        options.rows_by_timeframe["fortnightly"] = 10;
+        REQUIRE_THROWS_AS(EstimateCost(Compile("window=200"), options), std::runtime_error);
+    }
+}
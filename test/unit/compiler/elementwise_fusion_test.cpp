@@ -0,0 +1,218 @@
+//
+// Elementwise Fusion Unit Tests
+//
+
+#include <catch2/catch_all.hpp>
+#include "transforms/compiler/ast_compiler.h"
+#include "transforms/compiler/compile_session.h"
+#include "transforms/compiler/elementwise_fusion.h"
+#include "transforms/compiler/compilation_context.h"
+#include <epoch_script/strategy/metadata.h>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace epoch_script;
+using namespace epoch_script::strategy;
+
+namespace
+{
+    AlgorithmNode MakeNode(std::string id, std::string type, InputMapping inputs = {})
+    {
+        AlgorithmNode node;
+        node.id = std::move(id);
+        node.type = std::move(type);
+        node.inputs = std::move(inputs);
+        return node;
+    }
+
+    const AlgorithmNode* FindNode(const std::vector<AlgorithmNode>& algorithms, const std::string& id)
+    {
+        auto it = std::find_if(algorithms.begin(), algorithms.end(),
+                               [&](const AlgorithmNode& node) { return node.id == id; });
+        return it == algorithms.end() ? nullptr : &*it;
+    }
+
+    std::vector<AlgorithmNode> MakeGraph()
+    {
+        // (c - ema) / atr > 1.5 and v > sma
+        AlgorithmNode threshold = MakeNode("number_0", "number");
+        threshold.options["value"] = MetaDataOptionDefinition(1.5);
+        return {
+            MakeNode("src", "market_data_source"),
+            MakeNode("ema_0", "ema", {{"SLOT", {"src#c"}}}),
+            MakeNode("atr_0", "atr", {{"SLOT", {"src#c"}}}),
+            MakeNode("sub_0", "sub", {{"SLOT0", {"src#c"}}, {"SLOT1", {"ema_0#result"}}}),
+            MakeNode("div_0", "div", {{"SLOT0", {"sub_0#result"}}, {"SLOT1", {"atr_0#result"}}}),
+            threshold,
+            MakeNode("gt_0", "gt", {{"SLOT0", {"div_0#result"}}, {"SLOT1", {"number_0#result"}}}),
+            MakeNode("sma_0", "sma", {{"SLOT", {"src#v"}}}),
+            MakeNode("gt_1", "gt", {{"SLOT0", {"src#v"}}, {"SLOT1", {"sma_0#result"}}}),
+            MakeNode("logical_and_0", "logical_and", {{"SLOT0", {"gt_0#result"}}, {"SLOT1", {"gt_1#result"}}}),
+            MakeNode("executor", "trade_signal_executor", {{"enter_long", {"logical_and_0#result"}}}),
+        };
+    }
+
+    // A boolean_select over sub/div/gt operators, all on one timeframe
+    const std::string kFusableSource = R"(
+src = market_data_source(timeframe="1D")
+fast = ema(period=20)(src.c)
+slow = sma(period=50)(src.v)
+score = (src.c - fast) / fast if src.v > slow else 0.0
+report = numeric_cards_report(agg="sum", category="Test", title="Test")(score)
+)";
+
+    size_t CountType(const std::vector<AlgorithmNode>& algorithms, const std::string& type)
+    {
+        return std::count_if(algorithms.begin(), algorithms.end(),
+                             [&](const AlgorithmNode& node) { return node.type == type; });
+    }
+}
+
+TEST_CASE("Elementwise Fusion - Operator trees", "[elementwise_fusion]")
+{
+    SECTION("Fuses a whole expression into its root")
+    {
+        CompilationContext context;
+        auto algorithms = MakeGraph();
+        for (const auto& node : algorithms)
+        {
+            context.used_node_ids.insert(node.id);
+        }
+
+        ElementwiseFusion{}.Optimize(algorithms, context);
+
+        const auto* root = FindNode(algorithms, "logical_and_0");
+        REQUIRE(root != nullptr);
+        REQUIRE(root->type == "fused_expression_boolean");
+        REQUIRE(root->options.at("program").GetString() == "$0 $1 sub $2 div #1.5 gt $3 $4 gt and");
+        REQUIRE(root->inputs.at("SLOT") ==
+                std::vector<std::string>{"src#c", "ema_0#result", "atr_0#result", "src#v", "sma_0#result"});
+
+        // Operators and the inlined literal are gone
+        for (const auto* id : {"sub_0", "div_0", "gt_0", "gt_1", "number_0"})
+        {
+            REQUIRE(FindNode(algorithms, id) == nullptr);
+            REQUIRE(context.used_node_ids.count(id) == 0);
+        }
+        REQUIRE(algorithms.size() == 6);
+        REQUIRE(FindNode(algorithms, "executor")->inputs.at("enter_long").front() == "logical_and_0#result");
+    }
+
+    SECTION("Keeps shared operators as inputs")
+    {
+        CompilationContext context;
+        auto algorithms = MakeGraph();
+        // div_0 is also read by the executor
+        algorithms.back().inputs["exit_long"].push_back("div_0#result");
+
+        ElementwiseFusion{}.Optimize(algorithms, context);
+
+        const auto* div = FindNode(algorithms, "div_0");
+        REQUIRE(div != nullptr);
+        REQUIRE(div->type == "fused_expression_number");
+        REQUIRE(div->options.at("program").GetString() == "$0 $1 sub $2 div");
+        REQUIRE(FindNode(algorithms, "logical_and_0")->options.at("program").GetString() ==
+                "$0 #1.5 gt $1 $2 gt and");
+        REQUIRE(FindNode(algorithms, "logical_and_0")->inputs.at("SLOT").front() == "div_0#result");
+    }
+
+    SECTION("Does not fuse across timeframes")
+    {
+        CompilationContext context;
+        auto algorithms = MakeGraph();
+        for (auto& node : algorithms)
+        {
+            node.timeframe = TimeFrame("1D");
+        }
+        algorithms[3].timeframe = TimeFrame("1H");  // sub_0
+
+        ElementwiseFusion{}.Optimize(algorithms, context);
+
+        REQUIRE(FindNode(algorithms, "sub_0")->type == "sub");
+        REQUIRE(FindNode(algorithms, "logical_and_0")->inputs.at("SLOT").front() == "sub_0#result");
+    }
+
+    SECTION("Leaves a lone operator unchanged")
+    {
+        CompilationContext context;
+        std::vector<AlgorithmNode> algorithms{
+            MakeNode("src", "market_data_source"),
+            MakeNode("gt_0", "gt", {{"SLOT0", {"src#c"}}, {"SLOT1", {"src#o"}}}),
+            MakeNode("executor", "trade_signal_executor", {{"enter_long", {"gt_0#result"}}}),
+        };
+
+        ElementwiseFusion{}.Optimize(algorithms, context);
+
+        REQUIRE(algorithms.size() == 3);
+        REQUIRE(algorithms[1].type == "gt");
+    }
+}
+
+TEST_CASE("Elementwise Fusion - Compiler integration", "[elementwise_fusion]")
+{
+    AlgorithmAstCompiler plain;
+    auto unfused = plain.compile(kFusableSource);
+    REQUIRE(CountType(unfused, "boolean_select_number") == 1);
+    REQUIRE(CountType(unfused, "fused_expression_number") == 0);
+
+    AlgorithmAstCompiler compiler;
+    compiler.setElementwiseFusion(true);
+    auto fused = compiler.compile(kFusableSource);
+
+    REQUIRE(CountType(fused, "fused_expression_number") == 1);
+    for (const auto* type : {"boolean_select_number", "sub", "div", "gt"})
+    {
+        REQUIRE(CountType(fused, type) == 0);
+    }
+
+    auto root = std::find_if(fused.begin(), fused.end(),
+                             [](const AlgorithmNode& node) { return node.type == "fused_expression_number"; });
+    auto report = std::find_if(fused.begin(), fused.end(),
+                               [](const AlgorithmNode& node) { return node.type == "numeric_cards_report"; });
+    REQUIRE(report != fused.end());
+    REQUIRE(report->inputs.begin()->second.front() == root->id + "#result");
+    // Dependencies still precede their readers
+    REQUIRE(root < report);
+}
+
+TEST_CASE("Elementwise Fusion - Compile option of every entry point", "[elementwise_fusion]")
+{
+    const CompilerOptions fusion{.elementwise_fusion = true};
+    auto is_fused = [](const std::vector<AlgorithmNode>& algorithms)
+    {
+        return CountType(algorithms, "fused_expression_number") == 1;
+    };
+
+    REQUIRE(is_fused(AlgorithmAstCompiler{fusion}.compile(kFusableSource)));
+    REQUIRE(AlgorithmAstCompiler{fusion}.options() == fusion);
+
+    const std::vector<std::string> sources{kFusableSource};
+    REQUIRE(is_fused(compileBatch(sources, false, fusion).front().algorithms));
+    REQUIRE_FALSE(is_fused(compileBatch(sources, false, CompilerOptions{}).front().algorithms));
+
+    CompileSession session{false, fusion};
+    REQUIRE(is_fused(session.Open(kFusableSource)));
+
+    // The compilation cache keys on the options, so both forms are served
+    REQUIRE(is_fused(PythonSource(kFusableSource, false, fusion).GetCompilationResult()));
+    REQUIRE_FALSE(is_fused(PythonSource(kFusableSource, false, CompilerOptions{}).GetCompilationResult()));
+}
+
+TEST_CASE("Elementwise Fusion - Enabled from the environment", "[elementwise_fusion]")
+{
+    constexpr auto kVariable = "EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS";
+
+    ::unsetenv(kVariable);
+    REQUIRE(CompilerOptions::FromEnvironment() == CompilerOptions{});
+
+    ::setenv(kVariable, "elementwise_fusion", 1);
+    REQUIRE(CompilerOptions::FromEnvironment().elementwise_fusion);
+
+    ::setenv(kVariable, "all", 1);
+    REQUIRE(CompilerOptions::FromEnvironment().elementwise_fusion);
+
+    ::setenv(kVariable, "unknown_pass", 1);
+    REQUIRE(CompilerOptions::FromEnvironment() == CompilerOptions{});
+
+    ::unsetenv(kVariable);
+}
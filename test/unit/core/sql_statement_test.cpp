@@ -7,6 +7,8 @@
 #include <epoch_script/core/metadata_options.h>  // For glaze serialization
 #include <catch2/catch_all.hpp>
 #include <glaze/glaze.hpp>
+#include <atomic>
+#include <thread>
 
 using namespace epoch_script;
 
@@ -318,3 +320,29 @@ TEST_CASE("SqlStatement - Edge cases", "[SqlStatement]") {
         "SELECT * FROM (SELECT SLOT0 as RESULT0 FROM self) sub"));
   }
 }
+
+TEST_CASE("SqlStatement - Concurrent validation", "[SqlStatement]") {
+  // Each thread validates on its own DuckDB connection
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 50; ++i) {
+        try {
+          SqlStatement("SELECT SLOT" + std::to_string((t + i) % 100) + " FROM self");
+        } catch (...) {
+          ++failures;
+        }
+        try {
+          SqlStatement("SELECT MISSING FROM self");
+          ++failures;
+        } catch (const std::runtime_error &) {
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(failures == 0);
+}
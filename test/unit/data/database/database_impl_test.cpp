@@ -955,4 +955,122 @@ TEST_CASE("RefreshPipeline: updates with websocket data and transformations",
   REQUIRE_THAT(last_rows["vwap"].iloc(1).as_double(),
                Catch::Matchers::WithinAbs(
                    151.0, 1e-2)); // VWAP = close price in our simplified case
-}
\ No newline at end of file
+}
+TEST_CASE("TransformBarData trims the warm-up from each asset's first session",
+          "[DatabaseImpl][Transform][EvaluationStart]") {
+  const auto AAPL = EpochScriptAssetConstants::instance().AAPL;
+  const auto ES = EpochScriptAssetConstants::instance().ES;
+  const std::string base_timeframe = "1Min";
+  const auto evaluationStart = DateTime::from_date_str("2024-01-10").date();
+
+  auto utc = [](const char *timestamp) {
+    return DateTime::from_str(timestamp, "UTC");
+  };
+  const auto midnight = utc("2024-01-10 00:00:00").m_nanoseconds.count();
+  // CME Globex trades the 10th from 17:00 Chicago time on the 9th
+  const auto globexOpen = utc("2024-01-09 23:00:00").m_nanoseconds.count();
+  REQUIRE(DatabaseImpl::GetSessionStart(AAPL, evaluationStart) == midnight);
+  REQUIRE(DatabaseImpl::GetSessionStart(ES, evaluationStart) == globexOpen);
+
+  data_sdk::IDataLoader::DataMap input;
+  input[AAPL] = make_random_ohlcv(index::make_datetime_index(
+      std::vector{utc("2024-01-09 20:00:00"), utc("2024-01-10 14:30:00"),
+                  utc("2024-01-11 14:30:00")},
+      "", "UTC"));
+  input[ES] = make_random_ohlcv(index::make_datetime_index(
+      std::vector{utc("2024-01-09 21:00:00"), utc("2024-01-09 23:30:00"),
+                  utc("2024-01-10 14:30:00")},
+      "", "UTC"));
+
+  epoch_script::runtime::TimeFrameAssetDataFrameMap transform_result;
+  transform_result[base_timeframe][AAPL.GetID()] = input.at(AAPL);
+  transform_result[base_timeframe][ES.GetID()] = input.at(ES);
+
+  auto mock_loader = std::make_unique<MockDataloader>();
+  REQUIRE_CALL(*mock_loader, GetDataCategory()).RETURN(DataCategory::MinuteBars);
+  REQUIRE_CALL(*mock_loader, GetStoredData()).RETURN(input);
+  REQUIRE_CALL(*mock_loader, LoadData()).TIMES(1);
+
+  // Reporters and event markers are told the same boundaries before running
+  trompeloeil::sequence seq;
+  auto mock_transform = std::make_unique<MockTransformGraph>();
+  REQUIRE_CALL(*mock_transform, SetEvaluationStart(trompeloeil::_))
+      .WITH(_1.size() == 2 && _1.at(AAPL.GetID()) == midnight &&
+            _1.at(ES.GetID()) == globexOpen)
+      .IN_SEQUENCE(seq);
+  REQUIRE_CALL(*mock_transform, ExecutePipeline(trompeloeil::_))
+      .IN_SEQUENCE(seq)
+      .RETURN(transform_result);
+  REQUIRE_CALL(*mock_transform, GetGeneratedReports())
+      .TIMES(AT_LEAST(0))
+      .RETURN(epoch_script::runtime::AssetReportMap{});
+  REQUIRE_CALL(*mock_transform, GetGeneratedEventMarkers())
+      .TIMES(AT_LEAST(0))
+      .RETURN(epoch_script::runtime::AssetEventMarkerMap{});
+
+  DatabaseImplOptions opts;
+  opts.dataloader = std::move(mock_loader);
+  opts.dataTransform = std::move(mock_transform);
+  opts.evaluationStart = evaluationStart;
+
+  auto db = DatabaseImpl(std::move(opts));
+  db.RunPipeline();
+
+  const auto &transformed = db.GetTransformedData().at(base_timeframe);
+
+  // NYSE opens after UTC midnight, which stays the boundary
+  const auto &aapl = transformed.at(AAPL);
+  INFO("aapl: \n" << aapl);
+  REQUIRE(aapl.equals(input.at(AAPL).iloc({1, 3})));
+
+  // The Globex session of the 10th opened before UTC midnight
+  const auto &es = transformed.at(ES);
+  INFO("es: \n" << es);
+  REQUIRE(es.equals(input.at(ES).iloc({1, 3})));
+}
+
+TEST_CASE("RunPipeline rebuilds when the snapshot cannot be restored",
+          "[DatabaseImpl][DatabaseSnapshot]") {
+  const auto AAPL = EpochScriptAssetConstants::instance().AAPL;
+  const DatabaseSnapshotLocation location{
+      std::filesystem::temp_directory_path() / "epoch_script_snapshot_test" /
+          "unrestorable",
+      "key"};
+  std::filesystem::remove_all(location.directory);
+
+  // A snapshot under the expected key, written for another base timeframe
+  const std::string otherTimeframe = "1Min";
+  TransformedDataType noFrames;
+  DatabaseIndexer noIndex;
+  epoch_script::runtime::AssetReportMap noReports;
+  epoch_script::runtime::AssetEventMarkerMap noMarkers;
+  WriteDatabaseSnapshot(location.directory, location.key,
+                        DatabaseSnapshotRef{otherTimeframe, noFrames, noIndex,
+                                            noReports, noMarkers});
+
+  data_sdk::IDataLoader::DataMap input;
+  input[AAPL] = make_random_ohlcv(index::date_range(
+      {.start = "2000-01-01"_date, .periods = 3, .offset = offset::days(1)}));
+
+  auto mock_loader = std::make_unique<MockDataloader>();
+  REQUIRE_CALL(*mock_loader, GetDataCategory()).RETURN(DataCategory::DailyBars);
+  REQUIRE_CALL(*mock_loader, GetStoredData()).RETURN(input);
+  REQUIRE_CALL(*mock_loader, LoadData()).TIMES(1);
+
+  DatabaseImplOptions opts;
+  opts.dataloader = std::move(mock_loader);
+  opts.snapshot = location;
+
+  auto db = DatabaseImpl(std::move(opts));
+  REQUIRE_NOTHROW(db.RunPipeline());
+  REQUIRE(db.GetTransformedData().at("1D").at(AAPL).equals(input.at(AAPL)));
+
+  // The bad snapshot was replaced by one of this run
+  auto rewritten = ReadDatabaseSnapshot(
+      location.directory, location.key,
+      [&](std::string const &) { return AAPL; });
+  REQUIRE(rewritten);
+  REQUIRE(rewritten->baseTimeframe == "1D");
+
+  std::filesystem::remove_all(location.directory.parent_path());
+}
@@ -239,4 +239,37 @@ TEST_CASE("Database handles indexer data correctly", "[Database]") {
     REQUIRE((std::get<1>(calls[0]).equals(df2) ||
              std::get<1>(calls[1]).equals(df2)));
   }
+
+  SECTION("ForEachRowsAt and GetRowsAt expose row ranges without slicing") {
+    epoch_frame::DateTime dt1 = "2021-01-01"__date;
+    epoch_frame::DateTime dt2 = "2021-01-02"__date;
+    epoch_frame::DateTime missing = "2021-01-03"__date;
+
+    TimestampIndex mockIndex;
+    mockIndex[dt2.timestamp().value] = {{TimeFrameNotation("1D"), C.AAPL, {1, 2}}};
+
+    TransformedDataType transformedData;
+    auto df = make_dataframe<double>(
+        factory::index::make_datetime_index({dt1, dt2, dt2}),
+        {std::vector<double>{100, 101, 102}}, {"col"});
+    transformedData[TimeFrameNotation("1D")][C.AAPL] = df;
+
+    ALLOW_CALL(*mock_impl, GetTimestampIndex()).LR_RETURN(mockIndex);
+    ALLOW_CALL(*mock_impl, GetTransformedData()).LR_RETURN(transformedData);
+    Database db(std::move(mock_impl));
+
+    size_t visits = 0;
+    db.ForEachRowsAt(dt2, [&](Database::RowsView const &rows) {
+      ++visits;
+      REQUIRE(rows.timeframe == "1D");
+      REQUIRE(rows.asset == C.AAPL);
+      REQUIRE(&rows.frame == &transformedData.at("1D").at(C.AAPL));
+      REQUIRE(rows.range == IndexRange{1, 2});
+    });
+    REQUIRE(visits == 1);
+
+    REQUIRE(db.GetRowsAt("1D", C.AAPL, dt1) == IndexRange{0, 0});
+    REQUIRE(db.GetRowsAt("1D", C.AAPL, dt2) == IndexRange{1, 2});
+    REQUIRE_FALSE(db.GetRowsAt("1D", C.AAPL, missing).has_value());
+  }
 }
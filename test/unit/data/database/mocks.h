@@ -51,6 +51,7 @@ class MockTransformGraph final : public epoch_script::runtime::IDataFlowOrchestr
 public:
   MAKE_MOCK1(ExecutePipeline,
              epoch_script::runtime::TimeFrameAssetDataFrameMap(epoch_script::runtime::TimeFrameAssetDataFrameMap), override);
+  MAKE_MOCK1(SetEvaluationStart, void(epoch_script::runtime::AssetTimestampMap), override);
   MAKE_CONST_MOCK0(GetGeneratedReports, epoch_script::runtime::AssetReportMap(), override);
   MAKE_CONST_MOCK0(GetGeneratedEventMarkers, epoch_script::runtime::AssetEventMarkerMap(), override);
 };
@@ -87,8 +88,8 @@ class MockDatabaseImpl final : public IDatabaseImpl {
 public:
   MAKE_MOCK0(RunPipeline, void(), override);
   MAKE_CONST_MOCK0(GetBenchmark, OptionalSeries(), override);
-  MAKE_CONST_MOCK0(GetGeneratedReports, TearSheetMap(), override);
-  MAKE_CONST_MOCK0(GetGeneratedEventMarkers, epoch_script::runtime::AssetEventMarkerMap(), override);
+  MAKE_CONST_MOCK0(GetGeneratedReports, (const TearSheetMap &()), override);
+  MAKE_CONST_MOCK0(GetGeneratedEventMarkers, (const epoch_script::runtime::AssetEventMarkerMap &()), override);
 
   MAKE_MOCK0(RefreshPipeline, void(), override);
   MAKE_CONST_MOCK0(GetIndexer, DatabaseIndexerConstRef(), override);
@@ -104,8 +105,8 @@ public:
                                  const epoch_frame::DateTime &),
       override);
   MAKE_CONST_MOCK2(GetCurrentData,
-                   epoch_frame::DataFrame(TimeFrameNotation const &,
-                                          asset::Asset const &),
+                   const epoch_frame::DataFrame &(TimeFrameNotation const &,
+                                                  asset::Asset const &),
                    override);
 };
 
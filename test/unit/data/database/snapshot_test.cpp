@@ -0,0 +1,85 @@
+#include "data/database/snapshot.h"
+#include "epoch_frame/datetime.h"
+#include "epoch_frame/factory/dataframe_factory.h"
+#include "epoch_frame/factory/index_factory.h"
+#include <epoch_script/data/common/constants.h>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace epoch_script::data;
+using namespace epoch_script;
+using namespace epoch_frame;
+using namespace epoch_frame::factory;
+
+TEST_CASE("MakeDatabaseSnapshotKey is stable and order sensitive",
+          "[DatabaseSnapshot]") {
+  const auto key = MakeDatabaseSnapshotKey({"script", "1D", "AAPL"});
+  REQUIRE(key == MakeDatabaseSnapshotKey({"script", "1D", "AAPL"}));
+  REQUIRE(key != MakeDatabaseSnapshotKey({"script", "AAPL", "1D"}));
+  // Parts are length prefixed, so concatenation does not collide.
+  REQUIRE(MakeDatabaseSnapshotKey({"ab", "c"}) !=
+          MakeDatabaseSnapshotKey({"a", "bc"}));
+}
+
+TEST_CASE("DatabaseSnapshot round trips frames and indexer",
+          "[DatabaseSnapshot]") {
+  const auto &C = EpochScriptAssetConstants::instance();
+  const auto directory = std::filesystem::temp_directory_path() /
+                         "epoch_script_snapshot_test" / "roundtrip";
+  std::filesystem::remove_all(directory);
+
+  epoch_frame::DateTime dt1 = "2021-01-01"__date;
+  epoch_frame::DateTime dt2 = "2021-01-04"__date;
+  auto df = make_dataframe<double>(
+      factory::index::make_datetime_index({dt1, dt2}),
+      {std::vector<double>{100, 101}}, {"c"});
+
+  TransformedDataType transformedData;
+  transformedData["1D"].insert_or_assign(C.AAPL, df);
+
+  DatabaseIndexer indexer;
+  indexer.push_back(std::make_unique<DatabaseIndexerItem>(DatabaseIndexerItem{
+      "1D", C.AAPL,
+      {{dt1.timestamp().value, {0, 1}}, {dt2.timestamp().value, {1, 2}}}}));
+
+  const std::string baseTimeframe = "1D";
+  runtime::AssetReportMap reports;
+  runtime::AssetEventMarkerMap eventMarkers;
+  WriteDatabaseSnapshot(directory, "key",
+                        DatabaseSnapshotRef{baseTimeframe, transformedData,
+                                            indexer, reports, eventMarkers});
+
+  auto resolve = [&](std::string const &id) {
+    REQUIRE(id == C.AAPL.GetID());
+    return C.AAPL;
+  };
+
+  SECTION("Mismatched key is ignored") {
+    REQUIRE_FALSE(ReadDatabaseSnapshot(directory, "other", resolve));
+  }
+
+  SECTION("Matching key restores state") {
+    auto snapshot = ReadDatabaseSnapshot(directory, "key", resolve);
+    REQUIRE(snapshot);
+    REQUIRE(snapshot->baseTimeframe == baseTimeframe);
+    REQUIRE(snapshot->transformedData.at("1D").at(C.AAPL).equals(df));
+    REQUIRE(snapshot->indexer.size() == 1);
+    REQUIRE(snapshot->indexer[0]->indexer == indexer[0]->indexer);
+  }
+
+  SECTION("Rewriting replaces the snapshot and leaves no staging copies") {
+    WriteDatabaseSnapshot(directory, "rewritten",
+                          DatabaseSnapshotRef{baseTimeframe, transformedData,
+                                              indexer, reports, eventMarkers});
+    REQUIRE_FALSE(ReadDatabaseSnapshot(directory, "key", resolve));
+    REQUIRE(ReadDatabaseSnapshot(directory, "rewritten", resolve));
+
+    size_t entries = 0;
+    for ([[maybe_unused]] auto const &entry :
+         std::filesystem::directory_iterator(directory.parent_path())) {
+      ++entries;
+    }
+    REQUIRE(entries == 1);
+  }
+
+  std::filesystem::remove_all(directory.parent_path());
+}
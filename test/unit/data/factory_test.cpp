@@ -440,3 +440,134 @@ TEST_CASE("ProcessConfigurations does not add base timeframe to resampling", "[f
   // Same timeframe as base should not be added
   REQUIRE(option.barResampleTimeFrames.empty());
 }
+
+// ============================================================================
+// Tests for data requirements
+// ============================================================================
+
+std::unique_ptr<TransformConfiguration> MakeGraphConfig(
+    std::string const &id, std::string const &transformType,
+    epoch_core::TransformCategory category,
+    epoch_script::strategy::InputMapping inputs,
+    MetaDataArgDefinitionMapping options = {},
+    std::vector<std::string> requiredDataSources = {},
+    std::set<std::string> const &lookbackOptions = {"period"}) {
+  std::vector<epoch_script::MetaDataOption> optionMetadata;
+  for (auto const &[optionId, _] : options) {
+    optionMetadata.push_back({.id = optionId,
+                              .name = optionId,
+                              .type = epoch_core::MetaDataOptionType::Integer,
+                              .isLookback = lookbackOptions.contains(optionId)});
+  }
+
+  epoch_script::TransformDefinitionData data{
+      .type = transformType,
+      .id = id,
+      .options = options,
+      .timeframe = epoch_script::TimeFrame{"1d"},
+      .inputs = std::move(inputs),
+      .metaData = {
+          .id = transformType,
+          .category = category,
+          .plotKind = epoch_core::TransformPlotKind::Null,
+          .name = transformType,
+          .options = optionMetadata,
+          .isCrossSectional = false,
+          .desc = "Test transform",
+          .inputs = {},
+          .outputs = {},
+          .atLeastOneInputRequired = false,
+          .tags = {},
+          .requiresTimeFrame = false,
+          .requiredDataSources = std::move(requiredDataSources),
+      }};
+
+  return std::make_unique<TransformConfiguration>(
+      epoch_script::TransformDefinition(std::move(data)));
+}
+
+TEST_CASE("AnalyzeDataRequirements derives columns and warm-up", "[factory][requirements]") {
+  TransformConfigurationPtrList configs;
+  configs.push_back(MakeGraphConfig("src", "market_data_source",
+                                    epoch_core::TransformCategory::DataSource, {}));
+  configs.push_back(MakeGraphConfig(
+      "ema", "ema", epoch_core::TransformCategory::Trend, {{"SLOT", {"src#c"}}},
+      {{"period", epoch_script::MetaDataOptionDefinition{200.0}}}));
+  configs.push_back(MakeGraphConfig(
+      "sma", "sma", epoch_core::TransformCategory::Trend, {{"SLOT", {"ema#result"}}},
+      {{"period", epoch_script::MetaDataOptionDefinition{10.0}}}));
+  configs.push_back(MakeGraphConfig(
+      "gap", "intraday_returns", epoch_core::TransformCategory::Momentum, {}, {},
+      {"o", "c"}));
+
+  auto requirements = AnalyzeDataRequirements(configs, DataCategory::DailyBars);
+
+  REQUIRE(requirements.columns.size() == 1);
+  REQUIRE(requirements.columns.at(DataCategory::DailyBars) ==
+          std::set<std::string>{"c", "o"});
+
+  // sma(10) of ema(200) is valid after 210 bars
+  REQUIRE(requirements.warmupBars.size() == 1);
+  REQUIRE(requirements.warmupBars.at(epoch_script::TimeFrame{"1d"}) == 210);
+
+  SECTION("ApplyDataRequirements loads the warm-up before the period") {
+    auto startDate = epoch_frame::DateTime::from_date_str("2024-01-01").date();
+    DataModuleOption option{
+        .loader = {
+            .startDate = startDate,
+            .endDate = epoch_frame::DateTime::from_date_str("2024-12-31").date(),
+            .categories = {DataCategory::DailyBars}}};
+
+    ApplyDataRequirements(requirements, option);
+    const auto loadStart = option.loader.startDate;
+
+    // 210 sessions cover at least 294 calendar days
+    REQUIRE(loadStart <= epoch_frame::DateTime::from_date_str("2023-03-13").date());
+    REQUIRE(option.evaluationStart == startDate);
+    REQUIRE(option.requiredColumns == requirements.columns);
+
+    // Applying again does not move the start further
+    ApplyDataRequirements(requirements, option);
+    REQUIRE(option.loader.startDate == loadStart);
+    REQUIRE(option.evaluationStart == startDate);
+  }
+}
+
+TEST_CASE("AnalyzeDataRequirements counts only look-back options", "[factory][requirements]") {
+  TransformConfigurationPtrList configs;
+  configs.push_back(MakeGraphConfig("src", "market_data_source",
+                                    epoch_core::TransformCategory::DataSource, {}));
+  // An annualization factor is an integer option but consumes no bars
+  configs.push_back(MakeGraphConfig(
+      "vol", "hodges_tompkins", epoch_core::TransformCategory::Volatility,
+      {{"SLOT", {"src#c"}}},
+      {{"period", epoch_script::MetaDataOptionDefinition{14.0}},
+       {"trading_periods", epoch_script::MetaDataOptionDefinition{252.0}}}));
+  // Look-back options need not be named after periods
+  configs.push_back(MakeGraphConfig(
+      "span", "custom", epoch_core::TransformCategory::Trend,
+      {{"SLOT", {"vol#result"}}},
+      {{"bars", epoch_script::MetaDataOptionDefinition{30.0}}}, {}, {"bars"}));
+
+  auto requirements = AnalyzeDataRequirements(configs, DataCategory::DailyBars);
+
+  REQUIRE(requirements.warmupBars.at(epoch_script::TimeFrame{"1d"}) == 44);
+}
+
+TEST_CASE("ProcessConfigurations keeps the period without warm-up", "[factory][requirements]") {
+  auto startDate = epoch_frame::DateTime::from_date_str("2024-01-01").date();
+  DataModuleOption option{
+      .loader = {
+          .startDate = startDate,
+          .endDate = epoch_frame::DateTime::from_date_str("2024-12-31").date(),
+          .categories = {DataCategory::DailyBars}}};
+
+  std::vector<std::unique_ptr<TransformConfiguration>> configs;
+  configs.push_back(std::make_unique<TransformConfiguration>(
+      MakeTestConfig("sma", epoch_core::TransformCategory::Trend, epoch_script::TimeFrame{"1d"})));
+
+  ProcessConfigurations(configs, epoch_script::TimeFrame{"1d"}, option);
+
+  REQUIRE(option.loader.startDate == startDate);
+  REQUIRE_FALSE(option.evaluationStart.has_value());
+}
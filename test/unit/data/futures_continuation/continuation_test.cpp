@@ -4,6 +4,7 @@
 #include <trompeloeil.hpp>
 
 #include "data/futures_continuation/continuations.h"
+#include "data/futures_continuation/roll_method/liquidity_based.h"
 #include <epoch_frame/common.h>
 #include <epoch_frame/factory/array_factory.h>
 #include <epoch_frame/factory/dataframe_factory.h>
@@ -178,7 +179,20 @@ inline std::vector<Config> BuildConfigs() {
       false                 // no throw
   };
 
-  return {cfg1, cfg2, intra, multiContractsPerDay, longPath};
+  Config unsorted{"Unsorted timestamps throw",
+                  {"CLZ25", "CLF26", "CLZ25", "CLF26"},
+                  {"2025-01-03"__date, "2025-01-03"__date, "2025-01-02"__date,
+                   "2025-01-02"__date},
+                  {}, // never reaches the roll walk
+                  {},
+                  {},
+                  {},
+                  {},
+                  {},
+                  false,
+                  true};
+
+  return {cfg1, cfg2, intra, multiContractsPerDay, longPath, unsorted};
 }
 } // namespace
 
@@ -255,4 +269,58 @@ TEST_CASE("Single contract – no roll, same size output") {
 
   INFO(result);
   REQUIRE(cont->BuildBars(result).equals(result));
-}
\ No newline at end of file
+}
+namespace {
+// Liquidity roll read from the one-row frames, the view of the timeline that
+// methods implementing only the DataFrame overload get
+struct FrameLiquidityRoll : RolloverMethodBase {
+  using RolloverMethodBase::IsRollDate;
+
+  bool IsRollDate(Input const &input) const override {
+    return input.backData.iloc(0, C.OPEN_INTEREST()).as_double() /
+               input.frontData.iloc(0, C.OPEN_INTEREST()).as_double() >=
+           1.0;
+  }
+  epoch_core::RolloverType GetType() const override {
+    return epoch_core::RolloverType::LiquidityBased;
+  }
+};
+} // namespace
+
+TEST_CASE("Buffer roll decisions match the DataFrame path",
+          "[continuation]") {
+  std::vector<std::string> contracts;
+  std::vector<DateTime> dates;
+  for (auto const &date : {"2025-01-02"__date, "2025-01-03"__date,
+                           "2025-01-06"__date, "2025-01-07"__date,
+                           "2025-01-08"__date, "2025-01-09"__date}) {
+    for (auto const &contract : {"CLZ25", "CLF26", "CLG26"}) {
+      contracts.emplace_back(contract);
+      dates.emplace_back(date);
+    }
+  }
+  const auto input = make_df(contracts, dates);
+
+  struct Legs {
+    FuturesConstructedBars front, back;
+    std::vector<int64_t> rolloverPoints;
+  };
+  auto build = [&](std::unique_ptr<RolloverMethodBase> roll) {
+    Legs legs;
+    auto adj = std::make_unique<MockAdj>();
+    ALLOW_CALL(*adj,
+               AdjustContracts(trompeloeil::_, trompeloeil::_, trompeloeil::_))
+        .LR_SIDE_EFFECT(legs = {_1, _2, _3})
+        .RETURN(DataFrame{});
+    make_cont(std::move(roll), std::move(adj))->BuildBars(input);
+    return legs;
+  };
+
+  const auto buffers = build(std::make_unique<LiquidityBasedMethod>(0));
+  const auto frames = build(std::make_unique<FrameLiquidityRoll>());
+
+  REQUIRE_FALSE(buffers.front.t.empty());
+  REQUIRE(buffers.rolloverPoints == frames.rolloverPoints);
+  REQUIRE(buffers.front == frames.front);
+  REQUIRE(buffers.back == frames.back);
+}
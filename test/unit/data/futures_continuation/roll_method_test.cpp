@@ -124,4 +124,23 @@ TEST_CASE("LiquidityBasedMethod Not On Rollover Date", "[RolloverMethod]") {
       {.frontData = MakeDataFromContract(currentTime, "ESZ23", 12),
        .backData = MakeDataFromContract(currentTime, "ESF24", 8),
        .currentDate = currentTime}));
-}
\ No newline at end of file
+}
+TEST_CASE("RolloverMethod Snapshot matches frame input", "[RolloverMethod]") {
+  const LiquidityBasedMethod liquidity(10);
+  const LastTradingDayMethod lastTradingDay(0);
+  const Date currentTime = GetContractExpiration("ESZ23");
+
+  const RolloverMethodBase::Input input{
+      .frontData = MakeDataFromContract(currentTime, "ESZ23", 8),
+      .backData = MakeDataFromContract(currentTime, "ESF24", 12),
+      .currentDate = currentTime};
+  const auto snapshot = RolloverMethodBase::MakeSnapshot(input);
+
+  REQUIRE(snapshot.frontContract == "ESZ23");
+  REQUIRE(snapshot.backContract == "ESF24");
+  REQUIRE(snapshot.frontOpenInterest == 8);
+  REQUIRE(snapshot.backOpenInterest == 12);
+  REQUIRE(liquidity.IsRollDate(snapshot) == liquidity.IsRollDate(input));
+  REQUIRE(lastTradingDay.IsRollDate(snapshot) ==
+          lastTradingDay.IsRollDate(input));
+}
@@ -2,6 +2,10 @@
 #include "epoch_script/strategy/metadata.h" // Your metadata declarations
 #include <catch2/catch_all.hpp>
 #include <epoch_script/transforms/core/registration.h>
+#include <epoch_script/transforms/core/registry.h>
+#include "strategy/compilation_cache.h"
+#include "transforms/compiler/ast_compiler.h"
+#include <format>
 #include <yaml-cpp/yaml.h>
 
 // For convenience:
@@ -387,3 +391,77 @@ signal = gt()(src.c, sma_val.result)
   REQUIRE_FALSE(result1.empty());
   REQUIRE(&result1 == &result2); // Same reference (cached)
 }
+
+TEST_CASE("PythonSource - compilation cache reuses results", "[PythonSource]")
+{
+  transforms::RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER);
+
+  std::string source = R"(src = market_data_source(timeframe='1D')
+sma_val = sma(period=15, timeframe='1D')(src.c)
+report = numeric_cards_report(agg='sum', category='Test', title='Test')(sma_val.result))";
+
+  auto &cache = CompilationCache::Instance();
+  cache.Clear();
+
+  auto first = cache.GetOrCompile(source, true);
+  auto second = cache.GetOrCompile(source, true);
+  REQUIRE(first == second);
+
+  // skip_sink_validation and the compiler options are part of the key
+  REQUIRE(cache.GetOrCompile(source, false) != first);
+  REQUIRE(cache.GetOrCompile(source, true,
+                             CompilerOptions{.elementwise_fusion = true}) !=
+          first);
+
+  epoch_script::AlgorithmAstCompiler compiler;
+  REQUIRE(first->nodes == compiler.compile(source, true));
+  REQUIRE(first->executorCount == compiler.getExecutorCount());
+
+  PythonSource ps(source, true);
+  REQUIRE(ps.GetCompilationResult() == first->nodes);
+}
+
+TEST_CASE("PythonSource - compilation cache invalidation and bound", "[PythonSource]")
+{
+  transforms::RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER);
+
+  auto script = [](int period) {
+    return std::format(R"(src = market_data_source(timeframe='1D')
+sma_val = sma(period={}, timeframe='1D')(src.c)
+report = numeric_cards_report(agg='sum', category='Test', title='Test')(sma_val.result))",
+                       period);
+  };
+
+  auto &cache = CompilationCache::Instance();
+  cache.Clear();
+
+  SECTION("Changing a transform's metadata recompiles")
+  {
+    auto &registry = transforms::ITransformRegistry::GetInstance();
+    const auto original = registry.GetMetaData("sma")->get();
+    const auto first = cache.GetOrCompile(script(15), true);
+
+    // Same number of transforms, different content
+    auto changed = original;
+    changed.desc += " (changed)";
+    registry.Register(changed);
+    const auto second = cache.GetOrCompile(script(15), true);
+    registry.Register(original);
+
+    REQUIRE(second != first);
+    REQUIRE(second->nodes == first->nodes);
+  }
+
+  SECTION("Least recently used entries are evicted")
+  {
+    cache.SetCapacity(2);
+    const auto first = cache.GetOrCompile(script(10), true);
+    cache.GetOrCompile(script(11), true);
+    REQUIRE(cache.GetOrCompile(script(10), true) == first); // now most recent
+    cache.GetOrCompile(script(12), true);                   // evicts period 11
+
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(cache.GetOrCompile(script(10), true) == first);
+    cache.SetCapacity(CompilationCache::kDefaultCapacity);
+  }
+}
@@ -0,0 +1,195 @@
+#include "transforms/components/calendar/calendar_day_table.h"
+#include <epoch_script/core/constants.h>
+#include <epoch_script/transforms/core/config_helper.h>
+#include <epoch_script/transforms/core/itransform.h>
+#include <epoch_script/transforms/core/transform_configuration.h>
+#include <epoch_script/transforms/core/transform_registry.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <epoch_frame/datetime.h>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
+
+#include <chrono>
+
+using namespace epoch_script;
+using namespace epoch_script::transform;
+using namespace std::chrono_literals;
+
+namespace {
+int64_t DaysSinceEpoch(std::chrono::year_month_day ymd) {
+  return std::chrono::sys_days{ymd}.time_since_epoch().count();
+}
+
+// One bar per calendar day (weekends included) over [first, last]
+epoch_frame::DataFrame DailyBars(std::chrono::year_month_day first,
+                                 std::chrono::year_month_day last) {
+  std::vector<epoch_frame::DateTime> dates;
+  std::vector<double> values;
+  for (auto day = std::chrono::sys_days{first};
+       day <= std::chrono::sys_days{last}; day += std::chrono::days{1}) {
+    const std::chrono::year_month_day ymd{day};
+    dates.emplace_back(ymd.year(), ymd.month(), ymd.day(), 0h, 0min, 0s);
+    values.push_back(static_cast<double>(values.size()));
+  }
+  return epoch_frame::make_dataframe<double>(
+      epoch_frame::factory::index::make_datetime_index(dates), {values},
+      {"price"});
+}
+
+std::vector<bool> RunCalendarEffect(std::string const &type,
+                                    YAML::Node const &options,
+                                    epoch_frame::DataFrame const &bars) {
+  YAML::Node node;
+  node["type"] = type;
+  node["id"] = type;
+  node["timeframe"] = YAML::Load(
+      EpochStratifyXConstants::instance().DAILY_FREQUENCY.Serialize());
+  node["options"] = options;
+  const TransformConfiguration config{TransformDefinition{node}};
+  auto transformBase = MAKE_TRANSFORM(config);
+  auto transform = dynamic_cast<ITransform *>(transformBase.get());
+  auto output = transform->TransformData(bars);
+  auto values = std::static_pointer_cast<arrow::BooleanArray>(
+      output[config.GetOutputId()].contiguous_array().value());
+
+  std::vector<bool> result(values->length());
+  for (int64_t i = 0; i < values->length(); ++i) {
+    result[i] = values->Value(i);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("CalendarDayTable trading-day attributes", "[calendar]") {
+  using namespace std::chrono;
+  const auto table = CalendarDayTableCache::Instance().Get(
+      "", DaysSinceEpoch(2024y / May / 1d), DaysSinceEpoch(2024y / June / 30d));
+  auto row = [&](year_month_day ymd) {
+    return static_cast<size_t>(table->Row(DaysSinceEpoch(ymd)));
+  };
+
+  SECTION("Tables are shared across overlapping ranges") {
+    REQUIRE(CalendarDayTableCache::Instance().Get(
+                "", DaysSinceEpoch(2024y / January / 2d),
+                DaysSinceEpoch(2024y / December / 31d)) == table);
+  }
+
+  SECTION("Day attributes") {
+    REQUIRE(table->weekday[row(2024y / May / 31d)] == 4);
+    REQUIRE(table->Month(row(2024y / May / 31d)) == 5);
+    REQUIRE(table->Quarter(row(2024y / May / 31d)) == 2);
+    REQUIRE(table->dayOfMonth[row(2024y / May / 31d)] == 31);
+    REQUIRE_FALSE(table->IsTradingDay(row(2024y / June / 1d)));
+  }
+
+  SECTION("Turn of month counts trading days") {
+    // May 2024 ends on a Friday; June starts on a weekend
+    REQUIRE(table->TurnOfMonth(row(2024y / May / 31d), 1, 0));
+    REQUIRE(table->TurnOfMonth(row(2024y / May / 30d), 2, 0));
+    REQUIRE_FALSE(table->TurnOfMonth(row(2024y / May / 30d), 1, 0));
+    REQUIRE_FALSE(table->TurnOfMonth(row(2024y / June / 1d), 5, 5));
+    REQUIRE(table->TurnOfMonth(row(2024y / June / 3d), 0, 1));
+    REQUIRE_FALSE(table->TurnOfMonth(row(2024y / June / 4d), 0, 1));
+  }
+}
+
+TEST_CASE("CalendarDayTable holiday proximity", "[calendar][holiday]") {
+  using namespace std::chrono;
+  const auto table = CalendarDayTableCache::Instance().Get(
+      "USFederalHolidayCalendar", DaysSinceEpoch(2024y / May / 1d),
+      DaysSinceEpoch(2024y / July / 31d));
+  auto row = [&](year_month_day ymd) {
+    return static_cast<size_t>(table->Row(DaysSinceEpoch(ymd)));
+  };
+
+  REQUIRE(table->isHoliday[row(2024y / July / 4d)]);
+  REQUIRE(table->NearHoliday(row(2024y / July / 3d), 1, 0));
+  REQUIRE_FALSE(table->NearHoliday(row(2024y / July / 2d), 1, 0));
+  REQUIRE(table->NearHoliday(row(2024y / July / 5d), 0, 1));
+  REQUIRE_FALSE(table->NearHoliday(row(2024y / July / 4d), 5, 5));
+
+  // Memorial Day (Monday): the Friday before is one trading day ahead
+  REQUIRE(table->NearHoliday(row(2024y / May / 24d), 1, 0));
+  REQUIRE_FALSE(table->NearHoliday(row(2024y / May / 26d), 5, 5));
+}
+
+TEST_CASE("Calendar effects gather from the day table", "[calendar]") {
+  using namespace std::chrono;
+  const auto bars = DailyBars(2024y / January / 1d, 2024y / March / 31d);
+  const auto first = sys_days{2024y / January / 1d};
+
+  auto expected = [&](auto &&predicate) {
+    std::vector<bool> mask;
+    for (size_t i = 0; i < bars.size(); ++i) {
+      const auto day = first + days{static_cast<int64_t>(i)};
+      mask.push_back(predicate(year_month_day{day},
+                               weekday{day}.iso_encoding() - 1));
+    }
+    return mask;
+  };
+
+  SECTION("turn_of_month") {
+    YAML::Node options;
+    options["days_before"] = 1;
+    options["days_after"] = 1;
+    // Last weekday: Jan 31 (Wed), Feb 29 (Thu), Mar 29 (Fri);
+    // first weekday: Jan 1 (Mon), Feb 1 (Thu), Mar 1 (Fri)
+    REQUIRE(RunCalendarEffect("turn_of_month", options, bars) ==
+            expected([](year_month_day ymd, unsigned) {
+              const auto d = static_cast<unsigned>(ymd.day());
+              const auto m = static_cast<unsigned>(ymd.month());
+              return d == 1 || (m == 1 && d == 31) || (m == 2 && d == 29) ||
+                     (m == 3 && d == 29);
+            }));
+  }
+
+  SECTION("day_of_week") {
+    YAML::Node options;
+    options["weekday"] = "Friday";
+    REQUIRE(RunCalendarEffect("day_of_week", options, bars) ==
+            expected([](year_month_day, unsigned dow) { return dow == 4; }));
+  }
+
+  SECTION("month_of_year") {
+    YAML::Node options;
+    options["month"] = "February";
+    REQUIRE(RunCalendarEffect("month_of_year", options, bars) ==
+            expected([](year_month_day ymd, unsigned) {
+              return ymd.month() == February;
+            }));
+  }
+
+  SECTION("week_of_month") {
+    YAML::Node options;
+    options["week"] = "Last";
+    REQUIRE(RunCalendarEffect("week_of_month", options, bars) ==
+            expected([](year_month_day ymd, unsigned) {
+              return static_cast<unsigned>(ymd.day()) >= 29;
+            }));
+  }
+}
+
+// Week N holds days 7(N-1)+1 .. 7N, so days 29-31 are the "Last" week. The
+// previous formula, ceil((day - 1) / 7) + 1, made day 1 a week of its own
+// and put days 30-31 in a sixth week that no option selected.
+TEST_CASE("week_of_month counts days 1-7 as the first week", "[calendar]") {
+  using namespace std::chrono;
+  const auto bars = DailyBars(2024y / January / 1d, 2024y / March / 31d);
+  const auto first = sys_days{2024y / January / 1d};
+
+  const auto week = GENERATE(std::pair{"First", 1u}, std::pair{"Second", 2u},
+                             std::pair{"Third", 3u}, std::pair{"Fourth", 4u},
+                             std::pair{"Last", 5u});
+  YAML::Node options;
+  options["week"] = week.first;
+  const auto mask = RunCalendarEffect("week_of_month", options, bars);
+
+  REQUIRE(mask.size() == bars.size());
+  for (size_t i = 0; i < mask.size(); ++i) {
+    const auto day = static_cast<unsigned>(
+        year_month_day{first + days{static_cast<int64_t>(i)}}.day());
+    INFO(week.first << " day " << day);
+    CHECK(mask[i] == (day > 7 * (week.second - 1) && day <= 7 * week.second));
+  }
+}
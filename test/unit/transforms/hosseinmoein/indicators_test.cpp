@@ -138,7 +138,9 @@ TEST_CASE("IndicatorsTest", "[indicators]") {
         expanded_df.single_act_visit<double>("IBM_Close", expanded_hurst);
         auto expanded_rhs = expanded_hurst.get_result();
 
-        CHECK(expanded_lhs[i] == Scalar{expanded_rhs});
+        INFO("[" << i << "] result expanded: " << expanded_lhs[i]);
+        CHECK(expanded_lhs[i].as_double() ==
+              Catch::Approx(expanded_rhs).epsilon(1e-9));
       }
 
       StdDataFrame<int64_t> rolling_df;
@@ -157,7 +159,46 @@ TEST_CASE("IndicatorsTest", "[indicators]") {
 
       INFO("[" << i << "] result rolling: " << rolling_lhs[i]);
       INFO("[" << i << "] expected rolling: " << rolling_rhs);
-      CHECK(rolling_lhs[i] == Scalar{rolling_rhs});
+      if (i < period - 1) {
+        CHECK(rolling_lhs[i].is_null());
+      } else {
+        CHECK(rolling_lhs[i].as_double() ==
+              Catch::Approx(rolling_rhs).epsilon(1e-9));
+      }
+    }
+  }
+
+  SECTION("RollingHurstExponent stride forward fills between windows") {
+    const int64_t stride = 3;
+    auto cfg = rolling_hurst_exponent_cfg(
+        "rolling_hurst_id", period, C.CLOSE(),
+        epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY);
+    auto every_bar = MAKE_TRANSFORM(cfg)->TransformData(input_df)
+                         [cfg.GetOutputId("result")]
+                             .contiguous_array();
+
+    YAML::Node inputs_yaml;
+    inputs_yaml["SLOT"] = C.CLOSE();
+    YAML::Node options_yaml;
+    options_yaml["window"] = period;
+    options_yaml["stride"] = stride;
+    auto strided_cfg =
+        run_op("rolling_hurst_exponent", "rolling_hurst_id", inputs_yaml,
+               options_yaml,
+               epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY);
+    auto strided = MAKE_TRANSFORM(strided_cfg)->TransformData(input_df)
+                       [strided_cfg.GetOutputId("result")]
+                           .contiguous_array();
+
+    REQUIRE(strided.length() == every_bar.length());
+    for (int64_t i = 0; i < static_cast<int64_t>(strided.length()); ++i) {
+      INFO("[" << i << "]");
+      if (i < period - 1) {
+        CHECK(strided[i].is_null());
+        continue;
+      }
+      const int64_t computed = i - (i - (period - 1)) % stride;
+      CHECK(strided[i] == every_bar[computed]);
     }
   }
 
@@ -1,80 +1,292 @@
-#include <DataFrame/DataFrame.h>
 #include <DataFrame/DataFrameFinancialVisitors.h>
-#include <DataFrame/DataFrameTypes.h>
 #include <catch.hpp>
-#include <filesystem>
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #include "epoch_frame/factory/dataframe_factory.h"
 #include "epoch_frame/factory/index_factory.h"
-
-#include <epoch_script/core/bar_attribute.h>
 #include <epoch_script/core/constants.h>
 #include <epoch_script/transforms/core/config_helper.h>
+#include <epoch_script/transforms/core/transform_registry.h>
 
-// If you already have ADF/KPSS transforms, include their headers here
-// #include "transforms/src/hosseinmoein/statistics/adf_test.h"
-// #include "transforms/src/hosseinmoein/statistics/stationary_check.h"
+#include "transforms/components/hosseinmoein/common_utils.h"
+#include "transforms/components/hosseinmoein/indicators/rescaled_range.h"
+#include "transforms/components/hosseinmoein/statistics/rolling_stationarity.h"
 
 using namespace epoch_frame;
 using namespace epoch_script::transform;
 
-TEST_CASE("KPSS vs HMDF", "[hosseinmoein][kpss]") {
-  auto C = epoch_script::EpochStratifyXConstants::instance();
-  auto path = std::format("{}/test_data/hmdf/IBM.csv",
-                          std::filesystem::current_path().string());
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
 
-  hmdf::StdDataFrame<std::string> df;
-  df.read(path.c_str(), hmdf::io_format::csv2);
+std::vector<double> RandomWalk(size_t n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::normal_distribution<double> step(0.0, 1.0);
+  std::vector<double> values(n);
+  double level = 100.0;
+  for (auto &v : values) {
+    level += step(gen);
+    v = level;
+  }
+  return values;
+}
 
-  auto index_arr =
-      Series{factory::array::make_array(df.get_index())}.str().strptime(
-          arrow::compute::StrptimeOptions{"%Y-%m-%d", arrow::TimeUnit::NANO});
-  auto index = factory::index::make_index(
-      index_arr.value(), MonotonicDirection::Increasing, "Date");
-  auto input_df = make_dataframe<double>(
-      index, {df.get_column<double>("IBM_Close")}, {C.CLOSE()});
+bool HasNaN(std::vector<double> const &x, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    if (std::isnan(x[i]))
+      return true;
+  }
+  return false;
+}
 
-  const auto tf =
-      epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY;
-  const int64_t window = 60;
-  const double alpha = 0.05;
-
-  // Build expected rolling KPSS statistic using HMDF
-  const auto vals = input_df[C.CLOSE()].contiguous_array().to_vector<double>();
-  std::vector<double> exp(vals.size(),
-                          std::numeric_limits<double>::quiet_NaN());
-  for (size_t i = 0; i < vals.size(); ++i) {
-    if (i + 1 < static_cast<size_t>(window))
+// The R/S of one chunk as hmdf::HurstExponentVisitor computes it.
+double ReferenceRescaledRange(std::vector<double> const &x, size_t begin,
+                              size_t end) {
+  const double n = static_cast<double>(end - begin);
+  double mean = 0;
+  for (size_t i = begin; i < end; ++i)
+    mean += x[i];
+  mean /= n;
+  double m2 = 0, running = 0;
+  double high = -std::numeric_limits<double>::infinity();
+  double low = std::numeric_limits<double>::infinity();
+  for (size_t i = begin; i < end; ++i) {
+    m2 += (x[i] - mean) * (x[i] - mean);
+    running += x[i] - mean;
+    high = std::max(high, running);
+    low = std::min(low, running);
+  }
+  return (high - low) / std::sqrt(m2 / (n - 1));
+}
+
+// t statistic of γ from the ADF regression of y[start, start + window),
+// solved from scratch by Gauss-Jordan elimination.
+double ReferenceADF(std::vector<double> const &y, size_t start, size_t window,
+                    size_t lag, bool withTrend) {
+  const size_t k = lag + (withTrend ? 3 : 2);
+  std::vector<std::vector<double>> rows;
+  std::vector<double> targets;
+  for (size_t t = start + lag + 1; t < start + window; ++t) {
+    if (HasNaN(y, t - lag - 1, t + 1))
       continue;
-    size_t start = i + 1 - static_cast<size_t>(window);
-    hmdf::StdDataFrame<int64_t> tmp;
-    tmp.load_index(
-        hmdf::StdDataFrame<int64_t>::gen_sequence_index(0, window, 1));
-    std::vector<double> w(vals.begin() + start, vals.begin() + i + 1);
-    tmp.load_column("x", w);
-    hmdf::StationaryCheckVisitor<double> v(alpha);
-    tmp.single_act_visit<double>("x", v);
-    exp[i] = v.get_result();
+    std::vector<double> row{y[t - 1]};
+    for (size_t j = 1; j <= lag; ++j)
+      row.push_back(y[t - j] - y[t - j - 1]);
+    row.push_back(1.0);
+    if (withTrend)
+      row.push_back(static_cast<double>(t - start));
+    rows.push_back(row);
+    targets.push_back(y[t] - y[t - 1]);
+  }
+  if (rows.size() <= k)
+    return kNaN;
+
+  // [X'X | I | X'y] reduced to [I | (X'X)^-1 | β].
+  std::vector<std::vector<double>> a(k, std::vector<double>(2 * k + 1, 0.0));
+  for (size_t i = 0; i < k; ++i) {
+    for (size_t r = 0; r < rows.size(); ++r) {
+      for (size_t j = 0; j < k; ++j)
+        a[i][j] += rows[r][i] * rows[r][j];
+      a[i][2 * k] += rows[r][i] * targets[r];
+    }
+    a[i][k + i] = 1.0;
   }
+  for (size_t c = 0; c < k; ++c) {
+    size_t pivot = c;
+    for (size_t r = c; r < k; ++r) {
+      if (std::fabs(a[r][c]) > std::fabs(a[pivot][c]))
+        pivot = r;
+    }
+    std::swap(a[c], a[pivot]);
+    const double d = a[c][c];
+    for (auto &v : a[c])
+      v /= d;
+    for (size_t r = 0; r < k; ++r) {
+      if (r == c)
+        continue;
+      const double f = a[r][c];
+      for (size_t j = 0; j < 2 * k + 1; ++j)
+        a[r][j] -= f * a[c][j];
+    }
+  }
+  double sse = 0;
+  for (size_t r = 0; r < rows.size(); ++r) {
+    double fitted = 0;
+    for (size_t i = 0; i < k; ++i)
+      fitted += rows[r][i] * a[i][2 * k];
+    sse += (targets[r] - fitted) * (targets[r] - fitted);
+  }
+  const double sigma2 = sse / static_cast<double>(rows.size() - k);
+  return a[0][2 * k] / std::sqrt(sigma2 * a[0][k]);
+}
 
-  YAML::Node inputs_yaml;
-  inputs_yaml[epoch_script::ARG] = C.CLOSE();
-  YAML::Node options_yaml;
-  options_yaml["window"] = window;
-  options_yaml["alpha"] = alpha;
-  auto cfg =
-      run_op("stationary_check", "kpss_id", inputs_yaml, options_yaml, tf);
-
-  // StationaryCheck transform must exist and output 'result'
-  StationaryCheck kpss{cfg};
-  auto out = kpss.TransformData(input_df);
-  auto lhs = out[cfg.GetOutputId("result")].contiguous_array();
-  auto rhs = Array{factory::array::make_contiguous_array(exp)};
-  REQUIRE(lhs.is_equal(rhs));
+// Level KPSS statistic of x[start, start + window) from the residual
+// partial sums and Bartlett-weighted autocovariances.
+double ReferenceKPSS(std::vector<double> const &x, size_t start,
+                     size_t window, size_t lags) {
+  if (HasNaN(x, start, start + window))
+    return kNaN;
+  const double n = static_cast<double>(window);
+  double mean = 0;
+  for (size_t i = start; i < start + window; ++i)
+    mean += x[i];
+  mean /= n;
+  double partial = 0, eta = 0, variance = 0;
+  for (size_t i = start; i < start + window; ++i) {
+    partial += x[i] - mean;
+    eta += partial * partial;
+    variance += (x[i] - mean) * (x[i] - mean);
+  }
+  for (size_t l = 1; l <= lags; ++l) {
+    double autocovariance = 0;
+    for (size_t i = start + l; i < start + window; ++i)
+      autocovariance += (x[i] - mean) * (x[i - l] - mean);
+    variance += 2.0 * (1.0 - l / (lags + 1.0)) * autocovariance;
+  }
+  return (eta / (n * n)) / (variance / n);
+}
+
+void CheckClose(double actual, double expected) {
+  if (std::isnan(expected)) {
+    CHECK(std::isnan(actual));
+  } else {
+    CHECK(actual == Catch::Approx(expected).epsilon(1e-7).margin(1e-9));
+  }
 }
+} // namespace
 
-TEST_CASE("ADF vs HMDF", "[hosseinmoein][adf]") {
-  // If you add an ADF transform, mirror KPSS structure here comparing to HMDF
-  // ADF visitor
-  SUCCEED("ADF test placeholder: implement once ADF transform is available");
+TEST_CASE("RescaledRange matches a direct pass over the chunk",
+          "[hosseinmoein][hurst]") {
+  auto x = RandomWalk(1500, 7);
+  x[700] = kNaN;
+  const RescaledRange rescaledRange{x};
+
+  std::mt19937 gen(11);
+  for (int q = 0; q < 2000; ++q) {
+    const size_t begin = gen() % x.size();
+    const size_t end = std::min(x.size(), begin + 2 + gen() % 300);
+    INFO("chunk [" << begin << ", " << end << ")");
+    const double expected = HasNaN(x, begin, end)
+                                ? kNaN
+                                : ReferenceRescaledRange(x, begin, end);
+    CheckClose(rescaledRange(begin, end), expected);
+  }
+  CHECK(std::isnan(rescaledRange(3, 4)));
+}
+
+TEST_CASE("RollingADF matches a per-window regression",
+          "[hosseinmoein][adf]") {
+  auto y = RandomWalk(800, 42);
+  y[333] = kNaN;
+  const size_t window = GENERATE(10, 37, 120);
+  const size_t lag = GENERATE(0, 1, 3);
+  const bool withTrend = GENERATE(false, true);
+
+  size_t emitted = 0;
+  RollingADF(y, window, lag, withTrend,
+             [&](size_t i, ADFRegression const &regression) {
+               INFO("window " << window << " lag " << lag << " row " << i);
+               CheckClose(regression.Statistic(),
+                          ReferenceADF(y, i + 1 - window, window, lag,
+                                       withTrend));
+               ++emitted;
+             });
+  CHECK(emitted == y.size() - window + 1);
+}
+
+TEST_CASE("RollingADF matches hmdf::StationaryCheckVisitor",
+          "[hosseinmoein][adf]") {
+  // The visitor the transform used before the rolling accumulators; it has
+  // no NaN handling, so the series is complete.
+  const auto y = RandomWalk(400, 17);
+  std::vector<int64_t> ticks(y.size());
+  std::iota(ticks.begin(), ticks.end(), 0);
+  const size_t window = GENERATE(30, 120);
+  const size_t lag = GENERATE(0, 2);
+  const bool withTrend = GENERATE(false, true);
+
+  RollingADF(y, window, lag, withTrend,
+             [&](size_t i, ADFRegression const &regression) {
+               INFO("window " << window << " lag " << lag << " row " << i);
+               hmdf::StationaryCheckVisitor<double> visitor(
+                   hmdf::stationary_test::adf,
+                   {.adf_lag = lag, .adf_with_trend = withTrend});
+               run_visit_rows(ticks, visitor, y, i + 1 - window, i + 1);
+               CHECK(regression.Statistic() ==
+                     Catch::Approx(visitor.get_adf_statistic())
+                         .epsilon(1e-6));
+             });
+}
+
+TEST_CASE("RollingKPSS matches a per-window statistic",
+          "[hosseinmoein][kpss]") {
+  auto x = RandomWalk(800, 5);
+  x[401] = kNaN;
+  const size_t window = GENERATE(2, 10, 60, 250);
+  const size_t lags = KPSSWindow::DefaultLags(window);
+
+  size_t emitted = 0;
+  RollingKPSS(x, window, lags, [&](size_t i, KPSSWindow const &kpss) {
+    INFO("window " << window << " row " << i);
+    CheckClose(kpss.Statistic(),
+               ReferenceKPSS(x, i + 1 - window, window, lags));
+    ++emitted;
+  });
+  CHECK(emitted == x.size() - window + 1);
+}
+
+TEST_CASE("rolling_adf and rolling_kpss transforms",
+          "[hosseinmoein][adf][kpss]") {
+  const auto tf =
+      epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+  const size_t N = 300;
+  const int64_t window = 50;
+  const auto values = RandomWalk(N, 3);
+
+  std::vector<int64_t> ticks(N);
+  std::iota(ticks.begin(), ticks.end(), 0);
+  auto index = factory::index::make_index(
+      factory::array::make_contiguous_array(ticks),
+      MonotonicDirection::Increasing, "i");
+  auto df = make_dataframe<double>(index, {values}, {"x"});
+
+  // Statistic per row from the accumulators, NaN before the first window.
+  std::vector<double> adf(N, kNaN), kpss(N, kNaN);
+  RollingADF(values, window, 1, false,
+             [&](size_t i, ADFRegression const &r) { adf[i] = r.Statistic(); });
+  RollingKPSS(values, window, KPSSWindow::DefaultLags(window),
+              [&](size_t i, KPSSWindow const &k) { kpss[i] = k.Statistic(); });
+
+  const int64_t stride = GENERATE(1, 4);
+  for (auto const &[type, expected] :
+       {std::pair{"rolling_adf", &adf}, std::pair{"rolling_kpss", &kpss}}) {
+    YAML::Node inputs_yaml;
+    inputs_yaml[epoch_script::ARG] = "x";
+    YAML::Node options_yaml;
+    options_yaml["window"] = window;
+    options_yaml["stride"] = stride;
+    if (std::string{type} == "rolling_adf") {
+      options_yaml["adf_lag"] = 1;
+      options_yaml["adf_with_trend"] = false;
+    }
+    auto cfg = run_op(type, std::string{type} + "_id", inputs_yaml,
+                      options_yaml, tf);
+    auto out = MAKE_TRANSFORM(cfg)->TransformData(df);
+    auto result = out[cfg.GetOutputId("result")].contiguous_array();
+
+    REQUIRE(result.length() == static_cast<int64_t>(N));
+    for (int64_t i = 0; i < static_cast<int64_t>(N); ++i) {
+      INFO(type << " stride " << stride << " row " << i);
+      if (i < window - 1) {
+        CHECK(result[i].is_null());
+        continue;
+      }
+      const int64_t computed = i - (i - (window - 1)) % stride;
+      CHECK(result[i].as_double() ==
+            Catch::Approx((*expected)[computed]).epsilon(1e-12));
+    }
+  }
 }
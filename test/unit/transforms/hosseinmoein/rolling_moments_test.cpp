@@ -0,0 +1,115 @@
+#include <catch.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "transforms/components/hosseinmoein/statistics/rolling_moments.h"
+
+using namespace epoch_script::transform;
+
+namespace {
+struct WindowStats {
+  size_t count{0};
+  double cov{0}, varX{0}, varY{0}, corr{0}, slope{0}, intercept{0}, ssr{0};
+};
+
+// Two-pass reference over x[start, end) skipping NaN pairs.
+WindowStats Reference(std::vector<double> const &x,
+                      std::vector<double> const &y, size_t start,
+                      size_t end) {
+  WindowStats s;
+  double sx = 0, sy = 0;
+  for (size_t i = start; i < end; ++i) {
+    if (std::isnan(x[i]) || std::isnan(y[i]))
+      continue;
+    sx += x[i];
+    sy += y[i];
+    ++s.count;
+  }
+  const double mx = sx / s.count, my = sy / s.count;
+  double cxy = 0, m2x = 0, m2y = 0;
+  for (size_t i = start; i < end; ++i) {
+    if (std::isnan(x[i]) || std::isnan(y[i]))
+      continue;
+    cxy += (x[i] - mx) * (y[i] - my);
+    m2x += (x[i] - mx) * (x[i] - mx);
+    m2y += (y[i] - my) * (y[i] - my);
+  }
+  s.cov = cxy / (s.count - 1);
+  s.varX = m2x / (s.count - 1);
+  s.varY = m2y / (s.count - 1);
+  s.corr = cxy / std::sqrt(m2x * m2y);
+  s.slope = cxy / m2x;
+  s.intercept = my - s.slope * mx;
+  for (size_t i = start; i < end; ++i) {
+    if (std::isnan(x[i]) || std::isnan(y[i]))
+      continue;
+    const double r = y[i] - (s.intercept + s.slope * x[i]);
+    s.ssr += r * r;
+  }
+  return s;
+}
+} // namespace
+
+TEST_CASE("RollingPairwiseMoments matches two-pass window statistics",
+          "[hosseinmoein][rolling_moments]") {
+  const size_t window = GENERATE(2, 7, 50);
+  const size_t N = 1000;
+
+  std::mt19937 gen(42);
+  std::normal_distribution<double> dist(100.0, 5.0);
+  std::vector<double> x(N), y(N);
+  for (size_t i = 0; i < N; ++i) {
+    x[i] = dist(gen);
+    y[i] = 0.5 * x[i] + dist(gen);
+    if (i % 53 == 0)
+      x[i] = std::numeric_limits<double>::quiet_NaN();
+    if (i % 71 == 0)
+      y[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  size_t emitted = 0;
+  RollingPairwiseMoments(
+      x, y, window, [&](size_t i, RollingMoments const &moments) {
+        ++emitted;
+        const auto expected = Reference(x, y, i + 1 - window, i + 1);
+        REQUIRE(moments.Count() == expected.count);
+        if (expected.count < 3)
+          return;
+        REQUIRE(moments.Cov() == Catch::Approx(expected.cov).epsilon(1e-9));
+        REQUIRE(moments.VarX() == Catch::Approx(expected.varX).epsilon(1e-9));
+        REQUIRE(moments.Corr() == Catch::Approx(expected.corr).epsilon(1e-9));
+        REQUIRE(moments.BetaXOnY() ==
+                Catch::Approx(expected.cov / expected.varY).epsilon(1e-9));
+        REQUIRE(moments.Slope() == Catch::Approx(expected.slope).epsilon(1e-9));
+        REQUIRE(moments.Intercept() ==
+                Catch::Approx(expected.intercept).epsilon(1e-9));
+        REQUIRE(moments.SumSquaredResiduals() ==
+                Catch::Approx(expected.ssr).epsilon(1e-7));
+      });
+  REQUIRE(emitted == N - window + 1);
+}
+
+TEST_CASE("RollingMoments Remove undoes Add",
+          "[hosseinmoein][rolling_moments]") {
+  RollingMoments moments;
+  moments.Add(1.0, 2.0);
+  moments.Add(3.0, 5.0);
+  moments.Add(4.0, 4.0);
+  moments.Remove(1.0, 2.0);
+
+  RollingMoments expected;
+  expected.Add(3.0, 5.0);
+  expected.Add(4.0, 4.0);
+
+  REQUIRE(moments.Count() == 2);
+  REQUIRE(moments.MeanX() == Catch::Approx(expected.MeanX()));
+  REQUIRE(moments.Cov() == Catch::Approx(expected.Cov()));
+  REQUIRE(moments.VarY() == Catch::Approx(expected.VarY()));
+
+  moments.Remove(3.0, 5.0);
+  moments.Remove(4.0, 4.0);
+  REQUIRE(moments.Count() == 0);
+  REQUIRE(std::isnan(moments.Cov()));
+}
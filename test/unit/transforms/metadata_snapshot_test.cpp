@@ -0,0 +1,108 @@
+#include "../../common.h"
+#include <catch2/catch_all.hpp>
+#include <epoch_script/transforms/core/registration.h>
+#include <epoch_script/transforms/core/registry.h>
+#include <filesystem>
+#include <fstream>
+#include <glaze/glaze.hpp>
+
+using namespace epoch_script;
+using namespace epoch_script::transforms;
+
+namespace {
+// The snapshot with its source fingerprint replaced, as if written by a
+// build with different transforms.yaml or metadata builders
+std::string WithFingerprint(std::string snapshot,
+                            std::string const &fingerprint) {
+  const std::string key = "\"fingerprint\":\"";
+  const auto begin = snapshot.find(key);
+  REQUIRE(begin != std::string::npos);
+  const auto end = snapshot.find('"', begin + key.size());
+  snapshot.replace(begin + key.size(), end - begin - key.size(), fingerprint);
+  return snapshot;
+}
+} // namespace
+
+TEST_CASE("Transform metadata snapshot round-trips the registry",
+          "[metadata][snapshot]") {
+  RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER);
+  const auto &registry = ITransformRegistry::GetInstance().GetMetaData();
+
+  const auto snapshot = SerializeTransformMetadataSnapshot();
+  const auto transforms = ReadTransformMetadataSnapshot(snapshot);
+
+  REQUIRE(transforms.size() == registry.size());
+  for (auto const &metadata : transforms) {
+    INFO("Transform: " << metadata.id);
+    REQUIRE(registry.contains(metadata.id));
+    REQUIRE(glz::write_json(metadata).value_or("") ==
+            glz::write_json(registry.at(metadata.id)).value_or(""));
+  }
+
+  SECTION("Serialization is deterministic") {
+    REQUIRE(SerializeTransformMetadataSnapshot() == snapshot);
+  }
+
+  SECTION("Registering a snapshot leaves the registry unchanged") {
+    RegisterTransformMetadataSnapshot(snapshot);
+    REQUIRE(SerializeTransformMetadataSnapshot() == snapshot);
+  }
+
+  SECTION("Rejects malformed snapshots") {
+    REQUIRE_THROWS(ReadTransformMetadataSnapshot("{\"version\":1,"));
+  }
+
+  SECTION("Rejects snapshots from another format version") {
+    REQUIRE_THROWS_WITH(
+        ReadTransformMetadataSnapshot(R"({"version":0,"transforms":[]})"),
+        Catch::Matchers::ContainsSubstring("format version 0"));
+  }
+
+  SECTION("Rejects snapshots written from other metadata sources") {
+    REQUIRE_THROWS_WITH(
+        ReadTransformMetadataSnapshot(WithFingerprint(snapshot, "other")),
+        Catch::Matchers::ContainsSubstring("fingerprint 'other'"));
+  }
+}
+
+TEST_CASE("Transform metadata registers from a snapshot file or falls back "
+          "to YAML",
+          "[metadata][snapshot]") {
+  RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER);
+  const auto snapshot = SerializeTransformMetadataSnapshot();
+  auto &registry = ITransformRegistry::GetInstance();
+
+  const auto path = std::filesystem::temp_directory_path() /
+                    "epoch_transforms_snapshot_test.json";
+  auto write = [&](std::string const &contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+  };
+
+  SECTION("From the snapshot") {
+    write(snapshot);
+    registry.Clear();
+    REQUIRE(RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER, path));
+    REQUIRE(SerializeTransformMetadataSnapshot() == snapshot);
+  }
+
+  SECTION("Missing snapshot") {
+    std::filesystem::remove(path);
+    registry.Clear();
+    REQUIRE_FALSE(
+        RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER, path));
+    REQUIRE(SerializeTransformMetadataSnapshot() == snapshot);
+  }
+
+  SECTION("Stale or malformed snapshot") {
+    write(GENERATE_COPY(std::string{R"({"version":0,"transforms":[]})"},
+                        std::string{"{\"version\":"},
+                        WithFingerprint(snapshot, "other")));
+    registry.Clear();
+    REQUIRE_FALSE(
+        RegisterTransformMetadata(epoch_script::DEFAULT_YAML_LOADER, path));
+    REQUIRE(SerializeTransformMetadataSnapshot() == snapshot);
+  }
+
+  std::filesystem::remove(path);
+}
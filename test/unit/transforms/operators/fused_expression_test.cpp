@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <epoch_script/core/constants.h>
+#include "epoch_script/strategy/registration.h"
+#include <epoch_script/transforms/core/config_helper.h>
+#include <epoch_script/transforms/core/itransform.h>
+#include <epoch_script/transforms/core/transform_configuration.h>
+#include <epoch_script/transforms/core/transform_registry.h>
+#include "transforms/components/operators/fused_expression.h"
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
+#include <arrow/builder.h>
+
+#include <cmath>
+
+using namespace epoch_core;
+using namespace epoch_script;
+using namespace epoch_script::transform;
+using namespace std::chrono_literals;
+using namespace epoch_frame;
+
+namespace {
+IndexPtr MakeIndex(size_t rows) {
+  std::vector<DateTime> dates;
+  for (size_t i = 0; i < rows; ++i) {
+    dates.push_back(DateTime{2024y, std::chrono::January, 1d} +
+                    std::chrono::days(i));
+  }
+  return factory::index::make_datetime_index(dates);
+}
+
+arrow::ChunkedArrayPtr MakeDoubles(std::vector<std::optional<double>> const &values) {
+  arrow::DoubleBuilder builder;
+  for (auto const &value : values) {
+    (void)(value ? builder.Append(*value) : builder.AppendNull());
+  }
+  return std::make_shared<arrow::ChunkedArray>(builder.Finish().ValueOrDie());
+}
+
+DataFrame Run(TransformConfiguration const &config, DataFrame const &input) {
+  auto transformBase = MAKE_TRANSFORM(config);
+  auto transform = dynamic_cast<ITransform *>(transformBase.get());
+  return transform->TransformData(input);
+}
+} // namespace
+
+TEST_CASE("[fused_expression] Program parsing", "[operators][fused_expression]") {
+  SECTION("Tracks inputs and stack depth") {
+    FusedExpressionProgram program("$0 $1 sub $2 div #1.5 gt $3 $4 gt and");
+    REQUIRE(program.InputCount() == 5);
+    REQUIRE(program.MaxDepth() == 3);
+  }
+
+  SECTION("Rejects malformed programs") {
+    REQUIRE_THROWS(FusedExpressionProgram(""));
+    REQUIRE_THROWS(FusedExpressionProgram("$0 add"));
+    REQUIRE_THROWS(FusedExpressionProgram("$0 $1"));
+    REQUIRE_THROWS(FusedExpressionProgram("$x"));
+    REQUIRE_THROWS(FusedExpressionProgram("#1.5z $0 add"));
+    REQUIRE_THROWS(FusedExpressionProgram("$0 $1 pow"));
+  }
+}
+
+TEST_CASE("[fused_expression] Boolean tree", "[operators][fused_expression]") {
+  const auto &timeframe = EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+
+  // (c - e) / a > 1.5 and v > s
+  auto index = MakeIndex(4);
+  auto input_df = make_dataframe(
+      index,
+      {MakeDoubles({10.0, 10.0, std::nullopt, 10.0}),
+       MakeDoubles({4.0, 4.0, 4.0, 4.0}), MakeDoubles({2.0, 2.0, 2.0, 8.0}),
+       MakeDoubles({5.0, 1.0, 5.0, 5.0}), MakeDoubles({3.0, 3.0, 3.0, 3.0})},
+      {"c", "e", "a", "v", "s"});
+
+  auto config = fused_expression_cfg("boolean", "fused", {"c", "e", "a", "v", "s"},
+                                     "$0 $1 sub $2 div #1.5 gt $3 $4 gt and",
+                                     timeframe);
+  auto result = Run(config, input_df)["fused#result"];
+
+  REQUIRE(result.array()->type()->id() == arrow::Type::BOOL);
+  REQUIRE(result.iloc(0).as_bool());
+  REQUIRE_FALSE(result.iloc(1).as_bool()); // v <= s
+  REQUIRE(result.iloc(2).is_null());       // null c
+  REQUIRE_FALSE(result.iloc(3).as_bool()); // 0.75 <= 1.5
+}
+
+TEST_CASE("[fused_expression] Numeric select", "[operators][fused_expression]") {
+  const auto &timeframe = EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+
+  // c > 0 ? c * -1 : e + 2 - only the picked branch's nulls propagate
+  auto index = MakeIndex(4);
+  auto input_df = make_dataframe(
+      index,
+      {MakeDoubles({1.0, -1.0, 1.0, -1.0}),
+       MakeDoubles({3.0, 3.0, 3.0, std::nullopt})},
+      {"c", "e"});
+
+  auto config = fused_expression_cfg("number", "fused", {"c", "e"},
+                                     "$0 #0 gt #-1 $0 mul $1 #2 add select",
+                                     timeframe);
+  auto result = Run(config, input_df)["fused#result"];
+
+  REQUIRE(result.array()->type()->id() == arrow::Type::DOUBLE);
+  REQUIRE(result.iloc(0).as_double() == -1.0);
+  REQUIRE(result.iloc(1).as_double() == 5.0);
+  REQUIRE(result.iloc(2).as_double() == -1.0);
+  REQUIRE(result.iloc(3).is_null());
+}
+
+TEST_CASE("[fused_expression] Spans several row blocks", "[operators][fused_expression]") {
+  const auto &timeframe = EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+
+  constexpr size_t rows = 2500;
+  std::vector<double> a(rows), b(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    a[i] = static_cast<double>(i);
+    b[i] = static_cast<double>(i % 7);
+  }
+  auto input_df = make_dataframe<double>(MakeIndex(rows), {a, b}, {"a", "b"});
+
+  auto config = fused_expression_cfg("number", "fused", {"a", "b"},
+                                     "$0 $1 mul $0 add", timeframe);
+  auto result = Run(config, input_df)["fused#result"];
+
+  REQUIRE(result.size() == rows);
+  for (size_t i : {0UL, 1023UL, 1024UL, 2047UL, 2048UL, rows - 1}) {
+    REQUIRE(result.iloc(i).as_double() == a[i] * b[i] + a[i]);
+  }
+}
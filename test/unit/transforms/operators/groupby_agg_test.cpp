@@ -431,3 +431,74 @@ TEST_CASE("GroupBy Boolean Agg - NoneOf", "[groupby][boolean][noneof]") {
   INFO("NoneOf:\n" << output << "\nvs\n" << expected);
   REQUIRE(output.equals(expected));
 }
+
+TEST_CASE("GroupBy Any Agg - IsUnique detects inner duplicates", "[groupby][any][isunique]") {
+  auto index_input = epoch_frame::factory::index::make_datetime_index(
+      {epoch_frame::DateTime{2020y, std::chrono::January, 1d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 2d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 3d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 4d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 5d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 6d}});
+
+  // Group X: (10, 10, 20) repeats 10 although first != last -> false
+  // Group Y: (20, 30, 40) -> true
+  auto group_keys_input = epoch_frame::factory::array::make_array<std::string>(
+      {"X", "Y", "X", "Y", "X", "Y"});
+  auto values_input = epoch_frame::factory::array::make_array<double>(
+      {10.0, 20.0, 10.0, 30.0, 20.0, 40.0});
+
+  auto input = make_dataframe(index_input, {group_keys_input, values_input},
+                              {"group_key", "value"});
+
+  auto config = groupby_isunique("isunique_dup_test", "group_key", "value", timeframe);
+  auto ptr = MAKE_TRANSFORM(config);
+  auto transform = dynamic_cast<ITransform *>(ptr.get());
+  auto output = transform->TransformData(input);
+
+  auto index_expected = epoch_frame::factory::index::make_datetime_index(
+      {epoch_frame::DateTime{2020y, std::chrono::January, 5d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 6d}});
+  auto group_keys_expected = epoch_frame::factory::array::make_array<std::string>({"X", "Y"});
+  auto values_expected = epoch_frame::factory::array::make_array<bool>({false, true});
+  auto expected = make_dataframe(index_expected, {group_keys_expected, values_expected},
+                                 {config.GetOutputId("group_key"), config.GetOutputId("value")});
+
+  INFO("IsUnique:\n" << output << "\nvs\n" << expected);
+  REQUIRE(output.equals(expected));
+}
+
+TEST_CASE("GroupBy Numeric Agg - Integer keys keep first appearance order", "[groupby][numeric][sum]") {
+  auto index_input = epoch_frame::factory::index::make_datetime_index(
+      {epoch_frame::DateTime{2020y, std::chrono::January, 1d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 2d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 3d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 4d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 5d}});
+
+  auto group_keys_input = epoch_frame::factory::array::make_array<int64_t>(
+      {7, 3, 7, 9, 3});
+  auto values_input = epoch_frame::factory::array::make_array<double>(
+      {1.0, 2.0, 3.0, 4.0, 5.0});
+
+  auto input = make_dataframe(index_input, {group_keys_input, values_input},
+                              {"group_key", "value"});
+
+  auto config = groupby_sum("sum_int_key_test", "group_key", "value", timeframe);
+  auto ptr = MAKE_TRANSFORM(config);
+  auto transform = dynamic_cast<ITransform *>(ptr.get());
+  auto output = transform->TransformData(input);
+
+  // Groups 7, 3, 9 in order of first appearance, indexed at their last row
+  auto index_expected = epoch_frame::factory::index::make_datetime_index(
+      {epoch_frame::DateTime{2020y, std::chrono::January, 3d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 5d},
+       epoch_frame::DateTime{2020y, std::chrono::January, 4d}});
+  auto group_keys_expected = epoch_frame::factory::array::make_array<int64_t>({7, 3, 9});
+  auto values_expected = epoch_frame::factory::array::make_array<double>({4.0, 7.0, 4.0});
+  auto expected = make_dataframe(index_expected, {group_keys_expected, values_expected},
+                                 {config.GetOutputId("group_key"), config.GetOutputId("value")});
+
+  INFO("Sum:\n" << output << "\nvs\n" << expected);
+  REQUIRE(output.equals(expected));
+}
@@ -0,0 +1,118 @@
+#include "transforms/components/price_actions/infrastructure/pivot_scan.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
+
+#include <limits>
+#include <random>
+
+using namespace epoch_script::transform::pattern_utils;
+using namespace epoch_frame;
+
+namespace {
+// Reference nested-loop scan the chart formations used before DetectPivots.
+PivotFlags BruteForcePivots(std::vector<double> const &high,
+                            std::vector<double> const &low, size_t left_count,
+                            size_t right_count) {
+  const size_t N = high.size();
+  PivotFlags flags(N, kPivotNone);
+  for (size_t i = left_count; i + right_count < N; ++i) {
+    bool is_pivot_high = true;
+    bool is_pivot_low = true;
+    for (size_t j = i - left_count; j <= i + right_count; ++j) {
+      if (j == i)
+        continue;
+      if (high[i] < high[j])
+        is_pivot_high = false;
+      if (low[i] > low[j])
+        is_pivot_low = false;
+    }
+    flags[i] = (is_pivot_high ? kPivotHigh : kPivotNone) |
+               (is_pivot_low ? kPivotLow : kPivotNone);
+  }
+  return flags;
+}
+} // namespace
+
+TEST_CASE("DetectPivots matches the nested loop scan", "[PivotScan]") {
+  const auto seed = GENERATE(1u, 7u, 42u, 1234u);
+  std::mt19937 rng(seed);
+  // Coarse price grid so equal highs/lows (ties) are common
+  std::uniform_int_distribution<int> price(0, 20);
+  std::uniform_int_distribution<size_t> count(0, 6);
+  std::bernoulli_distribution isNaN(0.05);
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+  for (size_t trial = 0; trial < 200; ++trial) {
+    const size_t N = count(rng) * 10 + count(rng);
+    const size_t left = count(rng);
+    const size_t right = count(rng);
+    std::vector<double> high(N), low(N);
+    for (size_t i = 0; i < N; ++i) {
+      low[i] = isNaN(rng) ? nan : price(rng);
+      high[i] = isNaN(rng) ? nan : low[i] + price(rng) / 4.0;
+    }
+
+    INFO("seed=" << seed << " trial=" << trial << " N=" << N
+                 << " left=" << left << " right=" << right);
+    REQUIRE(DetectPivots(high, low, left, right) ==
+            BruteForcePivots(high, low, left, right));
+  }
+}
+
+TEST_CASE("PivotCache shares scans and stays bounded", "[PivotScan]") {
+  const auto &C = epoch_script::EpochStratifyXConstants::instance();
+  constexpr size_t N = 500;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> price(10.0, 20.0);
+  auto makeBars = [&] {
+    std::vector<double> high(N), low(N);
+    for (size_t i = 0; i < N; ++i) {
+      low[i] = price(rng);
+      high[i] = low[i] + 1.0;
+    }
+    return make_dataframe<double>(factory::index::from_range(0, N),
+                                  {high, low}, {C.HIGH(), C.LOW()});
+  };
+
+  PivotCache::SetMaxBytes(0);
+  PivotCache::SetMaxBytes(3 * N);
+
+  SECTION("The same buffers reuse one scan") {
+    const auto bars = makeBars();
+    const HighLowSpans prices{bars};
+    const auto first = PivotCache::Get(prices, 3, 3);
+    CHECK(PivotCache::Get(HighLowSpans{bars}, 3, 3) == first);
+    CHECK(PivotCache::Get(prices, 2, 2) != first);
+    CHECK(*first == DetectPivots(prices.high, prices.low, 3, 3));
+  }
+
+  SECTION("Flags are bounded by bytes, evicting the least recently used") {
+    std::vector<DataFrame> frames;
+    for (size_t i = 0; i < 5; ++i) {
+      frames.push_back(makeBars());
+      PivotCache::Get(HighLowSpans{frames.back()}, 3, 3);
+      CHECK(PivotCache::Bytes() <= 3 * N);
+    }
+    CHECK(PivotCache::Size() == 3);
+
+    // The oldest frame was evicted and is scanned again.
+    const HighLowSpans oldest{frames.front()};
+    const auto rescanned = PivotCache::Get(oldest, 3, 3);
+    CHECK(*rescanned == DetectPivots(oldest.high, oldest.low, 3, 3));
+    CHECK(PivotCache::Size() == 3);
+  }
+
+  SECTION("Entries of released frames are dropped") {
+    {
+      const auto released = makeBars();
+      PivotCache::Get(HighLowSpans{released}, 3, 3);
+    }
+    const auto bars = makeBars();
+    PivotCache::Get(HighLowSpans{bars}, 3, 3);
+    CHECK(PivotCache::Size() == 1);
+  }
+
+  PivotCache::SetMaxBytes(PivotCache::kDefaultMaxBytes);
+}
@@ -0,0 +1,100 @@
+#include <epoch_script/core/time_frame.h>
+#include <epoch_script/transforms/core/sessions_utils.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <epoch_frame/datetime.h>
+#include <epoch_frame/factory/index_factory.h>
+
+#include <chrono>
+#include <optional>
+
+using namespace epoch_script;
+using namespace epoch_script::transform;
+
+namespace {
+struct ReferenceMasks {
+  std::vector<bool> active, opened, closed;
+};
+
+// Straight port of the per-timestamp tz_convert BuildActiveMaskUTC that the
+// cached session masks replaced.
+ReferenceMasks ReferenceSessionMasks(const epoch_frame::IndexPtr &utcIndex,
+                                     const epoch_frame::SessionRange &range) {
+  ReferenceMasks state;
+  state.active.resize(utcIndex->size(), false);
+  state.opened.resize(utcIndex->size(), false);
+  state.closed.resize(utcIndex->size(), false);
+
+  const std::string sessionTz =
+      !range.start.tz.empty()
+          ? range.start.tz
+          : (!range.end.tz.empty() ? range.end.tz : std::string("UTC"));
+
+  std::optional<epoch_frame::Date> cachedDate;
+  epoch_frame::DateTime cachedStartUTC;
+  epoch_frame::DateTime cachedEndUTC;
+
+  for (size_t i = 0; i < utcIndex->size(); ++i) {
+    const auto dtUTC = utcIndex->at(i).to_datetime();
+    const auto localDate = dtUTC.tz_convert(sessionTz).date();
+
+    if (!cachedDate || *cachedDate != localDate) {
+      cachedDate = localDate;
+      auto startLocal = epoch_frame::DateTime{localDate, range.start};
+      auto endLocal = epoch_frame::DateTime{localDate, range.end};
+      if (range.end < range.start) {
+        endLocal = epoch_frame::DateTime{localDate + chrono_days(1), range.end};
+      }
+      cachedStartUTC = startLocal.tz_convert("UTC");
+      cachedEndUTC = endLocal.tz_convert("UTC");
+    }
+    state.opened[i] = (cachedStartUTC == dtUTC);
+    state.closed[i] = (cachedEndUTC == dtUTC);
+    state.active[i] = (cachedStartUTC <= dtUTC && dtUTC <= cachedEndUTC);
+  }
+  return state;
+}
+
+void RequireMaskEquals(const arrow::BooleanArray &actual,
+                       const std::vector<bool> &expected) {
+  REQUIRE(static_cast<size_t>(actual.length()) == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    INFO("bar " << i);
+    REQUIRE(actual.Value(i) == expected[i]);
+  }
+}
+} // namespace
+
+TEST_CASE("Session masks match per-timestamp timezone conversion",
+          "[sessions]") {
+  // 15 minute bars across the 2024 US (Mar 10) and UK (Mar 31) DST switches
+  constexpr int64_t kBar = 15LL * 60 * 1'000'000'000;
+  const int64_t first = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::sys_days{std::chrono::year{2024} /
+                                                  std::chrono::March / 5}
+                                .time_since_epoch())
+                            .count();
+  std::vector<int64_t> timestamps;
+  for (int64_t i = 0; i < 28 * 96; ++i) {
+    timestamps.push_back(first + i * kBar);
+  }
+  const auto index =
+      epoch_frame::factory::index::make_datetime_index(timestamps, "index",
+                                                       "UTC");
+
+  const auto session = GENERATE(
+      epoch_core::SessionType::Sydney, epoch_core::SessionType::London,
+      epoch_core::SessionType::NewYork, epoch_core::SessionType::AsianKillZone,
+      epoch_core::SessionType::LondonOpenKillZone);
+  const auto range = kSessionRegistry.at(session);
+  INFO("session " << epoch_core::SessionTypeWrapper::ToString(session));
+
+  const auto masks = sessions_utils::GetSessionMasks(index, range);
+  const auto expected = ReferenceSessionMasks(index, range);
+  RequireMaskEquals(*masks->active, expected.active);
+  RequireMaskEquals(*masks->opened, expected.opened);
+  RequireMaskEquals(*masks->closed, expected.closed);
+
+  // Same index and range reuse the computed masks
+  REQUIRE(sessions_utils::GetSessionMasks(index, range) == masks);
+}
@@ -0,0 +1,461 @@
+#include <epoch_script/core/bar_attribute.h>
+#include <epoch_script/transforms/core/config_helper.h>
+#include <epoch_script/transforms/core/itransform.h>
+#include <epoch_script/transforms/core/transform_configuration.h>
+#include <epoch_script/transforms/core/transform_registry.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+
+using namespace epoch_script;
+using namespace epoch_script::transform;
+
+// The order-block, FVG and BOS/CHoCH transforms find mitigations and breaks
+// through segment trees over the price columns. These tests compare them
+// with straight ports of the per-bar scans they replaced, on random bars with
+// quantized prices (many ties) and NaN prices.
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+struct Bars {
+  std::vector<double> open, high, low, close, volume;
+  // Swing marks: 1 = high, -1 = low, nullopt = none; level is the swing price
+  std::vector<std::optional<int64_t>> high_low;
+  std::vector<double> level;
+};
+
+Bars RandomBars(std::mt19937_64 &rng, size_t N, double tick, bool with_nan) {
+  std::normal_distribution<double> noise(0.0, 1.0);
+  auto quantize = [&](double v) { return std::round(v / tick) * tick; };
+  Bars bars;
+  bars.level.assign(N, kNaN);
+  bars.high_low.resize(N);
+  double price = 100.0;
+  for (size_t i = 0; i < N; ++i) {
+    price += noise(rng);
+    const double a = quantize(price + noise(rng));
+    const double b = quantize(price + noise(rng));
+    bars.open.push_back(a);
+    bars.close.push_back(b);
+    bars.high.push_back(std::max(a, b) + quantize(std::abs(noise(rng))));
+    bars.low.push_back(std::min(a, b) - quantize(std::abs(noise(rng))));
+    bars.volume.push_back(std::round(std::abs(noise(rng)) * 3));
+    if (with_nan && rng() % 15 == 0) {
+      (rng() % 2 ? bars.low : bars.high).back() = kNaN;
+    }
+    if (with_nan && rng() % 20 == 0) {
+      bars.close.back() = kNaN;
+    }
+    switch (rng() % 4) {
+    case 0:
+      bars.high_low[i] = 1;
+      bars.level[i] = bars.high[i];
+      break;
+    case 1:
+      bars.high_low[i] = -1;
+      bars.level[i] = bars.low[i];
+      break;
+    default:
+      break;
+    }
+  }
+  return bars;
+}
+
+arrow::ChunkedArrayPtr Doubles(std::vector<double> const &values) {
+  arrow::DoubleBuilder builder;
+  REQUIRE(builder.AppendValues(values).ok());
+  return std::make_shared<arrow::ChunkedArray>(builder.Finish().ValueOrDie());
+}
+
+arrow::ChunkedArrayPtr
+Int64s(std::vector<std::optional<int64_t>> const &values) {
+  arrow::Int64Builder builder;
+  for (auto const &value : values) {
+    REQUIRE((value ? builder.Append(*value) : builder.AppendNull()).ok());
+  }
+  return std::make_shared<arrow::ChunkedArray>(builder.Finish().ValueOrDie());
+}
+
+epoch_frame::DataFrame MakeFrame(Bars const &bars) {
+  const auto &C = EpochStratifyXConstants::instance();
+  return epoch_frame::make_dataframe(
+      epoch_frame::factory::index::from_range(0, bars.open.size()),
+      {Doubles(bars.open), Doubles(bars.high), Doubles(bars.low),
+       Doubles(bars.close), Doubles(bars.volume), Int64s(bars.high_low),
+       Doubles(bars.level)},
+      {C.OPEN(), C.HIGH(), C.LOW(), C.CLOSE(), C.VOLUME(), "high_low",
+       "level"});
+}
+
+// Values compare bitwise, so NaN matches NaN and nothing else
+void RequireColumn(epoch_frame::DataFrame const &result,
+                   std::string const &column,
+                   std::vector<double> const &expected,
+                   std::vector<bool> const &valid) {
+  const auto actual = result[column]
+                          .cast(arrow::float64())
+                          .contiguous_array()
+                          .to_view<double>();
+  REQUIRE(static_cast<size_t>(actual->length()) == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    INFO(column << "[" << i << "]");
+    REQUIRE(actual->IsValid(i) == valid[i]);
+    if (valid[i]) {
+      const double value = actual->Value(i);
+      REQUIRE((std::isnan(value) ? std::isnan(expected[i])
+                                 : value == expected[i]));
+    }
+  }
+}
+
+template <typename T> std::vector<double> AsDoubles(std::vector<T> const &v) {
+  return {v.begin(), v.end()};
+}
+
+struct OrderBlockColumns {
+  std::vector<int64_t> ob, mitigated_index;
+  std::vector<double> top, bottom, ob_volume, percentage;
+};
+
+// Straight port of the active-list order-block scan
+OrderBlockColumns ReferenceOrderBlocks(Bars const &bars,
+                                       bool close_mitigation) {
+  const auto &[open, high, low, close, volume, high_low, level] = bars;
+  const size_t N = open.size();
+  OrderBlockColumns out{std::vector<int64_t>(N, 0),
+                        std::vector<int64_t>(N, 0),
+                        std::vector<double>(N, 0.0),
+                        std::vector<double>(N, 0.0),
+                        std::vector<double>(N, 0.0),
+                        std::vector<double>(N, 0.0)};
+  std::vector<double> low_volume(N, 0.0), high_volume(N, 0.0);
+  std::vector<bool> breaker(N, false), crossed(N, false);
+
+  std::vector<int64_t> swing_high, swing_low;
+  for (size_t i = 0; i < N; ++i) {
+    if (high_low[i] == 1)
+      swing_high.push_back(i);
+    else if (high_low[i] == -1)
+      swing_low.push_back(i);
+  }
+
+  auto reset = [&](size_t idx) {
+    out.ob[idx] = 0;
+    out.top[idx] = out.bottom[idx] = out.ob_volume[idx] = 0.0;
+    out.percentage[idx] = low_volume[idx] = high_volume[idx] = 0.0;
+    out.mitigated_index[idx] = 0;
+    breaker[idx] = false;
+  };
+
+  auto process = [&](bool bullish, size_t t, std::vector<int64_t> &active) {
+    for (auto it = active.begin(); it != active.end();) {
+      const auto idx = static_cast<size_t>(*it);
+      if (breaker[idx]) {
+        const bool invalidate = bullish ? high[t] > out.top[idx]
+                                        : low[t] < out.bottom[idx];
+        if (invalidate) {
+          reset(idx);
+          it = active.erase(it);
+          continue;
+        }
+      } else if (bullish) {
+        const double price =
+            close_mitigation ? std::min(open[t], close[t]) : low[t];
+        if (price < out.bottom[idx]) {
+          breaker[idx] = true;
+          out.mitigated_index[idx] = static_cast<int64_t>(t - 1);
+        }
+      } else {
+        const double price =
+            close_mitigation ? std::max(open[t], close[t]) : high[t];
+        if (price > out.top[idx]) {
+          breaker[idx] = true;
+          out.mitigated_index[idx] = static_cast<int64_t>(t);
+        }
+      }
+      ++it;
+    }
+  };
+
+  auto create = [&](bool bullish, size_t t, std::vector<int64_t> const &swings,
+                    std::vector<int64_t> &active) {
+    auto it = std::ranges::lower_bound(swings, static_cast<int64_t>(t));
+    if (it == swings.begin() || it == swings.end())
+      return;
+    const auto s = static_cast<size_t>(*(--it));
+    const bool cross = bullish ? close[t] > high[s] : close[t] < low[s];
+    if (!cross || crossed[s])
+      return;
+    crossed[s] = true;
+
+    size_t idx = t - 1;
+    double top = bullish ? low[idx] : high[idx];
+    double bottom = bullish ? high[idx] : low[idx];
+    if (t - s > 1) {
+      const size_t start = s + 1;
+      const std::span<const double> segment{
+          (bullish ? low : high).data() + start, t - start};
+      const double extreme = bullish ? std::ranges::min(segment)
+                                     : std::ranges::max(segment);
+      for (size_t k = segment.size(); k-- > 0;) {
+        if (segment[k] == extreme) {
+          idx = start + k;
+          top = high[idx];
+          bottom = low[idx];
+          break;
+        }
+      }
+    }
+
+    out.ob[idx] = bullish ? 1 : -1;
+    out.top[idx] = top;
+    out.bottom[idx] = bottom;
+    const size_t t2 = t >= 2 ? t - 2 : 0;
+    const size_t t1 = t >= 1 ? t - 1 : 0;
+    out.ob_volume[idx] = volume[t] + volume[t1] + volume[t2];
+    if (bullish) {
+      low_volume[idx] = volume[t2];
+      high_volume[idx] = volume[t] + volume[t1];
+    } else {
+      low_volume[idx] = volume[t] + volume[t1];
+      high_volume[idx] = volume[t2];
+    }
+    const double max_v = std::max(high_volume[idx], low_volume[idx]);
+    out.percentage[idx] =
+        max_v == 0.0 ? 100.0
+                     : std::min(high_volume[idx], low_volume[idx]) / max_v *
+                           100.0;
+    active.push_back(static_cast<int64_t>(idx));
+  };
+
+  std::vector<int64_t> active_bullish, active_bearish;
+  for (size_t t = 0; t < N; ++t) {
+    process(true, t, active_bullish);
+    process(false, t, active_bearish);
+    create(true, t, swing_high, active_bullish);
+    create(false, t, swing_low, active_bearish);
+  }
+  return out;
+}
+
+struct FairValueGapColumns {
+  std::vector<double> fvg, top, bottom;
+  std::vector<int64_t> mitigated_index;
+};
+
+// Straight port of the shifted-column FVG detection and per-gap mitigation
+// scan. NaN marks bars without a gap.
+FairValueGapColumns ReferenceFairValueGaps(Bars const &bars,
+                                           bool join_consecutive) {
+  const auto &[open, high, low, close, volume, high_low, level] = bars;
+  const size_t N = open.size();
+  FairValueGapColumns out{std::vector(N, kNaN), std::vector(N, kNaN),
+                          std::vector(N, kNaN), std::vector<int64_t>(N, 0)};
+  for (size_t i = 1; i + 1 < N; ++i) {
+    const bool up = close[i] > open[i];
+    const bool down = close[i] < open[i];
+    if ((high[i - 1] < low[i + 1] && up) || (low[i - 1] > high[i + 1] && down)) {
+      out.fvg[i] = up ? 1 : -1;
+      out.top[i] = up ? low[i + 1] : low[i - 1];
+      out.bottom[i] = up ? high[i - 1] : high[i + 1];
+    }
+  }
+  if (join_consecutive) {
+    for (size_t i = 0; i + 1 < N; ++i) {
+      if (out.fvg[i] == out.fvg[i + 1]) {
+        out.top[i + 1] = std::max(out.top[i], out.top[i + 1]);
+        out.bottom[i + 1] = std::min(out.bottom[i], out.bottom[i + 1]);
+        out.fvg[i] = out.top[i] = out.bottom[i] = kNaN;
+      }
+    }
+  }
+  for (size_t i = 0; i < N; ++i) {
+    if (std::isnan(out.fvg[i]))
+      continue;
+    for (size_t j = i + 2; j < N; ++j) {
+      if (out.fvg[i] == 1 ? low[j] <= out.top[i] : high[j] >= out.bottom[i]) {
+        out.mitigated_index[i] = static_cast<int64_t>(j);
+        break;
+      }
+    }
+  }
+  return out;
+}
+
+struct BosChochColumns {
+  std::vector<int64_t> bos, choch, broken_index;
+  std::vector<double> level;
+};
+
+// Straight port of the swing-sequence detection and the per-structure break
+// scan that rescanned every earlier structure after each break
+BosChochColumns ReferenceBosChoch(Bars const &bars, bool close_break) {
+  const size_t N = bars.open.size();
+  BosChochColumns out{std::vector<int64_t>(N, 0), std::vector<int64_t>(N, 0),
+                      std::vector<int64_t>(N, 0), std::vector<double>(N, 0.0)};
+  std::vector<double> levels;
+  std::vector<int64_t> order;
+  std::vector<size_t> positions;
+  auto increasing = [](double a, double b, double c, double d) {
+    return a < b && b < c && c < d;
+  };
+  auto decreasing = [](double a, double b, double c, double d) {
+    return a > b && b > c && c > d;
+  };
+  for (size_t i = 0; i < N; ++i) {
+    if (!bars.high_low[i])
+      continue;
+    order.push_back(*bars.high_low[i]);
+    levels.push_back(bars.level[i]);
+    if (levels.size() < 4) {
+      positions.push_back(i);
+      continue;
+    }
+    const double m4 = levels.end()[-4], m3 = levels.end()[-3];
+    const double m2 = levels.end()[-2], m1 = levels.end()[-1];
+    const size_t s = order.size();
+    const bool up = order[s - 4] == -1 && order[s - 3] == 1 &&
+                    order[s - 2] == -1 && order[s - 1] == 1;
+    const bool down = order[s - 4] == 1 && order[s - 3] == -1 &&
+                      order[s - 2] == 1 && order[s - 1] == -1;
+    const size_t r = positions.end()[-2];
+    out.bos[r] = up && increasing(m4, m2, m3, m1) ? 1 : 0;
+    out.level[r] = out.bos[r] ? m3 : 0;
+    out.bos[r] = down && decreasing(m4, m2, m3, m1) ? -1 : out.bos[r];
+    out.level[r] = out.bos[r] ? m3 : 0;
+    out.choch[r] = up && decreasing(m1, m3, m4, m2) ? 1 : 0;
+    out.level[r] = out.choch[r] ? m3 : out.level[r];
+    out.choch[r] = down && increasing(m1, m3, m4, m2) ? -1 : out.choch[r];
+    out.level[r] = out.choch[r] ? m3 : out.level[r];
+    positions.push_back(i);
+  }
+
+  const auto &high = close_break ? bars.close : bars.high;
+  const auto &low = close_break ? bars.close : bars.low;
+  for (size_t i = 0; i < N; ++i) {
+    if (!out.bos[i] && !out.choch[i])
+      continue;
+    const double level = static_cast<float>(out.level[i]);
+    std::optional<size_t> broken;
+    for (size_t j = i + 2; j < N && !broken; ++j) {
+      if (out.bos[i] == 1 || out.choch[i] == 1 ? high[j] > level
+                                               : low[j] < level) {
+        broken = j;
+      }
+    }
+    if (!broken)
+      continue;
+    out.broken_index[i] = static_cast<int64_t>(*broken);
+    for (size_t k = 0; k < i; ++k) {
+      if ((out.bos[k] || out.choch[k]) &&
+          out.broken_index[k] >= static_cast<int64_t>(*broken)) {
+        out.bos[k] = out.choch[k] = 0;
+        out.level[k] = 0;
+      }
+    }
+  }
+  for (size_t i = 0; i < N; ++i) {
+    if ((out.bos[i] || out.choch[i]) && !out.broken_index[i]) {
+      out.bos[i] = out.choch[i] = 0;
+      out.level[i] = 0;
+    }
+  }
+  return out;
+}
+
+epoch_frame::DataFrame Run(TransformConfiguration const &config,
+                           epoch_frame::DataFrame const &df) {
+  auto transformBase = MAKE_TRANSFORM(config);
+  auto transform = dynamic_cast<ITransform *>(transformBase.get());
+  REQUIRE(transform != nullptr);
+  return transform->TransformData(df);
+}
+} // namespace
+
+TEST_CASE("SMC zone scans match the reference per-bar scans",
+          "[SMC][OrderBlocks][FVG][BOS_CHOCH]") {
+  const auto timeframe = EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+  const auto seed = GENERATE(3u, 11u, 29u);
+  // A coarse tick produces many equal prices, a fine one almost none
+  const double tick = GENERATE(0.5, 0.001);
+  const bool with_nan = GENERATE(false, true);
+  const bool flag = GENERATE(false, true);
+
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<size_t> length(0, 200);
+  for (size_t trial = 0; trial < 15; ++trial) {
+    const size_t N = trial == 0 ? 1500 : length(rng);
+    const auto bars = RandomBars(rng, N, tick, with_nan);
+    const auto df = MakeFrame(bars);
+    INFO("seed=" << seed << " tick=" << tick << " nan=" << with_nan
+                 << " flag=" << flag << " trial=" << trial << " N=" << N);
+
+    {
+      const auto config = order_blocks("ob", "high_low", flag, timeframe);
+      const auto result = Run(config, df);
+      const auto expected = ReferenceOrderBlocks(bars, flag);
+      std::vector<bool> valid(N);
+      for (size_t i = 0; i < N; ++i)
+        valid[i] = expected.ob[i] != 0;
+      RequireColumn(result, config.GetOutputId("ob"), AsDoubles(expected.ob),
+                    valid);
+      RequireColumn(result, config.GetOutputId("top"), expected.top, valid);
+      RequireColumn(result, config.GetOutputId("bottom"), expected.bottom,
+                    valid);
+      RequireColumn(result, config.GetOutputId("ob_volume"),
+                    expected.ob_volume, valid);
+      RequireColumn(result, config.GetOutputId("mitigated_index"),
+                    AsDoubles(expected.mitigated_index), valid);
+      RequireColumn(result, config.GetOutputId("percentage"),
+                    expected.percentage, valid);
+    }
+
+    {
+      const auto config = fair_value_gap("fvg", flag, timeframe);
+      const auto result = Run(config, df);
+      const auto expected = ReferenceFairValueGaps(bars, flag);
+      std::vector<bool> valid(N);
+      for (size_t i = 0; i < N; ++i)
+        valid[i] = !std::isnan(expected.fvg[i]);
+      RequireColumn(result, config.GetOutputId("fvg"), expected.fvg, valid);
+      RequireColumn(result, config.GetOutputId("top"), expected.top, valid);
+      RequireColumn(result, config.GetOutputId("bottom"), expected.bottom,
+                    valid);
+      RequireColumn(result, config.GetOutputId("mitigated_index"),
+                    AsDoubles(expected.mitigated_index), valid);
+    }
+
+    {
+      const auto config =
+          bos_choch("bos_choch", "high_low", "level", flag, timeframe);
+      const auto result = Run(config, df);
+      const auto expected = ReferenceBosChoch(bars, flag);
+      auto non_zero = [](auto const &values) {
+        std::vector<bool> valid(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+          valid[i] = !std::isnan(static_cast<double>(values[i])) &&
+                     values[i] != 0;
+        return valid;
+      };
+      RequireColumn(result, config.GetOutputId("bos"), AsDoubles(expected.bos),
+                    non_zero(expected.bos));
+      RequireColumn(result, config.GetOutputId("choch"),
+                    AsDoubles(expected.choch), non_zero(expected.choch));
+      RequireColumn(result, config.GetOutputId("level"), expected.level,
+                    non_zero(expected.level));
+      RequireColumn(result, config.GetOutputId("broken_index"),
+                    AsDoubles(expected.broken_index),
+                    non_zero(expected.broken_index));
+    }
+  }
+}
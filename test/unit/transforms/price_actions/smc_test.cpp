@@ -9,6 +9,7 @@
 #include <arrow/type_fwd.h>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
 #include <epoch_frame/factory/dataframe_factory.h>
 #include <epoch_frame/serialization.h>
 #include <index/datetime_index.h>
@@ -494,6 +495,20 @@ TEST_CASE("SMC Test") {
     auto true_count_end = in_window_end_col.cast(arrow::int64()).sum().value();
     std::cout << "Session end window hits: " << true_count_end << std::endl;
 
+    // LondonCloseKillZone lasts 120 minutes; a longer offset would wrap
+    // into another session
+    for (auto const &boundary : {"start", "end"}) {
+      INFO("boundary " << boundary);
+      REQUIRE_NOTHROW(MAKE_TRANSFORM(session_time_window(
+          "session_time_window_kz", "LondonCloseKillZone", 120, boundary,
+          timeframe)));
+      REQUIRE_THROWS_WITH(
+          MAKE_TRANSFORM(session_time_window("session_time_window_kz",
+                                             "LondonCloseKillZone", 180,
+                                             boundary, timeframe)),
+          Catch::Matchers::ContainsSubstring("session length of 120"));
+    }
+
     // Write actual output to CSV for inspection
     auto output_path_start = std::format("{}/{}/session_time_window_start_actual_output.csv",
                                    SMC_TEST_DATA_DIR,
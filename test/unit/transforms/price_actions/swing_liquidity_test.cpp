@@ -0,0 +1,321 @@
+#include <epoch_script/core/bar_attribute.h>
+#include <epoch_script/transforms/core/config_helper.h>
+#include <epoch_script/transforms/core/itransform.h>
+#include <epoch_script/transforms/core/transform_configuration.h>
+#include <epoch_script/transforms/core/transform_registry.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+using namespace epoch_script;
+using namespace epoch_script::transform;
+
+namespace {
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Straight port of the rolling-window / iterative-rebuild SwingHighsLows the
+// monotonic-deque version replaced. 0 marks a null high_low.
+std::vector<int64_t> ReferenceSwingHighsLows(std::vector<double> const &high,
+                                             std::vector<double> const &low,
+                                             size_t swing_length) {
+  const size_t N = high.size();
+  const size_t window = swing_length * 2;
+  std::vector<int64_t> shl(N, 0);
+  for (size_t i = 0; i < N; ++i) {
+    // shift(-swing_length).rolling(window): full windows only
+    if (i + 1 < window || i + swing_length >= N)
+      continue;
+    double max_high = high[i + 1 - swing_length];
+    double min_low = low[i + 1 - swing_length];
+    for (size_t j = i + 1 - swing_length; j <= i + swing_length; ++j) {
+      max_high = std::max(max_high, high[j]);
+      min_low = std::min(min_low, low[j]);
+    }
+    if (high[i] == max_high)
+      shl[i] = 1;
+    else if (low[i] == min_low)
+      shl[i] = -1;
+  }
+
+  while (true) {
+    std::vector<size_t> pos;
+    for (size_t i = 0; i < N; ++i)
+      if (shl[i] != 0)
+        pos.push_back(i);
+    const size_t P = pos.size();
+    if (P < 2)
+      break;
+
+    std::vector<bool> remove_flag(P, false);
+    for (size_t k = 0; k < P - 1; ++k) {
+      const auto cur = shl[pos[k]];
+      const auto nxt = shl[pos[k + 1]];
+      if (cur == 1 && nxt == 1) {
+        if (high[pos[k]] < high[pos[k + 1]])
+          remove_flag[k] = true;
+        else
+          remove_flag[k + 1] = true;
+      } else if (cur == -1 && nxt == -1) {
+        if (low[pos[k]] > low[pos[k + 1]])
+          remove_flag[k] = true;
+        else
+          remove_flag[k + 1] = true;
+      }
+    }
+    if (std::ranges::none_of(remove_flag, [](bool x) { return x; }))
+      break;
+    for (size_t k = 0; k < P; ++k)
+      if (remove_flag[k])
+        shl[pos[k]] = 0;
+  }
+
+  std::vector<size_t> pos;
+  for (size_t i = 0; i < N; ++i)
+    if (shl[i] != 0)
+      pos.push_back(i);
+  if (!pos.empty()) {
+    const auto first = shl[pos.front()];
+    const auto last = shl[pos.back()];
+    shl[0] = first == 1 ? -1 : 1;
+    shl.back() = last == -1 ? 1 : -1;
+  }
+  return shl;
+}
+
+struct LiquidityColumns {
+  std::vector<double> liquidity, level, end, swept;
+};
+
+// Straight port of the nested-scan Liquidity grouping. NaN marks a null;
+// NaN prices never set the pip range or sweep a group.
+LiquidityColumns ReferenceLiquidity(std::vector<double> const &high,
+                                    std::vector<double> const &low,
+                                    std::vector<int64_t> hl,
+                                    std::vector<double> const &level,
+                                    double range_percent) {
+  const size_t N = high.size();
+  double max_high = std::numeric_limits<double>::lowest();
+  double min_low = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < N; ++i) {
+    if (!std::isnan(high[i]))
+      max_high = std::max(max_high, high[i]);
+    if (!std::isnan(low[i]))
+      min_low = std::min(min_low, low[i]);
+  }
+  const double pip_range = (max_high - min_low) * range_percent;
+  LiquidityColumns out{std::vector(N, kNaN), std::vector(N, kNaN),
+                       std::vector(N, kNaN), std::vector(N, kNaN)};
+
+  for (int64_t side : {1L, -1L}) {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < N; ++i)
+      if (hl[i] == side)
+        indices.push_back(i);
+
+    for (auto i : indices) {
+      if (hl[i] != side)
+        continue;
+      const double range_low = level[i] - pip_range;
+      const double range_high = level[i] + pip_range;
+      std::vector<double> group_levels = {level[i]};
+      size_t group_end = i;
+
+      size_t swept = 0;
+      for (size_t j = i + 1; j < N; ++j) {
+        if (side == 1 ? high[j] >= range_high : low[j] <= range_low) {
+          swept = j;
+          break;
+        }
+      }
+
+      for (auto j : indices) {
+        if (j <= i)
+          continue;
+        if (swept && j >= swept)
+          break;
+        if (hl[j] == side && range_low <= level[j] && level[j] <= range_high) {
+          group_levels.push_back(level[j]);
+          group_end = j;
+          hl[j] = 0;
+        }
+      }
+
+      if (group_levels.size() > 1) {
+        out.liquidity[i] = static_cast<double>(side);
+        out.level[i] =
+            std::accumulate(group_levels.begin(), group_levels.end(), 0.0) /
+            group_levels.size();
+        out.end[i] = static_cast<double>(group_end);
+        out.swept[i] = static_cast<double>(swept);
+      }
+    }
+  }
+  return out;
+}
+
+void RequireColumnEquals(epoch_frame::DataFrame const &result,
+                         std::string const &column,
+                         std::vector<double> const &expected) {
+  const auto actual = result[column]
+                          .cast(arrow::float64())
+                          .contiguous_array()
+                          .to_view<double>();
+  REQUIRE(static_cast<size_t>(actual->length()) == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    INFO(column << "[" << i << "]");
+    REQUIRE(actual->IsNull(i) == std::isnan(expected[i]));
+    if (!actual->IsNull(i)) {
+      REQUIRE(actual->Value(i) == expected[i]);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("SwingHighsLows and Liquidity match the reference scans",
+          "[SMC][SwingHighsLows][Liquidity]") {
+  using namespace epoch_frame;
+  const auto &C = EpochStratifyXConstants::instance();
+  const auto timeframe = C.DAILY_FREQUENCY;
+
+  const auto seed = GENERATE(3u, 11u, 2024u);
+  const size_t swing_length = GENERATE(1, 2, 5);
+  const double range_percent = GENERATE(0.01, 0.1);
+
+  std::mt19937 rng(seed);
+  // Coarse price grid so equal highs/lows (ties) are common
+  std::uniform_int_distribution<int> step(-3, 3);
+  std::uniform_int_distribution<int> spread(0, 4);
+  std::uniform_int_distribution<size_t> length(1, 300);
+
+  for (size_t trial = 0; trial < 20; ++trial) {
+    const size_t N = length(rng);
+    std::vector<double> high(N), low(N);
+    double price = 100;
+    for (size_t i = 0; i < N; ++i) {
+      price += step(rng);
+      low[i] = price;
+      high[i] = price + spread(rng) / 2.0;
+    }
+    INFO("seed=" << seed << " swing_length=" << swing_length
+                 << " range_percent=" << range_percent << " trial=" << trial
+                 << " N=" << N);
+
+    auto bars = make_dataframe<double>(factory::index::from_range(0, N),
+                                       {high, low}, {C.HIGH(), C.LOW()});
+
+    auto shlBase = MAKE_TRANSFORM(
+        swing_highs_lows("shl", static_cast<int64_t>(swing_length), timeframe));
+    auto shl = dynamic_cast<ITransform *>(shlBase.get());
+    auto shlResult = shl->TransformData(bars);
+
+    const auto expectedHL = ReferenceSwingHighsLows(high, low, swing_length);
+    std::vector<double> expectedHLValues(N, kNaN);
+    std::vector<double> expectedLevel(N, kNaN);
+    for (size_t i = 0; i < N; ++i) {
+      if (expectedHL[i] != 0) {
+        expectedHLValues[i] = static_cast<double>(expectedHL[i]);
+        expectedLevel[i] = expectedHL[i] == 1 ? high[i] : low[i];
+      }
+    }
+    RequireColumnEquals(shlResult, shl->GetOutputId("high_low"),
+                        expectedHLValues);
+    RequireColumnEquals(shlResult, shl->GetOutputId("level"), expectedLevel);
+
+    auto liquidityBase = MAKE_TRANSFORM(
+        liquidity("liquidity", shl->GetOutputId("high_low"),
+                  shl->GetOutputId("level"), range_percent, timeframe));
+    auto liquidityTransform = dynamic_cast<ITransform *>(liquidityBase.get());
+    auto liquidityResult = liquidityTransform->TransformData(
+        bars.assign(shl->GetOutputId("high_low"),
+                    shlResult[shl->GetOutputId("high_low")])
+            .assign(shl->GetOutputId("level"),
+                    shlResult[shl->GetOutputId("level")]));
+
+    const auto expected = ReferenceLiquidity(high, low, expectedHL,
+                                             expectedLevel, range_percent);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("liquidity"),
+                        expected.liquidity);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("level"),
+                        expected.level);
+    RequireColumnEquals(liquidityResult, liquidityTransform->GetOutputId("end"),
+                        expected.end);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("swept"),
+                        expected.swept);
+  }
+}
+
+TEST_CASE("Liquidity matches the reference grouping with NaN highs and lows",
+          "[SMC][Liquidity]") {
+  using namespace epoch_frame;
+  const auto &C = EpochStratifyXConstants::instance();
+  const auto timeframe = C.DAILY_FREQUENCY;
+
+  const auto seed = GENERATE(5u, 17u, 99u);
+  const double range_percent = GENERATE(0.01, 0.1, 0.5);
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> step(-3, 3);
+  std::uniform_int_distribution<int> spread(0, 4);
+  std::uniform_int_distribution<size_t> length(1, 300);
+  std::bernoulli_distribution isNaN(0.1);
+  std::bernoulli_distribution isSwing(0.3);
+  std::bernoulli_distribution isHigh(0.5);
+
+  for (size_t trial = 0; trial < 20; ++trial) {
+    const size_t N = length(rng);
+    std::vector<double> high(N), low(N), level(N, kNaN);
+    std::vector<int64_t> hl(N, 0);
+    double price = 100.0;
+    for (size_t i = 0; i < N; ++i) {
+      price += step(rng);
+      low[i] = isNaN(rng) ? kNaN : price;
+      high[i] = isNaN(rng) ? kNaN : price + spread(rng) / 2.0;
+      // Swings sit on valid prices; the NaN bars around them must neither
+      // widen the pip range nor sweep a group.
+      const int64_t side = isHigh(rng) ? 1 : -1;
+      const double swing = side == 1 ? high[i] : low[i];
+      if (isSwing(rng) && !std::isnan(swing)) {
+        hl[i] = side;
+        level[i] = swing;
+      }
+    }
+    INFO("seed=" << seed << " range_percent=" << range_percent
+                 << " trial=" << trial << " N=" << N);
+
+    const auto index = factory::index::from_range(0, N);
+    auto bars = make_dataframe<double>(index, {high, low, level},
+                                       {C.HIGH(), C.LOW(), "level"})
+                    .assign("high_low",
+                            make_dataframe<int64_t>(index, {hl},
+                                                    {"high_low"})["high_low"]);
+
+    auto liquidityBase = MAKE_TRANSFORM(
+        liquidity("liquidity", "high_low", "level", range_percent, timeframe));
+    auto liquidityTransform = dynamic_cast<ITransform *>(liquidityBase.get());
+    auto liquidityResult = liquidityTransform->TransformData(bars);
+
+    const auto expected =
+        ReferenceLiquidity(high, low, hl, level, range_percent);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("liquidity"),
+                        expected.liquidity);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("level"),
+                        expected.level);
+    RequireColumnEquals(liquidityResult, liquidityTransform->GetOutputId("end"),
+                        expected.end);
+    RequireColumnEquals(liquidityResult,
+                        liquidityTransform->GetOutputId("swept"),
+                        expected.swept);
+  }
+}
@@ -1,16 +1,23 @@
 //
 // Created by assistant on 08/24/25.
 //
+#include <epoch_script/transforms/core/asset_scope.h>
 #include <epoch_script/transforms/core/config_helper.h>
 #include <epoch_script/transforms/core/transform_registry.h>
 #include <arrow/compute/api_vector.h>
 #include <catch2/catch_test_macros.hpp>
 #include <epoch_core/catch_defs.h>
 #include <epoch_frame/factory/dataframe_factory.h>
+#include <epoch_frame/factory/index_factory.h>
 #include <epoch_frame/serialization.h>
 #include <index/datetime_index.h>
+#include <cmath>
+#include <thread>
 #include <vector>
 
+#include "transforms/components/statistics/dataframe_armadillo_utils.h"
+#include "transforms/components/statistics/hmm_model_cache.h"
+
 #include <epoch_script/core/bar_attribute.h>
 #include <epoch_script/core/constants.h>
 
@@ -18,6 +25,7 @@ using namespace epoch_core;
 using namespace epoch_frame;
 using namespace epoch_script;
 using namespace epoch_script::transform;
+using namespace std::chrono_literals;
 
 namespace {
 
@@ -206,3 +214,228 @@ TEST_CASE("HMMTransform with uncorrelated features", "[hmm]") {
     }
   }
 }
+
+TEST_CASE("HMMTransform freeze_model reuses the asset's trained model",
+          "[hmm]") {
+  const auto tf =
+      epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+  auto uncorrelated = read_hmm_input("hmm_input_uncorrelated.csv");
+  auto correlated = read_hmm_input("hmm_input_2.csv");
+
+  YAML::Node inputs_yaml;
+  inputs_yaml[epoch_script::ARG] = std::vector<std::string>{"x", "y", "z"};
+  YAML::Node options_yaml;
+  options_yaml["min_training_samples"] = 100;
+  options_yaml["lookback_window"] = 0;
+  options_yaml["freeze_model"] = true;
+
+  auto cfg = run_op("hmm_2", "hmm_frozen", inputs_yaml, options_yaml, tf);
+  auto tbase = MAKE_TRANSFORM(cfg);
+  auto t = dynamic_cast<ITransform *>(tbase.get());
+  REQUIRE(t != nullptr);
+
+  {
+    ScopedAssetContext asset{"HMM_FROZEN_A"};
+    auto trained = t->TransformData(uncorrelated);
+    REQUIRE(trained.num_rows() == uncorrelated.num_rows());
+
+    // Predict-only: the correlated features would fail training, but the
+    // frozen model is reused
+    auto predicted = t->TransformData(correlated);
+    REQUIRE(predicted.num_rows() == correlated.num_rows());
+
+    // Same model, same input, same output
+    REQUIRE(t->TransformData(uncorrelated).equals(trained));
+  }
+
+  {
+    // Another asset has no model yet, so it trains (and fails) on its own data
+    ScopedAssetContext asset{"HMM_FROZEN_B"};
+    REQUIRE_THROWS_WITH(t->TransformData(correlated),
+                        Catch::Matchers::ContainsSubstring("correlated"));
+  }
+}
+
+TEST_CASE("HMMTransform models are scoped by timeframe and graph", "[hmm]") {
+  const auto &C = epoch_script::EpochStratifyXConstants::instance();
+  auto uncorrelated = read_hmm_input("hmm_input_uncorrelated.csv");
+  auto correlated = read_hmm_input("hmm_input_2.csv");
+
+  YAML::Node inputs_yaml;
+  inputs_yaml[epoch_script::ARG] = std::vector<std::string>{"x", "y", "z"};
+  YAML::Node options_yaml;
+  options_yaml["min_training_samples"] = 100;
+  options_yaml["lookback_window"] = 0;
+  options_yaml["freeze_model"] = true;
+
+  // Same node id, inputs and options; only the timeframe differs
+  auto dailyCfg = run_op("hmm_2", "hmm_scoped", inputs_yaml, options_yaml,
+                         C.DAILY_FREQUENCY);
+  auto minuteCfg = run_op("hmm_2", "hmm_scoped", inputs_yaml, options_yaml,
+                          C.MINUTE_FREQUENCY);
+  auto daily = MAKE_TRANSFORM(dailyCfg);
+  auto minute = MAKE_TRANSFORM(minuteCfg);
+
+  {
+    ScopedAssetContext asset{"HMM_SCOPED_A", "graph-1"};
+    REQUIRE(daily->TransformData(uncorrelated).num_rows() ==
+            uncorrelated.num_rows());
+
+    // A frozen model of the daily node would predict here; the minute node
+    // has none yet, so it trains (and fails) on its own data
+    REQUIRE_THROWS_WITH(minute->TransformData(correlated),
+                        Catch::Matchers::ContainsSubstring("correlated"));
+  }
+
+  {
+    // The same node and asset in another graph does not see the model either
+    ScopedAssetContext asset{"HMM_SCOPED_A", "graph-2"};
+    REQUIRE_THROWS_WITH(daily->TransformData(correlated),
+                        Catch::Matchers::ContainsSubstring("correlated"));
+  }
+
+  {
+    // Back in the first graph the frozen daily model is still reused
+    ScopedAssetContext asset{"HMM_SCOPED_A", "graph-1"};
+    REQUIRE(daily->TransformData(correlated).num_rows() ==
+            correlated.num_rows());
+  }
+}
+
+TEST_CASE("HMMTransform warm_start retrains from the asset's previous model",
+          "[hmm]") {
+  const auto tf =
+      epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+  auto uncorrelated = read_hmm_input("hmm_input_uncorrelated.csv");
+  auto correlated = read_hmm_input("hmm_input_2.csv");
+  REQUIRE(uncorrelated.num_rows() > 150);
+
+  YAML::Node inputs_yaml;
+  inputs_yaml[epoch_script::ARG] = std::vector<std::string>{"x", "y", "z"};
+  YAML::Node options_yaml;
+  options_yaml["min_training_samples"] = 100;
+  options_yaml["lookback_window"] = 100;
+  options_yaml["warm_start"] = true;
+
+  auto cfg = run_op("hmm_2", "hmm_warm", inputs_yaml, options_yaml, tf);
+  auto tbase = MAKE_TRANSFORM(cfg);
+  auto t = dynamic_cast<ITransform *>(tbase.get());
+  REQUIRE(t != nullptr);
+
+  ScopedAssetContext asset{"HMM_WARM_A"};
+  auto first = t->TransformData(uncorrelated);
+  REQUIRE(first.num_rows() == uncorrelated.num_rows() - 100);
+
+  // The same training window reuses the stored model as-is
+  REQUIRE(t->TransformData(uncorrelated).equals(first));
+
+  // A later window trains again, starting EM from the previous model
+  auto later = uncorrelated.iloc({50, static_cast<int64_t>(
+                                          uncorrelated.num_rows())});
+  auto walked = t->TransformData(later);
+  REQUIRE(walked.num_rows() == later.num_rows() - 100);
+  for (auto const &name : walked.column_names()) {
+    if (name.find("prob") == std::string::npos) {
+      continue;
+    }
+    for (auto p : walked[name].contiguous_array().to_vector<double>()) {
+      REQUIRE(p >= -1e-9);
+      REQUIRE(p <= 1.0 + 1e-9);
+    }
+  }
+
+  // Unlike freeze_model, a new window is trained, so features that cannot
+  // be trained on still fail
+  REQUIRE_THROWS_WITH(t->TransformData(correlated),
+                      Catch::Matchers::ContainsSubstring("correlated"));
+}
+
+TEST_CASE("HMM model cache trains once per series and stays bounded",
+          "[hmm]") {
+  const auto tf =
+      epoch_script::EpochStratifyXConstants::instance().DAILY_FREQUENCY;
+  auto uncorrelated = read_hmm_input("hmm_input_uncorrelated.csv");
+
+  YAML::Node inputs_yaml;
+  inputs_yaml[epoch_script::ARG] = std::vector<std::string>{"x", "y", "z"};
+  YAML::Node options_yaml;
+  options_yaml["min_training_samples"] = 100;
+  options_yaml["lookback_window"] = 0;
+
+  auto cfg = run_op("hmm_3", "hmm_flight", inputs_yaml, options_yaml, tf);
+  auto tbase = MAKE_TRANSFORM(cfg);
+  auto t = dynamic_cast<ITransform *>(tbase.get());
+  REQUIRE(t != nullptr);
+
+  auto &cache = HMMModelCache::Instance();
+  cache.Clear();
+
+  SECTION("Concurrent runs of one series share a single training") {
+    // Training starts from a random model, so a second training of the same
+    // window would almost surely produce different probabilities
+    constexpr size_t kThreads = 8;
+    std::vector<DataFrame> outputs(kThreads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+      threads.emplace_back([&, i] {
+        ScopedAssetContext asset{"HMM_FLIGHT_A"};
+        outputs[i] = t->TransformData(uncorrelated);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (size_t i = 1; i < kThreads; ++i) {
+      REQUIRE(outputs[i].equals(outputs[0]));
+    }
+    REQUIRE(cache.Size() == 1);
+  }
+
+  SECTION("Least recently used series are evicted beyond the capacity") {
+    cache.SetCapacity(2);
+    for (auto const *id : {"HMM_LRU_A", "HMM_LRU_B", "HMM_LRU_C"}) {
+      ScopedAssetContext asset{id};
+      t->TransformData(uncorrelated);
+    }
+    REQUIRE(cache.Size() == 2);
+    cache.SetCapacity(HMMModelCache::kDefaultCapacity);
+  }
+
+  cache.Clear();
+}
+
+TEST_CASE("ObservationsFromDataFrame reads null slots as NaN", "[hmm]") {
+  // AppendValues keeps the buffer value behind a null, as Arrow kernels may
+  auto with_null = [](std::vector<double> const &values) {
+    const std::vector<uint8_t> valid{1, 0, 1};
+    arrow::DoubleBuilder builder;
+    REQUIRE(builder.AppendValues(values, valid).ok());
+    return std::make_shared<arrow::ChunkedArray>(
+        builder.Finish().ValueOrDie());
+  };
+  auto index = factory::index::make_datetime_index(
+      {DateTime{2020y, std::chrono::January, 1d},
+       DateTime{2020y, std::chrono::January, 2d},
+       DateTime{2020y, std::chrono::January, 3d}});
+  auto df = make_dataframe(index,
+                           {with_null({1.0, 999.0, 3.0}),
+                            with_null({4.0, 999.0, 6.0})},
+                           {"x", "y"});
+
+  SECTION("Single column") {
+    auto observations = utils::ObservationsFromDataFrame(df, {"x"});
+    REQUIRE(observations.X.n_rows == 1);
+    REQUIRE(observations.X.n_cols == 3);
+    CHECK(observations.X(0, 0) == 1.0);
+    CHECK(std::isnan(observations.X(0, 1)));
+    CHECK(observations.X(0, 2) == 3.0);
+  }
+
+  SECTION("Several columns") {
+    auto observations = utils::ObservationsFromDataFrame(df, {"x", "y"});
+    REQUIRE(observations.X.n_rows == 2);
+    CHECK(std::isnan(observations.X(0, 1)));
+    CHECK(std::isnan(observations.X(1, 1)));
+    CHECK(observations.X(1, 2) == 6.0);
+  }
+}
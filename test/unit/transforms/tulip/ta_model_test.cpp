@@ -80,6 +80,32 @@ TEST_CASE("Tulip Indicator Transforms") {
            << expected);
       REQUIRE(result.equals(expected));
     }
+
+    SECTION("Batched run matches per-frame runs") {
+      auto tulipModel = dynamic_cast<TulipModelImpl<true> *>(model);
+      REQUIRE(tulipModel != nullptr);
+
+      std::vector<epoch_frame::DataFrame> inputs;
+      for (size_t rows : {5, 3, 8}) {
+        std::vector<epoch_frame::DateTime> dates;
+        std::vector<double> values;
+        for (size_t i = 0; i < rows; ++i) {
+          dates.emplace_back(epoch_frame::DateTime{
+              2020y, std::chrono::January, chrono_day(1 + i)});
+          values.push_back(static_cast<double>(i * i));
+        }
+        inputs.emplace_back(make_dataframe<double>(
+            epoch_frame::factory::index::make_datetime_index(dates), {values},
+            {"x"}));
+      }
+
+      auto results = tulipModel->TransformDataBatch(inputs);
+      REQUIRE(results.size() == inputs.size());
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        INFO("Frame " << i);
+        REQUIRE(results[i].equals(model->TransformData(inputs[i])));
+      }
+    }
   }
 
   SECTION("CrossOver and CrossAny Test") {
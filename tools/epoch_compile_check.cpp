@@ -1,21 +1,60 @@
 //
 // EpochScript Compile Check Tool
 //
-// Usage: epoch_compile_check "<epochscript_code>"
+// Usage: epoch_compile_check "<epochscript_code>" [--assets <n>] [--rows <n>]
+//                            [--timeframe-rows <timeframe>=<n> ...]
+//                            [--elementwise-fusion] [--algebraic-simplification]
+//        epoch_compile_check --serve [--socket <path>] [--threads <n>]
+//                            [--elementwise-fusion] [--algebraic-simplification]
 //
 // This executable validates EpochScript code syntax by attempting compilation.
 // Outputs JSON response: {"status": "ok"|"error", "message": "error message"}
 // Always returns exit code 0 for easy shell scripting.
 //
+// With --assets, --rows or --timeframe-rows the response also carries
+// "cost", the static runtime estimate of the compiled graph for that many
+// assets and rows per asset (per timeframe where given): per-node and total
+// work units and seconds.
+//
+// --elementwise-fusion and --algebraic-simplification enable those optional
+// compiler passes on top of the ones named in
+// EPOCH_SCRIPT_COMPILER_OPTIMIZATIONS.
+//
+// --serve keeps the runtime initialized and answers newline-delimited JSON
+// requests, {"id": <any>, "code": "<epochscript_code>"}, with one response
+// line each, {"id": <same>, "status": ..., "message": ...}. A request may
+// add "estimate": {"assets": n, "rows": n, "rows_by_timeframe": {...}} to
+// get "cost" in its response, and "options": {"elementwise_fusion": bool,
+// "algebraic_simplification": bool} to compile with exactly those passes
+// instead of the daemon's. Requests are read from stdin (responses on
+// stdout) or, with --socket, from every connection to a Unix socket. They
+// are compiled concurrently, so responses may arrive out of order; match
+// them by id. Each worker thread reuses one compiler and nothing is cached
+// per script, so the daemon's memory stays flat however many edits it sees
+// (see CompileServer).
+//
 
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <stdexcept>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
+#include <optional>
+#include <string_view>
+#include <thread>
 
-#include <epoch_script/strategy/metadata.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "transforms/compiler/compile_server.h"
+#include <epoch_script/core/compiler_options.h>
 #include <epoch_script/strategy/registration.h>
 #include <epoch_script/transforms/core/registration.h>
 #include <epoch_frame/factory/calendar_factory.h>
@@ -25,6 +64,9 @@
 #include <google/protobuf/stubs/common.h>
 #include <absl/log/initialize.h>
 #include <yaml-cpp/yaml.h>
+#include <glaze/glaze.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 
 namespace {
 
@@ -52,11 +94,13 @@ void InitializeRuntime() {
       data_sdk::asset::AssetSpecificationDatabase::GetInstance().IsInitialized(),
       "Failed to initialize Asset Specification Database.");
 
-  // Register transform metadata
-  epoch_script::transforms::RegisterTransformMetadata(DEFAULT_YAML_LOADER);
-
-  // Initialize transforms registry
-  epoch_script::transform::InitializeTransforms(DEFAULT_YAML_LOADER, {}, {});
+  // Register transform metadata from the build-time snapshot and initialize
+  // the transforms registry. YAML is loaded instead when the snapshot is
+  // missing, malformed or written from other YAML or metadata sources;
+  // EPOCH_SCRIPT_METADATA_SNAPSHOT overrides the path.
+  const char* snapshot = std::getenv("EPOCH_SCRIPT_METADATA_SNAPSHOT");
+  epoch_script::transform::InitializeTransforms(
+      DEFAULT_YAML_LOADER, {}, {}, snapshot ? snapshot : TRANSFORM_METADATA_SNAPSHOT);
 }
 
 // Escape JSON string
@@ -83,21 +127,143 @@ std::string EscapeJson(const std::string& s) {
 }
 
 // Output JSON response
-void OutputJson(const std::string& status, const std::string& message) {
+void OutputJson(const std::string& status, const std::string& message,
+                const std::optional<epoch_script::CostEstimate>& cost = std::nullopt) {
   std::cout << "{\"status\": \"" << status << "\", \"message\": \""
-            << EscapeJson(message) << "\"}" << std::endl;
+            << EscapeJson(message) << "\"";
+  if (cost) {
+    std::cout << ", \"cost\": " << glz::write_json(*cost).value_or("null");
+  }
+  std::cout << "}" << std::endl;
+}
+
+// Accept clients forever, one reader thread per connection
+void ServeSocket(const std::string& path, epoch_script::CompileServer& server) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  AssertFromFormat(!path.empty() && path.size() < sizeof(address.sun_path),
+                   "Invalid socket path: '{}'", path);
+  path.copy(address.sun_path, path.size());
+
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  AssertFromFormat(listener >= 0, "socket() failed: {}", std::strerror(errno));
+
+  // A stale socket file from a previous daemon would make bind() fail
+  ::unlink(path.c_str());
+  AssertFromFormat(
+      ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0,
+      "Failed to bind {}: {}", path, std::strerror(errno));
+  AssertFromFormat(::listen(listener, SOMAXCONN) == 0, "Failed to listen on {}: {}",
+                   path, std::strerror(errno));
+  SPDLOG_INFO("epoch_compile_check serving on {}", path);
+
+  for (;;) {
+    const int fd = ::accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno != EINTR) {
+        SPDLOG_WARN("accept() failed: {}", std::strerror(errno));
+      }
+      continue;
+    }
+    std::thread([fd, &server] { server.ServeConnection(fd, fd, true); }).detach();
+  }
+}
+
+int Serve(const std::optional<std::string>& socketPath, int threads,
+          const epoch_script::CompilerOptions& options) {
+  // Responses own stdout; keep compiler logging off it
+  spdlog::set_default_logger(spdlog::stderr_color_mt("epoch_compile_check"));
+  // A client closing early must not kill the daemon
+  std::signal(SIGPIPE, SIG_IGN);
+
+  try {
+    InitializeRuntime();
+  } catch (const std::exception& e) {
+    SPDLOG_CRITICAL("Runtime initialization failed: {}", e.what());
+    return 1;
+  }
+
+  epoch_script::CompileServer server(threads, options);
+  try {
+    if (socketPath) {
+      ServeSocket(*socketPath, server);
+    } else {
+      server.ServeConnection(STDIN_FILENO, STDOUT_FILENO, false);
+      server.Wait();
+    }
+  } catch (const std::exception& e) {
+    SPDLOG_CRITICAL("{}", e.what());
+    return 1;
+  }
+  return 0;
 }
 
 } // namespace
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
+  auto options = epoch_script::CompilerOptions::FromEnvironment();
+
+  if (argc >= 2 && std::string_view{argv[1]} == "--serve") {
+    std::optional<std::string> socketPath;
+    int threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    for (int i = 2; i < argc; ++i) {
+      const std::string_view arg{argv[i]};
+      if (arg == "--socket" && i + 1 < argc) {
+        socketPath = argv[++i];
+      } else if (arg == "--threads" && i + 1 < argc) {
+        threads = std::max(1, std::atoi(argv[++i]));
+      } else if (arg == "--elementwise-fusion") {
+        options.elementwise_fusion = true;
+      } else if (arg == "--algebraic-simplification") {
+        options.algebraic_simplification = true;
+      } else {
+        std::cerr << "Usage: epoch_compile_check --serve [--socket <path>] [--threads <n>] "
+                     "[--elementwise-fusion] [--algebraic-simplification]"
+                  << std::endl;
+        return 2;
+      }
+    }
+    return Serve(socketPath, threads, options);
+  }
+
+  if (argc < 2) {
     OutputJson("error", "Usage: epoch_compile_check \"<epochscript_code>\"");
     return 0;
   }
 
   std::string code = argv[1];
 
+  std::optional<epoch_script::CostEstimateOptions> estimate;
+  for (int i = 2; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (arg == "--elementwise-fusion") {
+      options.elementwise_fusion = true;
+      continue;
+    }
+    if (arg == "--algebraic-simplification") {
+      options.algebraic_simplification = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      OutputJson("error", "Missing value for " + std::string{arg});
+      return 0;
+    }
+    auto& estimateOptions = estimate ? *estimate : estimate.emplace();
+    const std::string value = argv[++i];
+    const auto separator = value.find('=');
+    if (arg == "--assets") {
+      estimateOptions.assets = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--rows") {
+      estimateOptions.rows = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--timeframe-rows" && separator != std::string::npos) {
+      estimateOptions.rows_by_timeframe[value.substr(0, separator)] =
+          std::strtoull(value.c_str() + separator + 1, nullptr, 10);
+    } else {
+      OutputJson("error", "Invalid argument: " + std::string{arg} + " " + value);
+      return 0;
+    }
+  }
+
   if (code.empty()) {
     OutputJson("error", "Empty code provided");
     return 0;
@@ -106,21 +272,18 @@ int main(int argc, char* argv[]) {
   try {
     // Initialize runtime
     InitializeRuntime();
-
-    // Attempt to compile code (skip_sink_validation=true for faster syntax-only check)
-    auto compiler = std::make_unique<epoch_script::strategy::PythonSource>(code, true);
-
-    // If we got here, compilation succeeded
-    OutputJson("ok", "Compilation successful");
-    return 0;
-
   } catch (const std::exception& e) {
-    // Compilation or runtime error
+    // Runtime error
     OutputJson("error", e.what());
     return 0;
   } catch (...) {
-    // Unknown error
-    OutputJson("error", "Unknown error during compilation");
+    OutputJson("error", "Unknown error during initialization");
     return 0;
   }
+
+  epoch_script::PythonParser parser;
+  epoch_script::AlgorithmAstCompiler compiler{options};
+  auto result = epoch_script::CheckCode(code, parser, compiler, estimate);
+  OutputJson(result.status, result.message, result.cost);
+  return 0;
 }
@@ -0,0 +1,53 @@
+//
+// EpochScript Transform Metadata Snapshot Tool
+//
+// Usage: epoch_metadata_snapshot <output_path>
+//
+// Registers the transform metadata from METADATA_FILES_DIR and the built-in
+// C++ metadata, then writes the merged registry as a snapshot that
+// RegisterTransformMetadataSnapshot loads without yaml-cpp. Run by the build
+// whenever the library or the YAML files change.
+//
+
+#include <epoch_script/transforms/core/registration.h>
+#include <epoch_script/transforms/core/registry.h>
+#include <yaml-cpp/yaml.h>
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <output_path>" << std::endl;
+    return 1;
+  }
+
+  try {
+    epoch_script::transforms::RegisterTransformMetadata(
+        [](std::string const &path) {
+          return YAML::LoadFile(std::filesystem::path{METADATA_FILES_DIR} /
+                                path);
+        });
+    const auto snapshot =
+        epoch_script::transforms::SerializeTransformMetadataSnapshot();
+
+    std::ofstream file(argv[1], std::ios::binary | std::ios::trunc);
+    file << snapshot;
+    if (!file) {
+      std::cerr << "Failed to write " << argv[1] << std::endl;
+      return 1;
+    }
+    std::cout << "Wrote "
+              << epoch_script::transforms::ITransformRegistry::GetInstance()
+                     .GetMetaData()
+                     .size()
+              << " transforms to " << argv[1] << std::endl;
+  } catch (std::exception const &e) {
+    std::cerr << "Failed to build transform metadata snapshot: " << e.what()
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}